@@ -193,6 +193,7 @@ public: \
 	using tree_t = tree##_t; \
 	using elem_t = tree##_elem_t; \
 	using key_t = tree##_key_t; \
+	using iterator_t = struct tree##_t_iterator; \
 	using Allocator_Base = \
 		DummyAllocator<tree##_EXTENT_SIZE>; \
 	struct Allocator: public Allocator_Base { \
@@ -219,6 +220,12 @@ public: \
 	static constexpr auto find = ::tree##_t_find; \
 	static constexpr auto insert = ::tree##_t_insert; \
 	static constexpr auto delete_ = ::tree##_t_delete; \
+	static constexpr auto first = ::tree##_t_first; \
+	static constexpr auto last = ::tree##_t_last; \
+	static constexpr auto iterator_next = ::tree##_t_iterator_next; \
+	static constexpr auto iterator_prev = ::tree##_t_iterator_prev; \
+	static constexpr auto iterator_get_elem = \
+		::tree##_t_iterator_get_elem; \
 }
 
 /* The class must be created for each instantiated BPS tree to test it. */
@@ -418,6 +425,56 @@ generate_benchmarks_height(find_rand, 2);
 generate_benchmarks_height(find_rand, 3);
 generate_benchmarks_height(find_rand, 4);
 
+/*
+ * The following functions test performance of sequential scans. Each
+ * benchmark iteration moves the iterator by one element and dereferences
+ * it, the scan is restarted when the iterator reaches the end.
+ */
+
+template<class tree>
+static void
+test_iterate_forward(benchmark::State &state, size_t count)
+{
+	typename tree::tree_t t;
+	typename tree::Allocator allocator(count);
+	create<tree>(t, count, allocator);
+	typename tree::iterator_t itr = tree::first(&t);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(*tree::iterator_get_elem(&t, &itr));
+		if (!tree::iterator_next(&t, &itr))
+			itr = tree::first(&t);
+	}
+	tree::destroy(&t);
+}
+
+generate_benchmarks_size(iterate_forward, 1000000);
+
+generate_benchmarks_height(iterate_forward, 2);
+generate_benchmarks_height(iterate_forward, 3);
+generate_benchmarks_height(iterate_forward, 4);
+
+template<class tree>
+static void
+test_iterate_backward(benchmark::State &state, size_t count)
+{
+	typename tree::tree_t t;
+	typename tree::Allocator allocator(count);
+	create<tree>(t, count, allocator);
+	typename tree::iterator_t itr = tree::last(&t);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(*tree::iterator_get_elem(&t, &itr));
+		if (!tree::iterator_prev(&t, &itr))
+			itr = tree::last(&t);
+	}
+	tree::destroy(&t);
+}
+
+generate_benchmarks_size(iterate_backward, 1000000);
+
+generate_benchmarks_height(iterate_backward, 2);
+generate_benchmarks_height(iterate_backward, 3);
+generate_benchmarks_height(iterate_backward, 4);
+
 /*
  * The following functions test performance of insertion and deletion without
  * reballancing. This is done by performing the two opposite operations in a
@@ -18,6 +18,7 @@
 //  - Search only (by value), no misses;
 //  - Search only (by value) with misses;
 //  - Search by key;
+//  - Batched search (by value) with prefetching;
 //  - Sequence iteration;
 //  - Inserts after erase;
 //  - Inserts alongside with lookups;
@@ -311,6 +312,33 @@ class HTBench : public ::benchmark::Fixture {
 		state.SetItemsProcessed(lookup_count);
 	}
 
+	// Same as FindRandValue, but the hashes of the lookups are known in
+	// advance so that the bucket of a value can be prefetched a few
+	// lookups before the value is searched for.
+	void
+	FindRandValueBatch(benchmark::State& state)
+	{
+		constexpr std::size_t distance = 8;
+		std::size_t lookup_count = 0;
+		for (auto s : state) {
+			state.PauseTiming();
+			Reset();
+			TupleHolder data(state.range(0));
+			Fill(data.tuples.begin(), data.tuples.end());
+			data.shuffle();
+			state.ResumeTiming();
+
+			const auto &tuples = data.tuples;
+			for (std::size_t i = 0; i < tuples.size(); ++i) {
+				if (i + distance < tuples.size())
+					hash_table.prefetch(tuples[i + distance]);
+				benchmark::DoNotOptimize(hash_table.find(tuples[i]));
+				lookup_count++;
+			}
+		}
+		state.SetItemsProcessed(lookup_count);
+	}
+
 	// Lookup random values (most of them should not be presented in the table).
 	void
 	FindRandValueWithMisses(benchmark::State& state)
@@ -514,6 +542,12 @@ class Light {
 		return light_find_key(&ht, tuple.hash, tuple.key);
 	}
 
+	void
+	prefetch(const TupleRef &tuple)
+	{
+		light_prefetch(&ht, tuple.hash);
+	}
+
 	void
 	clear()
 	{
@@ -550,6 +584,7 @@ class STL {
 	auto insert(const TupleRef &tuple) { return ht.insert(tuple); }
 	auto find(const TupleRef &tuple) { return ht.find(tuple); }
 	auto find_key(const TupleRef &tuple) { return ht.find(tuple); }
+	void prefetch(const TupleRef &) { /* no-op */ }
 	void clear() { ht.clear(); }
 	void reserve(std::size_t n) { ht.reserve(n); }
 
@@ -590,6 +625,7 @@ BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(InsertRandValueReserve);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(FindRandValue);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(FindRandValueWithMisses);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(FindRandByKey);
+BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(FindRandValueBatch);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(SequenceIteration);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(InsertAfterErase);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(FindAfterErase);
@@ -245,6 +245,30 @@ index_opts_validate(struct index_opts *opts)
 			 "less than or equal to 1");
 		return -1;
 	}
+	if (opts->bloom_partition_pages < 0 ||
+	    opts->bloom_partition_pages > UINT32_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "bloom_partition_pages must be greater than or "
+			 "equal to 0 and less than 2^32");
+		return -1;
+	}
+	if (opts->bloom_type == index_bloom_type_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "bloom_type must be either 'classic' or "
+			 "'binary_fuse'");
+		return -1;
+	}
+	if (opts->compaction_threads <= 0) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "compaction_threads must be greater than 0");
+		return -1;
+	}
+	if (opts->compaction_strategy == index_compaction_strategy_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "compaction_strategy must be one of 'leveled', "
+			 "'tiered' or 'delete_aware'");
+		return -1;
+	}
 	int rc = -1;
 	struct region *gc = &fiber()->gc;
 	size_t gc_svp = region_used(gc);
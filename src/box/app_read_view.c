@@ -0,0 +1,683 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "app_read_view.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_threads.h"
+#include "assoc.h"
+#include "box.h"
+#include "diag.h"
+#include "error.h"
+#include "fiber.h"
+#include "fiber_cond.h"
+#include "index.h"
+#include "iproto_constants.h"
+#include "iterator_type.h"
+#include "msgpuck.h"
+#include "read_view.h"
+#include "schema.h"
+#include "small/obuf.h"
+#include "small/region.h"
+#include "small/rlist.h"
+#include "space.h"
+#include "space_cache.h"
+#include "trivia/util.h"
+#include "tt_pthread.h"
+#include "tt_static.h"
+#include "user.h"
+#include "xrow.h"
+
+/**
+ * How often to check if retired read views can be closed while the shared
+ * read view is disabled, in seconds.
+ */
+static const double app_read_view_gc_interval = 0.1;
+
+/** Read view of a space shared by application threads. */
+struct app_read_view_space {
+	/** Space read view. */
+	struct space_read_view *rv;
+	/**
+	 * Set for each user (indexed by authentication token) that had
+	 * the read access to the space when the read view was opened.
+	 */
+	bool can_read[BOX_USER_MAX];
+};
+
+/** Database read view shared by application threads. */
+struct app_read_view {
+	/** Database read view. */
+	struct read_view rv;
+	/** Map: space id -> struct app_read_view_space. */
+	struct mh_i32ptr_t *spaces;
+	/**
+	 * User names indexed by authentication token, copied when the read
+	 * view was opened. NULL for unused tokens and roles.
+	 */
+	char *user_names[BOX_USER_MAX];
+	/**
+	 * Number of requests using this read view.
+	 * Protected by app_read_view_mutex.
+	 */
+	int refs;
+	/**
+	 * Set if the read view has been used by a request since it was
+	 * opened. Protected by app_read_view_mutex.
+	 */
+	bool is_used;
+	/** Link in app_read_view_retired. */
+	struct rlist in_retired;
+};
+
+/**
+ * An application thread fiber waiting for tx to reopen the shared read view.
+ * Allocated on the fiber stack. Protected by app_read_view_mutex.
+ */
+struct app_read_view_waiter {
+	/** Waiting fiber. */
+	struct fiber *fiber;
+	/** Event loop of the application thread running the fiber. */
+	struct ev_loop *loop;
+	/** Sent by tx to wake up the fiber. */
+	struct ev_async async;
+	/** Set by tx when it's done reopening the read view. */
+	bool is_done;
+	/** Link in app_read_view_waiters. */
+	struct rlist in_waiters;
+};
+
+/**
+ * Protects app_read_view_current, app_read_view_is_enabled,
+ * app_read_view_waiters, and app_read_view::refs, is_used.
+ */
+static pthread_mutex_t app_read_view_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Read view used for serving new requests or NULL if the read view is
+ * disabled or closed because it was idle. Protected by app_read_view_mutex.
+ */
+static struct app_read_view *app_read_view_current;
+
+/**
+ * Set if requests may be served from the shared read view.
+ * Protected by app_read_view_mutex.
+ */
+static bool app_read_view_is_enabled;
+
+/**
+ * List of application thread fibers that need the shared read view while
+ * it's closed, linked by app_read_view_waiter::in_waiters. Tx wakes them up
+ * and clears the list when it reopens the read view.
+ * Protected by app_read_view_mutex.
+ */
+static RLIST_HEAD(app_read_view_waiters);
+
+/**
+ * List of read views replaced by newer ones, linked by
+ * app_read_view::in_retired. A retired read view is closed as soon as
+ * it isn't used by any request. Accessed only from tx.
+ */
+static RLIST_HEAD(app_read_view_retired);
+
+/** Maximum age of the shared read view, in seconds. Zero if disabled. */
+static double app_read_view_staleness;
+
+/** Fiber that periodically reopens the shared read view. */
+static struct fiber *app_read_view_worker;
+
+/** Signaled to wake up the refresh fiber. */
+static struct fiber_cond app_read_view_cond;
+
+/** Event loop of the tx thread, which runs the refresh fiber. */
+static struct ev_loop *app_read_view_tx_loop;
+
+/** Sent by application threads to make tx reopen the shared read view. */
+static struct ev_async app_read_view_async;
+
+/** Space filter for the shared read view. */
+static bool
+app_read_view_space_filter(struct space *space, void *arg)
+{
+	(void)arg;
+	return space_is_memtx(space) && !space_is_system(space);
+}
+
+/** Index filter for the shared read view. */
+static bool
+app_read_view_index_filter(struct space *space, struct index *index,
+			   void *arg)
+{
+	(void)space;
+	(void)arg;
+	return (index->def->type == TREE || index->def->type == HASH) &&
+	       !index->def->key_def->for_func_index;
+}
+
+/**
+ * Returns true if the given user may read the given space.
+ * Follows the logic of access_check_space().
+ */
+static bool
+app_read_view_user_can_read(struct user *user, struct space *space)
+{
+	uint8_t token = user->auth_token;
+	user_access_t access = PRIV_R | PRIV_U;
+	access &= ~universe.access[token].effective;
+	access &= ~entity_access_get(SC_SPACE)[token].effective;
+	if (access == 0)
+		return true;
+	if ((access & PRIV_U) != 0)
+		return false;
+	return space->def->uid == user->def->uid ||
+	       (access & ~space->access[token].effective) == 0;
+}
+
+/**
+ * Opens a new read view to be shared by application threads.
+ * Returns NULL and sets diag on error.
+ */
+static struct app_read_view *
+app_read_view_new(void)
+{
+	struct app_read_view *arv = xmalloc(sizeof(*arv));
+	struct read_view_opts opts;
+	read_view_opts_create(&opts);
+	opts.name = "app_threads";
+	opts.filter_space = app_read_view_space_filter;
+	opts.filter_index = app_read_view_index_filter;
+	if (read_view_open(&arv->rv, &opts) != 0) {
+		free(arv);
+		return NULL;
+	}
+	for (int i = 0; i < BOX_USER_MAX; i++) {
+		struct user *user = user_find_by_token(i);
+		if (user->def != NULL && user->def->type == SC_USER)
+			arv->user_names[i] = xstrdup(user->def->name);
+		else
+			arv->user_names[i] = NULL;
+	}
+	arv->spaces = mh_i32ptr_new();
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, &arv->rv) {
+		struct space *space = space_by_id(space_rv->id);
+		assert(space != NULL);
+		struct app_read_view_space *arv_space =
+			xmalloc(sizeof(*arv_space));
+		arv_space->rv = space_rv;
+		for (int i = 0; i < BOX_USER_MAX; i++) {
+			arv_space->can_read[i] =
+				arv->user_names[i] != NULL &&
+				app_read_view_user_can_read(
+					user_find_by_token(i), space);
+		}
+		struct mh_i32ptr_node_t node = {space_rv->id, arv_space};
+		mh_i32ptr_put(arv->spaces, &node, NULL, NULL);
+	}
+	arv->refs = 0;
+	arv->is_used = false;
+	rlist_create(&arv->in_retired);
+	return arv;
+}
+
+/** Closes a shared read view that isn't used anymore. */
+static void
+app_read_view_delete(struct app_read_view *arv)
+{
+	assert(arv->refs == 0);
+	mh_int_t i;
+	mh_foreach(arv->spaces, i)
+		free(mh_i32ptr_node(arv->spaces, i)->val);
+	mh_i32ptr_delete(arv->spaces);
+	for (int i = 0; i < BOX_USER_MAX; i++)
+		free(arv->user_names[i]);
+	read_view_close(&arv->rv);
+	free(arv);
+}
+
+/**
+ * Makes the given read view (may be NULL) current and retires the previous
+ * one. @a is_enabled tells if requests may use the shared read view. If
+ * @a is_request_done is set, completes a pending request to reopen the read
+ * view. Called from tx.
+ */
+static void
+app_read_view_replace(struct app_read_view *arv, bool is_enabled,
+		      bool is_request_done)
+{
+	tt_pthread_mutex_lock(&app_read_view_mutex);
+	struct app_read_view *old = app_read_view_current;
+	app_read_view_current = arv;
+	app_read_view_is_enabled = is_enabled;
+	if (is_request_done) {
+		struct app_read_view_waiter *waiter, *next;
+		rlist_foreach_entry_safe(waiter, &app_read_view_waiters,
+					 in_waiters, next) {
+			/*
+			 * Sent under the mutex, because the waiter stops
+			 * the watcher as soon as it sees the flag.
+			 */
+			waiter->is_done = true;
+			ev_async_send(waiter->loop, &waiter->async);
+		}
+		rlist_create(&app_read_view_waiters);
+	}
+	tt_pthread_mutex_unlock(&app_read_view_mutex);
+	if (old != NULL)
+		rlist_add_tail_entry(&app_read_view_retired, old, in_retired);
+}
+
+/** Closes retired read views that aren't used anymore. Called from tx. */
+static void
+app_read_view_collect_garbage(void)
+{
+	struct app_read_view *arv, *next;
+	rlist_foreach_entry_safe(arv, &app_read_view_retired, in_retired,
+				 next) {
+		/*
+		 * A retired read view can't be referenced anew so once
+		 * the reference counter drops to 0, it stays 0.
+		 */
+		tt_pthread_mutex_lock(&app_read_view_mutex);
+		int refs = arv->refs;
+		tt_pthread_mutex_unlock(&app_read_view_mutex);
+		if (refs > 0)
+			continue;
+		rlist_del_entry(arv, in_retired);
+		app_read_view_delete(arv);
+	}
+}
+
+/**
+ * Reopens the shared read view when it becomes stale.
+ *
+ * An open read view makes memtx keep old versions of index data and
+ * tuples and disables the memtx defragmenter. To limit the impact, the
+ * read view is opened only on demand. If it hasn't been used since it
+ * was opened, it's closed instead of being reopened, so it stays open for
+ * at most two staleness periods after the last request. The next request
+ * asks tx to reopen it and waits, see app_read_view_ref().
+ */
+static int
+app_read_view_worker_f(va_list ap)
+{
+	(void)ap;
+	while (!fiber_is_cancelled()) {
+		bool is_enabled = app_read_view_staleness > 0 &&
+				  app_thread_count > 0 && box_is_configured();
+		tt_pthread_mutex_lock(&app_read_view_mutex);
+		struct app_read_view *old = app_read_view_current;
+		bool is_requested = !rlist_empty(&app_read_view_waiters);
+		bool is_needed = is_requested || (old != NULL && old->is_used);
+		tt_pthread_mutex_unlock(&app_read_view_mutex);
+		struct app_read_view *arv = NULL;
+		if (is_enabled && is_needed) {
+			arv = app_read_view_new();
+			/*
+			 * Don't keep serving requests from the old read view
+			 * because it's going to exceed the configured age.
+			 */
+			if (arv == NULL)
+				diag_log();
+		}
+		app_read_view_replace(arv, is_enabled,
+				      is_requested || !is_enabled);
+		app_read_view_collect_garbage();
+		tt_pthread_mutex_lock(&app_read_view_mutex);
+		is_requested = !rlist_empty(&app_read_view_waiters);
+		tt_pthread_mutex_unlock(&app_read_view_mutex);
+		/* A request may have come while we were opening the view. */
+		if (is_requested && is_enabled)
+			continue;
+		double timeout;
+		if (arv != NULL)
+			timeout = app_read_view_staleness;
+		else if (!rlist_empty(&app_read_view_retired))
+			timeout = app_read_view_gc_interval;
+		else
+			timeout = TIMEOUT_INFINITY;
+		fiber_cond_wait_timeout(&app_read_view_cond, timeout);
+	}
+	return 0;
+}
+
+/** Wakes up the refresh fiber on a request from an application thread. */
+static void
+app_read_view_async_cb(struct ev_loop *loop, struct ev_async *watcher,
+		       int events)
+{
+	(void)loop;
+	(void)watcher;
+	(void)events;
+	fiber_cond_signal(&app_read_view_cond);
+}
+
+void
+app_read_view_init(void)
+{
+	assert(app_read_view_worker == NULL);
+	fiber_cond_create(&app_read_view_cond);
+	app_read_view_tx_loop = loop();
+	ev_async_init(&app_read_view_async, app_read_view_async_cb);
+	ev_async_start(app_read_view_tx_loop, &app_read_view_async);
+	app_read_view_worker = fiber_new_system("app_read_view",
+						app_read_view_worker_f);
+	if (app_read_view_worker == NULL)
+		panic("failed to start application read view fiber");
+	fiber_set_joinable(app_read_view_worker, true);
+	fiber_start(app_read_view_worker);
+}
+
+void
+app_read_view_shutdown(void)
+{
+	if (app_read_view_worker == NULL)
+		return;
+	fiber_cancel(app_read_view_worker);
+	fiber_join(app_read_view_worker);
+	app_read_view_worker = NULL;
+	app_read_view_replace(NULL, false, true);
+	app_read_view_collect_garbage();
+	assert(rlist_empty(&app_read_view_retired));
+	ev_async_stop(app_read_view_tx_loop, &app_read_view_async);
+	fiber_cond_destroy(&app_read_view_cond);
+}
+
+void
+app_read_view_set_staleness(double staleness)
+{
+	assert(staleness >= 0);
+	app_read_view_staleness = staleness;
+	fiber_cond_signal(&app_read_view_cond);
+}
+
+/** Wakes up an application thread fiber when tx reopens the read view. */
+static void
+app_read_view_waiter_cb(struct ev_loop *loop, struct ev_async *watcher,
+			int events)
+{
+	(void)loop;
+	(void)events;
+	struct app_read_view_waiter *waiter =
+		(struct app_read_view_waiter *)watcher->data;
+	fiber_wakeup(waiter->fiber);
+}
+
+/**
+ * Acquires a reference to the current shared read view. If the read view
+ * was closed because it was idle, asks tx to reopen it and waits until it
+ * does. Returns NULL if the read view is disabled or failed to open.
+ */
+static struct app_read_view *
+app_read_view_ref(void)
+{
+	tt_pthread_mutex_lock(&app_read_view_mutex);
+	if (app_read_view_current == NULL && app_read_view_is_enabled) {
+		struct app_read_view_waiter waiter;
+		waiter.fiber = fiber();
+		waiter.loop = loop();
+		waiter.is_done = false;
+		ev_async_init(&waiter.async, app_read_view_waiter_cb);
+		waiter.async.data = &waiter;
+		ev_async_start(waiter.loop, &waiter.async);
+		rlist_add_tail_entry(&app_read_view_waiters, &waiter,
+				     in_waiters);
+		ev_async_send(app_read_view_tx_loop, &app_read_view_async);
+		/*
+		 * Tx always completes the request, even on shutdown, so
+		 * the wait can't be interrupted: the waiter is referenced
+		 * by tx until then.
+		 */
+		while (!waiter.is_done) {
+			tt_pthread_mutex_unlock(&app_read_view_mutex);
+			fiber_yield();
+			tt_pthread_mutex_lock(&app_read_view_mutex);
+		}
+		ev_async_stop(waiter.loop, &waiter.async);
+	}
+	struct app_read_view *arv = app_read_view_current;
+	if (arv != NULL) {
+		arv->refs++;
+		arv->is_used = true;
+	}
+	tt_pthread_mutex_unlock(&app_read_view_mutex);
+	return arv;
+}
+
+/** Releases a reference acquired with app_read_view_ref(). */
+static void
+app_read_view_unref(struct app_read_view *arv)
+{
+	tt_pthread_mutex_lock(&app_read_view_mutex);
+	assert(arv->refs > 0);
+	arv->refs--;
+	tt_pthread_mutex_unlock(&app_read_view_mutex);
+}
+
+/** Looks up a space read view by name. Returns NULL if not found. */
+static struct space_read_view *
+app_read_view_space_by_name(struct app_read_view *arv, const char *name,
+			    uint32_t name_len)
+{
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, &arv->rv) {
+		if (strlen(space_rv->name) == name_len &&
+		    memcmp(space_rv->name, name, name_len) == 0)
+			return space_rv;
+	}
+	return NULL;
+}
+
+/**
+ * Looks up the space targeted by a request in a shared read view.
+ * Returns NULL and sets diag if not found.
+ */
+static struct app_read_view_space *
+app_read_view_find_space(struct app_read_view *arv,
+			 const struct request *request)
+{
+	uint32_t space_id = request->space_id;
+	if (request->space_name != NULL) {
+		struct space_read_view *space_rv = app_read_view_space_by_name(
+			arv, request->space_name, request->space_name_len);
+		if (space_rv == NULL) {
+			diag_set(ClientError, ER_NO_SUCH_SPACE,
+				 tt_cstr(request->space_name,
+					 request->space_name_len));
+			return NULL;
+		}
+		space_id = space_rv->id;
+	}
+	mh_int_t i = mh_i32ptr_find(arv->spaces, space_id, NULL);
+	if (i == mh_end(arv->spaces)) {
+		diag_set(ClientError, ER_NO_SUCH_SPACE, int2str(space_id));
+		return NULL;
+	}
+	return mh_i32ptr_node(arv->spaces, i)->val;
+}
+
+/**
+ * Looks up the index targeted by a request in a space read view.
+ * Returns NULL and sets diag if not found.
+ */
+static struct index_read_view *
+app_read_view_find_index(struct space_read_view *space_rv,
+			 const struct request *request)
+{
+	if (request->index_name != NULL) {
+		for (uint32_t i = 0; i <= space_rv->index_id_max; i++) {
+			struct index_read_view *index_rv =
+				space_rv->index_map[i];
+			if (index_rv != NULL &&
+			    strlen(index_rv->def->name) ==
+			    request->index_name_len &&
+			    memcmp(index_rv->def->name, request->index_name,
+				   request->index_name_len) == 0)
+				return index_rv;
+		}
+		diag_set(ClientError, ER_NO_SUCH_INDEX_NAME,
+			 tt_cstr(request->index_name, request->index_name_len),
+			 space_rv->name);
+		return NULL;
+	}
+	struct index_read_view *index_rv =
+		space_read_view_index(space_rv, request->index_id);
+	if (index_rv == NULL) {
+		diag_set(ClientError, ER_NO_SUCH_INDEX_ID, request->index_id,
+			 space_rv->name);
+		return NULL;
+	}
+	return index_rv;
+}
+
+/**
+ * Checks if a SELECT request can be served from the shared read view.
+ * Returns 0 if it can. Otherwise, sets diag and returns -1.
+ */
+static int
+app_read_view_check_select(const struct request *request)
+{
+	static const char *object_name = "Application thread read view";
+	if (request->iterator >= iterator_type_MAX) {
+		diag_set(IllegalParams, "Invalid iterator type");
+		return -1;
+	}
+	enum iterator_type type = (enum iterator_type)request->iterator;
+	if (type != ITER_ALL && type != ITER_EQ && type != ITER_GE) {
+		diag_set(ClientError, ER_UNSUPPORTED, object_name,
+			 tt_sprintf("iterator type %s",
+				    iterator_type_strs[type]));
+		return -1;
+	}
+	const char *key = request->key;
+	if (key != NULL && mp_decode_array(&key) != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, object_name,
+			 "non-empty search key");
+		return -1;
+	}
+	if (request->after_position != NULL || request->after_tuple != NULL ||
+	    request->fetch_position) {
+		diag_set(ClientError, ER_UNSUPPORTED, object_name,
+			 "pagination");
+		return -1;
+	}
+	return 0;
+}
+
+/** Returns true if the user with the given name may read the space. */
+static bool
+app_read_view_can_read(struct app_read_view *arv,
+		       struct app_read_view_space *arv_space,
+		       const char *user_name)
+{
+	for (int i = 0; i < BOX_USER_MAX; i++) {
+		if (arv->user_names[i] != NULL &&
+		    strcmp(arv->user_names[i], user_name) == 0)
+			return arv_space->can_read[i];
+	}
+	return false;
+}
+
+/** Implementation of app_read_view_select() for the given read view. */
+static int
+app_read_view_select_impl(struct app_read_view *arv,
+			  const struct request *request,
+			  const char *user_name, struct obuf *out)
+{
+	struct app_read_view_space *arv_space =
+		app_read_view_find_space(arv, request);
+	if (arv_space == NULL)
+		return -1;
+	if (!app_read_view_can_read(arv, arv_space, user_name)) {
+		diag_set(AccessDeniedError, priv_name(PRIV_R),
+			 schema_object_name(SC_SPACE), arv_space->rv->name,
+			 user_name);
+		return -1;
+	}
+	struct index_read_view *index_rv =
+		app_read_view_find_index(arv_space->rv, request);
+	if (index_rv == NULL)
+		return -1;
+	struct index_read_view_iterator it;
+	if (index_read_view_create_iterator(index_rv, ITER_ALL, NULL, 0,
+					    &it) != 0)
+		return -1;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t offset = request->offset;
+	uint32_t count = 0;
+	int rc = 0;
+	while (count < request->limit) {
+		struct read_view_tuple tuple;
+		rc = index_read_view_iterator_next_raw(&it, &tuple);
+		if (rc != 0 || tuple.data == NULL)
+			break;
+		if (offset > 0) {
+			offset--;
+		} else {
+			xobuf_dup(out, tuple.data, tuple.size);
+			count++;
+		}
+		/* The tuple data may be allocated on the region. */
+		region_truncate(region, region_svp);
+	}
+	index_read_view_iterator_destroy(&it);
+	return rc == 0 ? (int)count : -1;
+}
+
+int
+app_read_view_select(const struct request *request, const char *user_name,
+		     struct obuf *out, struct obuf_svp *svp)
+{
+	if (app_read_view_check_select(request) != 0)
+		return -1;
+	/*
+	 * Acquiring the read view may yield, after which the request data
+	 * may be discarded from the input buffer, so copy the space and
+	 * index names. The key and the pagination data have already been
+	 * checked and aren't used anymore.
+	 */
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct request req = *request;
+	if (req.space_name != NULL) {
+		char *name = xregion_alloc(region, req.space_name_len);
+		memcpy(name, req.space_name, req.space_name_len);
+		req.space_name = name;
+	}
+	if (req.index_name != NULL) {
+		char *name = xregion_alloc(region, req.index_name_len);
+		memcpy(name, req.index_name, req.index_name_len);
+		req.index_name = name;
+	}
+	req.key = NULL;
+	req.key_end = NULL;
+	int rc = -1;
+	struct app_read_view *arv = app_read_view_ref();
+	if (arv != NULL) {
+		/*
+		 * Other fibers may have written to the output buffer while
+		 * we were waiting for the read view, so reserve the reply
+		 * header only now.
+		 */
+		iproto_prepare_select(out, svp);
+		rc = app_read_view_select_impl(arv, &req, user_name, out);
+		if (rc < 0)
+			obuf_rollback_to_svp(out, svp);
+		app_read_view_unref(arv);
+	} else {
+		diag_set(ClientError, ER_UNABLE_TO_PROCESS_IN_THREAD,
+			 iproto_type_name(IPROTO_SELECT), app_thread_id);
+	}
+	region_truncate(region, region_svp);
+	return rc;
+}
@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct obuf;
+struct obuf_svp;
+struct request;
+
+/**
+ * Initializes the database read view shared by application threads and
+ * starts the fiber that refreshes it. Must be called from tx.
+ *
+ * The read view is disabled until app_read_view_set_staleness() is called
+ * with a positive value.
+ */
+void
+app_read_view_init(void);
+
+/**
+ * Stops the refresh fiber and closes all read views. Must be called from tx
+ * after all requests that could use the read view have been processed.
+ */
+void
+app_read_view_shutdown(void);
+
+/**
+ * Sets the maximum age of the shared read view, in seconds. The read view is
+ * reopened as soon as it becomes older than that. Zero disables the read view.
+ * Must be called from tx.
+ *
+ * While the read view is open, memtx can't free old tuples and index data
+ * and the memtx defragmenter doesn't run. So the read view is opened on the
+ * first request and closed if no request has used it during a staleness
+ * period.
+ */
+void
+app_read_view_set_staleness(double staleness);
+
+/**
+ * Processes a SELECT request against the shared read view on behalf of
+ * the user with the given name and writes selected tuples to the output
+ * buffer. May be called from any thread.
+ *
+ * Waiting for the read view to be reopened may yield, so the reply header
+ * is reserved with iproto_prepare_select() only after that, and its
+ * position is saved to @a svp. The request data aren't used after a yield,
+ * so the input buffer may be discarded then.
+ *
+ * Only memtx TREE and HASH indexes of non-system spaces are available in
+ * the read view. Since keyed lookups aren't supported by read view iterators,
+ * the request must have an empty key and one of ALL, EQ, GE iterator types.
+ * Pagination isn't supported either, but offset and limit are respected.
+ *
+ * Returns the number of tuples written to the buffer. On error, returns -1
+ * and sets diag, and nothing is written to the buffer.
+ */
+int
+app_read_view_select(const struct request *request, const char *user_name,
+		     struct obuf *out, struct obuf_svp *svp);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
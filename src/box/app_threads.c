@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "app_read_view.h"
 #include "coio_task.h"
 #include "cord_buf.h"
 #include "call.h"
@@ -152,3 +153,14 @@ app_thread_process_eval(struct call_request *request, struct port *port)
 	port_msgpack_destroy(&args);
 	return rc;
 }
+
+int
+app_thread_process_select(struct request *request, struct obuf *out,
+			  struct obuf_svp *svp)
+{
+	struct runtime_credentials *runtime_cr =
+			fiber()->storage.runtime_credentials;
+	const char *uname = runtime_cr->user_name != NULL ?
+			    runtime_cr->user_name : "guest";
+	return app_read_view_select(request, uname, out, svp);
+}
@@ -10,7 +10,10 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct call_request;
+struct obuf;
+struct obuf_svp;
 struct port;
+struct request;
 
 enum {
 	APP_THREADS_MAX = 1000,
@@ -55,6 +58,18 @@ app_thread_process_call(struct call_request *request, struct port *port);
 int
 app_thread_process_eval(struct call_request *request, struct port *port);
 
+/**
+ * Processes SELECT request in this application thread. The request is served
+ * from the read view shared by application threads, see app_read_view.h.
+ * The reply header is reserved in the output buffer at @a svp.
+ *
+ * Returns the number of tuples written to the output buffer. On error,
+ * returns -1 and sets diag.
+ */
+int
+app_thread_process_select(struct request *request, struct obuf *out,
+			  struct obuf_svp *svp);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
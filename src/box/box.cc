@@ -41,6 +41,7 @@
 #include <say.h>
 #include <scoped_guard.h>
 #include "identifier.h"
+#include "app_read_view.h"
 #include "app_threads.h"
 #include "iproto.h"
 #include "iproto_constants.h"
@@ -1929,6 +1930,45 @@ box_check_wal_retention_period()
 	return value;
 }
 
+/** Validate that wal_group_commit_max_delay is >= 0. */
+static double
+box_check_wal_group_commit_max_delay(void)
+{
+	double value = cfg_getd("wal_group_commit_max_delay");
+	if (value < 0) {
+		diag_set(ClientError, ER_CFG, "wal_group_commit_max_delay",
+			 "the value must be >= 0");
+		return -1;
+	}
+	return value;
+}
+
+/** Validate that wal_group_commit_max_size is > 0. */
+static int64_t
+box_check_wal_group_commit_max_size(void)
+{
+	int64_t value = cfg_geti64("wal_group_commit_max_size");
+	if (value <= 0) {
+		diag_set(ClientError, ER_CFG, "wal_group_commit_max_size",
+			 "the value must be > 0");
+		return -1;
+	}
+	return value;
+}
+
+/** Validate that wal_spare_files is >= 0. */
+static int
+box_check_wal_spare_files(void)
+{
+	int count = cfg_geti("wal_spare_files");
+	if (count < 0) {
+		diag_set(ClientError, ER_CFG, "wal_spare_files",
+			 "the value must be >= 0");
+		return -1;
+	}
+	return count;
+}
+
 /** Validate wal_retention_period and raise error, if needed. */
 static double
 box_check_wal_retention_period_xc()
@@ -2016,6 +2056,92 @@ box_check_allocator(void)
 	return 0;
 }
 
+/**
+ * Checks the memtx arena memory placement options and stores them to
+ * @a opts. Returns -1 and sets diag if an option is invalid.
+ */
+static int
+box_check_memtx_arena_opts(struct memtx_arena_opts *opts)
+{
+	*opts = memtx_arena_opts_default;
+	const char *huge_pages = cfg_gets("memtx_memory_huge_pages");
+	opts->huge_pages = (enum memtx_huge_pages)STR2ENUM(memtx_huge_pages,
+							   huge_pages);
+	if (opts->huge_pages == memtx_huge_pages_MAX) {
+		diag_set(ClientError, ER_CFG, "memtx_memory_huge_pages",
+			 "the value must be one of the following strings: "
+			 "'none', 'transparent', '2M', '1G'");
+		return -1;
+	}
+	const char *numa = cfg_gets("memtx_memory_numa");
+	opts->numa_policy = (enum memtx_numa_policy)STR2ENUM(memtx_numa_policy,
+							     numa);
+	if (opts->numa_policy == memtx_numa_policy_MAX) {
+		diag_set(ClientError, ER_CFG, "memtx_memory_numa",
+			 "the value must be one of the following strings: "
+			 "'default', 'interleave', 'bind'");
+		return -1;
+	}
+	const char *nodes = "memtx_memory_numa_nodes";
+	int count = cfg_getarr_size(nodes);
+	for (int i = 0; i < count; i++) {
+		const char *node = cfg_getarr_elem(nodes, i);
+		char *end = NULL;
+		long n = node == NULL ? -1 : strtol(node, &end, 10);
+		if (n < 0 || n >= MEMTX_NUMA_NODES_MAX || end == node ||
+		    *end != '\0') {
+			diag_set(ClientError, ER_CFG, nodes,
+				 tt_sprintf("NUMA node numbers must be "
+					    "integers from 0 to %d",
+					    MEMTX_NUMA_NODES_MAX - 1));
+			return -1;
+		}
+		opts->numa_nodes |= (uint64_t)1 << n;
+	}
+	return 0;
+}
+
+/** Check box.cfg.memtx_defrag_rate and return its value or -1. */
+static double
+box_check_memtx_defrag_rate(void)
+{
+	double rate = cfg_getd("memtx_defrag_rate");
+	if (rate < 0) {
+		diag_set(ClientError, ER_CFG, "memtx_defrag_rate",
+			 "the value must be greater than or equal to 0");
+		return -1;
+	}
+	return rate;
+}
+
+/**
+ * Check box.cfg.memtx_checkpoint_delta_count and return its value or -1.
+ */
+static int
+box_check_memtx_checkpoint_delta_count(void)
+{
+	int count = cfg_geti("memtx_checkpoint_delta_count");
+	if (count < 0) {
+		diag_set(ClientError, ER_CFG, "memtx_checkpoint_delta_count",
+			 "the value must be greater than or equal to 0");
+		return -1;
+	}
+	return count;
+}
+
+/** Check box.cfg.memtx_defrag_threshold and return its value or -1. */
+static double
+box_check_memtx_defrag_threshold(void)
+{
+	double threshold = cfg_getd("memtx_defrag_threshold");
+	if (threshold < 0 || threshold > 1) {
+		diag_set(ClientError, ER_CFG, "memtx_defrag_threshold",
+			 "the value must be between 0 and 1");
+		return -1;
+	}
+	return threshold;
+}
+
 static void
 box_check_small_alloc_options(void)
 {
@@ -2057,6 +2183,40 @@ box_check_app_threads(void)
 	return 0;
 }
 
+/**
+ * Checks the value of the box.cfg.app_threads_read_view_staleness.
+ * Returns the value on success. On error, sets diag and returns -1.
+ */
+static double
+box_check_app_threads_read_view_staleness(void)
+{
+	double staleness = cfg_getd("app_threads_read_view_staleness");
+	if (staleness < 0) {
+		diag_set(ClientError, ER_CFG,
+			 "app_threads_read_view_staleness",
+			 "the value must be greater than or equal to 0");
+		return -1;
+	}
+	return staleness;
+}
+
+/**
+ * Checks the value of the box.cfg.iproto_ev_backend. Returns
+ * iproto_ev_backend_MAX and sets diag if the value is invalid.
+ */
+static enum iproto_ev_backend
+box_check_iproto_ev_backend(void)
+{
+	const char *name = cfg_gets("iproto_ev_backend");
+	int backend = STR2ENUM(iproto_ev_backend, name);
+	if (backend == iproto_ev_backend_MAX) {
+		diag_set(ClientError, ER_CFG, "iproto_ev_backend",
+			 "the value must be one of the following strings: "
+			 "'auto', 'io_uring'");
+	}
+	return (enum iproto_ev_backend)backend;
+}
+
 static int
 box_check_iproto_options(void)
 {
@@ -2068,6 +2228,8 @@ box_check_iproto_options(void)
 				     IPROTO_THREADS_MAX));
 		return -1;
 	}
+	if (box_check_iproto_ev_backend() == iproto_ev_backend_MAX)
+		return -1;
 	return 0;
 }
 
@@ -2243,15 +2405,32 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_wal_retention_period() < 0)
 		diag_raise();
+	if (box_check_wal_group_commit_max_delay() < 0)
+		diag_raise();
+	if (box_check_wal_group_commit_max_size() < 0)
+		diag_raise();
+	if (box_check_wal_spare_files() < 0)
+		diag_raise();
 	if (box_check_memory_quota("memtx_memory") < 0)
 		diag_raise();
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
 	if (box_check_allocator() != 0)
 		diag_raise();
 	box_check_small_alloc_options();
+	struct memtx_arena_opts arena_opts;
+	if (box_check_memtx_arena_opts(&arena_opts) != 0)
+		diag_raise();
+	if (box_check_memtx_defrag_rate() < 0)
+		diag_raise();
+	if (box_check_memtx_defrag_threshold() < 0)
+		diag_raise();
+	if (box_check_memtx_checkpoint_delta_count() < 0)
+		diag_raise();
 	box_check_vinyl_options();
 	if (box_check_app_threads() != 0)
 		diag_raise();
+	if (box_check_app_threads_read_view_staleness() < 0)
+		diag_raise();
 	if (box_check_iproto_options() != 0)
 		diag_raise();
 	if (box_check_sql_cache_size(cfg_geti("sql_cache_size")) != 0)
@@ -3413,6 +3592,54 @@ box_set_memtx_max_tuple_size(void)
 			cfg_geti("memtx_max_tuple_size"));
 }
 
+int
+box_set_memtx_defrag_rate(void)
+{
+	double rate = box_check_memtx_defrag_rate();
+	if (rate < 0)
+		return -1;
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_defrag_set_rate(&memtx->defrag, rate);
+	return 0;
+}
+
+int
+box_set_memtx_checkpoint_delta_count(void)
+{
+	int count = box_check_memtx_checkpoint_delta_count();
+	if (count < 0)
+		return -1;
+	/*
+	 * Older versions can't recover from incremental snapshots so they
+	 * must not be enabled until the schema is upgraded. The check is
+	 * skipped on startup, when the schema version isn't known yet,
+	 * so memtx also checks it when it starts a checkpoint.
+	 */
+	if (count > 0 &&
+	    schema_check_feature(SCHEMA_FEATURE_MEMTX_CHECKPOINT_DELTA) != 0)
+		return -1;
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_checkpoint_delta_count(memtx, count);
+	return 0;
+}
+
+int
+box_set_memtx_defrag_threshold(void)
+{
+	double threshold = box_check_memtx_defrag_threshold();
+	if (threshold < 0)
+		return -1;
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_defrag_set_threshold(&memtx->defrag, threshold);
+	return 0;
+}
+
 void
 box_set_too_long_threshold(void)
 {
@@ -3423,6 +3650,22 @@ box_set_too_long_threshold(void)
 	vinyl_engine_set_too_long_threshold(vinyl, too_long_threshold);
 }
 
+int
+box_set_app_threads_read_view_staleness(void)
+{
+	double staleness = box_check_app_threads_read_view_staleness();
+	if (staleness < 0)
+		return -1;
+	app_read_view_set_staleness(staleness);
+	return 0;
+}
+
+void
+box_set_iproto_connection_latency(void)
+{
+	iproto_set_connection_latency(cfg_getb("iproto_connection_latency"));
+}
+
 void
 box_set_readahead(void)
 {
@@ -3506,6 +3749,36 @@ box_set_wal_retention_period(void)
 	return 0;
 }
 
+int
+box_set_wal_group_commit_max_delay(void)
+{
+	double delay = box_check_wal_group_commit_max_delay();
+	if (delay < 0)
+		return -1;
+	wal_set_group_commit_max_delay(delay);
+	return 0;
+}
+
+int
+box_set_wal_group_commit_max_size(void)
+{
+	int64_t size = box_check_wal_group_commit_max_size();
+	if (size < 0)
+		return -1;
+	wal_set_group_commit_max_size(size);
+	return 0;
+}
+
+int
+box_set_wal_spare_files(void)
+{
+	int count = box_check_wal_spare_files();
+	if (count < 0)
+		return -1;
+	wal_set_spare_files(count);
+	return 0;
+}
+
 void
 box_set_vinyl_memory(void)
 {
@@ -3534,6 +3807,23 @@ box_set_vinyl_cache(void)
 	vinyl_engine_set_cache(vinyl, cfg_geti64("vinyl_cache"));
 }
 
+void
+box_set_vinyl_page_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_cache(vinyl, cfg_geti64("vinyl_page_cache"));
+}
+
+void
+box_set_vinyl_bloom_partition_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_bloom_partition_cache(
+		vinyl, cfg_geti64("vinyl_bloom_partition_cache"));
+}
+
 void
 box_set_vinyl_timeout(void)
 {
@@ -5345,12 +5635,16 @@ engine_init()
 	 * in checkpoints (in enigne_foreach order),
 	 * so it must be registered first.
 	 */
+	struct memtx_arena_opts arena_opts;
+	if (box_check_memtx_arena_opts(&arena_opts) != 0)
+		diag_raise();
 	struct memtx_engine *memtx;
 	memtx = memtx_engine_new_xc(cfg_gets("memtx_dir"),
 				    box_is_force_recovery,
 				    cfg_getd("memtx_memory"),
 				    cfg_geti("memtx_min_tuple_size"),
 				    cfg_geti("strip_core"),
+				    &arena_opts,
 				    cfg_geti("slab_alloc_granularity"),
 				    cfg_gets("memtx_allocator"),
 				    cfg_getd("slab_alloc_factor"),
@@ -5359,6 +5653,10 @@ engine_init()
 	engine_register((struct engine *)memtx);
 	box_set_memtx_use_sort_data();
 	box_set_memtx_max_tuple_size();
+	if (box_set_memtx_defrag_rate() != 0 ||
+	    box_set_memtx_defrag_threshold() != 0 ||
+	    box_set_memtx_checkpoint_delta_count() != 0)
+		diag_raise();
 
 	memcs_engine_register();
 
@@ -5371,6 +5669,8 @@ engine_init()
 	engine_register(vinyl);
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
+	box_set_vinyl_page_cache();
+	box_set_vinyl_bloom_partition_cache();
 	box_set_vinyl_timeout();
 
 	quiver_engine_register();
@@ -6009,7 +6309,10 @@ box_cfg_xc(void)
 		diag_raise();
 	box_set_net_msg_max();
 	box_set_readahead();
+	box_set_iproto_connection_latency();
 	box_set_too_long_threshold();
+	if (box_set_app_threads_read_view_staleness() != 0)
+		diag_raise();
 	box_set_replication_timeout();
 	box_set_replication_reconnect_timeout();
 	if (box_set_bootstrap_strategy() != 0)
@@ -6315,6 +6618,7 @@ box_reset_stat(void)
 	rmean_cleanup(rmean_box);
 	rmean_cleanup(rmean_error);
 	engine_reset_stat();
+	wal_reset_stat();
 	space_foreach(box_reset_space_stat, NULL);
 }
 
@@ -6594,13 +6898,14 @@ box_storage_init(void)
 	rmean_error = rmean_new(rmean_error_strings, RMEAN_ERROR_LAST);
 
 	app_threads_start(cfg_geti("app_threads"));
+	app_read_view_init();
 	gc_init(on_garbage_collection);
 	engine_init();
 	schema_init();
 	txn_limbo_init(box_raft());
 	journal_on_cascading_rollback = box_on_journal_cascading_rollback;
 	replication_init(cfg_geti_default("replication_threads", 1));
-	iproto_init(cfg_geti("iproto_threads"));
+	iproto_init(cfg_geti("iproto_threads"), box_check_iproto_ev_backend());
 	sql_init();
 	audit_log_init();
 	security_cfg();
@@ -6702,6 +7007,7 @@ box_storage_shutdown()
 		diag_log();
 		panic("cannot gracefully shutdown iproto");
 	}
+	app_read_view_shutdown();
 	replication_shutdown();
 	box_raft_shutdown();
 	txn_limbo_shutdown();
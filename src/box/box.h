@@ -384,19 +384,28 @@ void box_set_replication(void);
 void box_set_io_collect_interval(void);
 void box_set_snap_io_rate_limit(void);
 void box_set_too_long_threshold(void);
+int box_set_app_threads_read_view_staleness(void);
 void box_set_readahead(void);
 void box_set_checkpoint_count(void);
 void box_set_checkpoint_interval(void);
 void box_set_checkpoint_wal_threshold(void);
 int box_set_wal_queue_max_size(void);
+int box_set_wal_group_commit_max_delay(void);
+int box_set_wal_group_commit_max_size(void);
+int box_set_wal_spare_files(void);
 int box_set_replication_synchro_queue_max_size(void);
 int box_set_wal_cleanup_delay(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_use_sort_data(void);
 void box_set_memtx_max_tuple_size(void);
+int box_set_memtx_defrag_rate(void);
+int box_set_memtx_defrag_threshold(void);
+int box_set_memtx_checkpoint_delta_count(void);
 void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
+void box_set_vinyl_page_cache(void);
+void box_set_vinyl_bloom_partition_cache(void);
 void box_set_vinyl_timeout(void);
 void box_set_force_recovery(void);
 int box_set_election_mode(void);
@@ -419,6 +428,7 @@ void box_set_instance_name(void);
 void box_set_replicaset_name(void);
 void box_set_cluster_name(void);
 void box_set_net_msg_max(void);
+void box_set_iproto_connection_latency(void);
 int box_set_prepared_stmt_cache_size(void);
 int box_set_feedback(void);
 int box_set_txn_timeout(void);
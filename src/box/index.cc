@@ -43,6 +43,8 @@
 #include "box.h"
 #include "base64.h"
 #include "scoped_guard.h"
+#include "port.h"
+#include "qsort_arg.h"
 
 struct rlist box_on_select = RLIST_HEAD_INITIALIZER(box_on_select);
 
@@ -532,6 +534,137 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	return 0;
 }
 
+/**
+ * How many keys ahead of the current one box_index_get_many() asks the index
+ * to prefetch. Should be enough to hide a memory access latency behind the
+ * lookups in between.
+ */
+enum { GET_MANY_PREFETCH_DISTANCE = 8 };
+
+/** A key looked up by box_index_get_many(). */
+struct get_many_key {
+	/** Key parts, without the MsgPack array header. */
+	const char *parts;
+	/** Number of key parts. */
+	uint32_t part_count;
+	/** Position of the key in the request. */
+	uint32_t pos;
+};
+
+/** qsort_arg() comparator that orders get_many_key by the index key_def. */
+static int
+get_many_key_cmp(const void *a_ptr, const void *b_ptr, void *arg)
+{
+	const struct get_many_key *a = (const struct get_many_key *)a_ptr;
+	const struct get_many_key *b = (const struct get_many_key *)b_ptr;
+	struct key_def *key_def = (struct key_def *)arg;
+	return key_compare(a->parts, a->part_count, HINT_NONE,
+			   b->parts, b->part_count, HINT_NONE, key_def);
+}
+
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id, const char *keys,
+		   const char *keys_end, struct port *port)
+{
+	assert(keys != NULL && keys_end != NULL);
+	(void)keys_end;
+	if (box_check_slice() != 0)
+		return -1;
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	if (mp_typeof(*keys) != MP_ARRAY) {
+		diag_set(IllegalParams, "keys must be an array");
+		return -1;
+	}
+	struct region *region = &fiber()->gc;
+	RegionGuard region_guard(region);
+	uint32_t count = mp_decode_array(&keys);
+	struct get_many_key *lookup =
+		xregion_alloc_array(region, struct get_many_key, count);
+	for (uint32_t i = 0; i < count; i++) {
+		if (mp_typeof(*keys) != MP_ARRAY) {
+			diag_set(IllegalParams, "key must be an array");
+			return -1;
+		}
+		const char *key_array = keys;
+		struct get_many_key *key = &lookup[i];
+		key->part_count = mp_decode_array(&keys);
+		key->parts = keys;
+		key->pos = i;
+		if (exact_key_validate(index->def, key->parts,
+				       key->part_count) != 0)
+			return -1;
+		box_run_on_select(space, index, ITER_EQ, key_array);
+		keys = key_array;
+		mp_next(&keys);
+	}
+	/*
+	 * Looking up keys of an ordered index in the key order makes
+	 * adjacent lookups descend through the same inner nodes, which
+	 * are likely to be still cached.
+	 */
+	if (index->def->type == TREE && count > 1) {
+		qsort_arg(lookup, count, sizeof(*lookup), get_many_key_cmp,
+			  index->def->key_def);
+	}
+	struct tuple **results =
+		xregion_alloc_array(region, struct tuple *, count);
+	/* Start transaction in the engine. */
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	/* A lookup may yield in vinyl, pin the index in case it's dropped. */
+	index_ref(index);
+	/*
+	 * Keys of a batch are known in advance so a lookup can overlap with
+	 * loading the data needed by the lookups that follow it.
+	 */
+	for (uint32_t i = 0; i < count && i < GET_MANY_PREFETCH_DISTANCE; i++)
+		index_prefetch(index, lookup[i].parts, lookup[i].part_count);
+	int rc = 0;
+	uint32_t done = 0;
+	for (; done < count; done++) {
+		struct get_many_key *key = &lookup[done];
+		struct tuple *tuple;
+		rc = box_check_slice();
+		if (rc != 0)
+			break;
+		if (done + GET_MANY_PREFETCH_DISTANCE < count) {
+			struct get_many_key *next =
+				&lookup[done + GET_MANY_PREFETCH_DISTANCE];
+			index_prefetch(index, next->parts, next->part_count);
+		}
+		rc = index_get(index, key->parts, key->part_count, &tuple);
+		if (rc != 0)
+			break;
+		if (tuple != NULL)
+			tuple_ref(tuple);
+		results[key->pos] = tuple;
+	}
+	txn_end_ro_stmt(txn, &svp);
+	index_unref(index);
+	if (rc == 0) {
+		/* Count statistics. */
+		rmean_collect(rmean_box, IPROTO_SELECT, count);
+		port_c_create(port);
+		for (uint32_t i = 0; i < count; i++) {
+			if (results[i] != NULL)
+				port_c_add_tuple(port, results[i]);
+			else
+				port_c_add_null(port);
+		}
+	}
+	for (uint32_t i = 0; i < done; i++) {
+		struct tuple *tuple = results[lookup[i].pos];
+		if (tuple != NULL)
+			tuple_unref(tuple);
+	}
+	return rc;
+}
+
 int
 box_index_min(uint32_t space_id, uint32_t index_id, const char *key,
 	      const char *key_end, box_tuple_t **result)
@@ -1299,6 +1432,15 @@ generic_index_stat(struct index *index, struct info_handler *handler)
 	info_end(handler);
 }
 
+void
+generic_index_prefetch(struct index *index, const char *key,
+		       uint32_t part_count)
+{
+	(void)index;
+	(void)key;
+	(void)part_count;
+}
+
 void
 generic_index_compact(struct index *index)
 {
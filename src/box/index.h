@@ -49,6 +49,7 @@ struct space_read_view;
 struct index;
 struct index_read_view;
 struct index_read_view_iterator;
+struct port;
 struct index_def;
 struct key_def;
 struct info_handler;
@@ -321,6 +322,22 @@ box_index_tuple_position(uint32_t space_id, uint32_t index_id,
 			 const char *tuple, const char *tuple_end,
 			 const char **packed_pos, const char **packed_pos_end);
 
+/**
+ * Look up a batch of keys in a unique index (index:get_many()).
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param keys MsgPack array of keys, each of which is a MsgPack array
+ * \param keys_end the end of encoded \a keys
+ * \param[out] port port_c with a tuple or nil per key, in the order
+ *                  of \a keys; must be destroyed by the caller on success
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ */
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id, const char *keys,
+		   const char *keys_end, struct port *port);
+
 /**
  * Index statistics (index:stat())
  *
@@ -649,6 +666,13 @@ struct index_vtab {
 			    uint32_t part_count, struct tuple **result);
 	int (*get)(struct index *index, const char *key,
 		   uint32_t part_count, struct tuple **result);
+	/**
+	 * Start loading the data a get() with the given exact key is going
+	 * to access into the CPU cache. Used by batched lookups to overlap
+	 * the cache misses of the next keys with the current lookup.
+	 */
+	void (*prefetch)(struct index *index, const char *key,
+			 uint32_t part_count);
 	/**
 	 * Create an index iterator. Iterator can be placed right after
 	 * position, passed in pos argument. Argument pos is an extracted
@@ -1027,6 +1051,12 @@ index_get(struct index *index, const char *key,
 	return index->vtab->get(index, key, part_count, result);
 }
 
+static inline void
+index_prefetch(struct index *index, const char *key, uint32_t part_count)
+{
+	index->vtab->prefetch(index, key, part_count);
+}
+
 static inline struct iterator *
 index_create_iterator_with_offset(struct index *index, enum iterator_type type,
 				  const char *key, uint32_t part_count,
@@ -1248,6 +1278,7 @@ int generic_index_get(struct index *, const char *, uint32_t, struct tuple **);
 struct index_read_view *
 generic_index_create_read_view(struct index *index);
 void generic_index_stat(struct index *, struct info_handler *);
+void generic_index_prefetch(struct index *, const char *, uint32_t);
 void generic_index_compact(struct index *);
 void generic_index_reset_stat(struct index *);
 struct iterator *
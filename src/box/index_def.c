@@ -40,6 +40,12 @@ const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *index_bloom_type_strs[] = { "classic", "binary_fuse" };
+
+const char *index_compaction_strategy_strs[] = {
+	"leveled", "tiered", "delete_aware"
+};
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
@@ -49,6 +55,10 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .bloom_partition_pages = */ 0,
+	/* .bloom_type          = */ INDEX_BLOOM_TYPE_CLASSIC,
+	/* .compaction_threads  = */ 1,
+	/* .compaction_strategy = */ INDEX_COMPACTION_STRATEGY_LEVELED,
 	/* .lsn                 = */ 0,
 	/* .func                = */ 0,
 	/* .hint                = */ INDEX_HINT_DEFAULT,
@@ -248,6 +258,14 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF("bloom_partition_pages", OPT_INT64, struct index_opts,
+		bloom_partition_pages),
+	OPT_DEF_ENUM("bloom_type", index_bloom_type, struct index_opts,
+		     bloom_type, NULL),
+	OPT_DEF("compaction_threads", OPT_INT64, struct index_opts,
+		compaction_threads),
+	OPT_DEF_ENUM("compaction_strategy", index_compaction_strategy,
+		     struct index_opts, compaction_strategy, NULL),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
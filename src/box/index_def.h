@@ -67,6 +67,26 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+enum index_bloom_type {
+	/* Classic blocked bloom filter */
+	INDEX_BLOOM_TYPE_CLASSIC,
+	/* Binary fuse filter, smaller than bloom at the same FPR */
+	INDEX_BLOOM_TYPE_BINARY_FUSE,
+	index_bloom_type_MAX
+};
+extern const char *index_bloom_type_strs[];
+
+enum index_compaction_strategy {
+	/* Leveled LSM tree, one run at the last level */
+	INDEX_COMPACTION_STRATEGY_LEVELED,
+	/* Size-tiered LSM tree, a few runs at each level */
+	INDEX_COMPACTION_STRATEGY_TIERED,
+	/* Leveled LSM tree, purging DELETE statements early */
+	INDEX_COMPACTION_STRATEGY_DELETE_AWARE,
+	index_compaction_strategy_MAX
+};
+extern const char *index_compaction_strategy_strs[];
+
 /** Covered field attributes. */
 struct covered_field_def {
 	/** Fieldno of covered field. */
@@ -108,6 +128,24 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/**
+	 * Number of run pages covered by one bloom filter partition.
+	 * If 0, a run has a single bloom filter for all its pages.
+	 */
+	int64_t bloom_partition_pages;
+	/** Type of filters built for new vinyl runs. */
+	enum index_bloom_type bloom_type;
+	/**
+	 * Max number of threads a single compaction task may use.
+	 * If greater than 1, compaction of a large range is split
+	 * into key range parts executed in parallel.
+	 */
+	int64_t compaction_threads;
+	/**
+	 * Policy used for choosing runs to compact,
+	 * see vy_range_update_compaction_priority().
+	 */
+	enum index_compaction_strategy compaction_strategy;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -186,6 +224,14 @@ index_opts_is_equal(const struct index_opts *o1, const struct index_opts *o2)
 		return false;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return false;
+	if (o1->bloom_partition_pages != o2->bloom_partition_pages)
+		return false;
+	if (o1->bloom_type != o2->bloom_type)
+		return false;
+	if (o1->compaction_threads != o2->compaction_threads)
+		return false;
+	if (o1->compaction_strategy != o2->compaction_strategy)
+		return false;
 	if (o1->func_id != o2->func_id)
 		return false;
 	if (o1->hint != o2->hint)
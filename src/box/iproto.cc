@@ -67,6 +67,8 @@
 #include "iproto_constants.h"
 #include "iproto_features.h"
 #include "rmean.h"
+#include "latency.h"
+#include "clock.h"
 #include "execute.h"
 #include "errinj.h"
 #include "tt_static.h"
@@ -176,6 +178,11 @@ struct iproto_thread {
 		struct cpipe ret_pipe;
 		/** CALL/EVAL route. */
 		struct cmsg_hop call_route[2];
+		/**
+		 * SELECT route. Used only by application threads, which
+		 * serve SELECT requests from a shared read view.
+		 */
+		struct cmsg_hop select_route[2];
 		/** Route used to destroy an IPROTO connection. */
 		struct cmsg_hop destroy_route[2];
 	} *srv;
@@ -192,6 +199,7 @@ struct iproto_thread {
 	struct cmsg_hop auth_route[2];
 	struct cmsg_hop misc_route[2];
 	struct cmsg_hop select_route[2];
+	struct cmsg_hop get_many_route[2];
 	struct cmsg_hop process1_route[2];
 	struct cmsg_hop sql_route[2];
 	struct cmsg_hop join_route[2];
@@ -224,6 +232,16 @@ struct iproto_thread {
 	 * Iproto thread stat
 	 */
 	struct rmean *rmean;
+	/**
+	 * Latency of request processing stages, indexed by
+	 * enum iproto_latency_stage.
+	 */
+	struct latency latency[iproto_latency_stage_MAX];
+	/**
+	 * If set, request latency is also collected for each connection,
+	 * see iproto_connection::latency.
+	 */
+	bool connection_latency;
 	/*
 	 * Iproto thread id
 	 */
@@ -278,6 +296,69 @@ static struct uri_set iproto_uris;
 
 static struct iproto_thread *iproto_threads;
 int iproto_threads_count;
+
+const char *iproto_ev_backend_strs[] = {
+	/* [IPROTO_EV_BACKEND_AUTO] = */ "auto",
+	/* [IPROTO_EV_BACKEND_IO_URING] = */ "io_uring",
+};
+
+static_assert(lengthof(iproto_ev_backend_strs) == iproto_ev_backend_MAX,
+	      "each iproto_ev_backend must have a name");
+
+const char *iproto_latency_stage_strs[] = {
+	/* [IPROTO_LATENCY_INPUT] = */ "INPUT",
+	/* [IPROTO_LATENCY_CBUS] = */ "CBUS",
+	/* [IPROTO_LATENCY_EXEC] = */ "EXEC",
+	/* [IPROTO_LATENCY_OUTPUT] = */ "OUTPUT",
+};
+
+static_assert(lengthof(iproto_latency_stage_strs) == iproto_latency_stage_MAX,
+	      "each iproto_latency_stage must have a name");
+
+/** Event loop backend requested for IPROTO threads. */
+static enum iproto_ev_backend iproto_loop_backend;
+
+int
+iproto_latency_create(struct latency *latency)
+{
+	for (int i = 0; i < iproto_latency_stage_MAX; i++) {
+		if (latency_create(&latency[i]) != 0) {
+			while (--i >= 0)
+				latency_destroy(&latency[i]);
+			diag_set(OutOfMemory, sizeof(struct histogram *),
+				 "malloc", "latency histogram");
+			return -1;
+		}
+	}
+	return 0;
+}
+
+void
+iproto_latency_destroy(struct latency *latency)
+{
+	for (int i = 0; i < iproto_latency_stage_MAX; i++)
+		latency_destroy(&latency[i]);
+}
+
+/** Resets an array created with iproto_latency_create(). */
+static void
+iproto_latency_reset(struct latency *latency)
+{
+	for (int i = 0; i < iproto_latency_stage_MAX; i++)
+		latency_reset(&latency[i]);
+}
+
+/**
+ * Adds observations of array @a src created with iproto_latency_create()
+ * to array @a dst.
+ */
+static void
+iproto_latency_merge(struct latency *dst, const struct latency *src)
+{
+	for (int i = 0; i < iproto_latency_stage_MAX; i++)
+		latency_merge(&dst[i], &src[i]);
+}
+
 /**
  * This binary contains all bind socket properties, like
  * address the iproto listens for. Is kept in TX to be
@@ -400,6 +481,16 @@ enum iproto_cfg_op {
 	 * Command code to reset IPROTO thread statistics.
 	 */
 	IPROTO_CFG_RESET_STAT,
+	/**
+	 * Command code to get request latency statistics of an IPROTO
+	 * thread or connection.
+	 */
+	IPROTO_CFG_LATENCY,
+	/**
+	 * Command code to enable or disable per-connection request latency
+	 * statistics.
+	 */
+	IPROTO_CFG_CONNECTION_LATENCY,
 	/**
 	 * Command code to notify IPROTO threads a new handler has been set or
 	 * reset.
@@ -431,6 +522,26 @@ struct iproto_cfg_msg: public cbus_call_msg
 		struct iproto_stats *stats;
 		/** New iproto max message count. */
 		int iproto_msg_max;
+		struct {
+			/**
+			 * Array of latency counters indexed by
+			 * enum iproto_latency_stage to add statistics to.
+			 */
+			struct latency *latency;
+			/**
+			 * Connection to get statistics of or NULL to get
+			 * statistics of the whole thread.
+			 */
+			struct iproto_connection *connection;
+			/**
+			 * Set by IPROTO thread if the statistics have been
+			 * collected. Not set if the connection doesn't
+			 * collect latency statistics.
+			 */
+			bool is_found;
+		} latency;
+		/** Whether per-connection latency statistics are enabled. */
+		bool connection_latency;
 		struct {
 			/** New connection IO stream. */
 			struct iostream io;
@@ -680,6 +791,21 @@ struct iproto_msg
 	struct rlist in_inprogress;
 	/** Serving thread fiber processing this message. */
 	struct fiber *fiber;
+	/**
+	 * Monotonic timestamps of the request processing stages, used for
+	 * collecting latency statistics (see enum iproto_latency_stage).
+	 * Zero if the request hasn't reached the stage.
+	 */
+	struct {
+		/** Request was read from the socket. */
+		double input;
+		/** Request was sent to the serving thread. */
+		double dispatch;
+		/** Request was accepted by the serving thread. */
+		double accept;
+		/** Request was processed by the serving thread. */
+		double end;
+	} time;
 };
 
 /**
@@ -859,6 +985,13 @@ struct iproto_connection
 		 * iproto_msg::wpos).
 		 */
 		struct iproto_wpos wend;
+		/**
+		 * Time when the oldest reply that hasn't been flushed yet
+		 * was written to the output buffer by the serving thread,
+		 * or 0 if all output has been flushed. Used for collecting
+		 * the IPROTO_LATENCY_OUTPUT statistic.
+		 */
+		double output_time;
 		/**
 		 * List of inprogress messages (see iproto_msg::in_inprogress).
 		 */
@@ -903,6 +1036,14 @@ struct iproto_connection
 	 * meaningless.
 	 */
 	size_t parse_size;
+	/** Time when the last chunk of input was read from the socket. */
+	double input_time;
+	/**
+	 * Latency of request processing stages for this connection,
+	 * indexed by enum iproto_latency_stage. NULL unless enabled
+	 * with iproto_set_connection_latency().
+	 */
+	struct latency *latency;
 	/**
 	 * Nubmer of active long polling requests that have already
 	 * discarded their arguments in order not to stall other
@@ -1101,11 +1242,54 @@ iproto_msg_new(struct iproto_connection *con)
 	msg->srv_id = 0;
 	msg->stream = NULL;
 	msg->fiber = NULL;
+	msg->time.input = con->input_time;
+	msg->time.dispatch = 0;
+	msg->time.accept = 0;
+	msg->time.end = 0;
 	rmean_collect(con->iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	con->request_count++;
 	return msg;
 }
 
+/**
+ * Enables or disables collection of request latency statistics for
+ * the given connection.
+ */
+static void
+iproto_connection_set_latency(struct iproto_connection *con, bool enabled)
+{
+	if (enabled && con->latency == NULL) {
+		con->latency = xalloc_array(struct latency,
+					    iproto_latency_stage_MAX);
+		if (iproto_latency_create(con->latency) != 0) {
+			diag_log();
+			free(con->latency);
+			con->latency = NULL;
+		}
+	} else if (!enabled && con->latency != NULL) {
+		iproto_latency_destroy(con->latency);
+		free(con->latency);
+		con->latency = NULL;
+	}
+}
+
+/**
+ * Collects the latency of a request processing stage that started at
+ * @a begin and ended at @a end. Does nothing if the request skipped
+ * the stage.
+ */
+static inline void
+iproto_connection_collect_latency(struct iproto_connection *con,
+				  enum iproto_latency_stage stage,
+				  double begin, double end)
+{
+	if (begin == 0 || end == 0)
+		return;
+	latency_collect(&con->iproto_thread->latency[stage], end - begin);
+	if (con->latency != NULL)
+		latency_collect(&con->latency[stage], end - begin);
+}
+
 /**
  * Signal input unless it's blocked on I/O or stopped.
  */
@@ -1506,6 +1690,7 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		iproto_msg_prepare(msg, &pos, reqend);
 		if (iproto_msg_start_processing_in_stream(msg)) {
 			msg->wpos = con->srv[msg->srv_id].wpos;
+			msg->time.dispatch = clock_monotonic();
 			cpipe_push(&con->iproto_thread->srv[msg->srv_id].pipe,
 				   &msg->base);
 			n_requests++;
@@ -1649,6 +1834,7 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	/* Update the read position and connection state. */
 	ibuf_alloc(in, nrd);
 	con->parse_size += nrd;
+	con->input_time = clock_monotonic();
 	/* Enqueue all requests which are fully read up. */
 	if (iproto_enqueue_batch(con, in) != 0)
 		goto error;
@@ -1789,6 +1975,13 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 	}
 	if (ev_is_active(&con->output))
 		ev_io_stop(con->loop, &con->output);
+	/* All output has been flushed. */
+	double now = clock_monotonic();
+	for (int i = 0; i < con->iproto_thread->srv_count; i++) {
+		iproto_connection_collect_latency(con, IPROTO_LATENCY_OUTPUT,
+						  con->srv[i].output_time, now);
+		con->srv[i].output_time = 0;
+	}
 	/*
 	 * If the out channel isn't clogged, we can read more requests.
 	 * Note, we trigger input even if we didn't write any responses
@@ -1827,10 +2020,14 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 		iproto_wpos_create(&con->srv[i].wend, con->srv[i].p_obuf);
 		rlist_create(&con->srv[i].inprogress);
 		con->srv[i].runtime_credentials.user_name = NULL;
+		con->srv[i].output_time = 0;
 	}
 	con->flush.srv_id = 0;
 	con->flush.wend = con->srv[0].wend;
 	con->parse_size = 0;
+	con->input_time = 0;
+	con->latency = NULL;
+	iproto_connection_set_latency(con, iproto_thread->connection_latency);
 	con->can_write = true;
 	con->long_poll_count = 0;
 	con->session = NULL;
@@ -1895,6 +2092,7 @@ iproto_connection_delete(struct iproto_connection *con)
 	}
 	assert(mh_size(con->streams) == 0);
 	mh_i64ptr_delete(con->streams);
+	iproto_connection_set_latency(con, false);
 	rlist_del(&con->in_connections);
 	VERIFY(iproto_thread->connection_count-- > 0);
 	if (con->is_drop_pending) {
@@ -1924,6 +2122,9 @@ tx_process1(struct cmsg *msg);
 static void
 tx_process_select(struct cmsg *msg);
 
+static void
+tx_process_get_many(struct cmsg *msg);
+
 static void
 tx_process_sql(struct cmsg *msg);
 
@@ -2011,7 +2212,8 @@ iproto_msg_prepare(struct iproto_msg *msg, const char **pos, const char *reqend)
 		goto error;
 	}
 	if (thread_id != XROW_THREAD_UNSPEC && thread_id != 0 &&
-	    type != IPROTO_CALL && type != IPROTO_EVAL) {
+	    type != IPROTO_CALL && type != IPROTO_EVAL &&
+	    type != IPROTO_SELECT) {
 		diag_set(ClientError, ER_UNABLE_TO_PROCESS_IN_THREAD,
 			 iproto_type_name(type), thread_id);
 		goto error;
@@ -2104,6 +2306,8 @@ iproto_msg_decode(struct iproto_msg *msg, struct cmsg_hop **route)
 		assert(type < sizeof(iproto_thread->dml_route) /
 			      sizeof(*iproto_thread->dml_route));
 		*route = iproto_thread->dml_route[type];
+		if (type == IPROTO_SELECT && msg->srv_id != 0)
+			*route = iproto_thread->srv[msg->srv_id].select_route;
 		if (xrow_decode_dml_iproto(&msg->header, &msg->dml,
 					   dml_request_key_map(type)) != 0)
 			return -1;
@@ -2114,6 +2318,14 @@ iproto_msg_decode(struct iproto_msg *msg, struct cmsg_hop **route)
 		 */
 		msg->dml.header = NULL;
 		return 0;
+	case IPROTO_GET_MANY:
+		*route = iproto_thread->get_many_route;
+		if (xrow_decode_dml_iproto(&msg->header, &msg->dml,
+					   iproto_key_bit(IPROTO_SPACE_ID) |
+					   iproto_key_bit(IPROTO_KEY)) != 0)
+			return -1;
+		msg->dml.header = NULL;
+		return 0;
 	case IPROTO_BEGIN:
 		*route = iproto_thread->begin_route;
 		if (xrow_decode_begin(&msg->header, &msg->begin) != 0)
@@ -2450,6 +2662,7 @@ srv_accept_msg(struct cmsg *m)
 			msg, in_inprogress);
 	assert(msg->fiber == NULL);
 	msg->fiber = fiber();
+	msg->time.accept = clock_monotonic();
 	assert(msg->fiber->storage.runtime_credentials == NULL);
 	msg->fiber->storage.runtime_credentials =
 		&msg->connection->srv[msg->srv_id].runtime_credentials;
@@ -2517,6 +2730,7 @@ srv_end_msg(struct iproto_msg *msg)
 	rlist_del(&msg->in_inprogress);
 	msg->fiber->storage.runtime_credentials = NULL;
 	msg->fiber = NULL;
+	msg->time.end = clock_monotonic();
 }
 
 static inline void
@@ -2857,6 +3071,63 @@ tx_process_select(struct cmsg *m)
 	tx_end_msg(msg, &svp);
 }
 
+static void
+tx_process_get_many(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	bool box_tuple_as_ext =
+		iproto_features_test(&msg->connection->session->meta.features,
+				     IPROTO_FEATURE_DML_TUPLE_EXTENSION);
+	struct obuf *out;
+	struct obuf_svp svp;
+	struct port port;
+
+	struct mp_box_ctx ctx;
+	struct mp_ctx *ctx_ref = NULL;
+	if (box_tuple_as_ext) {
+		mp_box_ctx_create(&ctx, NULL, NULL);
+		ctx_ref = (struct mp_ctx *)&ctx;
+	}
+	auto ctx_guard = make_scoped_guard([ctx_ref] {
+		mp_ctx_destroy(ctx_ref);
+	});
+	ctx_guard.is_active = box_tuple_as_ext;
+
+	int count;
+	struct request *req = &msg->dml;
+	if (tx_check_msg(msg) != 0)
+		goto error;
+
+	tx_inject_delay();
+	if (tx_resolve_space_and_index_name(&msg->dml) != 0)
+		goto error;
+	if (box_index_get_many(req->space_id, req->index_id, req->key,
+			       req->key_end, &port) != 0)
+		goto error;
+
+	out = iproto_msg_obuf(msg);
+	iproto_prepare_select(out, &svp);
+	count = port_dump_msgpack_16_with_ctx(&port, out, ctx_ref);
+	port_destroy(&port);
+	if (count < 0 || (box_tuple_as_ext &&
+			  tuple_format_map_to_iproto_obuf(&ctx.tuple_format_map,
+							  out) != 0)) {
+		/* Discard the prepared select. */
+		obuf_rollback_to_svp(out, &svp);
+		goto error;
+	}
+	iproto_reply_select(out, &svp, msg->header.sync, ::schema_version,
+			    count, box_tuple_as_ext);
+	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg, &svp);
+	return;
+error:
+	out = iproto_msg_obuf(msg);
+	svp = obuf_create_svp(out);
+	tx_reply_error(msg);
+	tx_end_msg(msg, &svp);
+}
+
 static int
 srv_process_call_on_yield(struct trigger *trigger, void *event)
 {
@@ -3048,6 +3319,48 @@ srv_process_call(struct cmsg *m)
 	srv_end_msg(msg);
 }
 
+static int
+srv_process_select_on_yield(struct trigger *trigger, void *event)
+{
+	(void)event;
+	struct iproto_msg *msg = (struct iproto_msg *)trigger->data;
+	TRASH(&msg->dml);
+	srv_discard_input(msg);
+	trigger_clear(trigger);
+	return 0;
+}
+
+/**
+ * Process a SELECT request in a serving thread.
+ */
+static void
+srv_process_select(struct cmsg *m)
+{
+	struct iproto_msg *msg = srv_accept_msg(m);
+	struct obuf *out = iproto_msg_obuf(msg);
+	struct obuf_svp svp;
+	/*
+	 * Waiting for the shared read view may yield, so discard input
+	 * on yield to avoid stalling other requests of the connection.
+	 */
+	struct trigger fiber_on_yield;
+	trigger_create(&fiber_on_yield, srv_process_select_on_yield, msg,
+		       NULL);
+	trigger_add(&fiber()->on_yield, &fiber_on_yield);
+	int count = app_thread_process_select(&msg->dml, out, &svp);
+	trigger_clear(&fiber_on_yield);
+	if (count < 0) {
+		iproto_reply_error(out, diag_last_error(&fiber()->diag),
+				   msg->header.sync, /*schema_version=*/0);
+	} else {
+		iproto_reply_select(out, &svp, msg->header.sync,
+				    /*schema_version=*/0, count,
+				    /*box_tuple_as_ext=*/false);
+	}
+	iproto_wpos_create(&msg->wpos, out);
+	srv_end_msg(msg);
+}
+
 static void
 tx_process_id(struct iproto_connection *con, const struct id_request *id)
 {
@@ -3622,18 +3935,44 @@ iproto_msg_finish_processing_in_stream(struct iproto_msg *msg)
 						     in_stream);
 		assert(stream->current != NULL);
 		stream->current->wpos = con->srv[msg->srv_id].wpos;
+		stream->current->time.dispatch = clock_monotonic();
 		con->iproto_thread->requests_in_stream_queue--;
 		cpipe_push(&con->iproto_thread->srv[msg->srv_id].pipe,
 			   &stream->current->base);
 	}
 }
 
+/** Collects latency statistics of a processed request. */
+static void
+iproto_msg_collect_latency(struct iproto_msg *msg)
+{
+	struct iproto_connection *con = msg->connection;
+	iproto_connection_collect_latency(con, IPROTO_LATENCY_INPUT,
+					  msg->time.input, msg->time.dispatch);
+	iproto_connection_collect_latency(con, IPROTO_LATENCY_CBUS,
+					  msg->time.dispatch, msg->time.accept);
+	iproto_connection_collect_latency(con, IPROTO_LATENCY_EXEC,
+					  msg->time.accept, msg->time.end);
+	/*
+	 * Remember when the oldest reply awaiting flush was written.
+	 * The output latency is collected once it's flushed, see
+	 * iproto_connection_on_output().
+	 */
+	struct iproto_wpos *wend = &con->srv[msg->srv_id].wend;
+	double *output_time = &con->srv[msg->srv_id].output_time;
+	if (*output_time == 0 && msg->time.end != 0 &&
+	    (msg->wpos.obuf != wend->obuf ||
+	     msg->wpos.svp.used != wend->svp.used))
+		*output_time = msg->time.end;
+}
+
 static void
 net_send_msg(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
 	struct iproto_connection *con = msg->connection;
 
+	iproto_msg_collect_latency(msg);
 	iproto_msg_finish_processing_in_stream(msg);
 	if (msg->len != 0) {
 		/* Discard request (see iproto_enqueue_batch()). */
@@ -3892,6 +4231,12 @@ net_cord_f(va_list  ap)
 	mempool_create(&iproto_thread->iproto_stream_pool, &cord()->slabc,
 		       sizeof(struct iproto_stream));
 
+	if (iproto_loop_backend == IPROTO_EV_BACKEND_IO_URING &&
+	    ev_backend(loop()) != EVBACKEND_IOURING) {
+		say_warn("io_uring is not supported by the system, "
+			 "falling back to the default event loop backend");
+	}
+
 	evio_service_create(loop(), &iproto_thread->binary, "binary",
 			    iproto_on_accept_cb, iproto_thread);
 
@@ -4118,6 +4463,8 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->misc_route[1] = {net_send_msg, NULL};
 	iproto_thread->select_route[0] = {tx_process_select, net_pipe};
 	iproto_thread->select_route[1] = {net_send_msg, NULL};
+	iproto_thread->get_many_route[0] = {tx_process_get_many, net_pipe};
+	iproto_thread->get_many_route[1] = {net_send_msg, NULL};
 	iproto_thread->process1_route[0] = {tx_process1, net_pipe};
 	iproto_thread->process1_route[1] = {net_send_msg, NULL};
 	iproto_thread->sql_route[0] = {tx_process_sql, net_pipe};
@@ -4152,6 +4499,10 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 			{srv_process_call, &iproto_thread->srv[i].ret_pipe};
 		iproto_thread->srv[i].call_route[1] =
 			{net_send_msg, NULL};
+		iproto_thread->srv[i].select_route[0] =
+			{srv_process_select, &iproto_thread->srv[i].ret_pipe};
+		iproto_thread->srv[i].select_route[1] =
+			{net_send_msg, NULL};
 	}
 	for (int i = 0; i < iproto_thread->srv_count; i++) {
 		iproto_thread->srv[i].destroy_route[0] =
@@ -4174,6 +4525,9 @@ iproto_thread_init(struct iproto_thread *iproto_thread, int srv_count)
 	/* Init statistics counter */
 	iproto_thread->rmean = rmean_new(rmean_net_strings, RMEAN_NET_LAST);
 	iproto_thread->tx.rmean = rmean_new(rmean_tx_strings, RMEAN_TX_LAST);
+	if (iproto_latency_create(iproto_thread->latency) != 0)
+		panic("failed to allocate IPROTO latency histograms");
+	iproto_thread->connection_latency = false;
 	rlist_create(&iproto_thread->stopped_connections);
 	iproto_thread->tx.requests_in_progress = 0;
 	iproto_thread->requests_in_stream_queue = 0;
@@ -4342,11 +4696,37 @@ trigger_on_change_iproto_notify(struct trigger *trigger, void *arg)
 
 TRIGGER(trigger_on_change, trigger_on_change_iproto_notify);
 
+/**
+ * Returns libev flags for creating an IPROTO thread event loop with
+ * the given backend.
+ */
+static unsigned int
+iproto_ev_flags(enum iproto_ev_backend loop_backend)
+{
+	unsigned int flags = EVFLAG_AUTO | EVFLAG_ALLOCFD;
+	switch (loop_backend) {
+	case IPROTO_EV_BACKEND_AUTO:
+		break;
+	case IPROTO_EV_BACKEND_IO_URING:
+		/*
+		 * libev tries backends from the most preferred one, so if
+		 * io_uring can't be set up, the loop falls back to one of
+		 * the recommended backends (epoll on Linux).
+		 */
+		flags |= EVBACKEND_IOURING | ev_recommended_backends();
+		break;
+	default:
+		unreachable();
+	}
+	return flags;
+}
+
 /** Initialize the iproto subsystem and start network io thread */
 void
-iproto_init(int threads_count)
+iproto_init(int threads_count, enum iproto_ev_backend loop_backend)
 {
 	iproto_threads_count = 0;
+	iproto_loop_backend = loop_backend;
 	struct session_vtab iproto_session_vtab = {
 		/* .push = */ iproto_session_push,
 		/* .fd = */ iproto_session_fd,
@@ -4375,11 +4755,12 @@ iproto_init(int threads_count)
 	tx_req_handlers = mh_i32ptr_new();
 	event_foreach(iproto_override_event_init, NULL);
 
+	unsigned int ev_flags = iproto_ev_flags(loop_backend);
 	for (int i = 0; i < threads_count; i++) {
 		struct iproto_thread *iproto_thread = &iproto_threads[i];
 		struct cpipe *net_pipe = &iproto_thread->srv[0].ret_pipe;
-		if (cord_costart(&iproto_thread->net_cord, "iproto",
-				 net_cord_f, iproto_thread))
+		if (cord_costart_ev(&iproto_thread->net_cord, "iproto",
+				    ev_flags, net_cord_f, iproto_thread))
 			panic("failed to start iproto thread");
 		/* Create a pipe to "net" thread. */
 		char endpoint_name[ENDPOINT_NAME_MAX];
@@ -4479,9 +4860,38 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 	case IPROTO_CFG_STAT:
 		iproto_fill_stat(iproto_thread, cfg_msg);
 		break;
-	case IPROTO_CFG_RESET_STAT:
+	case IPROTO_CFG_RESET_STAT: {
 		rmean_cleanup(iproto_thread->rmean);
+		iproto_latency_reset(iproto_thread->latency);
+		struct iproto_connection *con;
+		rlist_foreach_entry(con, &iproto_thread->connections,
+				    in_connections) {
+			if (con->latency != NULL)
+				iproto_latency_reset(con->latency);
+		}
+		break;
+	}
+	case IPROTO_CFG_LATENCY: {
+		struct iproto_connection *con = cfg_msg->latency.connection;
+		struct latency *src = con != NULL ? con->latency :
+					iproto_thread->latency;
+		if (src != NULL) {
+			iproto_latency_merge(cfg_msg->latency.latency, src);
+			cfg_msg->latency.is_found = true;
+		}
+		break;
+	}
+	case IPROTO_CFG_CONNECTION_LATENCY: {
+		iproto_thread->connection_latency =
+			cfg_msg->connection_latency;
+		struct iproto_connection *con;
+		rlist_foreach_entry(con, &iproto_thread->connections,
+				    in_connections) {
+			iproto_connection_set_latency(
+				con, cfg_msg->connection_latency);
+		}
 		break;
+	}
 	case IPROTO_CFG_OVERRIDE:
 		if (cfg_msg->override.is_set) {
 			uint32_t old;
@@ -4732,6 +5142,44 @@ iproto_thread_stats_get(struct iproto_stats *stats, int thread_id)
 		iproto_threads[thread_id].tx.requests_in_progress;
 }
 
+void
+iproto_latency_get(struct latency *latency)
+{
+	for (int i = 0; i < iproto_threads_count; i++)
+		iproto_thread_latency_get(latency, i);
+}
+
+void
+iproto_thread_latency_get(struct latency *latency, int thread_id)
+{
+	struct iproto_cfg_msg cfg_msg;
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_LATENCY);
+	assert(thread_id >= 0 && thread_id < iproto_threads_count);
+	cfg_msg.latency.latency = latency;
+	iproto_do_cfg(&iproto_threads[thread_id], &cfg_msg);
+}
+
+int
+iproto_session_latency_get(struct session *session, struct latency *latency)
+{
+	if (session->type != SESSION_TYPE_BINARY)
+		return -1;
+	struct iproto_connection *con =
+		(struct iproto_connection *)session->meta.connection;
+	/*
+	 * The connection can't be destroyed while the message is in
+	 * flight, because the connection is freed only after its session
+	 * is deleted by tx and the IPROTO thread gets notified about it
+	 * via the same pipe.
+	 */
+	struct iproto_cfg_msg cfg_msg;
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_LATENCY);
+	cfg_msg.latency.latency = latency;
+	cfg_msg.latency.connection = con;
+	iproto_do_cfg(con->iproto_thread, &cfg_msg);
+	return cfg_msg.latency.is_found ? 0 : -1;
+}
+
 void
 iproto_reset_stat(void)
 {
@@ -4759,6 +5207,16 @@ iproto_set_msg_max(int new_iproto_msg_max)
 	return 0;
 }
 
+void
+iproto_set_connection_latency(bool enabled)
+{
+	struct iproto_cfg_msg cfg_msg;
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_CONNECTION_LATENCY);
+	cfg_msg.connection_latency = enabled;
+	for (int i = 0; i < iproto_threads_count; i++)
+		iproto_do_cfg(&iproto_threads[i], &cfg_msg);
+}
+
 int
 iproto_session_new(struct iostream *io, struct user *user, uint64_t *sid)
 {
@@ -4864,6 +5322,7 @@ iproto_free(void)
 		evio_service_detach(&iproto_threads[i].binary);
 		rmean_delete(iproto_threads[i].rmean);
 		rmean_delete(iproto_threads[i].tx.rmean);
+		iproto_latency_destroy(iproto_threads[i].latency);
 		slab_cache_destroy(&iproto_threads[i].srv[0].net_slabc);
 		free(iproto_threads[i].srv);
 	}
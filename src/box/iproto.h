@@ -36,6 +36,7 @@
 
 #include "box/box.h"
 
+struct latency;
 struct uri_set;
 struct session;
 struct user;
@@ -64,6 +65,48 @@ enum {
 	IPROTO_THREADS_MAX = 1000,
 };
 
+/** Event loop backend used by IPROTO threads. */
+enum iproto_ev_backend {
+	/** Let libev pick the best backend available on the platform. */
+	IPROTO_EV_BACKEND_AUTO,
+	/**
+	 * Linux io_uring. Socket readiness polls are submitted to the ring
+	 * in batches instead of issuing a syscall per watcher change. Falls
+	 * back to the default backend if the kernel doesn't support it.
+	 */
+	IPROTO_EV_BACKEND_IO_URING,
+	iproto_ev_backend_MAX,
+};
+
+/** String names of enum iproto_ev_backend members. */
+extern const char *iproto_ev_backend_strs[];
+
+/**
+ * Stages of IPROTO request processing, the latency of which is tracked
+ * separately by IPROTO threads.
+ */
+enum iproto_latency_stage {
+	/**
+	 * From the moment a request is read from the socket till it's
+	 * dispatched to a serving thread. Includes the time the request
+	 * waits for net_msg_max or in a stream queue.
+	 */
+	IPROTO_LATENCY_INPUT,
+	/** Transit of a request over cbus to a serving thread. */
+	IPROTO_LATENCY_CBUS,
+	/** Processing of a request in a serving thread. */
+	IPROTO_LATENCY_EXEC,
+	/**
+	 * From the moment a reply is written to the output buffer by
+	 * a serving thread till the output buffer is flushed to the socket.
+	 */
+	IPROTO_LATENCY_OUTPUT,
+	iproto_latency_stage_MAX,
+};
+
+/** String names of enum iproto_latency_stage members. */
+extern const char *iproto_latency_stage_strs[];
+
 struct iproto_stats {
 	/** Size of memory used for storing network buffers. */
 	size_t mem_used;
@@ -95,6 +138,40 @@ iproto_stats_get(struct iproto_stats *stats);
 void
 iproto_thread_stats_get(struct iproto_stats *stats, int thread_id);
 
+/**
+ * Creates an array of latency counters for all IPROTO request
+ * processing stages, see enum iproto_latency_stage.
+ * Returns -1 and sets diag on OOM.
+ */
+int
+iproto_latency_create(struct latency *latency);
+
+/** Destroys an array created with iproto_latency_create(). */
+void
+iproto_latency_destroy(struct latency *latency);
+
+/**
+ * Adds request latency observations collected by all IPROTO threads to
+ * the given array of latency counters indexed by iproto_latency_stage.
+ */
+void
+iproto_latency_get(struct latency *latency);
+
+/**
+ * Same as iproto_latency_get(), but only for the thread with the given id.
+ */
+void
+iproto_thread_latency_get(struct latency *latency, int thread_id);
+
+/**
+ * Same as iproto_latency_get(), but only for the connection of the given
+ * IPROTO session. Returns -1 if the session doesn't have a connection or
+ * per-connection latency statistics are disabled (see
+ * iproto_set_connection_latency()), otherwise returns 0.
+ */
+int
+iproto_session_latency_get(struct session *session, struct latency *latency);
+
 /**
  * Reset network statistics.
  */
@@ -153,8 +230,12 @@ iproto_enable_thread_requests(void);
 void
 iproto_register_func(const char *name);
 
+/**
+ * Initializes the IPROTO subsystem and starts @a threads_count network
+ * threads, each running an event loop with the given backend.
+ */
 void
-iproto_init(int threads_count);
+iproto_init(int threads_count, enum iproto_ev_backend ev_backend);
 
 int
 iproto_listen(const struct uri_set *uri_set);
@@ -162,6 +243,13 @@ iproto_listen(const struct uri_set *uri_set);
 int
 iproto_set_msg_max(int iproto_msg_max);
 
+/**
+ * Enables or disables collection of request latency statistics for each
+ * IPROTO connection. Disabling discards the statistics collected so far.
+ */
+void
+iproto_set_connection_latency(bool enabled);
+
 /**
  * Creates a new IPROTO session over the given IO stream. Doesn't yield.
  * Set the output parameter sid to the sid of newly created session.
@@ -131,6 +131,13 @@ const char *vy_row_index_key_strs[vy_row_index_key_MAX] = {
 	VY_ROW_INDEX_KEYS(VY_ROW_INDEX_KEY_STRS_MEMBER)
 };
 
+#define VY_RUN_BLOOM_KEY_STRS_MEMBER(s, ...) \
+	[VY_RUN_BLOOM_ ## s] = #s,
+
+const char *vy_run_bloom_key_strs[vy_run_bloom_key_MAX] = {
+	VY_RUN_BLOOM_KEYS(VY_RUN_BLOOM_KEY_STRS_MEMBER)
+};
+
 __attribute__((constructor))
 static void
 iproto_constants_init(void)
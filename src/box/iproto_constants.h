@@ -363,6 +363,12 @@ iproto_key_bit(unsigned char key)
 	_(ROLLBACK, 16)							\
 	/** INSERT Arrow request. */					\
 	_(INSERT_ARROW, 17)						\
+	/**
+	 * Look up a batch of keys in a unique index. IPROTO_KEY is
+	 * an array of keys, the reply IPROTO_DATA contains a tuple
+	 * or nil per key, in the order of the keys.
+	 */								\
+	_(GET_MANY, 18)							\
 									\
 	_(RAFT, 30)							\
 	/** PROMOTE request. */						\
@@ -423,11 +429,12 @@ iproto_key_bit(unsigned char key)
 	_(WATCH_ONCE, 77)						\
 									\
 	/**
-	 * The following three requests are reserved for vinyl types.
+	 * The following four requests are reserved for vinyl types.
 	 *
 	 * VY_INDEX_RUN_INFO = 100
 	 * VY_INDEX_PAGE_INFO = 101
 	 * VY_RUN_ROW_INDEX = 102
+	 * VY_RUN_BLOOM = 103
 	 */								\
 									\
 	/** Non-final response type. */					\
@@ -454,6 +461,8 @@ enum iproto_type {
 	VY_INDEX_PAGE_INFO = 101,
 	/** Vinyl row index stored in .run file */
 	VY_RUN_ROW_INDEX = 102,
+	/** Vinyl bloom filter partition stored in .run file */
+	VY_RUN_BLOOM = 103,
 };
 
 /** IPROTO type name by code */
@@ -497,6 +506,8 @@ iproto_type_name(uint16_t type)
 		return "PAGEINFO";
 	case VY_RUN_ROW_INDEX:
 		return "ROWINDEX";
+	case VY_RUN_BLOOM:
+		return "BLOOM";
 	default:
 		return NULL;
 	}
@@ -630,6 +641,10 @@ request_replace_body_create(struct request_replace_body *body,
 	_(STMT_STAT, 8)							\
 	/** Bloom filter for keys. */					\
 	_(BLOOM_FILTER, 9)						\
+	/** Index of bloom filter partitions stored in the run file. */	\
+	_(BLOOM_FILTER_PARTITIONS, 10)					\
+	/** Binary fuse filter for keys. */				\
+	_(BLOOM_FILTER_BINARY_FUSE, 11)					\
 
 #define VY_RUN_INFO_KEY_MEMBER(s, v) VY_RUN_INFO_ ## s = v,
 
@@ -717,6 +732,36 @@ vy_row_index_key_name(enum vy_row_index_key key)
 	return vy_row_index_key_strs[key];
 }
 
+/**
+ * Xrow keys for Vinyl bloom filter partition.
+ * @sa struct vy_bloom_partition.
+ */
+#define VY_RUN_BLOOM_KEYS(_)						\
+	/** Bloom filter for keys of the partition pages. */		\
+	_(FILTER, 1)							\
+	/** Binary fuse filter for keys of the partition pages. */	\
+	_(FILTER_BINARY_FUSE, 2)					\
+
+#define VY_RUN_BLOOM_KEY_MEMBER(s, v) VY_RUN_BLOOM_ ## s = v,
+
+enum vy_run_bloom_key {
+	VY_RUN_BLOOM_KEYS(VY_RUN_BLOOM_KEY_MEMBER)
+	vy_run_bloom_key_MAX
+};
+
+/**
+ * Return vy_bloom_partition key name by @a key code.
+ * @param key key
+ */
+static inline const char *
+vy_run_bloom_key_name(enum vy_run_bloom_key key)
+{
+	if (key <= 0 || key >= vy_run_bloom_key_MAX)
+		return NULL;
+	extern const char *vy_run_bloom_key_strs[];
+	return vy_run_bloom_key_strs[key];
+}
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif
@@ -177,6 +177,14 @@ lbox_cfg_set_checkpoint_wal_threshold(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_app_threads_read_view_staleness(struct lua_State *L)
+{
+	if (box_set_app_threads_read_view_staleness() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_wal_queue_max_size(struct lua_State *L)
 {
@@ -185,6 +193,30 @@ lbox_cfg_set_wal_queue_max_size(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_wal_group_commit_max_delay(struct lua_State *L)
+{
+	if (box_set_wal_group_commit_max_delay() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_wal_group_commit_max_size(struct lua_State *L)
+{
+	if (box_set_wal_group_commit_max_size() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_wal_spare_files(struct lua_State *L)
+{
+	if (box_set_wal_spare_files() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_replication_synchro_queue_max_size(struct lua_State *L)
 {
@@ -235,6 +267,33 @@ lbox_cfg_set_memtx_use_sort_data(struct lua_State *L)
 	return 0;
 }
 
+/** box.cfg.memtx_defrag_rate. */
+static int
+lbox_cfg_set_memtx_defrag_rate(struct lua_State *L)
+{
+	if (box_set_memtx_defrag_rate() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+/** box.cfg.memtx_defrag_threshold. */
+static int
+lbox_cfg_set_memtx_defrag_threshold(struct lua_State *L)
+{
+	if (box_set_memtx_defrag_threshold() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+/** box.cfg.memtx_checkpoint_delta_count. */
+static int
+lbox_cfg_set_memtx_checkpoint_delta_count(struct lua_State *L)
+{
+	if (box_set_memtx_checkpoint_delta_count() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_memtx_max_tuple_size(struct lua_State *L)
 {
@@ -279,6 +338,28 @@ lbox_cfg_set_vinyl_cache(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_vinyl_page_cache(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_page_cache();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_bloom_partition_cache(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_bloom_partition_cache();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_vinyl_timeout(struct lua_State *L)
 {
@@ -309,6 +390,14 @@ lbox_cfg_set_net_msg_max(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_iproto_connection_latency(struct lua_State *L)
+{
+	(void)L;
+	box_set_iproto_connection_latency();
+	return 0;
+}
+
 static int
 lbox_set_prepared_stmt_cache_size(struct lua_State *L)
 {
@@ -568,11 +657,18 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_readahead", lbox_cfg_set_readahead},
 		{"cfg_set_io_collect_interval", lbox_cfg_set_io_collect_interval},
 		{"cfg_set_too_long_threshold", lbox_cfg_set_too_long_threshold},
+		{"cfg_set_app_threads_read_view_staleness",
+		 lbox_cfg_set_app_threads_read_view_staleness},
 		{"cfg_set_snap_io_rate_limit", lbox_cfg_set_snap_io_rate_limit},
 		{"cfg_set_checkpoint_count", lbox_cfg_set_checkpoint_count},
 		{"cfg_set_checkpoint_interval", lbox_cfg_set_checkpoint_interval},
 		{"cfg_set_checkpoint_wal_threshold", lbox_cfg_set_checkpoint_wal_threshold},
 		{"cfg_set_wal_queue_max_size", lbox_cfg_set_wal_queue_max_size},
+		{"cfg_set_wal_group_commit_max_delay",
+		 lbox_cfg_set_wal_group_commit_max_delay},
+		{"cfg_set_wal_group_commit_max_size",
+		 lbox_cfg_set_wal_group_commit_max_size},
+		{"cfg_set_wal_spare_files", lbox_cfg_set_wal_spare_files},
 		{"cfg_set_replication_synchro_queue_max_size", lbox_cfg_set_replication_synchro_queue_max_size},
 		{"cfg_set_wal_cleanup_delay", lbox_cfg_set_wal_cleanup_delay},
 		{"cfg_set_read_only", lbox_cfg_set_read_only},
@@ -580,9 +676,17 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_memtx_use_sort_data",
 		 lbox_cfg_set_memtx_use_sort_data},
 		{"cfg_set_memtx_max_tuple_size", lbox_cfg_set_memtx_max_tuple_size},
+		{"cfg_set_memtx_defrag_rate", lbox_cfg_set_memtx_defrag_rate},
+		{"cfg_set_memtx_defrag_threshold",
+		 lbox_cfg_set_memtx_defrag_threshold},
+		{"cfg_set_memtx_checkpoint_delta_count",
+		 lbox_cfg_set_memtx_checkpoint_delta_count},
 		{"cfg_set_vinyl_memory", lbox_cfg_set_vinyl_memory},
 		{"cfg_set_vinyl_max_tuple_size", lbox_cfg_set_vinyl_max_tuple_size},
 		{"cfg_set_vinyl_cache", lbox_cfg_set_vinyl_cache},
+		{"cfg_set_vinyl_page_cache", lbox_cfg_set_vinyl_page_cache},
+		{"cfg_set_vinyl_bloom_partition_cache",
+		 lbox_cfg_set_vinyl_bloom_partition_cache},
 		{"cfg_set_vinyl_timeout", lbox_cfg_set_vinyl_timeout},
 		{"cfg_set_force_recovery", lbox_cfg_set_force_recovery},
 		{"cfg_set_election_mode", lbox_cfg_set_election_mode},
@@ -604,6 +708,8 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_instance_name", lbox_cfg_set_instance_name},
 		{"cfg_set_cluster_name", lbox_cfg_set_cluster_name},
 		{"cfg_set_net_msg_max", lbox_cfg_set_net_msg_max},
+		{"cfg_set_iproto_connection_latency",
+		 lbox_cfg_set_iproto_connection_latency},
 		{"cfg_set_sql_cache_size", lbox_set_prepared_stmt_cache_size},
 		{"cfg_set_feedback", lbox_cfg_set_feedback},
 		{"cfg_set_txn_timeout", lbox_cfg_set_txn_timeout},
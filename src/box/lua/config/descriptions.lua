@@ -1675,6 +1675,26 @@ I['iproto.advertise.sharding.uri'] = format_text([[
 
 -- }}} iproto.advertise configuration
 
+I['iproto.connection_latency'] = format_text([[
+    Whether to collect request latency statistics for each client
+    connection in addition to the statistics collected for each network
+    thread. The statistics of a connection are reported by
+    `box.stat.net.connection(<session id>)`. Disabling the option discards
+    the statistics collected so far.
+]])
+
+I['iproto.ev_backend'] = format_text([[
+    The event loop backend used by network threads.
+
+    - `auto`: let the event library choose the best backend available on
+      the platform (epoll on Linux, kqueue on BSD and macOS).
+    - `io_uring`: use Linux io_uring. Socket readiness polls of all
+      connections served by a network thread are submitted to the ring in
+      batches, which reduces the number of syscalls under a high request
+      rate. If the kernel doesn't support io_uring, the default backend is
+      used and a warning is logged.
+]])
+
 I['iproto.listen'] = format_text([[
     An array of URIs used to listen for incoming requests. If required,
     you can enable SSL for specific URIs by providing additional parameters
@@ -2037,6 +2057,30 @@ I['memtx.allocator'] = format_text([[
       switch to `system` in such cases.
 ]])
 
+I['memtx.checkpoint_delta_count'] = format_text([[
+    The maximum number of incremental snapshots written after a full one.
+    An incremental snapshot contains system spaces in full, but only the
+    tuples of user spaces changed since the previous checkpoint. It can only
+    be recovered together with all the snapshots it's based on, which are
+    kept by the garbage collector and included into backups. Any DDL
+    operation on a user space makes the next snapshot full. 0 disables
+    incremental snapshots.
+]])
+
+I['memtx.defrag_rate'] = format_text([[
+    The maximum number of tuples per second scanned by the background memtx
+    defragmenter. The defragmenter moves tuples to lower addresses of their
+    slab class so that sparsely used slabs get released. It only works with
+    the `small` allocator and pauses while a snapshot, a read view, or a DDL
+    operation is in progress. 0 disables the defragmenter.
+]])
+
+I['memtx.defrag_threshold'] = format_text([[
+    The fraction of the tuple slab memory that must be unused for the memtx
+    defragmenter to run. The current value is reported as
+    `box.stat.memtx().defrag.fragmentation`.
+]])
+
 I['memtx.max_tuple_size'] = format_text([[
     Size of the largest allocation unit for the memtx storage engine in bytes.
     It can be increased if it is necessary to store large tuples.
@@ -2050,6 +2094,38 @@ I['memtx.memory'] = format_text([[
     indexes and connection information.
 ]])
 
+I['memtx.memory_huge_pages'] = format_text([[
+    The kind of pages backing the memory allocated for tuples (`memtx.memory`).
+    Huge pages reduce TLB misses on index traversals in large instances.
+
+    - `none`: regular pages.
+    - `transparent`: regular pages that the kernel is advised to merge into
+      transparent huge pages.
+    - `2M`, `1G`: explicit huge pages of the given size reserved in the
+      system huge page pool (`vm.nr_hugepages`). If the pool doesn't have
+      enough free pages, `transparent` is used and a warning is logged.
+
+    Memory added by increasing `memtx.memory` at runtime uses regular pages.
+]])
+
+I['memtx.memory_numa'] = format_text([[
+    The NUMA memory policy for the memory allocated for tuples.
+
+    - `default`: the default policy of the process.
+    - `interleave`: spread the pages across the `memtx.memory_numa_nodes`
+      NUMA nodes round-robin.
+    - `bind`: allocate the pages only from the `memtx.memory_numa_nodes`
+      NUMA nodes.
+
+    If the system has no NUMA support, the option is ignored and a warning
+    is logged.
+]])
+
+I['memtx.memory_numa_nodes'] = format_text([[
+    An array of NUMA node numbers used by the `memtx.memory_numa` policy.
+    If not set, all the nodes the process is allowed to use are used.
+]])
+
 I['memtx.min_tuple_size'] = format_text([[
     Size of the smallest allocation unit in bytes. It can be decreased if
     most of the tuples are very small.
@@ -2908,6 +2984,13 @@ I['vinyl.bloom_fpr'] = format_text([[
     `space_object:create_index()`.
 ]])
 
+I['vinyl.bloom_partition_cache'] = format_text([[
+    The max size of bloom filter partitions loaded on demand for vinyl
+    indexes with the `bloom_partition_pages` option set, in bytes. Least
+    recently used partitions are unloaded when the limit is exceeded. The
+    limit can be changed dynamically.
+]])
+
 I['vinyl.cache'] = format_text([[
     The cache size for the vinyl storage engine. The cache can
     be resized dynamically.
@@ -2934,6 +3017,12 @@ I['vinyl.memory'] = format_text([[
     The maximum number of in-memory bytes that vinyl uses.
 ]])
 
+I['vinyl.page_cache'] = format_text([[
+    The size of the cache of decompressed pages read from vinyl run
+    files, in bytes. Zero disables the cache. The cache can be resized
+    dynamically.
+]])
+
 I['vinyl.page_size'] = format_text([[
     The page size. A page is a read/write unit for vinyl disk operations.
     The `vinyl.page_size` setting is a default value for the page_size option
@@ -3084,6 +3173,19 @@ I['wal.ext.spaces.*.new'] = I['wal.ext.new']
 
 I['wal.ext.spaces.*.old'] = I['wal.ext.old']
 
+I['wal.group_commit_max_delay'] = format_text([[
+    The maximum time in seconds a write may wait in the `fsync` WAL mode so
+    that it is synced to disk together with the writes that follow it. The
+    actual delay adapts to the observed disk sync time and never exceeds it.
+    Zero disables group commit: every write is synced as soon as it is done.
+]])
+
+I['wal.group_commit_max_size'] = format_text([[
+    The amount of data in bytes written to the write-ahead log since the last
+    sync that makes the WAL thread sync it without waiting for
+    `wal.group_commit_max_delay` to expire.
+]])
+
 I['wal.max_size'] = format_text([[
     The maximum number of bytes in a single write-ahead log file. When a
     request would cause an `.xlog` file to become larger than `wal.max_size`,
@@ -3132,6 +3234,13 @@ I['wal.retention_period'] = format_text([[
     which may lead to the removal of the required write-ahead logs.
 ]])
 
+I['wal.spare_files'] = format_text([[
+    The number of empty write-ahead log files with preallocated disk space
+    kept in the WAL directory. When the current WAL file is rotated, a spare
+    file is taken over instead of creating a new file and extending it as
+    data is written. Spare files are created in the background.
+]])
+
 -- }}} wal configuration
 
 -- {{{ threads configuration
@@ -854,11 +854,24 @@ return schema.new('instance_config', schema.record({
             box_cfg_nondynamic = true,
             default = 1,
         }),
+        ev_backend = schema.enum({
+            'auto',
+            'io_uring',
+        }, {
+            box_cfg = 'iproto_ev_backend',
+            box_cfg_nondynamic = true,
+            default = 'auto',
+        }),
         net_msg_max = schema.scalar({
             type = 'integer',
             box_cfg = 'net_msg_max',
             default = 768,
         }),
+        connection_latency = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'iproto_connection_latency',
+            default = false,
+        }),
         readahead = schema.scalar({
             type = 'integer',
             box_cfg = 'readahead',
@@ -958,6 +971,33 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'memtx_memory',
             default = 256 * 1024 * 1024,
         }),
+        memory_huge_pages = schema.enum({
+            'none',
+            'transparent',
+            '2M',
+            '1G',
+        }, {
+            box_cfg = 'memtx_memory_huge_pages',
+            box_cfg_nondynamic = true,
+            default = 'none',
+        }),
+        memory_numa = schema.enum({
+            'default',
+            'interleave',
+            'bind',
+        }, {
+            box_cfg = 'memtx_memory_numa',
+            box_cfg_nondynamic = true,
+            default = 'default',
+        }),
+        memory_numa_nodes = schema.array({
+            items = schema.scalar({
+                type = 'integer',
+            }),
+            box_cfg = 'memtx_memory_numa_nodes',
+            box_cfg_nondynamic = true,
+            default = box.NULL,
+        }),
         allocator = schema.enum({
             'small',
             'system',
@@ -1000,6 +1040,21 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'memtx_use_sort_data',
             default = false,
         }),
+        defrag_rate = schema.scalar({
+            type = 'number',
+            box_cfg = 'memtx_defrag_rate',
+            default = 0,
+        }),
+        defrag_threshold = schema.scalar({
+            type = 'number',
+            box_cfg = 'memtx_defrag_threshold',
+            default = 0.3,
+        }),
+        checkpoint_delta_count = schema.scalar({
+            type = 'integer',
+            box_cfg = 'memtx_checkpoint_delta_count',
+            default = 0,
+        }),
     }),
     vinyl = schema.record({
         bloom_fpr = schema.scalar({
@@ -1008,6 +1063,11 @@ return schema.new('instance_config', schema.record({
             box_cfg_nondynamic = true,
             default = 0.05,
         }),
+        bloom_partition_cache = schema.scalar({
+            type = 'integer',
+            box_cfg = 'vinyl_bloom_partition_cache',
+            default = 128 * 1024 * 1024,
+        }),
         cache = schema.scalar({
             type = 'integer',
             box_cfg = 'vinyl_cache',
@@ -1035,6 +1095,11 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'vinyl_memory',
             default = 128 * 1024 * 1024,
         }),
+        page_cache = schema.scalar({
+            type = 'integer',
+            box_cfg = 'vinyl_page_cache',
+            default = 0,
+        }),
         page_size = schema.scalar({
             type = 'integer',
             box_cfg = 'vinyl_page_size',
@@ -1129,6 +1194,21 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'wal_queue_max_size',
             default = 16 * 1024 * 1024,
         }),
+        group_commit_max_delay = schema.scalar({
+            type = 'number',
+            box_cfg = 'wal_group_commit_max_delay',
+            default = 0,
+        }),
+        group_commit_max_size = schema.scalar({
+            type = 'integer',
+            box_cfg = 'wal_group_commit_max_size',
+            default = 1024 * 1024,
+        }),
+        spare_files = schema.scalar({
+            type = 'integer',
+            box_cfg = 'wal_spare_files',
+            default = 0,
+        }),
         cleanup_delay = schema.scalar({
             type = 'number',
             box_cfg = 'wal_cleanup_delay',
@@ -99,8 +99,13 @@ local default_cfg = {
     slab_alloc_granularity = 8,
     slab_alloc_factor   = 1.05,
     app_threads         = 0,
+    app_threads_read_view_staleness = 0,
     iproto_threads      = 1,
+    iproto_ev_backend   = 'auto',
     memtx_allocator     = "small",
+    memtx_memory_huge_pages = 'none',
+    memtx_memory_numa   = 'default',
+    memtx_memory_numa_nodes = nil,
     work_dir            = nil,
     memtx_dir           = ".",
     wal_dir             = ".",
@@ -108,6 +113,8 @@ local default_cfg = {
     vinyl_dir           = '.',
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
+    vinyl_page_cache    = 0,
+    vinyl_bloom_partition_cache = 128 * 1024 * 1024,
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
@@ -167,6 +174,9 @@ local default_cfg = {
     wal_max_size        = 256 * 1024 * 1024,
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
+    wal_group_commit_max_delay = 0,
+    wal_group_commit_max_size = 1024 * 1024,
+    wal_spare_files     = 0,
     wal_cleanup_delay   = nil,
     wal_retention_period = ifdef_wal_retention_period(0),
     wal_ext             = ifdef_wal_ext(nil),
@@ -216,12 +226,16 @@ local default_cfg = {
     feedback_metrics_collect_interval = ifdef_feedback(60),
     feedback_metrics_limit = ifdef_feedback(1024 * 1024),
     net_msg_max           = 768,
+    iproto_connection_latency = false,
     sql_cache_size        = 5 * 1024 * 1024,
     txn_timeout           = 365 * 100 * 86400,
     txn_synchro_timeout   = 5,
     txn_isolation         = "best-effort",
     memtx_sort_threads    = nil,
     memtx_use_sort_data   = false,
+    memtx_defrag_rate     = 0,
+    memtx_defrag_threshold = 0.3,
+    memtx_checkpoint_delta_count = 0,
 
     metrics     = {
         include = 'all',
@@ -311,14 +325,21 @@ local template_cfg = {
     slab_alloc_granularity = 'number',
     slab_alloc_factor   = 'number',
     app_threads         = 'number',
+    app_threads_read_view_staleness = 'number',
     iproto_threads      = 'number',
+    iproto_ev_backend   = 'string',
     memtx_allocator     = 'string',
+    memtx_memory_huge_pages = 'string',
+    memtx_memory_numa   = 'string',
+    memtx_memory_numa_nodes = 'number, table',
     work_dir            = 'string',
     memtx_dir            = 'string',
     wal_dir             = 'string',
     vinyl_dir           = 'string',
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
+    vinyl_page_cache          = 'number',
+    vinyl_bloom_partition_cache = 'number',
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
@@ -395,6 +416,9 @@ local template_cfg = {
     checkpoint_interval = 'number',
     checkpoint_wal_threshold = 'number',
     wal_queue_max_size  = 'number',
+    wal_group_commit_max_delay = 'number',
+    wal_group_commit_max_size = 'number',
+    wal_spare_files     = 'number',
     checkpoint_count    = 'number',
     read_only           = 'boolean',
     hot_standby         = 'boolean',
@@ -428,11 +452,15 @@ local template_cfg = {
     feedback_metrics_collect_interval = ifdef_feedback('number'),
     feedback_metrics_limit = ifdef_feedback('number'),
     net_msg_max           = 'number',
+    iproto_connection_latency = 'boolean',
     sql_cache_size        = 'number',
     txn_timeout           = 'number',
     txn_synchro_timeout   = 'number',
     memtx_sort_threads    = 'number',
     memtx_use_sort_data   = 'boolean',
+    memtx_defrag_rate     = 'number',
+    memtx_defrag_threshold = 'number',
+    memtx_checkpoint_delta_count = 'number',
 
     metrics = 'table',
 }
@@ -534,14 +562,22 @@ local dynamic_cfg = {
     io_collect_interval     = private.cfg_set_io_collect_interval,
     readahead               = private.cfg_set_readahead,
     too_long_threshold      = private.cfg_set_too_long_threshold,
+    app_threads_read_view_staleness =
+        private.cfg_set_app_threads_read_view_staleness,
     snap_io_rate_limit      = private.cfg_set_snap_io_rate_limit,
     read_only               = private.cfg_set_read_only,
     memtx_memory            = private.cfg_set_memtx_memory,
     memtx_use_sort_data     = private.cfg_set_memtx_use_sort_data,
     memtx_max_tuple_size    = private.cfg_set_memtx_max_tuple_size,
+    memtx_defrag_rate       = private.cfg_set_memtx_defrag_rate,
+    memtx_defrag_threshold  = private.cfg_set_memtx_defrag_threshold,
+    memtx_checkpoint_delta_count = private.cfg_set_memtx_checkpoint_delta_count,
     vinyl_memory            = private.cfg_set_vinyl_memory,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
+    vinyl_bloom_partition_cache =
+        private.cfg_set_vinyl_bloom_partition_cache,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
     vinyl_defer_deletes     = nop,
     quiver_memory           = private.cfg_set_quiver_memory,
@@ -550,6 +586,9 @@ local dynamic_cfg = {
     checkpoint_interval     = private.cfg_set_checkpoint_interval,
     checkpoint_wal_threshold = private.cfg_set_checkpoint_wal_threshold,
     wal_queue_max_size      = private.cfg_set_wal_queue_max_size,
+    wal_group_commit_max_delay = private.cfg_set_wal_group_commit_max_delay,
+    wal_group_commit_max_size = private.cfg_set_wal_group_commit_max_size,
+    wal_spare_files         = private.cfg_set_wal_spare_files,
     worker_pool_threads     = private.cfg_set_worker_pool_threads,
     -- do nothing, affects new replicas, which query this value on start
     wal_dir_rescan_delay    = nop,
@@ -593,6 +632,7 @@ local dynamic_cfg = {
     replicaset_name         = private.cfg_set_replicaset_name,
     cluster_name            = private.cfg_set_cluster_name,
     net_msg_max             = private.cfg_set_net_msg_max,
+    iproto_connection_latency = private.cfg_set_iproto_connection_latency,
     sql_cache_size          = private.cfg_set_sql_cache_size,
     txn_timeout             = private.cfg_set_txn_timeout,
     txn_synchro_timeout     = private.cfg_set_txn_synchro_timeout,
@@ -738,13 +778,19 @@ local dynamic_cfg_skip_at_load = {
     memtx_memory            = true,
     memtx_use_sort_data     = true,
     memtx_max_tuple_size    = true,
+    memtx_defrag_rate       = true,
+    memtx_defrag_threshold  = true,
+    memtx_checkpoint_delta_count = true,
     vinyl_memory            = true,
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
+    vinyl_page_cache        = true,
+    vinyl_bloom_partition_cache = true,
     vinyl_timeout           = true,
     quiver_memory           = ifdef_quiver(true),
     quiver_run_size         = ifdef_quiver(true),
     too_long_threshold      = true,
+    app_threads_read_view_staleness = true,
     election_mode           = true,
     election_timeout        = true,
     election_fencing_mode   = true,
@@ -774,6 +820,7 @@ local dynamic_cfg_skip_at_load = {
     replicaset_name         = true,
     cluster_name            = true,
     net_msg_max             = true,
+    iproto_connection_latency = true,
     readahead               = true,
     auth_type               = true,
     auth_delay              = ifdef_security(true),
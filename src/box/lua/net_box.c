@@ -105,6 +105,7 @@ static struct iproto_features NETBOX_IPROTO_FEATURES;
 	_(PREPARE)							\
 	_(UNPREPARE)							\
 	_(GET)								\
+	_(GET_MANY)							\
 	_(MIN)								\
 	_(MAX)								\
 	_(COUNT)							\
@@ -990,6 +991,38 @@ netbox_encode_select(lua_State *L, int idx,
 	return 0;
 }
 
+/* Encode get_many request. */
+static int
+netbox_encode_get_many(lua_State *L, int idx,
+		       struct netbox_method_encode_ctx *ctx)
+{
+	/* Lua stack at idx: space_id, index_id, keys */
+	size_t svp = netbox_begin_encode(ctx->stream, ctx->sync,
+					 IPROTO_GET_MANY, ctx->thread_id,
+					 ctx->stream_id);
+
+	mpstream_encode_map(ctx->stream, 3);
+
+	netbox_encode_space_id_or_name(L, idx, ctx->stream);
+
+	netbox_encode_index_id_or_name(L, idx + 1, ctx->stream);
+
+	/* encode keys */
+	mpstream_encode_uint(ctx->stream, IPROTO_KEY);
+	uint32_t count = lua_objlen(L, idx + 2);
+	mpstream_encode_array(ctx->stream, count);
+	for (uint32_t i = 1; i <= count; i++) {
+		lua_rawgeti(L, idx + 2, i);
+		int rc = luamp_convert_key(L, cfg, ctx->stream, lua_gettop(L));
+		lua_pop(L, 1);
+		if (rc != 0)
+			return -1;
+	}
+
+	netbox_end_encode(ctx->stream, svp);
+	return 0;
+}
+
 static int
 netbox_encode_insert_or_replace(lua_State *L, int idx, struct mpstream *stream,
 				uint64_t sync, enum iproto_type type,
@@ -1528,6 +1561,7 @@ netbox_encode_method(struct lua_State *L, int idx, enum netbox_method method,
 		[NETBOX_PREPARE]	= netbox_encode_prepare,
 		[NETBOX_UNPREPARE]	= netbox_encode_unprepare,
 		[NETBOX_GET]		= netbox_encode_select,
+		[NETBOX_GET_MANY]	= netbox_encode_get_many,
 		[NETBOX_MIN]		= netbox_encode_select,
 		[NETBOX_MAX]		= netbox_encode_select,
 		[NETBOX_COUNT]		= netbox_encode_call,
@@ -1706,6 +1740,11 @@ netbox_decode_data(struct lua_State *L, const char **data,
 	uint32_t count = mp_decode_array(data);
 	lua_createtable(L, count, 0);
 	for (uint32_t j = 0; j < count; ++j) {
+		/* IPROTO_GET_MANY replies with nil for missing tuples. */
+		if (mp_typeof(**data) == MP_NIL) {
+			mp_next(data);
+			continue;
+		}
 		const char *begin = *data;
 		mp_next(data);
 		struct tuple *tuple;
@@ -2074,6 +2113,7 @@ netbox_decode_method(struct lua_State *L, enum netbox_method method,
 		[NETBOX_PREPARE]	= netbox_decode_prepare,
 		[NETBOX_UNPREPARE]	= netbox_decode_nil,
 		[NETBOX_GET]		= netbox_decode_tuple,
+		[NETBOX_GET_MANY]	= netbox_decode_select,
 		[NETBOX_MIN]		= netbox_decode_tuple,
 		[NETBOX_MAX]		= netbox_decode_tuple,
 		[NETBOX_COUNT]		= netbox_decode_count,
@@ -3316,6 +3356,8 @@ netbox_iproto_features_init(void)
 			    IPROTO_FEATURE_CALL_ARG_TUPLE_EXTENSION);
 	iproto_features_set(&NETBOX_IPROTO_FEATURES,
 			    IPROTO_FEATURE_IS_SYNC);
+	iproto_features_set(&NETBOX_IPROTO_FEATURES,
+			    IPROTO_FEATURE_GET_MANY);
 }
 
 int
@@ -1238,6 +1238,11 @@ space_metatable = function(remote)
         return check_primary_index(self):get(key, opts)
     end
 
+    function methods:get_many(keys, opts)
+        check_space_arg(self, 'get_many')
+        return check_primary_index(self):get_many(keys, opts)
+    end
+
     function methods:format(format)
         if format == nil then
             return self._format
@@ -1291,6 +1296,21 @@ index_metatable = function(remote)
                                                0, 2, key, nil, false))
     end
 
+    function methods:get_many(keys, opts)
+        check_index_arg(self, 'get_many')
+        check_param_table(opts, REQUEST_OPTION_TYPES)
+        if type(keys) ~= 'table' then
+            error("Usage: index:get_many(keys)")
+        end
+        if not remote.peer_protocol_features.get_many then
+            return box.error(box.error.UNSUPPORTED, "Remote server",
+                "get_many")
+        end
+        return remote:_request('GET_MANY', opts, self.space._format_cdata,
+                               self._stream_id, self.space._id_or_name,
+                               self._id_or_name, keys)
+    end
+
     function methods:min(key, opts)
         check_index_arg(self, 'min')
         check_param_table(opts, REQUEST_OPTION_TYPES)
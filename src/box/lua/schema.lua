@@ -496,6 +496,7 @@ box.schema.space.create = function(name, options)
         defer_deletes = 'boolean',
         constraint = 'string, table',
         foreign_key = 'table',
+        field_offset_step = 'number',
     }
     local options_defaults = {
         engine = 'memtx',
@@ -548,6 +549,7 @@ box.schema.space.create = function(name, options)
         defer_deletes = options.defer_deletes and true or nil,
         constraint = constraint,
         foreign_key = foreign_key,
+        field_offset_step = options.field_offset_step,
     })
     call_at(2, _space.insert, _space,
             {id, uid, name, options.engine, options.field_count, space_options,
@@ -659,6 +661,7 @@ local alter_space_template = {
     name = 'string',
     constraint = 'string, table',
     foreign_key = 'table',
+    field_offset_step = 'number',
 }
 
 box.schema.space.alter = function(space_id, options)
@@ -704,6 +707,11 @@ box.schema.space.alter = function(space_id, options)
         flags.defer_deletes = options.defer_deletes
     end
 
+    if options.field_offset_step ~= nil then
+        flags.field_offset_step = options.field_offset_step ~= 0 and
+                                  options.field_offset_step or nil
+    end
+
     local format
     if options.format ~= nil then
         format = normalize_format(space_id, tuple.name, options.format, 2)
@@ -1204,6 +1212,10 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    bloom_partition_pages = 'number',
+    bloom_type = 'string',
+    compaction_threads = 'number',
+    compaction_strategy = 'string',
     func = 'number, string',
     hint = 'boolean',
     covers = 'table',
@@ -1419,6 +1431,10 @@ box.schema.index.create = atomic_wrapper(function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            bloom_partition_pages = options.bloom_partition_pages,
+            bloom_type = options.bloom_type,
+            compaction_threads = options.compaction_threads,
+            compaction_strategy = options.compaction_strategy,
             func = options.func,
             hint = options.hint,
             covers = options.covers,
@@ -2253,6 +2269,20 @@ base_index_mt.get_luac = function(index, key)
     return internal.get(index.space_id, index.id, key)
 end
 
+-- Look up a batch of keys in one call. The i-th element of the result
+-- is the tuple matching the i-th key or nil if there's no such tuple.
+base_index_mt.get_many = function(index, keys)
+    check_index_arg(index, 'get_many', 2)
+    if type(keys) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS, "Usage: index:get_many(keys)", 2)
+    end
+    local key_list = {}
+    for i = 1, #keys do
+        key_list[i] = keify(keys[i])
+    end
+    return internal.get_many(index.space_id, index.id, key_list)
+end
+
 base_index_mt.select_ffi = function(index, key, opts)
     if builtin.box_read_ffi_is_disabled then
         return base_index_mt.select_luac(index, key, opts)
@@ -2412,6 +2442,10 @@ space_mt.get = function(space, key)
     check_space_arg(space, 'get', 2)
     return check_primary_index(space, 2):get(key)
 end
+space_mt.get_many = function(space, keys)
+    check_space_arg(space, 'get_many', 2)
+    return check_primary_index(space, 2):get_many(keys)
+end
 space_mt.select = function(space, key, opts)
     check_space_arg(space, 'select', 2)
     return check_primary_index(space, 2):select(key, opts)
@@ -742,6 +742,33 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			if (index_opts->bloom_partition_pages > 0) {
+				lua_pushnumber(L,
+					index_opts->bloom_partition_pages);
+				lua_setfield(L, -2, "bloom_partition_pages");
+			}
+
+			if (index_opts->bloom_type !=
+			    INDEX_BLOOM_TYPE_CLASSIC) {
+				lua_pushstring(L, index_bloom_type_strs[
+					index_opts->bloom_type]);
+				lua_setfield(L, -2, "bloom_type");
+			}
+
+			if (index_opts->compaction_threads > 1) {
+				lua_pushnumber(L,
+					index_opts->compaction_threads);
+				lua_setfield(L, -2, "compaction_threads");
+			}
+
+			if (index_opts->compaction_strategy !=
+			    INDEX_COMPACTION_STRATEGY_LEVELED) {
+				int s = index_opts->compaction_strategy;
+				lua_pushstring(L,
+					index_compaction_strategy_strs[s]);
+				lua_setfield(L, -2, "compaction_strategy");
+			}
+
 			lua_settable(L, -3);
 		}
 		lua_setfield(L, -2, index_def->name);
@@ -40,10 +40,13 @@
 
 #include "box/box.h"
 #include "box/iproto.h"
+#include "box/session.h"
 #include "box/engine.h"
 #include "box/vinyl.h"
+#include "box/wal.h"
 #include "box/sql.h"
 #include "box/memtx_engine.h"
+#include "latency.h"
 #include "info/info.h"
 #include "lua/info.h"
 #include "lua/utils.h"
@@ -80,6 +83,49 @@ inject_iproto_stats(struct lua_State *L, struct iproto_stats *stats)
 			    stats->requests_in_stream_queue);
 }
 
+/**
+ * Pushes a table with percentiles of request latency, in seconds,
+ * for each IPROTO request processing stage to a Lua stack.
+ */
+static void
+push_iproto_latency(struct lua_State *L, struct latency *latency)
+{
+	lua_createtable(L, 0, iproto_latency_stage_MAX);
+	for (int i = 0; i < iproto_latency_stage_MAX; i++) {
+		struct latency *l = &latency[i];
+		lua_createtable(L, 0, 5);
+		lua_pushnumber(L, latency_get(l, 50));
+		lua_setfield(L, -2, "p50");
+		lua_pushnumber(L, latency_get(l, 75));
+		lua_setfield(L, -2, "p75");
+		lua_pushnumber(L, latency_get(l, 90));
+		lua_setfield(L, -2, "p90");
+		lua_pushnumber(L, latency_get(l, 95));
+		lua_setfield(L, -2, "p95");
+		lua_pushnumber(L, latency_get(l, 99));
+		lua_setfield(L, -2, "p99");
+		lua_setfield(L, -2, iproto_latency_stage_strs[i]);
+	}
+}
+
+/**
+ * Pushes a table with IPROTO request latency of all threads or of
+ * the thread with the given id (if not negative) to a Lua stack.
+ */
+static void
+push_iproto_thread_latency(struct lua_State *L, int thread_id)
+{
+	struct latency latency[iproto_latency_stage_MAX];
+	if (iproto_latency_create(latency) != 0)
+		luaT_error(L);
+	if (thread_id < 0)
+		iproto_latency_get(latency);
+	else
+		iproto_thread_latency_get(latency, thread_id);
+	push_iproto_latency(L, latency);
+	iproto_latency_destroy(latency);
+}
+
 static void
 fill_stat_item(struct lua_State *L, int rps, int64_t total)
 {
@@ -179,6 +225,16 @@ lbox_stat_vinyl(struct lua_State *L)
 	return 1;
 }
 
+/* box.stat.wal() */
+static int
+lbox_stat_wal(struct lua_State *L)
+{
+	struct info_handler h;
+	luaT_info_handler_create(&h, L);
+	wal_stat(&h);
+	return 1;
+}
+
 /* box.stat.memtx() */
 static int
 lbox_stat_memtx(struct lua_State *L)
@@ -221,6 +277,10 @@ static int
 lbox_stat_net_index(struct lua_State *L)
 {
 	const char *key = luaL_checkstring(L, -1);
+	if (strcmp(key, "LATENCY") == 0) {
+		push_iproto_thread_latency(L, -1);
+		return 1;
+	}
 	if (iproto_rmean_foreach(seek_stat_item, L) == 0)
 		return 0;
 
@@ -261,7 +321,8 @@ lbox_stat_net_index(struct lua_State *L)
  * - STREAMS: total, rps, current;
  * - REQUESTS: total, rps, current;
  * - REQUESTS_IN_PROGRESS: total, rps, current;
- * - REQUESTS_IN_STREAM_QUEUE: total, rps, current.
+ * - REQUESTS_IN_STREAM_QUEUE: total, rps, current;
+ * - LATENCY: INPUT, CBUS, EXEC, OUTPUT.
  *
  * These fields have the following meaning:
  *
@@ -269,6 +330,10 @@ lbox_stat_net_index(struct lua_State *L)
  * - rps -- amount of events per second, mean over last 5 seconds;
  * - current -- amount of resources currently hold (say, number of
  *   open connections).
+ *
+ * Each LATENCY field is a table with p50, p75, p90, p95, p99
+ * percentiles of the latency of the corresponding request processing
+ * stage (see enum iproto_latency_stage), in seconds.
  */
 static int
 lbox_stat_net_call(struct lua_State *L)
@@ -278,6 +343,8 @@ lbox_stat_net_call(struct lua_State *L)
 	struct iproto_stats stats;
 	iproto_stats_get(&stats);
 	inject_iproto_stats(L, &stats);
+	push_iproto_thread_latency(L, -1);
+	lua_setfield(L, -2, "LATENCY");
 	return 1;
 }
 
@@ -296,6 +363,8 @@ lbox_stat_net_thread_index(struct lua_State *L)
 	struct iproto_stats stats;
 	iproto_thread_stats_get(&stats, thread_id);
 	inject_iproto_stats(L, &stats);
+	push_iproto_thread_latency(L, thread_id);
+	lua_setfield(L, -2, "LATENCY");
 	return 1;
 }
 
@@ -312,11 +381,45 @@ lbox_stat_net_thread_call(struct lua_State *L)
 		iproto_thread_rmean_foreach(thread_id, set_stat_item, L);
 		iproto_thread_stats_get(&stats, thread_id);
 		inject_iproto_stats(L, &stats);
+		push_iproto_thread_latency(L, thread_id);
+		lua_setfield(L, -2, "LATENCY");
 		lua_rawseti(L, -2, thread_id + 1);
 	}
 	return 1;
 }
 
+/**
+ * Push a table of network metrics of the IPROTO connection of
+ * the session with the given id (the current session by default)
+ * to a Lua stack.
+ *
+ * The table contains only the LATENCY field, which has the same
+ * format as the one returned by lbox_stat_net_call(). Nothing is
+ * pushed if the session doesn't exist or isn't an IPROTO session,
+ * or if per-connection statistics are disabled
+ * (box.cfg.iproto_connection_latency).
+ */
+static int
+lbox_stat_net_connection(struct lua_State *L)
+{
+	uint64_t sid = luaL_optinteger(L, 1, current_session()->id);
+	struct session *session = session_find(sid);
+	if (session == NULL)
+		return 0;
+	struct latency latency[iproto_latency_stage_MAX];
+	if (iproto_latency_create(latency) != 0)
+		return luaT_error(L);
+	if (iproto_session_latency_get(session, latency) != 0) {
+		iproto_latency_destroy(latency);
+		return 0;
+	}
+	lua_newtable(L);
+	push_iproto_latency(L, latency);
+	lua_setfield(L, -2, "LATENCY");
+	iproto_latency_destroy(latency);
+	return 1;
+}
+
 static int
 lbox_stat_sql(struct lua_State *L)
 {
@@ -365,6 +468,7 @@ box_lua_stat_init(struct lua_State *L)
 {
 	static const struct luaL_Reg statlib [] = {
 		{"vinyl", lbox_stat_vinyl},
+		{"wal", lbox_stat_wal},
 		{"reset", lbox_stat_reset},
 		{"sql", lbox_stat_sql},
 		{NULL, NULL}
@@ -378,7 +482,13 @@ box_lua_stat_init(struct lua_State *L)
 	lua_setmetatable(L, -2);
 	lua_pop(L, 1); /* stat module */
 
+	static const struct luaL_Reg statnetlib[] = {
+		{"connection", lbox_stat_net_connection},
+		{NULL, NULL}
+	};
+
 	luaL_findtable(L, LUA_GLOBALSINDEX, "box.stat.net", 0);
+	luaL_setfuncs(L, statnetlib, 0);
 	lua_newtable(L);
 	luaL_setfuncs(L, lbox_stat_net_meta, 0);
 	lua_setmetatable(L, -2);
@@ -1512,6 +1512,16 @@ local function upgrade_to_3_3_0()
     create_gc_consumers()
 end
 
+--------------------------------------------------------------------------------
+-- Tarantool 3.7.0
+--------------------------------------------------------------------------------
+local function upgrade_to_3_7_0()
+    -- NoOp. We need to bump schema version to allow incremental memtx
+    -- snapshots, which older versions can't recover from, only after
+    -- the user is done with the upgrade.
+    return
+end
+
 --------------------------------------------------------------------------------
 
 local handlers = {
@@ -1538,6 +1548,7 @@ local handlers = {
     {version = mkversion.new(3, 0, 0), func = upgrade_to_3_0_0},
     {version = mkversion.new(3, 1, 0), func = upgrade_to_3_1_0},
     {version = mkversion.new(3, 3, 0), func = upgrade_to_3_3_0},
+    {version = mkversion.new(3, 7, 0), func = upgrade_to_3_7_0},
 }
 
 builtin.box_init_latest_dd_version_id(
@@ -341,6 +341,16 @@ class MemtxAllocator {
 		return block->version < memtx_block_rv_version(rv);
 	}
 
+	/** True if there's at least one open read view. */
+	static bool has_read_views()
+	{
+		for (int type = 0; type < memtx_block_rv_type_MAX; type++) {
+			if (!rlist_empty(&read_views[type]))
+				return true;
+		}
+		return false;
+	}
+
 	/**
 	 * Allocates a block of memory of the given `data_size' and returns its
 	 * handle. By default `data_offset' equals the header size, however in
@@ -0,0 +1,211 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_arena.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#if defined(__linux__)
+# include <linux/mempolicy.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif /* defined(__linux__) */
+
+#include "say.h"
+#include "small/slab_arena.h"
+#include "small/util.h"
+#include "trivia/util.h"
+
+#if !defined(MAP_HUGE_SHIFT)
+# define MAP_HUGE_SHIFT 26
+#endif
+#if !defined(MAP_HUGE_2MB)
+# define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#if !defined(MAP_HUGE_1GB)
+# define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+const char *memtx_huge_pages_strs[] = {
+	"none",
+	"transparent",
+	"2M",
+	"1G",
+};
+
+const char *memtx_numa_policy_strs[] = {
+	"default",
+	"interleave",
+	"bind",
+};
+
+const struct memtx_arena_opts memtx_arena_opts_default = {
+	.huge_pages = MEMTX_HUGE_PAGES_NONE,
+	.numa_policy = MEMTX_NUMA_POLICY_DEFAULT,
+	.numa_nodes = 0,
+};
+
+/**
+ * Advise the kernel to back [@a addr, @a addr + @a size) with
+ * transparent huge pages.
+ */
+static void
+memtx_arena_advise_huge_pages(void *addr, size_t size)
+{
+#if defined(MADV_HUGEPAGE)
+	if (madvise(addr, size, MADV_HUGEPAGE) != 0)
+		say_syserror("failed to enable transparent huge pages "
+			     "for memtx arena");
+#else
+	(void)addr;
+	(void)size;
+	say_warn("transparent huge pages are not supported on this "
+		 "platform");
+#endif
+}
+
+/**
+ * Replace the part of the memory [@a addr, @a addr + @a size) aligned
+ * to huge pages with a mapping of explicit huge pages. The unaligned
+ * head and tail keep regular pages. Since the memory isn't touched yet,
+ * no data is lost. Returns 0 on success, -1 on failure (errno is set).
+ */
+static int
+memtx_arena_map_huge_pages(void *addr, size_t size,
+			   enum memtx_huge_pages huge_pages, bool dontdump)
+{
+#if defined(MAP_HUGETLB)
+	size_t page_size;
+	int page_flag;
+	if (huge_pages == MEMTX_HUGE_PAGES_1G) {
+		page_size = 1024 * 1024 * 1024;
+		page_flag = MAP_HUGE_1GB;
+	} else {
+		assert(huge_pages == MEMTX_HUGE_PAGES_2M);
+		page_size = 2 * 1024 * 1024;
+		page_flag = MAP_HUGE_2MB;
+	}
+	char *begin = (char *)small_align((uintptr_t)addr, page_size);
+	char *end = (char *)(((uintptr_t)addr + size) & ~(page_size - 1));
+	if (begin >= end) {
+		errno = EINVAL;
+		return -1;
+	}
+	/*
+	 * Private hugetlb mappings reserve the pages on mmap so we fail
+	 * here rather than get SIGBUS later if the pool is exhausted.
+	 */
+	void *ptr = mmap(begin, end - begin, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED |
+			 MAP_HUGETLB | page_flag, -1, 0);
+	if (ptr == MAP_FAILED) {
+		int save_errno = errno;
+		/*
+		 * A failed MAP_FIXED mapping may leave the range unmapped,
+		 * restore the regular pages.
+		 */
+		if (mmap(begin, end - begin, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+			 -1, 0) == MAP_FAILED)
+			panic_syserror("failed to restore memtx arena mapping");
+		if (dontdump) {
+#if defined(MADV_DONTDUMP)
+			madvise(begin, end - begin, MADV_DONTDUMP);
+#endif
+		}
+		errno = save_errno;
+		return -1;
+	}
+	assert(ptr == begin);
+	if (dontdump) {
+#if defined(MADV_DONTDUMP)
+		if (madvise(begin, end - begin, MADV_DONTDUMP) != 0)
+			say_syserror("failed to exclude memtx arena from "
+				     "core dump");
+#endif
+	}
+	say_info("mapped %zu bytes of memtx arena with %s huge pages",
+		 (size_t)(end - begin), memtx_huge_pages_strs[huge_pages]);
+	return 0;
+#else /* !defined(MAP_HUGETLB) */
+	(void)addr;
+	(void)size;
+	(void)huge_pages;
+	(void)dontdump;
+	errno = ENOTSUP;
+	return -1;
+#endif /* !defined(MAP_HUGETLB) */
+}
+
+/**
+ * Set the NUMA memory policy of [@a addr, @a addr + @a size).
+ * Returns 0 on success, -1 on failure (errno is set).
+ */
+static int
+memtx_arena_set_numa_policy(void *addr, size_t size,
+			    enum memtx_numa_policy policy, uint64_t nodes)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+	/* The kernel reads maxnode - 1 bits of the mask. */
+	unsigned long maxnode = MEMTX_NUMA_NODES_MAX + 1;
+	unsigned long mask[2] = {0, 0};
+	if (nodes == 0) {
+		if (syscall(SYS_get_mempolicy, NULL, mask, maxnode, NULL,
+			    MPOL_F_MEMS_ALLOWED) != 0)
+			return -1;
+	} else {
+		memcpy(mask, &nodes, sizeof(nodes));
+	}
+	int mode = policy == MEMTX_NUMA_POLICY_INTERLEAVE ?
+		   MPOL_INTERLEAVE : MPOL_BIND;
+	return syscall(SYS_mbind, addr, size, mode, mask, maxnode, 0);
+#else
+	(void)addr;
+	(void)size;
+	(void)policy;
+	(void)nodes;
+	errno = ENOTSUP;
+	return -1;
+#endif
+}
+
+void
+memtx_arena_apply_opts(struct slab_arena *arena,
+		       const struct memtx_arena_opts *opts)
+{
+	assert(arena->used == 0);
+	void *addr = arena->arena;
+	size_t size = arena->prealloc;
+	if (addr == NULL || size == 0)
+		return;
+	switch (opts->huge_pages) {
+	case MEMTX_HUGE_PAGES_NONE:
+		break;
+	case MEMTX_HUGE_PAGES_2M:
+	case MEMTX_HUGE_PAGES_1G:
+		if (memtx_arena_map_huge_pages(
+				addr, size, opts->huge_pages,
+				(arena->flags & SLAB_ARENA_DONTDUMP) != 0) == 0)
+			break;
+		say_syserror("failed to map memtx arena with %s huge pages, "
+			     "falling back to transparent huge pages",
+			     memtx_huge_pages_strs[opts->huge_pages]);
+		FALLTHROUGH;
+	case MEMTX_HUGE_PAGES_TRANSPARENT:
+		memtx_arena_advise_huge_pages(addr, size);
+		break;
+	default:
+		unreachable();
+	}
+	if (opts->numa_policy != MEMTX_NUMA_POLICY_DEFAULT &&
+	    memtx_arena_set_numa_policy(addr, size, opts->numa_policy,
+					opts->numa_nodes) != 0) {
+		say_syserror("failed to set '%s' NUMA policy for memtx arena",
+			     memtx_numa_policy_strs[opts->numa_policy]);
+	}
+}
@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct slab_arena;
+
+/** Kind of pages backing the memtx tuple arena (box.cfg.memtx_memory). */
+enum memtx_huge_pages {
+	/** Regular pages. */
+	MEMTX_HUGE_PAGES_NONE,
+	/** Regular pages advised to be merged into transparent huge pages. */
+	MEMTX_HUGE_PAGES_TRANSPARENT,
+	/** Explicit 2M huge pages from the hugetlbfs pool. */
+	MEMTX_HUGE_PAGES_2M,
+	/** Explicit 1G huge pages from the hugetlbfs pool. */
+	MEMTX_HUGE_PAGES_1G,
+	memtx_huge_pages_MAX,
+};
+
+/** String names of enum memtx_huge_pages members. */
+extern const char *memtx_huge_pages_strs[];
+
+/** NUMA memory policy of the memtx tuple arena. */
+enum memtx_numa_policy {
+	/** The default policy of the process. */
+	MEMTX_NUMA_POLICY_DEFAULT,
+	/** Spread pages of the arena across the NUMA nodes round-robin. */
+	MEMTX_NUMA_POLICY_INTERLEAVE,
+	/** Allocate pages of the arena only from the given NUMA nodes. */
+	MEMTX_NUMA_POLICY_BIND,
+	memtx_numa_policy_MAX,
+};
+
+/** String names of enum memtx_numa_policy members. */
+extern const char *memtx_numa_policy_strs[];
+
+enum {
+	/** Max number of NUMA nodes supported by memtx_arena_opts. */
+	MEMTX_NUMA_NODES_MAX = 64,
+};
+
+/** Memory placement options of the memtx tuple arena. */
+struct memtx_arena_opts {
+	/** Kind of pages backing the arena. */
+	enum memtx_huge_pages huge_pages;
+	/** NUMA memory policy of the arena. */
+	enum memtx_numa_policy numa_policy;
+	/**
+	 * Bit mask of NUMA nodes the policy applies to, 0 means all the
+	 * nodes the process is allowed to allocate memory from.
+	 */
+	uint64_t numa_nodes;
+};
+
+/** Default options: regular pages, default NUMA policy. */
+extern const struct memtx_arena_opts memtx_arena_opts_default;
+
+/**
+ * Apply the memory placement options to the preallocated memory of
+ * @a arena. Must be called right after the arena is created, before
+ * any slab is allocated from it. If an option can't be applied, e.g.
+ * the huge page pool is exhausted or the system has no NUMA support,
+ * a warning is logged and the closest fallback is used: explicit huge
+ * pages fall back to transparent huge pages, NUMA policy is ignored.
+ *
+ * Slabs mapped after the preallocated memory is exhausted (when
+ * memtx_memory is increased at runtime) use regular pages.
+ */
+void
+memtx_arena_apply_opts(struct slab_arena *arena,
+		       const struct memtx_arena_opts *opts);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
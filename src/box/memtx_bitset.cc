@@ -518,6 +518,7 @@ static const struct index_vtab memtx_bitset_index_vtab_base = {
 	/* .count = */ memtx_bitset_index_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ generic_index_get,
+	/* .prefetch = */ generic_index_prefetch,
 	/* .create_iterator = */ memtx_bitset_index_create_iterator,
 	/* .create_iterator_with_offset = */
 	generic_index_create_iterator_with_offset,
@@ -535,6 +536,7 @@ static const struct memtx_index_vtab memtx_bitset_index_vtab = {
 	/* .reserve = */ generic_memtx_index_reserve,
 	/* .build_next = */ generic_memtx_index_build_next,
 	/* .end_build = */ generic_memtx_index_end_build,
+	/* .relocate = */ NULL,
 };
 
 struct index *
@@ -0,0 +1,356 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_defrag.h"
+
+#include <string.h>
+
+#include "allocator.h"
+#include "diag.h"
+#include "fiber.h"
+#include "index.h"
+#include "info/info.h"
+#include "memtx_allocator.h"
+#include "memtx_engine.h"
+#include "memtx_index.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "space.h"
+#include "space_cache.h"
+#include "trivia/util.h"
+#include "tuple.h"
+#include "txn.h"
+
+enum {
+	/** Max number of tuples scanned without yielding. */
+	MEMTX_DEFRAG_BATCH_SIZE = 100,
+};
+
+/**
+ * How long the defragmenter sleeps when there's nothing to do before
+ * checking again, in seconds.
+ */
+static const double MEMTX_DEFRAG_IDLE_TIMEOUT = 1.0;
+
+using SmallAllocator = MemtxAllocator<SmallAlloc>;
+
+double
+memtx_defrag_fragmentation(void)
+{
+	struct allocator_stats stats;
+	memset(&stats, 0, sizeof(stats));
+	SmallAlloc::stats(&stats, stats_noop_cb, NULL);
+	if (stats.small.total == 0 || stats.small.used >= stats.small.total)
+		return 0;
+	return (double)(stats.small.total - stats.small.used) /
+	       stats.small.total;
+}
+
+/** Check if a transaction doing DDL is in progress. */
+static bool
+memtx_defrag_ddl_in_progress(void)
+{
+	struct txn *txn;
+	rlist_foreach_entry(txn, &txns, in_txns) {
+		if (txn->is_schema_changed)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Check if tuples may be relocated now. Index entries are updated in
+ * place so there must be no read view that could see the index memory.
+ * A DDL operation may build a new index in the background from the
+ * primary key, which we must not change behind its back.
+ */
+static bool
+memtx_defrag_may_run(struct memtx_defrag *defrag, struct memtx_engine *memtx)
+{
+	return defrag->is_supported && defrag->rate > 0 &&
+	       memtx->state == MEMTX_OK &&
+	       !SmallAllocator::has_read_views() &&
+	       !memtx_defrag_ddl_in_progress() &&
+	       memtx_defrag_fragmentation() >= defrag->threshold;
+}
+
+/** Check if tuples of the given space may be relocated. */
+static bool
+memtx_defrag_space_is_eligible(struct space *space)
+{
+	if (!space_is_memtx(space) || space->upgrade != NULL)
+		return false;
+	/* The scan position is a key so the primary key must be ordered. */
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL || pk->def->type != TREE)
+		return false;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		if (!memtx_index_supports_relocate(space->index[i]))
+			return false;
+	}
+	return true;
+}
+
+/** space_foreach() callback that adds a memtx space to the pass. */
+static int
+memtx_defrag_add_space_cb(struct space *space, void *arg)
+{
+	struct memtx_defrag *defrag = (struct memtx_defrag *)arg;
+	/* System spaces are small and their tuples may be cached. */
+	if (!space_is_memtx(space) || space_is_system(space))
+		return 0;
+	defrag->space_ids = (uint32_t *)xrealloc(
+		defrag->space_ids,
+		(defrag->space_count + 1) * sizeof(*defrag->space_ids));
+	defrag->space_ids[defrag->space_count++] = space_id(space);
+	return 0;
+}
+
+/**
+ * Start a new pass over all memtx spaces. Spaces created during the pass
+ * are picked up by the next one.
+ */
+static void
+memtx_defrag_begin_pass(struct memtx_defrag *defrag)
+{
+	defrag->space_count = 0;
+	defrag->space_pos = 0;
+	if (space_foreach(memtx_defrag_add_space_cb, defrag) != 0)
+		diag_log();
+}
+
+/** Proceed to the next space of the pass. */
+static void
+memtx_defrag_next_space(struct memtx_defrag *defrag)
+{
+	assert(defrag->space_pos < defrag->space_count);
+	defrag->space_pos++;
+	free(defrag->last_key);
+	defrag->last_key = NULL;
+	defrag->last_key_capacity = 0;
+}
+
+/** Remember the primary key of the last scanned tuple. */
+static void
+memtx_defrag_set_last_key(struct memtx_defrag *defrag, struct index *pk,
+			  struct tuple *tuple)
+{
+	uint32_t key_size;
+	const char *key = tuple_extract_key(tuple, pk->def->key_def,
+					    MULTIKEY_NONE, &key_size);
+	if (key == NULL)
+		panic("failed to extract key of a memtx tuple");
+	if (key_size > defrag->last_key_capacity) {
+		defrag->last_key = (char *)xrealloc(defrag->last_key,
+						    key_size);
+		defrag->last_key_capacity = key_size;
+	}
+	memcpy(defrag->last_key, key, key_size);
+}
+
+/**
+ * Move the tuple to a new block if the allocator gives one with a lower
+ * address. The small allocator serves allocations from the slabs with
+ * the lowest addresses first so moving tuples only downwards makes
+ * the slabs at the end of each pool drain, eventually getting released.
+ * Returns true if the tuple was moved.
+ */
+static bool
+memtx_defrag_relocate_tuple(struct memtx_defrag *defrag, struct space *space,
+			    struct tuple *old_tuple)
+{
+	/*
+	 * Anyone but the space referencing the tuple (a Lua object,
+	 * an iterator, a statement) may use its address. A dirty tuple
+	 * has MVCC stories linked to it.
+	 */
+	if (!tuple_is_referenced_once(old_tuple) ||
+	    tuple_has_flag(old_tuple, TUPLE_IS_DIRTY))
+		return false;
+	struct memtx_block *old_block = memtx_block_from_tuple(old_tuple);
+	size_t size = memtx_block_size(old_block);
+	struct small_alloc_info info;
+	SmallAlloc::get_alloc_info(old_block, size, &info);
+	/* Large tuples are allocated with malloc and aren't fragmented. */
+	if (info.is_large)
+		return false;
+	struct memtx_block *new_block = SmallAllocator::alloc(
+		tuple_bsize(old_tuple), tuple_data_offset(old_tuple),
+		tuple_is_compact(old_tuple));
+	if (new_block == NULL)
+		return false;
+	if ((uintptr_t)new_block > (uintptr_t)old_block) {
+		SmallAllocator::free(new_block);
+		return false;
+	}
+	assert(memtx_block_size(new_block) == size);
+	struct tuple *new_tuple = memtx_block_to_tuple(new_block);
+	/* The reference of the space is passed to the new tuple. */
+	memcpy(new_tuple, old_tuple, tuple_size(old_tuple));
+	tuple_format_ref(tuple_format(new_tuple));
+	for (uint32_t i = 0; i < space->index_count; i++)
+		memtx_index_relocate(space->index[i], old_tuple, new_tuple);
+	tuple_unref(old_tuple);
+	defrag->relocated++;
+	defrag->relocated_bytes += size;
+	return true;
+}
+
+/**
+ * Scan at most @a limit tuples of the space starting after the last
+ * scanned one and relocate them. Returns the number of scanned tuples:
+ * if it's less than @a limit, the scan of the space is complete.
+ */
+static int
+memtx_defrag_scan_space(struct memtx_defrag *defrag, struct space *space,
+			int limit)
+{
+	struct index *pk = space_index(space, 0);
+	const char *key = defrag->last_key;
+	uint32_t part_count = 0;
+	if (key != NULL)
+		part_count = mp_decode_array(&key);
+	struct iterator *it = index_create_iterator(
+		pk, key != NULL ? ITER_GT : ITER_ALL, key, part_count);
+	if (it == NULL) {
+		diag_log();
+		return 0;
+	}
+	RegionGuard region_guard(&fiber()->gc);
+	struct tuple **tuples = xregion_alloc_array(&fiber()->gc,
+						    struct tuple *, limit);
+	int count = 0;
+	while (count < limit) {
+		struct tuple *tuple;
+		if (iterator_next_internal(it, &tuple) != 0) {
+			diag_log();
+			break;
+		}
+		if (tuple == NULL)
+			break;
+		tuples[count++] = tuple;
+	}
+	if (count > 0)
+		memtx_defrag_set_last_key(defrag, pk, tuples[count - 1]);
+	/*
+	 * The iterator references the last returned tuple so it must be
+	 * deleted before relocation. We don't yield so the collected
+	 * tuples can't be freed meanwhile.
+	 */
+	iterator_delete(it);
+	for (int i = 0; i < count; i++)
+		memtx_defrag_relocate_tuple(defrag, space, tuples[i]);
+	defrag->scanned += count;
+	return count;
+}
+
+/**
+ * Scan at most @a limit tuples, proceeding to the next space of the pass
+ * if needed. Returns the number of scanned tuples.
+ */
+static int
+memtx_defrag_step(struct memtx_defrag *defrag, int limit)
+{
+	int scanned = 0;
+	while (scanned < limit && defrag->space_pos < defrag->space_count) {
+		struct space *space =
+			space_by_id(defrag->space_ids[defrag->space_pos]);
+		int count = 0;
+		if (space != NULL && memtx_defrag_space_is_eligible(space))
+			count = memtx_defrag_scan_space(defrag, space,
+							limit - scanned);
+		if (count < limit - scanned)
+			memtx_defrag_next_space(defrag);
+		scanned += count;
+	}
+	return scanned;
+}
+
+static int
+memtx_defrag_f(va_list ap)
+{
+	struct memtx_engine *memtx = va_arg(ap, struct memtx_engine *);
+	struct memtx_defrag *defrag = &memtx->defrag;
+	while (!fiber_is_cancelled()) {
+		FiberGCChecker gc_check;
+		if (!memtx_defrag_may_run(defrag, memtx)) {
+			fiber_yield_timeout(MEMTX_DEFRAG_IDLE_TIMEOUT);
+			continue;
+		}
+		if (defrag->space_pos == defrag->space_count)
+			memtx_defrag_begin_pass(defrag);
+		int limit = MIN(MEMTX_DEFRAG_BATCH_SIZE,
+				MAX((int)defrag->rate, 1));
+		int scanned = memtx_defrag_step(defrag, limit);
+		if (scanned == 0) {
+			fiber_yield_timeout(MEMTX_DEFRAG_IDLE_TIMEOUT);
+			continue;
+		}
+		fiber_sleep(scanned / defrag->rate);
+	}
+	return 0;
+}
+
+int
+memtx_defrag_create(struct memtx_defrag *defrag, const char *allocator)
+{
+	memset(defrag, 0, sizeof(*defrag));
+	defrag->is_supported = strcmp(allocator, "small") == 0;
+	defrag->fiber = fiber_new_system("memtx.defrag", memtx_defrag_f);
+	if (defrag->fiber == NULL)
+		return -1;
+	fiber_set_joinable(defrag->fiber, true);
+	return 0;
+}
+
+void
+memtx_defrag_destroy(struct memtx_defrag *defrag)
+{
+	free(defrag->space_ids);
+	free(defrag->last_key);
+	TRASH(defrag);
+}
+
+void
+memtx_defrag_start(struct memtx_defrag *defrag, struct memtx_engine *memtx)
+{
+	assert(&memtx->defrag == defrag);
+	fiber_start(defrag->fiber, memtx);
+}
+
+void
+memtx_defrag_stop(struct memtx_defrag *defrag)
+{
+	fiber_cancel(defrag->fiber);
+	fiber_join(defrag->fiber);
+	defrag->fiber = NULL;
+}
+
+void
+memtx_defrag_set_rate(struct memtx_defrag *defrag, double rate)
+{
+	defrag->rate = rate;
+	if (defrag->fiber != NULL)
+		fiber_wakeup(defrag->fiber);
+}
+
+void
+memtx_defrag_set_threshold(struct memtx_defrag *defrag, double threshold)
+{
+	defrag->threshold = threshold;
+	if (defrag->fiber != NULL)
+		fiber_wakeup(defrag->fiber);
+}
+
+void
+memtx_defrag_stat(struct memtx_defrag *defrag, struct info_handler *h)
+{
+	info_table_begin(h, "defrag");
+	info_append_double(h, "fragmentation", memtx_defrag_fragmentation());
+	info_append_int(h, "scanned", defrag->scanned);
+	info_append_int(h, "relocated", defrag->relocated);
+	info_append_int(h, "relocated_bytes", defrag->relocated_bytes);
+	info_table_end(h);
+}
@@ -0,0 +1,115 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct fiber;
+struct info_handler;
+struct memtx_engine;
+
+/**
+ * Memtx tuple defragmenter.
+ *
+ * Freed tuples leave holes in the slabs of the small allocator, which
+ * can't be returned to the arena until all tuples allocated from a slab
+ * are freed. After churn this results in a lot of sparsely used slabs.
+ * The defragmenter is a background fiber that scans memtx spaces and
+ * moves tuples to the lowest free addresses of their size class so that
+ * the slabs with higher addresses drain and get released.
+ *
+ * A tuple is moved by copying it to a new block and updating all index
+ * entries referring to it in place, so the defragmenter only works
+ * while there's no open read view and no DDL in progress, and skips
+ * tuples that are referenced by anyone except the space or have MVCC
+ * stories.
+ */
+struct memtx_defrag {
+	/** Fiber doing the job. */
+	struct fiber *fiber;
+	/**
+	 * Set if tuples can be relocated, that is the "small" memtx
+	 * allocator is used.
+	 */
+	bool is_supported;
+	/**
+	 * Max number of tuples scanned per second,
+	 * box.cfg.memtx_defrag_rate. Zero disables the defragmenter.
+	 */
+	double rate;
+	/**
+	 * Fraction of the memory of the tuple slabs that must be wasted
+	 * for the defragmenter to run, box.cfg.memtx_defrag_threshold.
+	 */
+	double threshold;
+	/** IDs of the spaces scanned during the current pass. */
+	uint32_t *space_ids;
+	/** Number of elements in space_ids. */
+	uint32_t space_count;
+	/** Position of the space being scanned in space_ids. */
+	uint32_t space_pos;
+	/**
+	 * Primary key of the last scanned tuple of the current space
+	 * or NULL if the scan of the space hasn't started yet.
+	 */
+	char *last_key;
+	/** Size of the memory allocated for last_key. */
+	uint32_t last_key_capacity;
+	/** Number of tuples scanned so far. */
+	int64_t scanned;
+	/** Number of tuples moved so far. */
+	int64_t relocated;
+	/** Size of the tuples moved so far, in bytes. */
+	int64_t relocated_bytes;
+};
+
+/**
+ * Create the defragmenter. Only the "small" memtx allocator supports
+ * relocation of tuples. Returns 0 on success, -1 on error (diag is set).
+ */
+int
+memtx_defrag_create(struct memtx_defrag *defrag, const char *allocator);
+
+/** Destroy the defragmenter. */
+void
+memtx_defrag_destroy(struct memtx_defrag *defrag);
+
+/** Start the defragmenter fiber. */
+void
+memtx_defrag_start(struct memtx_defrag *defrag, struct memtx_engine *memtx);
+
+/** Stop the defragmenter fiber. Yields. */
+void
+memtx_defrag_stop(struct memtx_defrag *defrag);
+
+/** Set box.cfg.memtx_defrag_rate. */
+void
+memtx_defrag_set_rate(struct memtx_defrag *defrag, double rate);
+
+/** Set box.cfg.memtx_defrag_threshold. */
+void
+memtx_defrag_set_threshold(struct memtx_defrag *defrag, double threshold);
+
+/**
+ * Return the fraction of the memory of the tuple slabs that isn't used
+ * by tuples.
+ */
+double
+memtx_defrag_fragmentation(void);
+
+/** Append the defragmenter statistics to box.stat.memtx(). */
+void
+memtx_defrag_stat(struct memtx_defrag *defrag, struct info_handler *h);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -67,6 +67,7 @@
 #include "assoc.h"
 #include "scoped_guard.h"
 #include "xlog_reader.h"
+#include "qsort_arg.h"
 
 #include <type_traits>
 
@@ -78,6 +79,8 @@ enum {
 	SLAB_SIZE = 16 * 1024 * 1024,
 	MIN_MEMORY_QUOTA = SLAB_SIZE * 4,
 	MAX_TUPLE_SIZE = 1 * 1024 * 1024,
+	/** Initial size of the checkpoint change log buffer. */
+	MEMTX_CHECKPOINT_CHANGES_IBUF_SIZE = 16 * 1024,
 };
 
 template <class ALLOC>
@@ -124,12 +127,16 @@ memtx_alloc_init(void)
  * Regarding the sort data: the O(n) SK sort can only be performed right
  * after the .snap is loaded.
  *
- * So all space indexes are built early in this case.
+ * So all space indexes are built early in this case. If the checkpoint is
+ * incremental, the build is postponed until the incremental snapshots are
+ * applied to primary keys, because they may break unique constraints of
+ * secondary keys temporarily.
  */
 static bool
 memtx_build_spaces_early(struct memtx_engine *memtx)
 {
-	return memtx_tx_manager_use_mvcc_engine ||
+	return (memtx_tx_manager_use_mvcc_engine &&
+		memtx->recovery.snap_chain_len <= 1) ||
 	       memtx->recovery.sort_data_reader != NULL;
 }
 
@@ -323,6 +330,86 @@ memtx_end_build_snapshot_space(struct memtx_engine *memtx, uint32_t space_id)
 	return 0;
 }
 
+/**
+ * Return true if loading a snapshot row into the space may run user-defined
+ * triggers. Triggers may access any space so a space primary key must not be
+ * built in background while they run.
+ */
+static bool
+memtx_space_has_recovery_triggers(struct space *space)
+{
+	if (space_events_are_enabled() &&
+	    (space_has_before_replace_triggers(space) ||
+	     space_has_on_replace_triggers(space)))
+		return true;
+	if (!txn_events_are_enabled())
+		return false;
+	for (int i = 0; i < txn_event_id_MAX; i++) {
+		if (space_event_has_triggers(&space->txn_events[i]))
+			return true;
+	}
+	return txn_events_have_global_triggers();
+}
+
+/** Background fiber function building the primary key of a space. */
+static int
+memtx_build_snapshot_space_f(va_list ap)
+{
+	struct memtx_engine *memtx = va_arg(ap, struct memtx_engine *);
+	uint32_t space_id = va_arg(ap, uint32_t);
+	struct space *space = space_by_id(space_id);
+	VERIFY(memtx_end_build_primary_key(space, memtx) == 0);
+	return 0;
+}
+
+void
+memtx_wait_build_snapshot_space(struct memtx_engine *memtx)
+{
+	if (memtx->recovery.build_fiber == NULL)
+		return;
+	fiber_join(memtx->recovery.build_fiber);
+	memtx->recovery.build_fiber = NULL;
+}
+
+int
+memtx_end_build_snapshot_space_async(struct memtx_engine *memtx,
+				     uint32_t space_id,
+				     struct space *next_space)
+{
+	assert(memtx->state == MEMTX_INITIAL_RECOVERY);
+	assert(space_id != BOX_ID_NIL);
+	/*
+	 * Don't run more than one build at a time: the sort is parallel
+	 * anyway, we only want to overlap it with loading the next space.
+	 */
+	memtx_wait_build_snapshot_space(memtx);
+	/*
+	 * Secondary keys built early may use the sort data, which is read
+	 * sequentially, and triggers run during recovery may access the
+	 * space being built, so fall back to the synchronous build if the
+	 * space or the next one has triggers. Triggers set on spaces loaded
+	 * later wait for the build to complete, see
+	 * memtx_engine_recover_snapshot_row().
+	 */
+	struct space *space = space_by_id(space_id);
+	if (memtx_build_spaces_early(memtx) ||
+	    memtx_space_has_recovery_triggers(space) ||
+	    memtx_space_has_recovery_triggers(next_space))
+		return memtx_end_build_snapshot_space(memtx, space_id);
+	say_verbose("Building primary key of space '%s' in background",
+		    space_name(space));
+	struct fiber *fiber = fiber_new_system("memtx.build",
+					       memtx_build_snapshot_space_f);
+	if (fiber == NULL) {
+		diag_log();
+		return memtx_end_build_snapshot_space(memtx, space_id);
+	}
+	fiber_set_joinable(fiber, true);
+	memtx->recovery.build_fiber = fiber;
+	fiber_start(fiber, memtx, space_id);
+	return 0;
+}
+
 /**
  * Memtx shutdown. Shutdown stops all internal fiber. Yields.
  */
@@ -333,6 +420,7 @@ memtx_engine_shutdown(struct engine *engine)
 	fiber_cancel(memtx->gc_fiber);
 	fiber_join(memtx->gc_fiber);
 	memtx->gc_fiber = NULL;
+	memtx_defrag_stop(&memtx->defrag);
 }
 
 static void
@@ -345,6 +433,7 @@ memtx_engine_free(struct engine *engine)
 	while (!stop)
 		memtx_engine_run_gc(memtx, &stop);
 #endif
+	memtx_defrag_destroy(&memtx->defrag);
 	mempool_destroy(&memtx->iterator_pool);
 	if (mempool_is_initialized(&memtx->rtree_iterator_pool))
 		mempool_destroy(&memtx->rtree_iterator_pool);
@@ -371,6 +460,8 @@ memtx_engine_free(struct engine *engine)
 
 	xdir_destroy(&memtx->snap_dir);
 	tuple_format_unref(memtx->func_key_format);
+	ibuf_destroy(&memtx->checkpoint_changes);
+	free(memtx->recovery.snap_chain);
 	free(memtx);
 }
 
@@ -385,13 +476,20 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 				  struct xlog_entry *entry,
 				  bool recovering_system_spaces);
 
-int
-memtx_engine_recover_snapshot(struct memtx_engine *memtx,
-			      const struct vclock *vclock)
+/**
+ * Loads a snapshot file. The system part of a snapshot consists of rows
+ * of system spaces followed by the raft and limbo state, the rest is the
+ * user part. The vclock of the snapshot is only needed to load its sort
+ * data and may be NULL, in which case the sort data isn't used.
+ */
+static int
+memtx_engine_recover_snapshot_file(struct memtx_engine *memtx,
+				   int64_t signature,
+				   const struct vclock *vclock,
+				   bool load_system, bool load_user)
 {
-	/* Process existing snapshot */
-	say_info("recovery start");
-	int64_t signature = vclock_sum(vclock);
+	assert(load_system || load_user);
+	assert(vclock == NULL || (load_system && load_user));
 	const char *filename = xdir_format_filename(&memtx->snap_dir,
 						    signature);
 
@@ -415,7 +513,7 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	 * trigger on the `_index` space. Now the saved sort data is invalid
 	 * for the altered index.
 	 */
-	if (memtx->use_sort_data) {
+	if (memtx->use_sort_data && vclock != NULL) {
 		struct space *index_space = space_by_id(BOX_INDEX_ID);
 		/*
 		 * Note: the `_index` space has an internal C before_replace
@@ -456,6 +554,7 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	bool force_recovery = false;
 	bool eof_marker = false;
 	bool recovering_system_spaces = true;
+	bool recovering_user_spaces = false;
 	while (true) {
 		struct xlog_entry *entry;
 		enum xlog_reader_result result =
@@ -490,6 +589,20 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			recovering_system_spaces = false;
 			force_recovery = memtx->force_recovery;
 		}
+		if (!recovering_user_spaces && result == XLOG_READER_OK &&
+		    iproto_type_is_dml(entry->header.type) &&
+		    !space_id_is_system(entry->dml.space_id)) {
+			recovering_user_spaces = true;
+			if (!load_user) {
+				/* The rest of the file isn't needed. */
+				eof_marker = true;
+				break;
+			}
+		}
+		if (!recovering_user_spaces && !load_system) {
+			++row_count;
+			continue;
+		}
 		if (result == XLOG_READER_OK) {
 			entry->header.lsn = signature;
 			rc = memtx_engine_recover_snapshot_row(
@@ -512,6 +625,7 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 		}
 	}
 	xlog_reader_delete(reader);
+	memtx_wait_build_snapshot_space(memtx);
 	if (rc < 0)
 		return -1;
 
@@ -540,6 +654,91 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	return 0;
 }
 
+/**
+ * Collects signatures of the snapshots the checkpoint with the given
+ * signature consists of. An incremental snapshot stores the vclock of
+ * the previous checkpoint in its meta, so the chain is walked back to
+ * the full snapshot, which is returned first. The returned array must
+ * be freed by the caller.
+ */
+static int
+memtx_engine_snap_chain(struct memtx_engine *memtx, int64_t signature,
+			int64_t **chain_out, int *len_out)
+{
+	int64_t *chain = NULL;
+	int len = 0;
+	while (true) {
+		int64_t *new_chain = (int64_t *)realloc(
+			chain, (len + 1) * sizeof(*chain));
+		if (new_chain == NULL) {
+			diag_set(OutOfMemory, (len + 1) * sizeof(*chain),
+				 "realloc", "snapshot chain");
+			goto fail;
+		}
+		chain = new_chain;
+		chain[len++] = signature;
+		struct xlog_cursor cursor;
+		if (xdir_open_cursor(&memtx->snap_dir, signature,
+				     &cursor) != 0)
+			goto fail;
+		bool is_delta = cursor.meta.is_delta;
+		int64_t prev_signature = vclock_sum(&cursor.meta.prev_vclock);
+		xlog_cursor_close(&cursor, false);
+		if (!is_delta)
+			break;
+		if (prev_signature >= signature) {
+			diag_set(XlogError, "snapshot `%s' refers to a newer "
+				 "snapshot", xdir_format_filename(
+					&memtx->snap_dir, signature));
+			goto fail;
+		}
+		signature = prev_signature;
+	}
+	/* Reverse the chain so that it starts with the full snapshot. */
+	for (int i = 0; i < len / 2; i++) {
+		int64_t tmp = chain[i];
+		chain[i] = chain[len - i - 1];
+		chain[len - i - 1] = tmp;
+	}
+	*chain_out = chain;
+	*len_out = len;
+	return 0;
+fail:
+	free(chain);
+	return -1;
+}
+
+int
+memtx_engine_recover_snapshot(struct memtx_engine *memtx,
+			      const struct vclock *vclock)
+{
+	/* Process existing snapshot */
+	say_info("recovery start");
+	int64_t *chain;
+	int len;
+	if (memtx_engine_snap_chain(memtx, vclock_sum(vclock),
+				    &chain, &len) != 0)
+		return -1;
+	assert(memtx->recovery.snap_chain == NULL);
+	memtx->recovery.snap_chain = chain;
+	memtx->recovery.snap_chain_len = len;
+	if (len == 1)
+		return memtx_engine_recover_snapshot_file(memtx, chain[0],
+							  vclock, true, true);
+	/*
+	 * The checkpoint is incremental: load the system spaces from
+	 * the last snapshot and the user spaces from the full one. The
+	 * incremental snapshots are applied on the final recovery after
+	 * the primary keys are built.
+	 */
+	say_info("checkpoint consists of %d snapshots", len);
+	if (memtx_engine_recover_snapshot_file(memtx, chain[len - 1], NULL,
+					       true, false) != 0)
+		return -1;
+	return memtx_engine_recover_snapshot_file(memtx, chain[0], NULL,
+						  false, true);
+}
+
 static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 				  struct xlog_entry *entry,
@@ -588,6 +787,13 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 				"snapshot recovery performance is better with"
 				" new value of"
 				" compat.box_recovery_triggers_deprecation");
+		/*
+		 * Don't let triggers access a space which primary key is
+		 * being built in background.
+		 */
+		if (!recovering_system_spaces &&
+		    memtx_space_has_recovery_triggers(space))
+			memtx_wait_build_snapshot_space(memtx);
 		struct txn *txn = txn_begin();
 		if (txn == NULL)
 			goto log_request;
@@ -618,6 +824,111 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 	return -1;
 }
 
+/**
+ * Applies an incremental snapshot on top of the user spaces loaded from
+ * the previous one. Only REPLACE and DELETE rows of user spaces are
+ * applied, the rest of the snapshot has already been loaded.
+ */
+static int
+memtx_engine_recover_snapshot_delta(struct memtx_engine *memtx,
+				    int64_t signature)
+{
+	const char *filename = xdir_format_filename(&memtx->snap_dir,
+						    signature);
+	say_info("applying incremental snapshot `%s'", filename);
+	struct xlog_reader *reader = xlog_reader_new(filename);
+	if (reader == NULL)
+		return -1;
+	int rc = 0;
+	uint64_t row_count = 0;
+	bool eof_marker = false;
+	while (true) {
+		struct xlog_entry *entry;
+		enum xlog_reader_result result =
+					xlog_reader_next(reader, &entry);
+		if (result == XLOG_READER_READ_ERROR) {
+			struct error *e = diag_last_error(diag_get());
+			if (memtx->force_recovery &&
+			    e->type == &type_XlogError) {
+				diag_log();
+				continue;
+			}
+			rc = -1;
+			break;
+		}
+		if (result == XLOG_READER_EOF)
+			break;
+		if (result == XLOG_READER_EOF_MARKER) {
+			eof_marker = true;
+			break;
+		}
+		if (result == XLOG_READER_OK &&
+		    entry->header.type != IPROTO_REPLACE &&
+		    entry->header.type != IPROTO_DELETE)
+			continue;
+		if (result == XLOG_READER_OK) {
+			struct request *request = &entry->dml;
+			struct space *space =
+				space_cache_find(request->space_id);
+			if (space != NULL && space->engine != &memtx->base) {
+				diag_set(ClientError, ER_ALIEN_ENGINE,
+					 space->engine->name);
+				space = NULL;
+			}
+			if (space == NULL ||
+			    memtx_space_recover_delta_row(space,
+							  request) != 0) {
+				say_error("error at request: %s",
+					  request_str(request));
+				rc = -1;
+			}
+		} else {
+			rc = -1;
+		}
+		if (rc < 0) {
+			if (!memtx->force_recovery)
+				break;
+			rc = 0;
+			say_error("can't apply row: ");
+			diag_log();
+		}
+		++row_count;
+		if (row_count % 100000 == 0) {
+			say_info_ratelimited("%.1fM rows processed",
+					     row_count / 1e6);
+			fiber_yield_timeout(0);
+		}
+	}
+	xlog_reader_delete(reader);
+	if (rc < 0)
+		return -1;
+	if (!eof_marker) {
+		if (!memtx->force_recovery)
+			panic("snapshot `%s' has no EOF marker", filename);
+		else
+			say_error("snapshot `%s' has no EOF marker", filename);
+	}
+	return 0;
+}
+
+/**
+ * Applies the incremental snapshots of the recovered checkpoint, if any,
+ * and frees the snapshot chain.
+ */
+static int
+memtx_engine_recover_snapshot_deltas(struct memtx_engine *memtx)
+{
+	int rc = 0;
+	for (int i = 1; i < memtx->recovery.snap_chain_len && rc == 0; i++) {
+		rc = memtx_engine_recover_snapshot_delta(
+			memtx, memtx->recovery.snap_chain[i]);
+	}
+	free(memtx->recovery.snap_chain);
+	memtx->recovery.snap_chain = NULL;
+	memtx->recovery.snap_chain_len = 0;
+	return rc;
+}
+
 /** Called at start to tell memtx to recover to a given LSN. */
 static int
 memtx_engine_begin_initial_recovery(struct engine *engine,
@@ -646,15 +957,30 @@ memtx_engine_begin_final_recovery(struct engine *engine)
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
 	if (memtx->state == MEMTX_OK) {
 		assert(memtx->recovery.sort_data_reader == NULL);
-		return 0;
+		return memtx_engine_recover_snapshot_deltas(memtx);
 	}
 
+	/* Wait for the PK build of the previous space, if any. */
+	memtx_wait_build_snapshot_space(memtx);
+
 	/* Build PK and possibly SKs of the last space. */
 	if (memtx->recovery.last_space_id != BOX_ID_NIL &&
 	    memtx_end_build_snapshot_space(memtx,
 					   memtx->recovery.last_space_id) != 0)
 		return -1;
 
+	/*
+	 * Apply the incremental snapshots to the primary keys. If the
+	 * secondary keys must be built early, their build is postponed
+	 * until this moment, see memtx_build_spaces_early().
+	 */
+	bool has_deltas = memtx->recovery.snap_chain_len > 1;
+	if (memtx_engine_recover_snapshot_deltas(memtx) != 0)
+		return -1;
+	if (has_deltas && memtx_build_spaces_early(memtx) &&
+	    space_foreach(memtx_build_secondary_keys, memtx) != 0)
+		return -1;
+
 	/* Set the appropriate memtx space callbacks. */
 	space_foreach(memtx_begin_space_final_recovery, memtx);
 
@@ -849,7 +1175,6 @@ static void
 memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 				struct txn_stmt *stmt)
 {
-	(void)engine;
 	(void)txn;
 	struct tuple *old_tuple = stmt->rollback_info.old_tuple;
 	struct tuple *new_tuple = stmt->rollback_info.new_tuple;
@@ -873,10 +1198,17 @@ memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 	/*
 	 * With MVCC, we do not physically rollback the state of the indexes.
 	 * Instead, we mark the `new_tuple`, if any, as deleted and `old_tuple`,
-	 * if any, as visible again.
+	 * if any, as visible again. The change might have got to a checkpoint
+	 * read view though, so log it to rewrite the tuple in the next one.
 	 */
-	if (memtx_tx_manager_use_mvcc_engine)
+	if (memtx_tx_manager_use_mvcc_engine) {
+		if (memtx_space->has_change_log) {
+			memtx_engine_log_change((struct memtx_engine *)engine,
+						space, new_tuple != NULL ?
+						new_tuple : old_tuple);
+		}
 		return memtx_tx_history_rollback_stmt(stmt);
+	}
 
 	if (memtx_space->replace == memtx_space_replace_all_keys)
 		index_count = space->index_count;
@@ -1003,15 +1335,15 @@ checkpoint_write_row(struct xlog *l, struct xrow_header *row)
 }
 
 static int
-checkpoint_write_tuple(struct xlog *l, uint32_t space_id, uint32_t group_id,
-		       const char *data, uint32_t size)
+checkpoint_write_tuple(struct xlog *l, uint16_t type, uint32_t space_id,
+		       uint32_t group_id, const char *data, uint32_t size)
 {
 	struct request_replace_body body;
 	request_replace_body_create(&body, space_id);
 
 	struct xrow_header row;
 	memset(&row, 0, sizeof(struct xrow_header));
-	row.type = IPROTO_INSERT;
+	row.type = type;
 	row.group_id = group_id;
 
 	row.bodycnt = 2;
@@ -1047,6 +1379,13 @@ struct checkpoint {
 	 * checkpoint already exists.
 	 */
 	bool touch;
+	/**
+	 * Write only the tuples changed since the previous checkpoint
+	 * for user spaces, see memtx_engine::checkpoint_changes.
+	 */
+	bool is_delta;
+	/** Keys of the tuples changed since the previous checkpoint. */
+	struct ibuf changes;
 };
 
 /** Space filter for checkpoint. */
@@ -1159,12 +1498,28 @@ checkpoint_new(struct memtx_engine *memtx, const struct box_checkpoint *box)
 			 "struct checkpoint");
 		return NULL;
 	}
+	/*
+	 * The snapshot can be written incrementally if the change log
+	 * covers all changes made since the previous checkpoint and
+	 * the schema is upgraded so that the user can't expect older
+	 * versions, which don't support incremental snapshots, to be
+	 * able to recover from it.
+	 */
+	struct vclock prev_vclock;
+	ckpt->is_delta = memtx->checkpoint_delta_max > 0 &&
+			 schema_has_feature(
+				SCHEMA_FEATURE_MEMTX_CHECKPOINT_DELTA) &&
+			 !memtx->checkpoint_need_full &&
+			 memtx->checkpoint_delta_count <
+			 memtx->checkpoint_delta_max &&
+			 xdir_last_vclock(&memtx->snap_dir, &prev_vclock) >= 0;
 	struct read_view_opts rv_opts;
 	read_view_opts_create(&rv_opts);
 	rv_opts.name = "checkpoint";
 	rv_opts.is_system = true;
 	rv_opts.filter_space = checkpoint_space_filter;
-	rv_opts.filter_index = checkpoint_index_filter;
+	rv_opts.filter_index = ckpt->is_delta ? primary_index_filter :
+						checkpoint_index_filter;
 	if (read_view_open(&ckpt->rv, &rv_opts) != 0) {
 		free(ckpt);
 		return NULL;
@@ -1175,12 +1530,30 @@ checkpoint_new(struct memtx_engine *memtx, const struct box_checkpoint *box)
 	opts.free_cache = true;
 	xdir_create(&ckpt->dir, memtx->snap_dir.dirname,
 		    "SNAP", &INSTANCE_UUID, &opts);
+	if (ckpt->is_delta) {
+		/*
+		 * Refer to the previous checkpoint in the snapshot meta
+		 * and mark the snapshot as incremental so that versions
+		 * not supporting it refuse to load it.
+		 */
+		ckpt->dir.store_prev_vclock = true;
+		ckpt->dir.is_delta = true;
+		xdir_add_vclock(&ckpt->dir, &prev_vclock);
+	}
 	xlog_clear(&ckpt->snap);
 	vclock_create(&ckpt->vclock);
-	ckpt->sort_data_writer = memtx->use_sort_data ?
+	ckpt->sort_data_writer = memtx->use_sort_data && !ckpt->is_delta ?
 				 memtx_sort_data_writer_new() : NULL;
 	ckpt->box = box;
 	ckpt->touch = false;
+	/*
+	 * The read view is consistent with the change log at this point,
+	 * changes made from now on go to the next checkpoint.
+	 */
+	ckpt->changes = memtx->checkpoint_changes;
+	ibuf_create(&memtx->checkpoint_changes, cord_slab_cache(),
+		    MEMTX_CHECKPOINT_CHANGES_IBUF_SIZE);
+	memtx->checkpoint_need_full = false;
 	return ckpt;
 }
 
@@ -1191,9 +1564,79 @@ checkpoint_delete(struct checkpoint *ckpt)
 		memtx_sort_data_writer_delete(ckpt->sort_data_writer);
 	read_view_close(&ckpt->rv);
 	xdir_destroy(&ckpt->dir);
+	ibuf_destroy(&ckpt->changes);
 	free(ckpt);
 }
 
+/** A tuple change logged since the previous checkpoint. */
+struct checkpoint_change {
+	/** Id of the space the tuple belongs to. */
+	uint32_t space_id;
+	/** Primary key of the tuple, a MsgPack array. */
+	const char *key;
+	/** Primary key parts, following the array header. */
+	const char *parts;
+	/** Number of primary key parts. */
+	uint32_t part_count;
+};
+
+/** qsort() comparator that orders checkpoint changes by space id. */
+static int
+checkpoint_change_cmp_space(const void *a_ptr, const void *b_ptr)
+{
+	const struct checkpoint_change *a =
+		(const struct checkpoint_change *)a_ptr;
+	const struct checkpoint_change *b =
+		(const struct checkpoint_change *)b_ptr;
+	return a->space_id < b->space_id ? -1 : a->space_id > b->space_id;
+}
+
+/** qsort_arg() comparator that orders checkpoint changes by key. */
+static int
+checkpoint_change_cmp_key(const void *a_ptr, const void *b_ptr, void *arg)
+{
+	const struct checkpoint_change *a =
+		(const struct checkpoint_change *)a_ptr;
+	const struct checkpoint_change *b =
+		(const struct checkpoint_change *)b_ptr;
+	struct key_def *key_def = (struct key_def *)arg;
+	return key_compare(a->parts, a->part_count, HINT_NONE,
+			   b->parts, b->part_count, HINT_NONE, key_def);
+}
+
+/**
+ * Decodes the change log of a checkpoint. Returns a malloc'ed array
+ * sorted by space id.
+ */
+static struct checkpoint_change *
+checkpoint_decode_changes(struct checkpoint *ckpt, size_t *count)
+{
+	const char *data = ckpt->changes.rpos;
+	const char *data_end = ckpt->changes.wpos;
+	size_t n = 0;
+	for (const char *p = data; p < data_end; n++) {
+		mp_next(&p);
+		mp_next(&p);
+	}
+	*count = n;
+	if (n == 0)
+		return NULL;
+	struct checkpoint_change *changes =
+		(struct checkpoint_change *)xmalloc(n * sizeof(*changes));
+	for (size_t i = 0; i < n; i++) {
+		struct checkpoint_change *change = &changes[i];
+		change->space_id = mp_decode_uint(&data);
+		change->key = data;
+		change->part_count = mp_decode_array(&data);
+		change->parts = data;
+		data = change->key;
+		mp_next(&data);
+	}
+	assert(data == data_end);
+	qsort(changes, n, sizeof(*changes), checkpoint_change_cmp_space);
+	return changes;
+}
+
 static int
 checkpoint_write_raft(struct xlog *l, const struct raft_request *req)
 {
@@ -1241,8 +1684,8 @@ checkpoint_write_corrupted_insert_row(struct xlog *l)
 	char *p = mp_encode_array(buf, 10);
 	p = mp_encode_uint(p, 0);
 	assert((size_t)(p - buf) <= sizeof(buf));
-	return checkpoint_write_tuple(l, /*space_id=*/512, GROUP_DEFAULT,
-				      buf, p - buf);
+	return checkpoint_write_tuple(l, IPROTO_INSERT, /*space_id=*/512,
+				      GROUP_DEFAULT, buf, p - buf);
 }
 
 /** Writes an INSERT row for a missing space to the snapshot. */
@@ -1253,8 +1696,8 @@ checkpoint_write_missing_space_row(struct xlog *l)
 	char *p = mp_encode_array(buf, 1);
 	p = mp_encode_uint(p, 0);
 	assert((size_t)(p - buf) <= sizeof(buf));
-	return checkpoint_write_tuple(l, /*space_id=*/777, GROUP_DEFAULT,
-				      buf, p - buf);
+	return checkpoint_write_tuple(l, IPROTO_INSERT, /*space_id=*/777,
+				      GROUP_DEFAULT, buf, p - buf);
 }
 
 /** Writes a row with an unknown type to the snapshot. */
@@ -1293,6 +1736,89 @@ checkpoint_write_invalid_system_row(struct xlog *l)
 }
 #endif /* NDEBUG */
 
+/** Writes a DELETE row to an incremental snapshot. */
+static int
+checkpoint_write_delete(struct xlog *l, uint32_t space_id, uint32_t group_id,
+			const char *key, const char *key_end)
+{
+	struct request request;
+	memset(&request, 0, sizeof(request));
+	request.type = IPROTO_DELETE;
+	request.space_id = space_id;
+	request.key = key;
+	request.key_end = key_end;
+
+	struct xrow_header row;
+	memset(&row, 0, sizeof(row));
+	row.type = IPROTO_DELETE;
+	row.group_id = group_id;
+	RegionGuard region_guard(&fiber()->gc);
+	xrow_encode_dml(&request, &fiber()->gc, row.body, &row.bodycnt);
+	return checkpoint_write_row(l, &row);
+}
+
+/**
+ * Writes changes of a user space made since the previous checkpoint to
+ * an incremental snapshot: a REPLACE row for each changed key found in
+ * the read view and a DELETE row for each changed key not found in it.
+ * Each changed key is looked up in the primary key read view so the cost
+ * doesn't depend on the space size.
+ */
+static int
+checkpoint_write_space_delta(struct xlog *snap,
+			     struct space_read_view *space_rv,
+			     struct checkpoint_change *changes, size_t count,
+			     unsigned int yield_loops)
+{
+	if (count == 0)
+		return 0;
+	struct index_read_view *index_rv = space_read_view_index(space_rv, 0);
+	assert(index_rv != NULL);
+	struct key_def *key_def = index_rv->def->key_def;
+	/*
+	 * Sort the keys to remove duplicates. Looking them up in order
+	 * also improves the cache locality of a tree index.
+	 */
+	qsort_arg(changes, count, sizeof(*changes), checkpoint_change_cmp_key,
+		  key_def);
+	unsigned int loops = 0;
+	for (size_t i = 0; i < count; i++) {
+		struct checkpoint_change *change = &changes[i];
+		if (i > 0 && checkpoint_change_cmp_key(&changes[i - 1], change,
+						       key_def) == 0)
+			continue;
+		RegionGuard region_guard(&fiber()->gc);
+		struct read_view_tuple tuple;
+		if (index_read_view_get_raw(index_rv, change->parts,
+					    change->part_count, &tuple) != 0)
+			return -1;
+		if (tuple.data != NULL) {
+			if (checkpoint_write_tuple(snap, IPROTO_REPLACE,
+						   space_rv->id,
+						   space_rv->group_id,
+						   tuple.data,
+						   tuple.size) != 0)
+				return -1;
+		} else {
+			const char *key_end = change->key;
+			mp_next(&key_end);
+			if (checkpoint_write_delete(snap, space_rv->id,
+						    space_rv->group_id,
+						    change->key,
+						    key_end) != 0)
+				return -1;
+		}
+		/* Yield to make thread cancellable. */
+		if (++loops % yield_loops == 0)
+			fiber_sleep(0);
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			return -1;
+		}
+	}
+	return 0;
+}
+
 static int
 checkpoint_f(va_list ap)
 {
@@ -1315,8 +1841,15 @@ checkpoint_f(va_list ap)
 	if (ckpt->touch) {
 		if (xdir_touch_xlog(&ckpt->dir, &ckpt->vclock) == 0)
 			return 0;
-		/* Failed to touch an existing snapshot, create a new one. */
+		/*
+		 * Failed to touch an existing snapshot, create a new one.
+		 * It can't be incremental because it would be based on
+		 * the snapshot it replaces.
+		 */
 		ckpt->touch = false;
+		ckpt->is_delta = false;
+		ckpt->dir.store_prev_vclock = false;
+		ckpt->dir.is_delta = false;
 	}
 
 	struct xlog *snap = &ckpt->snap;
@@ -1343,6 +1876,12 @@ checkpoint_f(va_list ap)
 
 	struct mh_i32_t *temp_space_ids = mh_i32_new();
 	auto _ = make_scoped_guard([=] { mh_i32_delete(temp_space_ids); });
+	size_t change_count = 0;
+	size_t change_pos = 0;
+	struct checkpoint_change *changes = NULL;
+	if (ckpt->is_delta)
+		changes = checkpoint_decode_changes(ckpt, &change_count);
+	auto changes_guard = make_scoped_guard([=] { free(changes); });
 	bool is_synchro_written = false;
 	say_info("saving snapshot `%s'", snap->filename);
 	ERROR_INJECT_WHILE(ERRINJ_SNAP_WRITE_DELAY, {
@@ -1376,6 +1915,23 @@ checkpoint_f(va_list ap)
 			is_synchro_written = true;
 		}
 
+		/* Write only the changed tuples of user spaces, if allowed. */
+		if (ckpt->is_delta && !space_id_is_system(space_rv->id)) {
+			while (change_pos < change_count &&
+			       changes[change_pos].space_id < space_rv->id)
+				change_pos++;
+			size_t begin = change_pos;
+			while (change_pos < change_count &&
+			       changes[change_pos].space_id == space_rv->id)
+				change_pos++;
+			if (checkpoint_write_space_delta(
+					snap, space_rv, changes + begin,
+					change_pos - begin,
+					YIELD_LOOPS_SNAP) != 0)
+				return -1;
+			continue;
+		}
+
 		/*
 		 * Need to write PK tuple pointers to the sort data file if we
 		 * have the MemTX sort data enabled and at least one secondary
@@ -1415,7 +1971,8 @@ checkpoint_f(va_list ap)
 				continue;
 
 			/* Write the tuple into the snapshot. */
-			if (checkpoint_write_tuple(snap, space_rv->id,
+			if (checkpoint_write_tuple(snap, IPROTO_INSERT,
+						   space_rv->id,
 						   space_rv->group_id,
 						   tuple.data, tuple.size) != 0)
 				return -1;
@@ -1590,6 +2147,24 @@ memtx_engine_commit_checkpoint(struct engine *engine,
 		xdir_add_vclock(&memtx->snap_dir, &memtx->checkpoint->vclock);
 	}
 
+	struct checkpoint *ckpt = memtx->checkpoint;
+	if (ckpt->touch) {
+		/*
+		 * No snapshot was written, so the changes logged for it
+		 * go to the next one.
+		 */
+		size_t size = ibuf_used(&ckpt->changes);
+		void *buf = ibuf_alloc(&memtx->checkpoint_changes, size);
+		if (buf != NULL)
+			memcpy(buf, ckpt->changes.rpos, size);
+		else
+			memtx->checkpoint_need_full = true;
+	} else if (ckpt->is_delta) {
+		memtx->checkpoint_delta_count++;
+	} else {
+		memtx->checkpoint_delta_count = 0;
+	}
+
 	checkpoint_delete(memtx->checkpoint);
 	memtx->checkpoint = NULL;
 }
@@ -1616,14 +2191,25 @@ memtx_engine_abort_checkpoint(struct engine *engine)
 	coio_call(memtx_engine_abort_checkpoint_f, memtx->checkpoint);
 	checkpoint_delete(memtx->checkpoint);
 	memtx->checkpoint = NULL;
+	/* The changes logged for the checkpoint are lost. */
+	memtx->checkpoint_need_full = true;
 }
 
 static void
 memtx_engine_collect_garbage(struct engine *engine, const struct vclock *vclock)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
-	xdir_collect_garbage(&memtx->snap_dir, vclock_sum(vclock),
-			     XDIR_GC_ASYNC);
+	/* Keep the snapshots an incremental checkpoint is based on. */
+	int64_t *chain;
+	int len;
+	if (memtx_engine_snap_chain(memtx, vclock_sum(vclock),
+				    &chain, &len) != 0) {
+		diag_log();
+		return;
+	}
+	int64_t signature = chain[0];
+	free(chain);
+	xdir_collect_garbage(&memtx->snap_dir, signature, XDIR_GC_ASYNC);
 }
 
 static int
@@ -1631,17 +2217,27 @@ memtx_engine_backup(struct engine *engine, const struct vclock *vclock,
 		    engine_backup_cb cb, void *cb_arg)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
-
-	/* Backup the .snap file. */
-	const char *snap_filename = xdir_format_filename(&memtx->snap_dir,
-							 vclock_sum(vclock));
-	if (cb(snap_filename, cb_arg) != 0)
+	/* An incremental checkpoint needs all snapshots it's based on. */
+	int64_t *chain;
+	int len;
+	if (memtx_engine_snap_chain(memtx, vclock_sum(vclock),
+				    &chain, &len) != 0)
 		return -1;
+	auto guard = make_scoped_guard([=] { free(chain); });
+	for (int i = 0; i < len; i++) {
+		/* Backup the .snap file. */
+		const char *snap_filename =
+			xdir_format_filename(&memtx->snap_dir, chain[i]);
+		if (cb(snap_filename, cb_arg) != 0)
+			return -1;
 
-	/* Backup the corresponding .sortdata file if exists. */
-	const char *sortdata_filename = memtx_sort_data_filename(snap_filename);
-	if (access(sortdata_filename, F_OK) == 0)
-		return cb(sortdata_filename, cb_arg);
+		/* Backup the corresponding .sortdata file if exists. */
+		const char *sortdata_filename =
+			memtx_sort_data_filename(snap_filename);
+		if (access(sortdata_filename, F_OK) == 0 &&
+		    cb(sortdata_filename, cb_arg) != 0)
+			return -1;
+	}
 	return 0;
 }
 
@@ -1919,8 +2515,9 @@ memtx_tuple_validate(struct tuple_format *format, struct tuple *tuple)
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		 bool dontdump, unsigned granularity,
-		 const char *allocator, float alloc_factor, int sort_threads,
+		 bool dontdump, const struct memtx_arena_opts *arena_opts,
+		 unsigned granularity, const char *allocator,
+		 float alloc_factor, int sort_threads,
 		 memtx_on_indexes_built_cb on_indexes_built)
 {
 	int64_t snap_signature;
@@ -1983,6 +2580,9 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		goto fail;
 	fiber_set_joinable(memtx->gc_fiber, true);
 
+	if (memtx_defrag_create(&memtx->defrag, allocator) != 0)
+		goto fail;
+
 	/*
 	 * Currently we have two quota consumers: tuple and index allocators.
 	 * The first one uses either SystemAlloc or memtx->slab_cache (in case
@@ -2026,6 +2626,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	quota_init(&memtx->quota, tuple_arena_max_size);
 	tuple_arena_create(&memtx->arena, &memtx->quota, tuple_arena_max_size,
 			   SLAB_SIZE, dontdump, "memtx");
+	memtx_arena_apply_opts(&memtx->arena, arena_opts);
 	slab_cache_create(&memtx->slab_cache, &memtx->arena);
 	float actual_alloc_factor;
 	allocator_settings alloc_settings;
@@ -2079,7 +2680,17 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	}
 	memtx->sort_threads = sort_threads;
 	memtx->recovery.last_space_id = BOX_ID_NIL;
+	memtx->recovery.build_fiber = NULL;
 	memtx->recovery.sort_data_reader = NULL;
+	memtx->recovery.snap_chain = NULL;
+	memtx->recovery.snap_chain_len = 0;
+
+	memtx->checkpoint_delta_max = 0;
+	memtx->checkpoint_delta_count = 0;
+	/* The recovered state isn't logged. */
+	memtx->checkpoint_need_full = true;
+	ibuf_create(&memtx->checkpoint_changes, cord_slab_cache(),
+		    MEMTX_CHECKPOINT_CHANGES_IBUF_SIZE);
 
 	memtx->base.vtab = &memtx_engine_vtab;
 	memtx->base.name = "memtx";
@@ -2101,6 +2712,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->use_sort_data = false;
 
 	fiber_start(memtx->gc_fiber, memtx);
+	memtx_defrag_start(&memtx->defrag, memtx);
 	return memtx;
 fail:
 	xdir_destroy(&memtx->snap_dir);
@@ -2208,6 +2820,7 @@ memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h)
 	memtx_engine_stat_data(memtx, h);
 	memtx_engine_stat_index(memtx, h);
 	memtx_engine_stat_tx(memtx, h);
+	memtx_defrag_stat(&memtx->defrag, h);
 	info_end(h);
 }
 
@@ -2254,6 +2867,44 @@ memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size)
 	memtx->max_tuple_size = max_size;
 }
 
+void
+memtx_engine_set_checkpoint_delta_count(struct memtx_engine *memtx,
+					int count)
+{
+	/* Changes aren't logged while incremental snapshots are disabled. */
+	if (memtx->checkpoint_delta_max == 0 && count > 0)
+		memtx->checkpoint_need_full = true;
+	memtx->checkpoint_delta_max = count;
+}
+
+void
+memtx_engine_log_change_slow(struct memtx_engine *memtx, struct space *space,
+			     struct tuple *tuple)
+{
+	assert(memtx->checkpoint_delta_max > 0);
+	assert(!memtx->checkpoint_need_full);
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL)
+		return;
+	RegionGuard region_guard(&fiber()->gc);
+	uint32_t id = space_id(space);
+	uint32_t key_size;
+	const char *key = tuple_extract_key(tuple, pk->def->key_def,
+					    MULTIKEY_NONE, &key_size);
+	char *buf = NULL;
+	if (key != NULL) {
+		buf = (char *)ibuf_alloc(&memtx->checkpoint_changes,
+					 mp_sizeof_uint(id) + key_size);
+	}
+	if (buf == NULL) {
+		/* Fall back on a full snapshot rather than fail the change. */
+		memtx->checkpoint_need_full = true;
+		return;
+	}
+	buf = mp_encode_uint(buf, id);
+	memcpy(buf, key, key_size);
+}
+
 template<class ALLOC>
 static struct tuple *
 memtx_tuple_new_raw_impl(struct tuple_format *format, const char *data,
@@ -2481,6 +3132,11 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.hint != new_def->opts.hint)
 		return true;
+	if ((old_def->opts.layout == NULL) != (new_def->opts.layout == NULL))
+		return true;
+	if (old_def->opts.layout != NULL &&
+	    strcmp(old_def->opts.layout, new_def->opts.layout) != 0)
+		return true;
 
 	const struct key_def *old_cmp_def, *new_cmp_def;
 	if (index_depends_on_pk(index)) {
@@ -2552,7 +3208,8 @@ memtx_prepare_read_view_tuple(struct tuple *tuple,
 					index->space->upgrade, tuple);
 	result->data = tuple_data_range(tuple, &result->size);
 	result->ptr = tuple;
-	if (!index->space->rv->disable_decompression) {
+	if (tuple_is_compressed(tuple) &&
+	    !index->space->rv->disable_decompression) {
 		result->data = memtx_tuple_decompress_raw(
 				result->data, result->data + result->size,
 				&result->size);
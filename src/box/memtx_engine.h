@@ -37,11 +37,14 @@
 #include <small/small.h>
 #include <small/mempool.h>
 #include <small/matras.h>
+#include <small/ibuf.h>
 
 #include "engine.h"
 #include "xlog.h"
 #include "salad/stailq.h"
 #include "sysalloc.h"
+#include "memtx_arena.h"
+#include "memtx_defrag.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -54,6 +57,7 @@ struct info_handler;
 struct iterator;
 struct fiber;
 struct read_view_tuple;
+struct space;
 struct tuple;
 struct tuple_format;
 struct memtx_tx_snapshot_cleaner;
@@ -98,7 +102,7 @@ enum memtx_recovery_state {
  * allocated for each iterator (except rtree index iterator that
  * is significantly bigger so has own pool).
  */
-#define MEMTX_ITERATOR_SIZE (184)
+#define MEMTX_ITERATOR_SIZE (200)
 
 typedef void
 (*memtx_on_indexes_built_cb)(void);
@@ -117,6 +121,24 @@ struct memtx_engine {
 	bool force_recovery;
 	/** Save and load the sort data. */
 	bool use_sort_data;
+	/**
+	 * Max number of incremental snapshots written after a full one,
+	 * box.cfg.memtx_checkpoint_delta_count. 0 disables them.
+	 */
+	int checkpoint_delta_max;
+	/** Number of incremental snapshots written since the last full one. */
+	int checkpoint_delta_count;
+	/**
+	 * Set if the change log doesn't cover all changes made since the
+	 * last checkpoint was started, so the next one must be full.
+	 */
+	bool checkpoint_need_full;
+	/**
+	 * Keys of tuples changed since the last checkpoint was started,
+	 * used to write the next snapshot incrementally. Each entry is
+	 * a space id followed by a primary key, both encoded in MsgPack.
+	 */
+	struct ibuf checkpoint_changes;
 	/**
 	 * A callback run once memtx engine builds secondary indexes for the
 	 * data.
@@ -161,6 +183,8 @@ struct memtx_engine {
 	 * memtx_gc_task::link.
 	 */
 	struct stailq gc_queue;
+	/** Background tuple defragmenter. */
+	struct memtx_defrag defrag;
 	/**
 	 * Format used for allocating functional index keys.
 	 */
@@ -178,6 +202,19 @@ struct memtx_engine {
 		uint32_t last_space_id;
 		/** The memtx index sort data reader. */
 		struct memtx_sort_data_reader *sort_data_reader;
+		/**
+		 * Fiber building the primary key of the previous space
+		 * while the next one is being loaded. May be NULL.
+		 */
+		struct fiber *build_fiber;
+		/**
+		 * Signatures of the snapshots the recovered checkpoint
+		 * consists of, starting with the full one. The incremental
+		 * snapshots following it are applied on the final recovery.
+		 */
+		int64_t *snap_chain;
+		/** Number of entries in the snapshot chain. */
+		int snap_chain_len;
 	} recovery;
 };
 
@@ -213,8 +250,9 @@ memtx_engine_schedule_gc(struct memtx_engine *memtx,
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		 bool dontdump, unsigned granularity,
-		 const char *allocator, float alloc_factor, int threads_num,
+		 bool dontdump, const struct memtx_arena_opts *arena_opts,
+		 unsigned granularity, const char *allocator,
+		 float alloc_factor, int threads_num,
 		 memtx_on_indexes_built_cb on_indexes_built);
 
 /**
@@ -230,6 +268,26 @@ memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h);
 int
 memtx_end_build_snapshot_space(struct memtx_engine *memtx, uint32_t space_id);
 
+/**
+ * Same as memtx_end_build_snapshot_space(), but if possible, the primary key
+ * is built in a background fiber so that loading of the next space from the
+ * snapshot overlaps with sorting the keys of this one in the sort threads.
+ * The build is synchronous if loading rows into this space or @a next_space,
+ * the space to be loaded next, may run triggers. Waits for the previous
+ * background build to complete. Yields.
+ */
+int
+memtx_end_build_snapshot_space_async(struct memtx_engine *memtx,
+				     uint32_t space_id,
+				     struct space *next_space);
+
+/**
+ * Wait for the background build started with
+ * memtx_end_build_snapshot_space_async() to complete. Yields.
+ */
+void
+memtx_wait_build_snapshot_space(struct memtx_engine *memtx);
+
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock);
@@ -249,6 +307,34 @@ memtx_engine_set_use_sort_data(struct memtx_engine *memtx, bool value);
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size);
 
+/**
+ * The box.cfg.memtx_checkpoint_delta_count field update handler.
+ */
+void
+memtx_engine_set_checkpoint_delta_count(struct memtx_engine *memtx,
+					int count);
+
+/** Slow path of memtx_engine_log_change(). */
+void
+memtx_engine_log_change_slow(struct memtx_engine *memtx, struct space *space,
+			     struct tuple *tuple);
+
+/**
+ * Log a change of a tuple in a space so that the next snapshot can be
+ * written incrementally. The tuple is only used to extract the primary
+ * key. Must be called for every tuple inserted into or removed from the
+ * primary key of a space that is written to snapshots, including the
+ * rollback of such changes.
+ */
+static inline void
+memtx_engine_log_change(struct memtx_engine *memtx, struct space *space,
+			struct tuple *tuple)
+{
+	if (memtx->checkpoint_delta_max == 0 || memtx->checkpoint_need_full)
+		return;
+	memtx_engine_log_change_slow(memtx, space, tuple);
+}
+
 /** Tuple format vtab for memtx engine. */
 extern struct tuple_format_vtab memtx_tuple_format_vtab;
 
@@ -360,15 +446,16 @@ memtx_tuple_validate(struct tuple_format *format, struct tuple *tuple);
 static inline struct memtx_engine *
 memtx_engine_new_xc(const char *snap_dirname, bool force_recovery,
 		    uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		    bool dontdump, unsigned granularity,
-		    const char *allocator, float alloc_factor,
-		    int sort_threads,
+		    bool dontdump, const struct memtx_arena_opts *arena_opts,
+		    unsigned granularity, const char *allocator,
+		    float alloc_factor, int sort_threads,
 		    memtx_on_indexes_built_cb on_indexes_built)
 {
 	struct memtx_engine *memtx;
 	memtx = memtx_engine_new(snap_dirname, force_recovery,
 				 tuple_arena_max_size, objsize_min, dontdump,
-				 granularity, allocator, alloc_factor,
+				 arena_opts, granularity, allocator,
+				 alloc_factor,
 				 sort_threads, on_indexes_built);
 	if (memtx == NULL)
 		diag_raise();
@@ -77,11 +77,22 @@ memtx_hash_equal_key(struct tuple *tuple, const char *key,
 #undef LIGHT_EQUAL
 #undef LIGHT_EQUAL_KEY
 
+/** Element of the array used for building a hash index in bulk. */
+struct memtx_hash_build_data {
+	/** Indexed tuple. */
+	struct tuple *tuple;
+	/** Tuple hash, calculated on the end of build. */
+	uint32_t hash;
+};
+
 struct memtx_hash_index {
 	struct index base;
 	struct light_index_core hash_table;
 	struct memtx_gc_task gc_task;
 	struct light_index_iterator gc_iterator;
+	/** Tuples collected on build, see memtx_hash_index_end_build(). */
+	struct memtx_hash_build_data *build_array;
+	size_t build_array_size, build_array_alloc_size;
 };
 
 /* {{{ MemtxHash Iterators ****************************************/
@@ -189,6 +200,7 @@ static void
 memtx_hash_index_free(struct memtx_hash_index *index)
 {
 	light_index_destroy(&index->hash_table);
+	free(index->build_array);
 	free(index);
 }
 
@@ -320,6 +332,17 @@ memtx_hash_index_count(struct index *base, enum iterator_type type,
 	return generic_index_count(base, type, key, part_count);
 }
 
+static void
+memtx_hash_index_prefetch(struct index *base, const char *key,
+			  uint32_t part_count)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	assert(part_count == base->def->key_def->part_count);
+	(void)part_count;
+	uint32_t h = key_hash(key, base->def->key_def);
+	light_index_prefetch(&index->hash_table, h);
+}
+
 static int
 memtx_hash_index_get_internal(struct index *base, const char *key,
 			      uint32_t part_count, struct tuple **result)
@@ -597,17 +620,25 @@ hash_read_view_free(struct index_read_view *base)
 # include "memtx_hash_read_view.cc"
 #else /* !defined(ENABLE_READ_VIEW) */
 
+/** Implementation of get_raw index_read_view callback. */
 static int
-hash_read_view_get_raw(struct index_read_view *rv,
+hash_read_view_get_raw(struct index_read_view *base,
 		       const char *key, uint32_t part_count,
 		       struct read_view_tuple *result)
 {
-	(void)rv;
-	(void)key;
+	struct hash_read_view *rv = (struct hash_read_view *)base;
+	assert(base->def->opts.is_unique &&
+	       part_count == base->def->key_def->part_count);
 	(void)part_count;
-	(void)result;
-	unreachable();
-	return 0;
+	uint32_t h = key_hash(key, base->def->key_def);
+	uint32_t k = light_index_view_find_key(&rv->view, h, key);
+	if (k == light_index_end) {
+		*result = read_view_tuple_none();
+		return 0;
+	}
+	struct tuple *tuple = light_index_view_get(&rv->view, k);
+	return memtx_prepare_read_view_tuple(tuple, base, &rv->cleaner,
+					     result);
 }
 
 /** Implementation of next_raw index_read_view_iterator callback. */
@@ -653,10 +684,14 @@ hash_read_view_iterator_start(struct hash_read_view_iterator *it,
 	return 0;
 }
 
+/**
+ * Make the hash table view use the key definition owned by the read view,
+ * because the index key definition may be freed on alter.
+ */
 static void
 hash_read_view_reset_key_def(struct hash_read_view *rv)
 {
-	rv->view.common.arg = NULL;
+	rv->view.common.arg = rv->base.def->key_def;
 }
 
 #endif /* !defined(ENABLE_READ_VIEW) */
@@ -732,6 +767,7 @@ static const struct index_vtab memtx_hash_index_vtab_base = {
 	/* .count = */ memtx_hash_index_count,
 	/* .get_internal = */ memtx_hash_index_get_internal,
 	/* .get = */ memtx_index_get,
+	/* .prefetch = */ memtx_hash_index_prefetch,
 	/* .create_iterator = */ memtx_hash_index_create_iterator,
 	/* .create_iterator_with_offset = */
 	generic_index_create_iterator_with_offset,
@@ -742,13 +778,188 @@ static const struct index_vtab memtx_hash_index_vtab_base = {
 	/* .reset_stat = */ generic_index_reset_stat,
 };
 
+/**
+ * If the number of tuples to build the index from is less than this,
+ * hashes are calculated in the calling thread.
+ */
+enum { MEMTX_HASH_BUILD_NOSPAWN_THRESHOLD = 1024 };
+
+/**
+ * How many tuples ahead of the one being inserted on the bulk build
+ * the hash table buckets are prefetched.
+ */
+enum { MEMTX_HASH_BUILD_PREFETCH_DISTANCE = 8 };
+
+/** Thread calculating hashes of a part of the build array. */
+struct memtx_hash_build_worker {
+	/** The worker cord. */
+	struct cord cord;
+	/** Tuple formats inherited from the TX thread. */
+	struct tuple_format **formats;
+	/** Key definition used to calculate hashes. */
+	struct key_def *key_def;
+	/** Part of the build array processed by this thread. */
+	struct memtx_hash_build_data *begin, *end;
+};
+
+/** Calculate hashes of a part of the build array. */
+static void
+memtx_hash_build_calc(struct memtx_hash_build_data *begin,
+		      struct memtx_hash_build_data *end,
+		      struct key_def *key_def)
+{
+	for (struct memtx_hash_build_data *d = begin; d < end; d++)
+		d->hash = tuple_hash(d->tuple, key_def);
+}
+
+static int
+memtx_hash_build_worker_f(va_list ap)
+{
+	struct memtx_hash_build_worker *worker =
+		va_arg(ap, struct memtx_hash_build_worker *);
+	tuple_formats_inherit(worker->formats);
+	memtx_hash_build_calc(worker->begin, worker->end, worker->key_def);
+	return 0;
+}
+
+/**
+ * Calculate hashes of all the tuples in the build array in
+ * `memtx_sort_threads` threads. Yields while waiting for the threads.
+ */
+static void
+memtx_hash_build_calc_mt(struct memtx_hash_index *index)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)index->base.engine;
+	struct key_def *key_def = index->base.def->key_def;
+	struct memtx_hash_build_data *data = index->build_array;
+	size_t size = index->build_array_size;
+	int thread_count = memtx->sort_threads;
+	if (size < MEMTX_HASH_BUILD_NOSPAWN_THRESHOLD) {
+		memtx_hash_build_calc(data, data + size, key_def);
+		return;
+	}
+	assert(thread_count > 0);
+	struct memtx_hash_build_worker *workers =
+		(struct memtx_hash_build_worker *)
+			xmalloc(thread_count * sizeof(*workers));
+	size_t part_size = DIV_ROUND_UP(size, thread_count);
+	for (int i = 0; i < thread_count; i++) {
+		struct memtx_hash_build_worker *worker = &workers[i];
+		worker->formats = tuple_formats;
+		worker->key_def = key_def;
+		worker->begin = data + MIN(i * part_size, size);
+		worker->end = data + MIN((i + 1) * part_size, size);
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "hash.worker.%d", i);
+		if (cord_costart(&worker->cord, name,
+				 memtx_hash_build_worker_f, worker) != 0) {
+			diag_log();
+			panic("cord_start failed");
+		}
+	}
+	for (int i = 0; i < thread_count; i++) {
+		if (cord_cojoin(&workers[i].cord) != 0) {
+			diag_log();
+			panic("cord_cojoin failed");
+		}
+	}
+	free(workers);
+}
+
+static int
+memtx_hash_index_reserve(struct index *base, uint32_t size_hint)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	if (size_hint < index->build_array_alloc_size)
+		return 0;
+	struct memtx_hash_build_data *tmp = (struct memtx_hash_build_data *)
+		realloc(index->build_array, size_hint * sizeof(*tmp));
+	if (tmp == NULL) {
+		diag_set(OutOfMemory, size_hint * sizeof(*tmp),
+			 "memtx_hash_index", "reserve");
+		return -1;
+	}
+	index->build_array = tmp;
+	index->build_array_alloc_size = size_hint;
+	return 0;
+}
+
+static int
+memtx_hash_index_build_next(struct index *base, struct tuple *tuple)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	if (index->build_array_size == index->build_array_alloc_size) {
+		size_t size = index->build_array_alloc_size == 0 ?
+			      MEMTX_EXTENT_SIZE / sizeof(index->build_array[0]) :
+			      index->build_array_alloc_size +
+			      DIV_ROUND_UP(index->build_array_alloc_size, 2);
+		if (memtx_hash_index_reserve(base, size) != 0)
+			return -1;
+	}
+	struct memtx_hash_build_data *elem =
+		&index->build_array[index->build_array_size++];
+	elem->tuple = tuple;
+	return 0;
+}
+
+/**
+ * Hashes of the collected tuples are calculated in parallel and then
+ * the tuples are inserted into the hash table without lookups. Like
+ * the bulk build of a tree index, it relies on the tuples being unique,
+ * which is true for tuples recovered from a snapshot. Since the hashes
+ * are known in advance, the buckets of the tuples inserted next are
+ * prefetched to overlap their cache misses with the current insertion.
+ */
+static void
+memtx_hash_index_end_build(struct index *base)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	memtx_hash_build_calc_mt(index);
+	for (size_t i = 0; i < index->build_array_size; i++) {
+		struct memtx_hash_build_data *d = &index->build_array[i];
+		size_t ahead = i + MEMTX_HASH_BUILD_PREFETCH_DISTANCE;
+		if (ahead < index->build_array_size)
+			light_index_prefetch(&index->hash_table,
+					     index->build_array[ahead].hash);
+		assert(light_index_find(&index->hash_table, d->hash,
+					d->tuple) == light_index_end);
+		if (light_index_insert(&index->hash_table, d->hash,
+				       d->tuple) == light_index_end) {
+			diag_log();
+			panic("failed to build hash index '%s' of space '%s'",
+			      base->def->name, base->def->space_name);
+		}
+	}
+	free(index->build_array);
+	index->build_array = NULL;
+	index->build_array_size = 0;
+	index->build_array_alloc_size = 0;
+}
+
+static void
+memtx_hash_index_relocate(struct index *base, struct tuple *old_tuple,
+			  struct tuple *new_tuple)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	uint32_t h = tuple_hash(new_tuple, base->def->key_def);
+	struct tuple *replaced = NULL;
+	/* The tuples are equal so the entry of the old one is replaced. */
+	uint32_t pos = light_index_replace(&index->hash_table, h, new_tuple,
+					   &replaced);
+	assert(pos != light_index_end && replaced == old_tuple);
+	(void)pos;
+	(void)old_tuple;
+	(void)replaced;
+}
+
 static const struct memtx_index_vtab memtx_hash_index_vtab = {
 	/* .base = */ memtx_hash_index_vtab_base,
 	/* .replace = */ memtx_hash_index_replace,
 	/* .begin_build = */ generic_memtx_index_begin_build,
-	/* .reserve = */ generic_memtx_index_reserve,
-	/* .build_next = */ generic_memtx_index_build_next,
-	/* .end_build = */ generic_memtx_index_end_build,
+	/* .reserve = */ memtx_hash_index_reserve,
+	/* .build_next = */ memtx_hash_index_build_next,
+	/* .end_build = */ memtx_hash_index_end_build,
+	/* .relocate = */ memtx_hash_index_relocate,
 };
 
 struct index *
@@ -45,6 +45,16 @@ struct memtx_index_vtab {
 	int (*build_next)(struct index *index, struct tuple *tuple);
 	/** Finish index build. */
 	void (*end_build)(struct index *index);
+	/**
+	 * Make the index refer to @a new_tuple instead of @a old_tuple,
+	 * which is a byte-wise copy of it, without changing the position
+	 * of the entry. Used by the memtx defragmenter to move tuples in
+	 * memory. Never fails: the caller guarantees that there's no open
+	 * read view so the index memory can be modified in place.
+	 * NULL if the index doesn't support tuple relocation.
+	 */
+	void (*relocate)(struct index *index, struct tuple *old_tuple,
+			 struct tuple *new_tuple);
 };
 
 static inline int
@@ -85,6 +95,23 @@ memtx_index_end_build(struct index *index)
 	vtab->end_build(index);
 }
 
+/** Check if the index supports the `relocate' operation. */
+static inline bool
+memtx_index_supports_relocate(struct index *index)
+{
+	struct memtx_index_vtab *vtab = (struct memtx_index_vtab *)index->vtab;
+	return vtab->relocate != NULL;
+}
+
+static inline void
+memtx_index_relocate(struct index *index, struct tuple *old_tuple,
+		     struct tuple *new_tuple)
+{
+	struct memtx_index_vtab *vtab = (struct memtx_index_vtab *)index->vtab;
+	assert(vtab->relocate != NULL);
+	vtab->relocate(index, old_tuple, new_tuple);
+}
+
 /** No-op stub for the `begin_build` operation. */
 void
 generic_memtx_index_begin_build(struct index *index);
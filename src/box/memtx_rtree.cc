@@ -413,6 +413,7 @@ static const struct index_vtab memtx_rtree_index_vtab_base = {
 	/* .count = */ memtx_rtree_index_count,
 	/* .get_internal = */ memtx_rtree_index_get_internal,
 	/* .get = */ memtx_index_get,
+	/* .prefetch = */ generic_index_prefetch,
 	/* .create_iterator = */ memtx_rtree_index_create_iterator,
 	/* .create_iterator_with_offset = */
 	generic_index_create_iterator_with_offset,
@@ -430,6 +431,7 @@ static const struct memtx_index_vtab memtx_rtree_index_vtab = {
 	/* .reserve = */ memtx_rtree_index_reserve,
 	/* .build_next = */ generic_memtx_index_build_next,
 	/* .end_build = */ generic_memtx_index_end_build,
+	/* .relocate = */ NULL,
 };
 
 struct index *
@@ -66,9 +66,27 @@ enum { MEMTX_DDL_YIELD_LOOPS = 1000 };
 enum { MEMTX_DDL_YIELD_LOOPS = 10 };
 #endif
 
+/**
+ * Min number of tuples in a space for a new TREE index to be built by
+ * sorting the tuples in the memtx sort threads rather than by inserting
+ * them into the index one by one. Starting the threads isn't worth it
+ * for small spaces.
+ */
+enum { MEMTX_DDL_SORT_MIN_TUPLES = 10000 };
+
 static void
 memtx_space_destroy(struct space *space)
 {
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	/*
+	 * The space is destroyed when it's dropped or altered, including
+	 * truncation. Such changes aren't logged tuple by tuple.
+	 */
+	if (memtx_space->has_change_log) {
+		struct memtx_engine *memtx =
+			(struct memtx_engine *)space->engine;
+		memtx->checkpoint_need_full = true;
+	}
 	TRASH(space);
 	free(space);
 }
@@ -91,6 +109,12 @@ memtx_space_update_tuple_stat(struct space *space, struct tuple *old_tuple,
 	struct memtx_space *memtx_space = (struct memtx_space *)space;
 	struct tuple_info info, *stat;
 
+	if (memtx_space->has_change_log) {
+		memtx_engine_log_change((struct memtx_engine *)space->engine,
+					space, new_tuple != NULL ?
+					new_tuple : old_tuple);
+	}
+
 	if (new_tuple != NULL) {
 		tuple_info(new_tuple, &info);
 
@@ -156,8 +180,9 @@ memtx_space_replace_build_next(struct space *space, struct tuple *old_tuple,
 	if (memtx->recovery.last_space_id != space->def->id) {
 		/* Build PK and possibly SKs of the previous space. */
 		if (memtx->recovery.last_space_id != BOX_ID_NIL &&
-		    memtx_end_build_snapshot_space(
-				memtx, memtx->recovery.last_space_id) != 0)
+		    memtx_end_build_snapshot_space_async(
+				memtx, memtx->recovery.last_space_id,
+				space) != 0)
 			return -1;
 
 		/* Use the sort data for secondary keys if required. */
@@ -788,6 +813,90 @@ memtx_space_recover_snapshot_row(struct space *space, struct request *request)
 	return rc;
 }
 
+int
+memtx_space_recover_delta_row(struct space *space, struct request *request)
+{
+	assert(request->type == IPROTO_REPLACE ||
+	       request->type == IPROTO_DELETE);
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL) {
+		diag_set(ClientError, ER_NO_SUCH_INDEX_ID, 0,
+			 space_name(space));
+		return -1;
+	}
+	/*
+	 * Secondary keys are normally built after all incremental
+	 * snapshots are applied, but in case of force recovery they
+	 * are enabled from the start and must be updated, too.
+	 */
+	uint32_t index_count =
+		memtx_space->replace == memtx_space_replace_all_keys ?
+		space->index_count : 1;
+	int rc = -1;
+	struct tuple *unused;
+	struct tuple *old_tuple = NULL;
+	struct tuple *new_tuple = NULL;
+	struct tuple *new_index_tuple = NULL;
+	if (request->type == IPROTO_DELETE) {
+		const char *key = request->key;
+		uint32_t part_count = mp_decode_array(&key);
+		if (exact_key_validate(pk->def, key, part_count) != 0)
+			return -1;
+		if (index_get_internal(pk, key, part_count, &old_tuple) != 0)
+			return -1;
+		if (old_tuple == NULL)
+			return 0;
+	} else {
+		new_tuple = space->format->vtab.tuple_new(
+			space->format, request->tuple, request->tuple_end);
+		if (new_tuple == NULL) {
+			error_set_space(diag_last_error(diag_get()),
+					space->def);
+			return -1;
+		}
+		tuple_ref(new_tuple);
+		new_index_tuple = memtx_space_prepare_index_tuple(
+			space->format, new_tuple);
+		if (new_index_tuple == NULL)
+			goto out;
+		tuple_ref(new_index_tuple);
+	}
+	for (uint32_t i = 0; i < index_count; i++) {
+		struct tuple *replaced;
+		if (memtx_index_replace(space->index[i], old_tuple,
+					new_index_tuple,
+					i == 0 ? DUP_REPLACE_OR_INSERT :
+					DUP_INSERT, &replaced, &unused) != 0) {
+			for (; i > 0; i--) {
+				VERIFY(memtx_index_replace(
+					space->index[i - 1], new_index_tuple,
+					old_tuple, DUP_INSERT, &unused,
+					&unused) == 0);
+			}
+			goto out;
+		}
+		if (i == 0)
+			old_tuple = replaced;
+	}
+	memtx_space_update_tuple_stat(space, old_tuple, new_index_tuple);
+	if (new_index_tuple != NULL) {
+		tuple_ref(new_index_tuple);
+		if (space->upgrade != NULL)
+			memtx_space_upgrade_track_tuple(space->upgrade,
+							new_index_tuple);
+	}
+	if (old_tuple != NULL)
+		tuple_unref(old_tuple);
+	rc = 0;
+out:
+	if (new_tuple != NULL)
+		tuple_unref(new_tuple);
+	if (new_index_tuple != NULL)
+		tuple_unref(new_index_tuple);
+	return rc;
+}
+
 /* }}} DML */
 
 /* {{{ DDL */
@@ -929,11 +1038,9 @@ memtx_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "covering index");
 		return -1;
 	}
-	if (index_def->opts.layout != NULL) {
-		diag_set(ClientError, ER_UNSUPPORTED, "memtx",
-			 "'layout' option");
+	if (index_def->opts.layout != NULL &&
+	    memtx_tree_index_check_layout(index_def, space_name(space)) != 0)
 		return -1;
-	}
 	if (index_def->opts.aggregates != NULL) {
 		diag_set(ClientError, ER_UNSUPPORTED, "memtx",
 			 "'aggregates' option");
@@ -1065,10 +1172,96 @@ struct memtx_ddl_state {
 	 * gone wrong.
 	 */
 	struct rlist stmt_triggers;
+	/*
+	 * Set if the index is built by sorting the collected tuples.
+	 * Concurrent changes can't be applied to the index then so they
+	 * are logged in the changes array to be merged into the index
+	 * once it's built.
+	 */
+	bool is_sorted_build;
+	/*
+	 * Set when all tuples of the space have been collected for
+	 * a sorted build, so all concurrent changes must be logged.
+	 */
+	bool is_collected;
+	/* Changes logged during a sorted build, in order. */
+	struct memtx_ddl_change *changes;
+	/* Number of elements in the changes array. */
+	uint32_t change_count;
+	/* Number of elements allocated for the changes array. */
+	uint32_t change_capacity;
 	struct diag diag;
 	int rc;
 };
 
+/* A change of a space made during a sorted index build. */
+struct memtx_ddl_change {
+	/* Replaced tuple or NULL. Referenced. */
+	struct tuple *old_tuple;
+	/* Inserted tuple or NULL. Referenced. */
+	struct tuple *new_tuple;
+};
+
+/* Log a change made during a sorted index build. */
+static void
+memtx_ddl_state_log_change(struct memtx_ddl_state *state,
+			   struct tuple *old_tuple, struct tuple *new_tuple)
+{
+	assert(state->is_sorted_build);
+	if (state->change_count == state->change_capacity) {
+		state->change_capacity = MAX(state->change_capacity * 2, 16);
+		state->changes = xrealloc(state->changes,
+					  state->change_capacity *
+					  sizeof(*state->changes));
+	}
+	struct memtx_ddl_change *change = &state->changes[state->change_count++];
+	change->old_tuple = old_tuple;
+	change->new_tuple = new_tuple;
+	if (old_tuple != NULL)
+		tuple_ref(old_tuple);
+	if (new_tuple != NULL)
+		tuple_ref(new_tuple);
+}
+
+/* Drop the changes logged during a sorted index build. */
+static void
+memtx_ddl_state_clear_changes(struct memtx_ddl_state *state)
+{
+	for (uint32_t i = 0; i < state->change_count; i++) {
+		struct memtx_ddl_change *change = &state->changes[i];
+		if (change->old_tuple != NULL)
+			tuple_unref(change->old_tuple);
+		if (change->new_tuple != NULL)
+			tuple_unref(change->new_tuple);
+	}
+	state->change_count = 0;
+}
+
+/*
+ * Apply the changes logged during a sorted index build to the index.
+ * Never yields so no new changes can be logged meanwhile. The index
+ * must be free of duplicates for the unique constraint to be checked
+ * correctly.
+ */
+static int
+memtx_ddl_state_merge_changes(struct memtx_ddl_state *state)
+{
+	assert(state->is_sorted_build);
+	struct index *index = state->index;
+	enum dup_replace_mode mode = index->def->opts.is_unique ?
+				     DUP_INSERT : DUP_REPLACE_OR_INSERT;
+	for (uint32_t i = 0; i < state->change_count; i++) {
+		struct memtx_ddl_change *change = &state->changes[i];
+		struct tuple *delete = NULL;
+		struct tuple *successor;
+		if (memtx_index_replace(index, change->old_tuple,
+					change->new_tuple, mode, &delete,
+					&successor) != 0)
+			return -1;
+	}
+	return 0;
+}
+
 static int
 memtx_check_on_replace(struct trigger *trigger, void *event)
 {
@@ -1238,6 +1431,11 @@ memtx_build_on_replace_rollback(struct trigger *base, void *event)
 	assert(stmt->old_tuple == NULL ||
 	       memtx_tuple_validate(state->format, stmt->old_tuple) == 0);
 
+	if (state->is_sorted_build) {
+		memtx_ddl_state_log_change(state, stmt->new_tuple,
+					   stmt->old_tuple);
+		return 0;
+	}
 	struct tuple *delete = NULL;
 	struct tuple *successor = NULL;
 	/*
@@ -1293,7 +1491,8 @@ memtx_build_on_replace(struct trigger *trigger, void *event)
 	 * Only update the already built part of an index. All the other
 	 * tuples will be inserted when build continues.
 	 */
-	if (tuple_compare(state->cursor, HINT_NONE, cmp_tuple, HINT_NONE,
+	if (!state->is_collected &&
+	    tuple_compare(state->cursor, HINT_NONE, cmp_tuple, HINT_NONE,
 			  state->cmp_def) < 0)
 		return 0;
 
@@ -1304,28 +1503,33 @@ memtx_build_on_replace(struct trigger *trigger, void *event)
 		return 0;
 	}
 
-	struct tuple *delete = NULL;
-	enum dup_replace_mode mode =
-		state->index->def->opts.is_unique ? DUP_INSERT :
-						    DUP_REPLACE_OR_INSERT;
-	struct tuple *successor;
-	state->rc = memtx_index_replace(state->index, stmt->old_tuple,
-					stmt->new_tuple, mode, &delete,
-					&successor);
-	if (state->rc != 0) {
-		diag_move(diag_get(), &state->diag);
-		return 0;
-	}
-	/*
-	 * All tuples stored in a memtx space are
-	 * referenced by the primary index. That is
-	 * why we need to ref new tuple and unref old tuple.
-	 */
-	if (state->index->def->iid == 0) {
-		if (stmt->new_tuple != NULL)
-			tuple_ref(stmt->new_tuple);
-		if (stmt->old_tuple != NULL)
-			tuple_unref(stmt->old_tuple);
+	if (state->is_sorted_build) {
+		memtx_ddl_state_log_change(state, stmt->old_tuple,
+					   stmt->new_tuple);
+	} else {
+		struct tuple *delete = NULL;
+		enum dup_replace_mode mode =
+			state->index->def->opts.is_unique ?
+			DUP_INSERT : DUP_REPLACE_OR_INSERT;
+		struct tuple *successor;
+		state->rc = memtx_index_replace(state->index, stmt->old_tuple,
+						stmt->new_tuple, mode, &delete,
+						&successor);
+		if (state->rc != 0) {
+			diag_move(diag_get(), &state->diag);
+			return 0;
+		}
+		/*
+		 * All tuples stored in a memtx space are
+		 * referenced by the primary index. That is
+		 * why we need to ref new tuple and unref old tuple.
+		 */
+		if (state->index->def->iid == 0) {
+			if (stmt->new_tuple != NULL)
+				tuple_ref(stmt->new_tuple);
+			if (stmt->old_tuple != NULL)
+				tuple_unref(stmt->old_tuple);
+		}
 	}
 	/*
 	 * Set on_rollback trigger on stmt to avoid
@@ -1347,6 +1551,165 @@ memtx_build_on_replace(struct trigger *trigger, void *event)
 	return 0;
 }
 
+/*
+ * Check if a new index of a space may be built by sorting the space
+ * tuples, see memtx_space_build_index_with_sort().
+ */
+static bool
+memtx_space_build_index_can_sort(struct memtx_engine *memtx,
+				 struct index *pk, struct index *new_index)
+{
+	struct index_def *def = new_index->def;
+	/*
+	 * Concurrent changes are tracked by the position in the primary
+	 * key so it must be ordered. Without MVCC the on_replace trigger
+	 * is the only way to track them.
+	 */
+	if (def->iid == 0 || def->type != TREE || pk->def->type != TREE ||
+	    def->key_def->is_multikey || def->key_def->for_func_index ||
+	    memtx_tx_manager_use_mvcc_engine || memtx->state != MEMTX_OK)
+		return false;
+	struct errinj *inj = errinj(ERRINJ_BUILD_INDEX_DISABLE_YIELD,
+				    ERRINJ_BOOL);
+	if (inj != NULL && inj->bparam)
+		return false;
+	return index_size(pk) >= MEMTX_DDL_SORT_MIN_TUPLES;
+}
+
+/*
+ * Check if a sorted index build must be aborted because the DDL fiber
+ * was cancelled or a concurrent change failed to be logged.
+ */
+static int
+memtx_ddl_state_check(struct memtx_ddl_state *state)
+{
+	if (fiber_is_cancelled()) {
+		diag_set(FiberIsCancelled);
+		return -1;
+	}
+	if (state->rc != 0) {
+		diag_move(&state->diag, diag_get());
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Collect the tuples of a space for a sorted index build, yielding
+ * periodically. Changes of the already collected tuples made during
+ * yields are logged by the on_replace trigger.
+ */
+static int
+memtx_space_build_index_collect(struct index *pk,
+				struct memtx_ddl_state *state)
+{
+	struct index *new_index = state->index;
+	struct key_def *key_def = new_index->def->key_def;
+	ssize_t count = index_size(pk);
+	assert(count >= 0);
+	memtx_index_begin_build(new_index);
+	if (memtx_index_reserve(new_index, count) != 0)
+		return -1;
+	struct iterator *it = index_create_iterator(pk, ITER_ALL, NULL, 0);
+	if (it == NULL)
+		return -1;
+	int rc;
+	struct tuple *tuple;
+	count = 0;
+	while ((rc = iterator_next_internal(it, &tuple)) == 0 &&
+	       tuple != NULL) {
+		if (!tuple_format_is_compatible_with_key_def(tuple_format(tuple),
+							     key_def)) {
+			rc = -1;
+			break;
+		}
+		rc = memtx_tuple_validate(state->format, tuple);
+		if (rc != 0)
+			break;
+		rc = memtx_index_build_next(new_index, tuple);
+		if (rc != 0)
+			break;
+		ERROR_INJECT_DOUBLE(ERRINJ_BUILD_INDEX_TIMEOUT,
+				    inj->dparam > 0,
+				    thread_sleep(inj->dparam));
+		/*
+		 * A collected tuple can't be freed before the index is
+		 * built: if it's deleted, the change is logged and the
+		 * log references the tuple.
+		 */
+		state->cursor = tuple;
+		if (++count % MEMTX_DDL_YIELD_LOOPS == 0)
+			fiber_sleep(0);
+		ERROR_INJECT_YIELD(ERRINJ_BUILD_INDEX_DELAY);
+		rc = memtx_ddl_state_check(state);
+		if (rc != 0)
+			break;
+	}
+	iterator_delete(it);
+	return rc;
+}
+
+/*
+ * Build a new TREE index of a space by sorting its tuples in the memtx
+ * sort threads, which takes much less time of the tx thread than
+ * inserting them into the index one by one:
+ *
+ * 1. The tuples are collected from the primary key, yielding
+ *    periodically.
+ * 2. The collected tuples are sorted in the sort threads while the tx
+ *    thread is free to process requests.
+ * 3. The index is built from the sorted tuples and checked for
+ *    duplicates.
+ * 4. Changes made concurrently to the collected tuples are logged by
+ *    the space on_replace trigger and merged into the built index.
+ */
+static int
+memtx_space_build_index_with_sort(struct space *src_space, struct index *pk,
+				  struct index *new_index,
+				  struct tuple_format *new_format)
+{
+	struct memtx_ddl_state state;
+	state.index = new_index;
+	state.format = new_format;
+	state.cursor = NULL;
+	state.cmp_def = pk->def->key_def;
+	state.is_sorted_build = true;
+	state.is_collected = false;
+	state.changes = NULL;
+	state.change_count = 0;
+	state.change_capacity = 0;
+	state.rc = 0;
+	diag_create(&state.diag);
+	rlist_create(&state.stmt_triggers);
+
+	struct trigger on_replace;
+	trigger_create(&on_replace, memtx_build_on_replace, &state, NULL);
+	trigger_add(&src_space->on_replace, &on_replace);
+
+	int rc = memtx_space_build_index_collect(pk, &state);
+	if (rc == 0) {
+		state.is_collected = true;
+		/* Yields while the sort threads are running. */
+		memtx_index_end_build(new_index);
+		rc = memtx_ddl_state_check(&state);
+	}
+	if (rc == 0)
+		rc = memtx_tree_index_check_unique(new_index);
+	if (rc == 0)
+		rc = memtx_ddl_state_merge_changes(&state);
+	memtx_ddl_state_clear_changes(&state);
+
+	struct memtx_build_stmt_trigger *trg;
+	rlist_foreach_entry(trg, &state.stmt_triggers, in_state) {
+		trigger_clear(&trg->on_rollback);
+		trigger_clear(&trg->on_commit);
+	}
+	free(state.changes);
+	diag_destroy(&state.diag);
+	trigger_clear(&on_replace);
+	return rc;
+}
+
 static int
 memtx_space_build_index(struct space *src_space, struct index *new_index,
 			struct tuple_format *new_format,
@@ -1381,6 +1744,12 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 	if (txn_check_singlestatement(txn, "index build") != 0)
 		return -1;
 
+	struct memtx_engine *memtx = (struct memtx_engine *)src_space->engine;
+	if (memtx_space_build_index_can_sort(memtx, pk, new_index)) {
+		return memtx_space_build_index_with_sort(src_space, pk,
+							 new_index, new_format);
+	}
+
 	/* Now deal with any kind of add index during normal operation. */
 	struct iterator *it = index_create_iterator(pk, ITER_ALL, NULL, 0);
 	if (it == NULL)
@@ -1398,7 +1767,6 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 	if (inj != NULL && inj->bparam == true)
 		can_yield = false;
 
-	struct memtx_engine *memtx = (struct memtx_engine *)src_space->engine;
 	struct memtx_ddl_state state;
 	struct trigger on_replace;
 	/*
@@ -1409,6 +1777,11 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		state.index = new_index;
 		state.format = new_format;
 		state.cmp_def = pk->def->key_def;
+		state.is_sorted_build = false;
+		state.is_collected = false;
+		state.changes = NULL;
+		state.change_count = 0;
+		state.change_capacity = 0;
 		state.rc = 0;
 		diag_create(&state.diag);
 		rlist_create(&state.stmt_triggers);
@@ -1643,5 +2016,12 @@ memtx_space_new(struct memtx_engine *memtx,
 	memset(&memtx_space->tuple_stat, 0, sizeof(memtx_space->tuple_stat));
 	memtx_space->rowid = 0;
 	memtx_space->replace = memtx_space_replace_no_keys;
+	/*
+	 * System spaces are always written to snapshots in full, while
+	 * temporary and ephemeral spaces aren't written at all.
+	 */
+	memtx_space->has_change_log = !def->opts.is_ephemeral &&
+				      !space_id_is_system(def->id) &&
+				      !space_opts_is_data_temporary(&def->opts);
 	return (struct space *)memtx_space;
 }
@@ -62,6 +62,11 @@ struct memtx_space {
 	 */
 	int (*replace)(struct space *, struct tuple *, struct tuple *,
 		       enum dup_replace_mode, struct tuple **);
+	/**
+	 * Set if changes of the space are logged to write incremental
+	 * snapshots, see memtx_engine::checkpoint_changes.
+	 */
+	bool has_change_log;
 };
 
 /**
@@ -98,6 +103,15 @@ memtx_space_replace_all_keys(struct space *, struct tuple *, struct tuple *,
 int
 memtx_space_recover_snapshot_row(struct space *space, struct request *request);
 
+/**
+ * Apply a REPLACE or DELETE row of an incremental snapshot. Called after
+ * the space has been loaded from the full snapshot the incremental one
+ * is based on, before its secondary keys are built, unless they are
+ * enabled from the start (force recovery).
+ */
+int
+memtx_space_recover_delta_row(struct space *space, struct request *request);
+
 struct space *
 memtx_space_new(struct memtx_engine *memtx,
 		struct space_def *def, struct rlist *key_list);
@@ -47,17 +47,77 @@
 #include "trivia/config.h"
 #include "trivia/util.h"
 #include "tt_sort.h"
+#include "salad/hint_search.h"
 #include <small/mempool.h>
 
 /**
- * Check if an index has a tree with hints enabled given its definition.
+ * Layout of the elements of a memtx tree, see memtx_tree_data.
  */
-static bool
-memtx_tree_index_uses_hint(struct index_def *def)
+enum memtx_tree_layout {
+	/** Elements store tuple pointers only. */
+	MEMTX_TREE_NO_HINT,
+	/** Elements store tuple pointers and comparison hints. */
+	MEMTX_TREE_HINT,
+	/**
+	 * Elements store tuple pointers, comparison hints and prefixes
+	 * of the first key part, see memtx_tree_key_prefix_create().
+	 */
+	MEMTX_TREE_KEY_PREFIX,
+};
+
+/** Value of the index layout option selecting MEMTX_TREE_KEY_PREFIX. */
+static const char MEMTX_TREE_LAYOUT_KEY_PREFIX[] = "key_prefix";
+
+enum {
+	/** Size of the key prefix stored in tree elements. */
+	MEMTX_TREE_KEY_PREFIX_SIZE = 16,
+};
+
+/**
+ * Get the layout of the tree elements of an index given its definition.
+ */
+static enum memtx_tree_layout
+memtx_tree_index_layout(const struct index_def *def)
 {
-	return def->key_def->for_func_index ||
-	       def->key_def->is_multikey ||
-	       def->opts.hint == INDEX_HINT_ON;
+	if (def->opts.layout != NULL &&
+	    strcmp(def->opts.layout, MEMTX_TREE_LAYOUT_KEY_PREFIX) == 0)
+		return MEMTX_TREE_KEY_PREFIX;
+	if (def->key_def->for_func_index || def->key_def->is_multikey ||
+	    def->opts.hint == INDEX_HINT_ON)
+		return MEMTX_TREE_HINT;
+	return MEMTX_TREE_NO_HINT;
+}
+
+int
+memtx_tree_index_check_layout(const struct index_def *def,
+			      const char *space_name)
+{
+	assert(def->opts.layout != NULL);
+	if (def->type != TREE ||
+	    strcmp(def->opts.layout, MEMTX_TREE_LAYOUT_KEY_PREFIX) != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memtx",
+			 "'layout' option");
+		return -1;
+	}
+	const struct key_def *key_def = def->key_def;
+	const struct key_part *part = &key_def->parts[0];
+	const char *reason = NULL;
+	if (def->opts.hint == INDEX_HINT_OFF) {
+		reason = "key_prefix layout requires hints";
+	} else if (key_def->is_multikey || key_def->for_func_index) {
+		reason = "key_prefix layout can't be used by multikey or "
+			 "functional index";
+	} else if (part->type != FIELD_TYPE_STRING || part->coll != NULL ||
+		   part->sort_order == SORT_ORDER_DESC) {
+		reason = "key_prefix layout requires the first key part "
+			 "to be an ascending string without collation";
+	}
+	if (reason != NULL) {
+		diag_set(ClientError, ER_MODIFY_INDEX, def->name, space_name,
+			 reason);
+		return -1;
+	}
+	return 0;
 }
 
 /**
@@ -70,21 +130,62 @@ struct memtx_tree_key_data_common {
 	uint32_t part_count;
 };
 
-template <bool USE_HINT>
-struct memtx_tree_key_data;
+/**
+ * Keys don't store a key prefix even if the tree elements do: it's
+ * as cheap to take it from the key itself on comparison.
+ */
+template <memtx_tree_layout LAYOUT>
+struct memtx_tree_key_data : memtx_tree_key_data_common {
+	/** Comparison hint, see tuple_hint(). */
+	hint_t hint;
+	void set_hint(hint_t h) { hint = h; }
+};
 
 template <>
-struct memtx_tree_key_data<false> : memtx_tree_key_data_common {
+struct memtx_tree_key_data<MEMTX_TREE_NO_HINT> : memtx_tree_key_data_common {
 	static constexpr hint_t hint = HINT_NONE;
 	void set_hint(hint_t) { assert(false); }
 };
 
-template <>
-struct memtx_tree_key_data<true> : memtx_tree_key_data_common {
-	/** Comparison hint, see tuple_hint(). */
-	hint_t hint;
-	void set_hint(hint_t h) { hint = h; }
-};
+/**
+ * Fill the key prefix given the first key part of a tuple or a key.
+ * The prefix consists of the first bytes of the string padded with
+ * zeros, so comparing prefixes with memcmp() gives the same result as
+ * comparing the strings unless the prefixes are equal. A key part that
+ * isn't a string (nil in a nullable index) gives a zero prefix.
+ */
+static inline void
+memtx_tree_key_prefix_create(char *prefix, const char *field)
+{
+	memset(prefix, 0, MEMTX_TREE_KEY_PREFIX_SIZE);
+	if (field == NULL || mp_typeof(*field) != MP_STR)
+		return;
+	uint32_t len;
+	const char *str = mp_decode_str(&field, &len);
+	memcpy(prefix, str, MIN(len, (uint32_t)MEMTX_TREE_KEY_PREFIX_SIZE));
+}
+
+/**
+ * Compare the key prefix of a tree element with the first part of
+ * a key as if the latter was converted to a key prefix too.
+ */
+static inline int
+memtx_tree_key_prefix_compare(const char *prefix, const char *key)
+{
+	if (mp_typeof(*key) != MP_STR)
+		return 0;
+	uint32_t len;
+	const char *str = mp_decode_str(&key, &len);
+	len = MIN(len, (uint32_t)MEMTX_TREE_KEY_PREFIX_SIZE);
+	int rc = memcmp(prefix, str, len);
+	if (rc != 0)
+		return rc;
+	for (uint32_t i = len; i < MEMTX_TREE_KEY_PREFIX_SIZE; i++) {
+		if (prefix[i] != 0)
+			return 1;
+	}
+	return 0;
+}
 
 /**
  * Struct that is used as a elem in BPS tree definition.
@@ -94,22 +195,46 @@ struct memtx_tree_data_common {
 	struct tuple *tuple;
 };
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 struct memtx_tree_data;
 
 template <>
-struct memtx_tree_data<false> : memtx_tree_data_common {
+struct memtx_tree_data<MEMTX_TREE_NO_HINT> : memtx_tree_data_common {
 	static constexpr hint_t hint = HINT_NONE;
 	void set_hint(hint_t) { assert(false); }
+	void set_key_prefix(struct key_def *) { assert(false); }
+	void copy_key_prefix(const memtx_tree_data_common *) { assert(false); }
 };
 
 template <>
-struct memtx_tree_data<true> :  memtx_tree_data<false> {
+struct memtx_tree_data<MEMTX_TREE_HINT> :
+	memtx_tree_data<MEMTX_TREE_NO_HINT> {
 	/** Comparison hint, see key_hint(). */
 	hint_t hint;
 	void set_hint(hint_t h) { hint = h; }
 };
 
+template <>
+struct memtx_tree_data<MEMTX_TREE_KEY_PREFIX> :
+	memtx_tree_data<MEMTX_TREE_HINT> {
+	/**
+	 * Prefix of the first key part of the tuple, which resolves
+	 * comparisons of elements with equal hints without accessing
+	 * the tuple, see memtx_tree_key_prefix_create().
+	 */
+	char key_prefix[MEMTX_TREE_KEY_PREFIX_SIZE];
+	void set_key_prefix(struct key_def *cmp_def)
+	{
+		const char *field = tuple_field_by_part(
+			tuple, &cmp_def->parts[0], MULTIKEY_NONE);
+		memtx_tree_key_prefix_create(key_prefix, field);
+	}
+	void copy_key_prefix(const memtx_tree_data *other)
+	{
+		memcpy(key_prefix, other->key_prefix, sizeof(key_prefix));
+	}
+};
+
 /**
  * Test whether BPS tree elements are identical i.e. represent
  * the same tuple at the same position in the tree.
@@ -125,21 +250,126 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 	return a->tuple == b->tuple;
 }
 
+/** Compare two tree elements. */
+template <memtx_tree_layout LAYOUT>
+static inline int
+memtx_tree_compare(const struct memtx_tree_data<LAYOUT> *a,
+		   const struct memtx_tree_data<LAYOUT> *b,
+		   struct key_def *cmp_def)
+{
+	return tuple_compare(a->tuple, a->hint, b->tuple, b->hint, cmp_def);
+}
+
+/**
+ * Elements with equal hints are ordered by their key prefixes before
+ * resorting to tuple comparison. A hint and a key prefix determine
+ * the type of the first key part so comparing prefixes is safe.
+ */
+static inline int
+memtx_tree_compare(const struct memtx_tree_data<MEMTX_TREE_KEY_PREFIX> *a,
+		   const struct memtx_tree_data<MEMTX_TREE_KEY_PREFIX> *b,
+		   struct key_def *cmp_def)
+{
+	if (a->hint == b->hint && a->hint != HINT_NONE) {
+		int rc = memcmp(a->key_prefix, b->key_prefix,
+				MEMTX_TREE_KEY_PREFIX_SIZE);
+		if (rc != 0)
+			return rc;
+	}
+	return tuple_compare(a->tuple, a->hint, b->tuple, b->hint, cmp_def);
+}
+
+/** Compare a tree element with a key. */
+template <memtx_tree_layout LAYOUT>
+static inline int
+memtx_tree_compare_key(const struct memtx_tree_data<LAYOUT> *a,
+		       const struct memtx_tree_key_data<LAYOUT> *b,
+		       struct key_def *cmp_def)
+{
+	return tuple_compare_with_key(a->tuple, a->hint, b->key,
+				      b->part_count, b->hint, cmp_def);
+}
+
+/** Same as the element comparison, but with a key, see above. */
+static inline int
+memtx_tree_compare_key(
+	const struct memtx_tree_data<MEMTX_TREE_KEY_PREFIX> *a,
+	const struct memtx_tree_key_data<MEMTX_TREE_KEY_PREFIX> *b,
+	struct key_def *cmp_def)
+{
+	if (a->hint == b->hint && a->hint != HINT_NONE &&
+	    b->part_count > 0) {
+		int rc = memtx_tree_key_prefix_compare(a->key_prefix, b->key);
+		if (rc != 0)
+			return rc;
+	}
+	return tuple_compare_with_key(a->tuple, a->hint, b->key,
+				      b->part_count, b->hint, cmp_def);
+}
+
+static_assert(HINT_NONE == HINT_SEARCH_NONE,
+	      "HINT_NONE must be the unknown hint for hint_search_range()");
+static_assert(sizeof(struct memtx_tree_data<MEMTX_TREE_HINT>) ==
+	      2 * sizeof(hint_t) &&
+	      sizeof(struct memtx_tree_data<MEMTX_TREE_KEY_PREFIX>) ==
+	      2 * sizeof(hint_t) + MEMTX_TREE_KEY_PREFIX_SIZE,
+	      "Hints must be interleaved with tuple pointers");
+
+/**
+ * Narrow the range of a tree block to be searched for an element or a key
+ * with the given hint using vectorized hint comparison. Hints of multikey
+ * and functional indexes aren't comparison hints so they can't be used.
+ */
+template <memtx_tree_layout LAYOUT>
+static inline void
+memtx_tree_narrow(struct memtx_tree_data<LAYOUT> *arr, size_t size,
+		  hint_t hint, struct key_def *cmp_def,
+		  struct memtx_tree_data<LAYOUT> **begin,
+		  struct memtx_tree_data<LAYOUT> **end)
+{
+	if (hint == HINT_NONE || cmp_def->is_multikey ||
+	    cmp_def->for_func_index)
+		return;
+	size_t b, e;
+	hint_search_range(&arr->hint, size, sizeof(*arr) / sizeof(hint_t),
+			  hint, &b, &e);
+	*begin = arr + b;
+	*end = arr + e;
+}
+
+/** Trees without hints have nothing to narrow the search with. */
+static inline void
+memtx_tree_narrow(struct memtx_tree_data<MEMTX_TREE_NO_HINT> *arr,
+		  size_t size, hint_t hint, struct key_def *cmp_def,
+		  struct memtx_tree_data<MEMTX_TREE_NO_HINT> **begin,
+		  struct memtx_tree_data<MEMTX_TREE_NO_HINT> **end)
+{
+	(void)arr;
+	(void)size;
+	(void)hint;
+	(void)cmp_def;
+	(void)begin;
+	(void)end;
+}
+
 #define BPS_INNER_CARD
 #define BPS_TREE_NAME memtx_tree
 #define BPS_TREE_BLOCK_SIZE (512)
-#define BPS_TREE_COMPARE(a, b, arg)\
-	tuple_compare((&a)->tuple, (&a)->hint, (&b)->tuple, (&b)->hint, arg)
-#define BPS_TREE_COMPARE_KEY(a, b, arg)\
-	tuple_compare_with_key((&a)->tuple, (&a)->hint, (b)->key,\
-			       (b)->part_count, (b)->hint, arg)
+#define BPS_TREE_COMPARE(a, b, arg) memtx_tree_compare(&(a), &(b), arg)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) memtx_tree_compare_key(&(a), b, arg)
 #define BPS_TREE_IS_IDENTICAL(a, b) memtx_tree_data_is_equal(&a, &b)
+#define BPS_TREE_NARROW_KEY(arr, size, key, arg, begin, end)\
+	memtx_tree_narrow(arr, size, (key)->hint, arg, begin, end)
+#define BPS_TREE_NARROW_ELEM(arr, size, elem, arg, begin, end)\
+	memtx_tree_narrow(arr, size, (&elem)->hint, arg, begin, end)
+/* Tuple headers are read by the comparators and the iterator filters. */
+#define BPS_TREE_PREFETCH_ELEM(elem) prefetch((elem).tuple, 0)
 #define BPS_TREE_NO_DEBUG 1
 #define bps_tree_arg_t struct key_def *
 
 #define BPS_TREE_NAMESPACE NS_NO_HINT
-#define bps_tree_elem_t struct memtx_tree_data<false>
-#define bps_tree_key_t struct memtx_tree_key_data<false> *
+#define bps_tree_elem_t struct memtx_tree_data<MEMTX_TREE_NO_HINT>
+#define bps_tree_key_t struct memtx_tree_key_data<MEMTX_TREE_NO_HINT> *
 
 #include "salad/bps_tree.h"
 
@@ -148,8 +378,18 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef bps_tree_key_t
 
 #define BPS_TREE_NAMESPACE NS_USE_HINT
-#define bps_tree_elem_t struct memtx_tree_data<true>
-#define bps_tree_key_t struct memtx_tree_key_data<true> *
+#define bps_tree_elem_t struct memtx_tree_data<MEMTX_TREE_HINT>
+#define bps_tree_key_t struct memtx_tree_key_data<MEMTX_TREE_HINT> *
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAMESPACE
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
+#define BPS_TREE_NAMESPACE NS_USE_KEY_PREFIX
+#define bps_tree_elem_t struct memtx_tree_data<MEMTX_TREE_KEY_PREFIX>
+#define bps_tree_key_t struct memtx_tree_key_data<MEMTX_TREE_KEY_PREFIX> *
 
 #include "salad/bps_tree.h"
 
@@ -162,51 +402,70 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef BPS_TREE_COMPARE
 #undef BPS_TREE_COMPARE_KEY
 #undef BPS_TREE_IS_IDENTICAL
+#undef BPS_TREE_NARROW_KEY
+#undef BPS_TREE_NARROW_ELEM
+#undef BPS_TREE_PREFETCH_ELEM
 #undef BPS_TREE_NO_DEBUG
 #undef bps_tree_arg_t
 
 using namespace NS_NO_HINT;
 using namespace NS_USE_HINT;
+using namespace NS_USE_KEY_PREFIX;
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 struct memtx_tree_selector;
 
 template <>
-struct memtx_tree_selector<false> : NS_NO_HINT::memtx_tree {};
+struct memtx_tree_selector<MEMTX_TREE_NO_HINT> : NS_NO_HINT::memtx_tree {};
+
+template <>
+struct memtx_tree_selector<MEMTX_TREE_HINT> : NS_USE_HINT::memtx_tree {};
 
 template <>
-struct memtx_tree_selector<true> : NS_USE_HINT::memtx_tree {};
+struct memtx_tree_selector<MEMTX_TREE_KEY_PREFIX> :
+	NS_USE_KEY_PREFIX::memtx_tree {};
 
-template <bool USE_HINT>
-using memtx_tree_t = struct memtx_tree_selector<USE_HINT>;
+template <memtx_tree_layout LAYOUT>
+using memtx_tree_t = struct memtx_tree_selector<LAYOUT>;
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 struct memtx_tree_view_selector;
 
 template <>
-struct memtx_tree_view_selector<false> : NS_NO_HINT::memtx_tree_view {};
+struct memtx_tree_view_selector<MEMTX_TREE_NO_HINT> :
+	NS_NO_HINT::memtx_tree_view {};
 
 template <>
-struct memtx_tree_view_selector<true> : NS_USE_HINT::memtx_tree_view {};
+struct memtx_tree_view_selector<MEMTX_TREE_HINT> :
+	NS_USE_HINT::memtx_tree_view {};
 
-template <bool USE_HINT>
-using memtx_tree_view_t = struct memtx_tree_view_selector<USE_HINT>;
+template <>
+struct memtx_tree_view_selector<MEMTX_TREE_KEY_PREFIX> :
+	NS_USE_KEY_PREFIX::memtx_tree_view {};
+
+template <memtx_tree_layout LAYOUT>
+using memtx_tree_view_t = struct memtx_tree_view_selector<LAYOUT>;
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 struct memtx_tree_iterator_selector;
 
 template <>
-struct memtx_tree_iterator_selector<false> {
+struct memtx_tree_iterator_selector<MEMTX_TREE_NO_HINT> {
 	using type = NS_NO_HINT::memtx_tree_iterator;
 };
 
 template <>
-struct memtx_tree_iterator_selector<true> {
+struct memtx_tree_iterator_selector<MEMTX_TREE_HINT> {
 	using type = NS_USE_HINT::memtx_tree_iterator;
 };
 
-template <bool USE_HINT>
-using memtx_tree_iterator_t = typename memtx_tree_iterator_selector<USE_HINT>::type;
+template <>
+struct memtx_tree_iterator_selector<MEMTX_TREE_KEY_PREFIX> {
+	using type = NS_USE_KEY_PREFIX::memtx_tree_iterator;
+};
+
+template <memtx_tree_layout LAYOUT>
+using memtx_tree_iterator_t = typename memtx_tree_iterator_selector<LAYOUT>::type;
 
 static void
 invalidate_tree_iterator(NS_NO_HINT::memtx_tree_iterator *itr)
@@ -220,14 +479,20 @@ invalidate_tree_iterator(NS_USE_HINT::memtx_tree_iterator *itr)
 	*itr = NS_USE_HINT::memtx_tree_invalid_iterator();
 }
 
-template <bool USE_HINT>
+static void
+invalidate_tree_iterator(NS_USE_KEY_PREFIX::memtx_tree_iterator *itr)
+{
+	*itr = NS_USE_KEY_PREFIX::memtx_tree_invalid_iterator();
+}
+
+template <memtx_tree_layout LAYOUT>
 struct memtx_tree_index {
 	struct index base;
-	memtx_tree_t<USE_HINT> tree;
-	struct memtx_tree_data<USE_HINT> *build_array;
+	memtx_tree_t<LAYOUT> tree;
+	struct memtx_tree_data<LAYOUT> *build_array;
 	size_t build_array_size, build_array_alloc_size;
 	struct memtx_gc_task gc_task;
-	memtx_tree_iterator_t<USE_HINT> gc_iterator;
+	memtx_tree_iterator_t<LAYOUT> gc_iterator;
 	/** Whether index is functional. */
 	bool is_func;
 };
@@ -264,27 +529,26 @@ memtx_tree_cmp_def(TREE *tree)
 	return tree->common.arg;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 memtx_tree_qcompare(const void* a, const void *b, void *c)
 {
-	const struct memtx_tree_data<USE_HINT> *data_a =
-		(struct memtx_tree_data<USE_HINT> *)a;
-	const struct memtx_tree_data<USE_HINT> *data_b =
-		(struct memtx_tree_data<USE_HINT> *)b;
+	const struct memtx_tree_data<LAYOUT> *data_a =
+		(struct memtx_tree_data<LAYOUT> *)a;
+	const struct memtx_tree_data<LAYOUT> *data_b =
+		(struct memtx_tree_data<LAYOUT> *)b;
 	struct key_def *key_def = (struct key_def *)c;
-	return tuple_compare(data_a->tuple, data_a->hint, data_b->tuple,
-			     data_b->hint, key_def);
+	return memtx_tree_compare(data_a, data_b, key_def);
 }
 
 /* {{{ MemtxTree Iterators ****************************************/
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 struct tree_iterator {
 	struct iterator base;
-	memtx_tree_iterator_t<USE_HINT> tree_iterator;
+	memtx_tree_iterator_t<LAYOUT> tree_iterator;
 	enum iterator_type type;
-	struct memtx_tree_key_data<USE_HINT> after_data;
-	struct memtx_tree_key_data<USE_HINT> key_data;
+	struct memtx_tree_key_data<LAYOUT> after_data;
+	struct memtx_tree_key_data<LAYOUT> key_data;
 	/** The amount of tuples to skip after the iterator start. */
 	uint32_t offset;
 	/**
@@ -293,7 +557,7 @@ struct tree_iterator {
 	 * Otherwise, tuple pointer is not NULL, even if iterator is
 	 * exhausted - pagination relies on it.
 	 */
-	struct memtx_tree_data<USE_HINT> last;
+	struct memtx_tree_data<LAYOUT> last;
 	/**
 	 * For functional indexes only: reference to the functional index key
 	 * at the last iterator position.
@@ -307,17 +571,21 @@ struct tree_iterator {
 	struct mempool *pool;
 };
 
-static_assert(sizeof(struct tree_iterator<false>) <= MEMTX_ITERATOR_SIZE,
-	      "sizeof(struct tree_iterator<false>) must be less than or equal "
+static_assert(sizeof(struct tree_iterator<MEMTX_TREE_NO_HINT>) <= MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<MEMTX_TREE_NO_HINT>) must be less than or equal "
 	      "to MEMTX_ITERATOR_SIZE");
-static_assert(sizeof(struct tree_iterator<true>) <= MEMTX_ITERATOR_SIZE,
-	      "sizeof(struct tree_iterator<true>) must be less than or equal "
+static_assert(sizeof(struct tree_iterator<MEMTX_TREE_HINT>) <= MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<MEMTX_TREE_HINT>) must be less than or equal "
 	      "to MEMTX_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_iterator<MEMTX_TREE_KEY_PREFIX>) <=
+	      MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<MEMTX_TREE_KEY_PREFIX>) must be less "
+	      "than or equal to MEMTX_ITERATOR_SIZE");
 
 /** Set last fetched tuple. */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static inline void
-tree_iterator_set_last_tuple(struct tree_iterator<USE_HINT> *it,
+tree_iterator_set_last_tuple(struct tree_iterator<LAYOUT> *it,
 			     struct tuple *tuple)
 {
 	assert(tuple != NULL);
@@ -328,11 +596,11 @@ tree_iterator_set_last_tuple(struct tree_iterator<USE_HINT> *it,
 }
 
 /** Set hint of last fetched tuple. */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static inline void
-tree_iterator_set_last_hint(struct tree_iterator<USE_HINT> *it, hint_t hint)
+tree_iterator_set_last_hint(struct tree_iterator<LAYOUT> *it, hint_t hint)
 {
-	if (!USE_HINT)
+	if (LAYOUT == MEMTX_TREE_NO_HINT)
 		return;
 	struct index *index = index_weak_ref_get_index_checked(
 		&it->base.index_ref);
@@ -352,33 +620,35 @@ tree_iterator_set_last_hint(struct tree_iterator<USE_HINT> *it, hint_t hint)
  * Prerequisites: last is not NULL and last->tuple is not NULL.
  * Use set_last_tuple and set_last_hint manually to free occupied resources.
  */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static inline void
-tree_iterator_set_last(struct tree_iterator<USE_HINT> *it,
-		       struct memtx_tree_data<USE_HINT> *last)
+tree_iterator_set_last(struct tree_iterator<LAYOUT> *it,
+		       struct memtx_tree_data<LAYOUT> *last)
 {
 	assert(last != NULL && last->tuple != NULL);
 	tree_iterator_set_last_tuple(it, last->tuple);
 	tree_iterator_set_last_hint(it, last->hint);
+	if (LAYOUT == MEMTX_TREE_KEY_PREFIX)
+		it->last.copy_key_prefix(last);
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
 tree_iterator_free(struct iterator *iterator);
 
-template <bool USE_HINT>
-static inline struct tree_iterator<USE_HINT> *
+template <memtx_tree_layout LAYOUT>
+static inline struct tree_iterator<LAYOUT> *
 get_tree_iterator(struct iterator *it)
 {
-	assert(it->free == &tree_iterator_free<USE_HINT>);
-	return (struct tree_iterator<USE_HINT> *) it;
+	assert(it->free == &tree_iterator_free<LAYOUT>);
+	return (struct tree_iterator<LAYOUT> *) it;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
 tree_iterator_free(struct iterator *iterator)
 {
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct tree_iterator<LAYOUT> *it = get_tree_iterator<LAYOUT>(iterator);
 	if (it->last.tuple != NULL)
 		tuple_unref(it->last.tuple);
 	if (it->last_func_key != NULL)
@@ -390,17 +660,17 @@ tree_iterator_free(struct iterator *iterator)
  * If the iterator's underlying tuple does not match its last tuple, it needs
  * to be repositioned.
  */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
-tree_iterator_prev_reposition(struct tree_iterator<USE_HINT> *iterator,
-			      struct memtx_tree_index<USE_HINT> *index)
+tree_iterator_prev_reposition(struct tree_iterator<LAYOUT> *iterator,
+			      struct memtx_tree_index<LAYOUT> *index)
 {
 	bool exact = false;
 	iterator->tree_iterator =
 		memtx_tree_lower_bound_elem(&index->tree, iterator->last,
 					    &exact);
 	if (exact) {
-		struct memtx_tree_data<USE_HINT> *successor =
+		struct memtx_tree_data<LAYOUT> *successor =
 		memtx_tree_iterator_get_elem(&index->tree,
 					     &iterator->tree_iterator);
 		tree_iterator_set_last(iterator, successor);
@@ -413,18 +683,18 @@ tree_iterator_prev_reposition(struct tree_iterator<USE_HINT> *iterator,
 	assert(exact || in_txn() == NULL || !memtx_tx_manager_use_mvcc_engine);
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 {
 	struct space *space;
 	struct index *index_base;
 	index_weak_ref_get_checked(&iterator->index_ref, &space, &index_base);
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)index_base;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)index_base;
+	struct tree_iterator<LAYOUT> *it = get_tree_iterator<LAYOUT>(iterator);
 	assert(it->last.tuple != NULL);
-	struct memtx_tree_data<USE_HINT> *check =
+	struct memtx_tree_data<LAYOUT> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	if (check == NULL || !memtx_tree_data_is_equal(check, &it->last)) {
 		it->tree_iterator = memtx_tree_upper_bound_elem(&index->tree,
@@ -432,13 +702,13 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	} else {
 		memtx_tree_iterator_next(&index->tree, &it->tree_iterator);
 	}
-	struct memtx_tree_data<USE_HINT> *res =
+	struct memtx_tree_data<LAYOUT> *res =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	*ret = res != NULL ? res->tuple : NULL;
 	if (*ret == NULL) {
 		iterator->next_internal = exhausted_iterator_next;
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<LAYOUT>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = index_base->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -456,31 +726,31 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 {
 	struct space *space;
 	struct index *index_base;
 	index_weak_ref_get_checked(&iterator->index_ref, &space, &index_base);
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)index_base;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)index_base;
+	struct tree_iterator<LAYOUT> *it = get_tree_iterator<LAYOUT>(iterator);
 	assert(it->last.tuple != NULL);
-	struct memtx_tree_data<USE_HINT> *check =
+	struct memtx_tree_data<LAYOUT> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	if (check == NULL || !memtx_tree_data_is_equal(check, &it->last))
 		tree_iterator_prev_reposition(it, index);
 	memtx_tree_iterator_prev(&index->tree, &it->tree_iterator);
 	struct tuple *successor = it->last.tuple;
 	tuple_ref(successor);
-	struct memtx_tree_data<USE_HINT> *res =
+	struct memtx_tree_data<LAYOUT> *res =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	*ret = res != NULL ? res->tuple : NULL;
 	if (*ret == NULL) {
 		iterator->next_internal = exhausted_iterator_next;
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<LAYOUT>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = index_base->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -498,18 +768,18 @@ tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 {
 	struct space *space;
 	struct index *index_base;
 	index_weak_ref_get_checked(&iterator->index_ref, &space, &index_base);
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)index_base;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)index_base;
+	struct tree_iterator<LAYOUT> *it = get_tree_iterator<LAYOUT>(iterator);
 	assert(it->last.tuple != NULL);
-	struct memtx_tree_data<USE_HINT> *check =
+	struct memtx_tree_data<LAYOUT> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	if (check == NULL || !memtx_tree_data_is_equal(check, &it->last)) {
 		it->tree_iterator = memtx_tree_upper_bound_elem(&index->tree,
@@ -517,7 +787,7 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 	} else {
 		memtx_tree_iterator_next(&index->tree, &it->tree_iterator);
 	}
-	struct memtx_tree_data<USE_HINT> *res =
+	struct memtx_tree_data<LAYOUT> *res =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	/* Use user key def to save a few loops. */
 	if (res == NULL ||
@@ -538,7 +808,7 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 				   ITER_EQ, it->key_data.key,
 				   it->key_data.part_count);
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<LAYOUT>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = index_base->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -555,25 +825,25 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 {
 	struct space *space;
 	struct index *index_base;
 	index_weak_ref_get_checked(&iterator->index_ref, &space, &index_base);
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)index_base;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)index_base;
+	struct tree_iterator<LAYOUT> *it = get_tree_iterator<LAYOUT>(iterator);
 	assert(it->last.tuple != NULL);
-	struct memtx_tree_data<USE_HINT> *check =
+	struct memtx_tree_data<LAYOUT> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	if (check == NULL || !memtx_tree_data_is_equal(check, &it->last))
 		tree_iterator_prev_reposition(it, index);
 	memtx_tree_iterator_prev(&index->tree, &it->tree_iterator);
 	struct tuple *successor = it->last.tuple;
 	tuple_ref(successor);
-	struct memtx_tree_data<USE_HINT> *res =
+	struct memtx_tree_data<LAYOUT> *res =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	/* Use user key def to save a few loops. */
 	if (res == NULL ||
@@ -593,7 +863,7 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 				   ITER_REQ, it->key_data.key,
 				   it->key_data.part_count);
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<LAYOUT>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = index_base->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -611,12 +881,12 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 }
 
 #define WRAP_ITERATOR_METHOD(name)						\
-template <bool USE_HINT>							\
+template <memtx_tree_layout LAYOUT>							\
 static int									\
 name(struct iterator *iterator, struct tuple **ret)				\
 {										\
 	do {									\
-		int rc = name##_base<USE_HINT>(iterator, ret);			\
+		int rc = name##_base<LAYOUT>(iterator, ret);			\
 		if (rc != 0 ||							\
 		    iterator->next_internal == exhausted_iterator_next)		\
 			return rc;						\
@@ -632,27 +902,27 @@ WRAP_ITERATOR_METHOD(tree_iterator_prev_equal);
 
 #undef WRAP_ITERATOR_METHOD
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
-tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
+tree_iterator_set_next_method(struct tree_iterator<LAYOUT> *it)
 {
 	assert(it->last.tuple != NULL);
 	switch (it->type) {
 	case ITER_EQ:
-		it->base.next_internal = tree_iterator_next_equal<USE_HINT>;
+		it->base.next_internal = tree_iterator_next_equal<LAYOUT>;
 		break;
 	case ITER_REQ:
-		it->base.next_internal = tree_iterator_prev_equal<USE_HINT>;
+		it->base.next_internal = tree_iterator_prev_equal<LAYOUT>;
 		break;
 	case ITER_LT:
 	case ITER_LE:
 	case ITER_PP:
-		it->base.next_internal = tree_iterator_prev<USE_HINT>;
+		it->base.next_internal = tree_iterator_prev<LAYOUT>;
 		break;
 	case ITER_GE:
 	case ITER_GT:
 	case ITER_NP:
-		it->base.next_internal = tree_iterator_next<USE_HINT>;
+		it->base.next_internal = tree_iterator_next<LAYOUT>;
 		break;
 	default:
 		/* The type was checked in initIterator */
@@ -680,15 +950,15 @@ tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
  * @retval true on success;
  * @retval false if the iteration must be stopped without an error.
  */
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static bool
-memtx_tree_lookup(memtx_tree_t<USE_HINT> *tree,
-		  struct memtx_tree_key_data<USE_HINT> *start_data,
-		  struct memtx_tree_key_data<USE_HINT> after_data,
+memtx_tree_lookup(memtx_tree_t<LAYOUT> *tree,
+		  struct memtx_tree_key_data<LAYOUT> *start_data,
+		  struct memtx_tree_key_data<LAYOUT> after_data,
 		  enum iterator_type *type, struct region *region,
-		  memtx_tree_iterator_t<USE_HINT> *iterator,
+		  memtx_tree_iterator_t<LAYOUT> *iterator,
 		  size_t *offset, bool *equals,
-		  struct memtx_tree_data<USE_HINT> **initial_elem)
+		  struct memtx_tree_data<LAYOUT> **initial_elem)
 {
 	struct key_def *cmp_def = memtx_tree_cmp_def(tree);
 
@@ -698,7 +968,7 @@ memtx_tree_lookup(memtx_tree_t<USE_HINT> *tree,
 						   start_data->part_count,
 						   cmp_def, region))
 			return false;
-		if (USE_HINT) {
+		if (LAYOUT != MEMTX_TREE_NO_HINT) {
 			hint_t hint = key_hint(start_data->key,
 					       start_data->part_count, cmp_def);
 			start_data->set_hint(hint);
@@ -787,7 +1057,7 @@ memtx_tree_lookup(memtx_tree_t<USE_HINT> *tree,
 	return true;
 }
 
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 {
@@ -797,23 +1067,23 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 	*ret = NULL;
 	iterator->next_internal = exhausted_iterator_next;
 
-	struct tree_iterator<USE_HINT> *it =
-		get_tree_iterator<USE_HINT>(iterator);
+	struct tree_iterator<LAYOUT> *it =
+		get_tree_iterator<LAYOUT>(iterator);
 	assert(it->last.tuple == NULL);
 
 	struct space *space;
 	struct index *index_base;
 	index_weak_ref_get_checked(&iterator->index_ref, &space, &index_base);
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)index_base;
-	memtx_tree_t<USE_HINT> *tree = &index->tree;
-	struct memtx_tree_key_data<USE_HINT> start_data =
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)index_base;
+	memtx_tree_t<LAYOUT> *tree = &index->tree;
+	struct memtx_tree_key_data<LAYOUT> start_data =
 		it->after_data.key != NULL ? it->after_data : it->key_data;
 	enum iterator_type type = it->type;
 	size_t curr_offset;
 	/* The flag is true if the found tuple equals to the key. */
 	bool equals;
-	struct memtx_tree_data<USE_HINT> *initial_elem;
+	struct memtx_tree_data<LAYOUT> *initial_elem;
 	if (!memtx_tree_lookup(tree, &start_data, it->after_data,
 			       &type, region, &it->tree_iterator,
 			       &curr_offset, &equals, &initial_elem))
@@ -825,7 +1095,7 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 	 */
 	struct tuple *successor = initial_elem ? initial_elem->tuple : NULL;
 
-	struct memtx_tree_data<USE_HINT> *res = initial_elem;
+	struct memtx_tree_data<LAYOUT> *res = initial_elem;
 
 	/*
 	 * If the iterator type is not reverse, the initial_elem is the result
@@ -858,7 +1128,7 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 			memtx_tx_index_invisible_count_matching_until(
 				txn, space, index_base, type, start_data.key,
 				start_data.part_count, res->tuple, res->hint);
-		memtx_tree_iterator_t<USE_HINT> *iterator = &it->tree_iterator;
+		memtx_tree_iterator_t<LAYOUT> *iterator = &it->tree_iterator;
 		while (skip_more_visible != 0 && res != NULL) {
 			if (memtx_tx_tuple_key_is_visible(txn, space,
 							  index_base,
@@ -965,16 +1235,16 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 
 /* {{{ MemtxTree  **********************************************************/
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
-memtx_tree_index_free(struct memtx_tree_index<USE_HINT> *index)
+memtx_tree_index_free(struct memtx_tree_index<LAYOUT> *index)
 {
 	memtx_tree_destroy(&index->tree);
 	free(index->build_array);
 	free(index);
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
 memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 {
@@ -988,15 +1258,15 @@ memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 	enum { YIELD_LOOPS = 10 };
 #endif
 
-	struct memtx_tree_index<USE_HINT> *index = container_of(task,
-			struct memtx_tree_index<USE_HINT>, gc_task);
-	memtx_tree_t<USE_HINT> *tree = &index->tree;
-	memtx_tree_iterator_t<USE_HINT> *itr = &index->gc_iterator;
+	struct memtx_tree_index<LAYOUT> *index = container_of(task,
+			struct memtx_tree_index<LAYOUT>, gc_task);
+	memtx_tree_t<LAYOUT> *tree = &index->tree;
+	memtx_tree_iterator_t<LAYOUT> *itr = &index->gc_iterator;
 
 	const bool is_func = index->is_func;
 	unsigned int loops = 0;
 	while (!memtx_tree_iterator_is_invalid(itr)) {
-		struct memtx_tree_data<USE_HINT> *res =
+		struct memtx_tree_data<LAYOUT> *res =
 			memtx_tree_iterator_get_elem(tree, itr);
 		memtx_tree_iterator_next(tree, itr);
 		if (is_func)
@@ -1011,32 +1281,32 @@ memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 	*done = true;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
 memtx_tree_index_gc_free(struct memtx_gc_task *task)
 {
-	struct memtx_tree_index<USE_HINT> *index = container_of(task,
-			struct memtx_tree_index<USE_HINT>, gc_task);
+	struct memtx_tree_index<LAYOUT> *index = container_of(task,
+			struct memtx_tree_index<LAYOUT>, gc_task);
 	memtx_tree_index_free(index);
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static struct memtx_gc_task_vtab * get_memtx_tree_index_gc_vtab()
 {
 	static memtx_gc_task_vtab tab =
 	{
-		.run = memtx_tree_index_gc_run<USE_HINT>,
-		.free = memtx_tree_index_gc_free<USE_HINT>,
+		.run = memtx_tree_index_gc_run<LAYOUT>,
+		.free = memtx_tree_index_gc_free<LAYOUT>,
 	};
 	return &tab;
 };
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
 memtx_tree_index_destroy(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
 	if (base->def->iid == 0 || index->is_func) {
 		/*
@@ -1048,7 +1318,7 @@ memtx_tree_index_destroy(struct index *base)
 		 * free all functional keys associated with this tuple.
 		 * Let's do it in background also.
 		 */
-		index->gc_task.vtab = get_memtx_tree_index_gc_vtab<USE_HINT>();
+		index->gc_task.vtab = get_memtx_tree_index_gc_vtab<LAYOUT>();
 		index->gc_iterator = memtx_tree_first(&index->tree);
 		memtx_engine_schedule_gc(memtx, &index->gc_task);
 	} else {
@@ -1060,12 +1330,12 @@ memtx_tree_index_destroy(struct index *base)
 	}
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
 memtx_tree_index_update_def(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	struct index_def *def = base->def;
 	/*
 	 * We use extended key def for non-unique and nullable
@@ -1086,28 +1356,28 @@ memtx_tree_index_depends_on_pk(struct index *base)
 	return !def->opts.is_unique || def->key_def->is_nullable;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static ssize_t
 memtx_tree_index_size(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	struct space *space = space_by_id(base->def->space_id);
 	/* Substract invisible count. */
 	return memtx_tree_size(&index->tree) -
 	       memtx_tx_track_count(in_txn(), space, base, ITER_GE, NULL, 0);
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static ssize_t
 memtx_tree_index_bsize(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	return memtx_tree_mem_used(&index->tree);
 }
 
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 memtx_tree_index_quantile(struct index *base, double level,
 			  const char *begin_key, uint32_t begin_part_count,
@@ -1115,22 +1385,22 @@ memtx_tree_index_quantile(struct index *base, double level,
 			  const char **quantile_key,
 			  uint32_t *quantile_key_size)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
-	memtx_tree_t<USE_HINT> *tree = &index->tree;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
+	memtx_tree_t<LAYOUT> *tree = &index->tree;
 	struct key_def *key_def = base->def->key_def;
 
-	struct memtx_tree_key_data<USE_HINT> begin_data;
+	struct memtx_tree_key_data<LAYOUT> begin_data;
 	begin_data.key = begin_key;
 	begin_data.part_count = begin_part_count;
-	if (USE_HINT)
+	if (LAYOUT != MEMTX_TREE_NO_HINT)
 		begin_data.set_hint(
 			key_hint(begin_key, begin_part_count, key_def));
 
-	struct memtx_tree_key_data<USE_HINT> end_data;
+	struct memtx_tree_key_data<LAYOUT> end_data;
 	end_data.key = end_key;
 	end_data.part_count = end_part_count;
-	if (USE_HINT)
+	if (LAYOUT != MEMTX_TREE_NO_HINT)
 		end_data.set_hint(
 			key_hint(end_key, end_part_count, key_def));
 
@@ -1152,10 +1422,10 @@ memtx_tree_index_quantile(struct index *base, double level,
 
 	assert(level > 0 && level < 1);
 	size_t offset = begin_offset + (end_offset - begin_offset) * level;
-	memtx_tree_iterator_t<USE_HINT> itr =
+	memtx_tree_iterator_t<LAYOUT> itr =
 		memtx_tree_iterator_at(tree, offset);
 	assert(!memtx_tree_iterator_is_invalid(&itr));
-	struct memtx_tree_data<USE_HINT> *data =
+	struct memtx_tree_data<LAYOUT> *data =
 		memtx_tree_iterator_get_elem(tree, &itr);
 	if (key_def->for_func_index) {
 		*quantile_key = tuple_data_range((struct tuple *)data->hint,
@@ -1173,23 +1443,23 @@ memtx_tree_index_quantile(struct index *base, double level,
 	return 0;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	struct txn *txn = in_txn();
 	struct space *space = space_by_id(base->def->space_id);
 	bool is_multikey = base->def->key_def->is_multikey;
-	if (memtx_tree_index_size<USE_HINT>(base) == 0) {
+	if (memtx_tree_index_size<LAYOUT>(base) == 0) {
 		*result = NULL;
 		memtx_tx_track_gap(txn, space, base, NULL, ITER_GE, NULL, 0);
 		return 0;
 	}
 
 	do {
-		struct memtx_tree_data<USE_HINT> *res =
+		struct memtx_tree_data<LAYOUT> *res =
 			memtx_tree_random(&index->tree, rnd++);
 		assert(res != NULL);
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -1199,33 +1469,34 @@ memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 	return memtx_prepare_result_tuple(space, result);
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static ssize_t
 memtx_tree_index_count(struct index *base, enum iterator_type type,
 		       const char *key, uint32_t part_count)
 {
-	assert((base->def->opts.hint == INDEX_HINT_ON) == USE_HINT);
+	assert((base->def->opts.hint == INDEX_HINT_ON) ==
+	       (LAYOUT != MEMTX_TREE_NO_HINT));
 
 	struct region *region = &fiber()->gc;
 	RegionGuard region_guard(region);
 
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 
 	canonicalize_lookup(&type, &key, part_count);
 
-	memtx_tree_t<USE_HINT> *tree = &index->tree;
+	memtx_tree_t<LAYOUT> *tree = &index->tree;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
-	struct memtx_tree_key_data<USE_HINT> start_data;
+	struct memtx_tree_key_data<LAYOUT> start_data;
 	start_data.key = key;
 	start_data.part_count = part_count;
-	if (USE_HINT)
+	if (LAYOUT != MEMTX_TREE_NO_HINT)
 		start_data.set_hint(key_hint(key, part_count, cmp_def));
-	struct memtx_tree_key_data<USE_HINT> null_after_data = {};
-	memtx_tree_iterator_t<USE_HINT> unused;
+	struct memtx_tree_key_data<LAYOUT> null_after_data = {};
+	memtx_tree_iterator_t<LAYOUT> unused;
 	size_t begin_offset;
 	bool equals;
-	struct memtx_tree_data<USE_HINT> *initial_elem;
+	struct memtx_tree_data<LAYOUT> *initial_elem;
 	if (!memtx_tree_lookup(tree, &start_data, null_after_data, &type,
 			       region, &unused, &begin_offset, &equals,
 			       &initial_elem))
@@ -1311,24 +1582,24 @@ memtx_tree_index_count(struct index *base, enum iterator_type type,
 	return full_count - invisible_count;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 memtx_tree_index_get_internal(struct index *base, const char *key,
 			      uint32_t part_count, struct tuple **result)
 {
 	assert(base->def->opts.is_unique &&
 	       part_count == base->def->key_def->part_count);
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	struct txn *txn = in_txn();
 	struct space *space = space_by_id(base->def->space_id);
-	struct memtx_tree_key_data<USE_HINT> key_data;
+	struct memtx_tree_key_data<LAYOUT> key_data;
 	key_data.key = key;
 	key_data.part_count = part_count;
-	if (USE_HINT)
+	if (LAYOUT != MEMTX_TREE_NO_HINT)
 		key_data.set_hint(key_hint(key, part_count, cmp_def));
-	struct memtx_tree_data<USE_HINT> *res =
+	struct memtx_tree_data<LAYOUT> *res =
 		memtx_tree_find(&index->tree, &key_data);
 	if (res == NULL) {
 		*result = NULL;
@@ -1346,13 +1617,13 @@ memtx_tree_index_get_internal(struct index *base, const char *key,
 /**
  * Implementation of iterator position for general and multikey indexes.
  */
-template <bool USE_HINT, bool IS_MULTIKEY>
+template <memtx_tree_layout LAYOUT, bool IS_MULTIKEY>
 static inline int
-tree_iterator_position_impl(struct memtx_tree_data<USE_HINT> *last,
+tree_iterator_position_impl(struct memtx_tree_data<LAYOUT> *last,
 			    struct index_def *def,
 			    const char **pos, uint32_t *size)
 {
-	static_assert(!IS_MULTIKEY || USE_HINT,
+	static_assert(!IS_MULTIKEY || LAYOUT == MEMTX_TREE_HINT,
 		      "Multikey index actually uses hint.");
 	struct tuple *tuple = last != NULL ? last->tuple : NULL;
 	if (tuple == NULL) {
@@ -1373,18 +1644,18 @@ tree_iterator_position_impl(struct memtx_tree_data<USE_HINT> *last,
 /**
  * Implementation of iterator position for general and multikey indexes.
  */
-template <bool USE_HINT, bool IS_MULTIKEY>
+template <memtx_tree_layout LAYOUT, bool IS_MULTIKEY>
 static int
 tree_iterator_position(struct iterator *it, const char **pos, uint32_t *size)
 {
-	static_assert(!IS_MULTIKEY || USE_HINT,
+	static_assert(!IS_MULTIKEY || LAYOUT == MEMTX_TREE_HINT,
 		      "Multikey index actually uses hint.");
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)
 		index_weak_ref_get_index_checked(&it->index_ref);
-	struct tree_iterator<USE_HINT> *tree_it =
-		get_tree_iterator<USE_HINT>(it);
-	return tree_iterator_position_impl<USE_HINT, IS_MULTIKEY>(
+	struct tree_iterator<LAYOUT> *tree_it =
+		get_tree_iterator<LAYOUT>(it);
+	return tree_iterator_position_impl<LAYOUT, IS_MULTIKEY>(
 		&tree_it->last, index->base.def, pos, size);
 }
 
@@ -1392,7 +1663,7 @@ tree_iterator_position(struct iterator *it, const char **pos, uint32_t *size)
  * Implementation of iterator position for functional indexes.
  */
 static int
-tree_iterator_position_func_impl(struct memtx_tree_data<true> *last,
+tree_iterator_position_func_impl(struct memtx_tree_data<MEMTX_TREE_HINT> *last,
 				 struct index_def *def,
 				 const char **pos, uint32_t *size)
 {
@@ -1441,7 +1712,7 @@ tree_iterator_position_func(struct iterator *it, const char **pos,
 			    uint32_t *size)
 {
 	struct index *index = index_weak_ref_get_index_checked(&it->index_ref);
-	struct tree_iterator<true> *tree_it = get_tree_iterator<true>(it);
+	struct tree_iterator<MEMTX_TREE_HINT> *tree_it = get_tree_iterator<MEMTX_TREE_HINT>(it);
 	return tree_iterator_position_func_impl(&tree_it->last, index->def,
 						pos, size);
 }
@@ -1450,12 +1721,12 @@ tree_iterator_position_func(struct iterator *it, const char **pos,
  * Adds OOM injection and setting txn flag `TXN_STMT_ROLLBACK' on OOM
  * to `memtx_tree_insert'.
  */
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
-memtx_tree_index_insert_impl(struct memtx_tree_index<USE_HINT> *index,
-			     struct memtx_tree_data<USE_HINT> new_data,
-			     struct memtx_tree_data<USE_HINT> *dup_data,
-			     struct memtx_tree_data<USE_HINT> *suc_data)
+memtx_tree_index_insert_impl(struct memtx_tree_index<LAYOUT> *index,
+			     struct memtx_tree_data<LAYOUT> new_data,
+			     struct memtx_tree_data<LAYOUT> *dup_data,
+			     struct memtx_tree_data<LAYOUT> *suc_data)
 {
 	if (index_inject_oom() != 0)
 		goto fail;
@@ -1471,11 +1742,11 @@ memtx_tree_index_insert_impl(struct memtx_tree_index<USE_HINT> *index,
  * Adds OOM injection and setting txn flag `TXN_STMT_ROLLBACK' on OOM
  * to `memtx_tree_delete'.
  */
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
-memtx_tree_index_delete_impl(struct memtx_tree_index<USE_HINT> *index,
-			     struct memtx_tree_data<USE_HINT> elem_data,
-			     struct memtx_tree_data<USE_HINT> *del_data)
+memtx_tree_index_delete_impl(struct memtx_tree_index<LAYOUT> *index,
+			     struct memtx_tree_data<LAYOUT> elem_data,
+			     struct memtx_tree_data<LAYOUT> *del_data)
 {
 	if (index_inject_oom() != 0)
 		goto fail;
@@ -1491,11 +1762,11 @@ memtx_tree_index_delete_impl(struct memtx_tree_index<USE_HINT> *index,
  * Adds OOM injection and setting txn flag `TXN_STMT_ROLLBACK' on OOM
  * to `memtx_tree_delete_value'.
  */
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
-memtx_tree_index_delete_value_impl(struct memtx_tree_index<USE_HINT> *index,
-				   struct memtx_tree_data<USE_HINT> elem_data,
-				   struct memtx_tree_data<USE_HINT> *del_data)
+memtx_tree_index_delete_value_impl(struct memtx_tree_index<LAYOUT> *index,
+				   struct memtx_tree_data<LAYOUT> elem_data,
+				   struct memtx_tree_data<LAYOUT> *del_data)
 {
 	if (index_inject_oom() != 0)
 		goto fail;
@@ -1507,23 +1778,25 @@ memtx_tree_index_delete_value_impl(struct memtx_tree_index<USE_HINT> *index,
 	return -1;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 			 struct tuple *new_tuple, enum dup_replace_mode mode,
 			 struct tuple **result, struct tuple **successor)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	struct key_def *key_def = base->def->key_def;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	if (new_tuple != NULL &&
 	    !tuple_key_is_excluded(new_tuple, key_def, MULTIKEY_NONE)) {
-		struct memtx_tree_data<USE_HINT> new_data;
+		struct memtx_tree_data<LAYOUT> new_data;
 		new_data.tuple = new_tuple;
-		if (USE_HINT)
+		if (LAYOUT != MEMTX_TREE_NO_HINT)
 			new_data.set_hint(tuple_hint(new_tuple, cmp_def));
-		struct memtx_tree_data<USE_HINT> dup_data, suc_data;
+		if (LAYOUT == MEMTX_TREE_KEY_PREFIX)
+			new_data.set_key_prefix(cmp_def);
+		struct memtx_tree_data<LAYOUT> dup_data, suc_data;
 		dup_data.tuple = suc_data.tuple = NULL;
 
 		/* Try to optimistically replace the new_tuple. */
@@ -1533,10 +1806,10 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 
 		if (index_check_dup(base, old_tuple, new_tuple,
 				    dup_data.tuple, mode) != 0) {
-			VERIFY(memtx_tree_index_delete_impl<USE_HINT>(
+			VERIFY(memtx_tree_index_delete_impl<LAYOUT>(
 						index, new_data, NULL) == 0);
 			if (dup_data.tuple != NULL)
-				VERIFY(memtx_tree_index_insert_impl<USE_HINT>(
+				VERIFY(memtx_tree_index_insert_impl<LAYOUT>(
 						index, dup_data, NULL,
 						NULL) == 0);
 			return -1;
@@ -1549,21 +1822,25 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 	}
 	if (old_tuple != NULL &&
 	    !tuple_key_is_excluded(old_tuple, key_def, MULTIKEY_NONE)) {
-		struct memtx_tree_data<USE_HINT> old_data;
+		struct memtx_tree_data<LAYOUT> old_data;
 		old_data.tuple = old_tuple;
-		if (USE_HINT)
+		if (LAYOUT != MEMTX_TREE_NO_HINT)
 			old_data.set_hint(tuple_hint(old_tuple, cmp_def));
-		if (memtx_tree_index_delete_impl<USE_HINT>(
+		if (LAYOUT == MEMTX_TREE_KEY_PREFIX)
+			old_data.set_key_prefix(cmp_def);
+		if (memtx_tree_index_delete_impl<LAYOUT>(
 					index, old_data, NULL) != 0) {
 			if (new_tuple != NULL &&
 			    !tuple_key_is_excluded(new_tuple, key_def,
 						   MULTIKEY_NONE)) {
-				struct memtx_tree_data<USE_HINT> new_data;
+				struct memtx_tree_data<LAYOUT> new_data;
 				new_data.tuple = new_tuple;
-				if (USE_HINT)
+				if (LAYOUT != MEMTX_TREE_NO_HINT)
 					new_data.set_hint(tuple_hint(new_tuple,
 								     cmp_def));
-				VERIFY(memtx_tree_index_delete_impl<USE_HINT>(
+				if (LAYOUT == MEMTX_TREE_KEY_PREFIX)
+					new_data.set_key_prefix(cmp_def);
+				VERIFY(memtx_tree_index_delete_impl<LAYOUT>(
 						index, new_data, NULL) == 0);
 			}
 			return -1;
@@ -1581,14 +1858,14 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
  * by all it's multikey indexes.
  */
 static int
-memtx_tree_index_replace_multikey_one(struct memtx_tree_index<true> *index,
+memtx_tree_index_replace_multikey_one(struct memtx_tree_index<MEMTX_TREE_HINT> *index,
 			struct tuple *old_tuple, struct tuple *new_tuple,
 			enum dup_replace_mode mode, hint_t hint,
-			struct memtx_tree_data<true> *replaced_data,
-			struct memtx_tree_data<true> *successor_data,
+			struct memtx_tree_data<MEMTX_TREE_HINT> *replaced_data,
+			struct memtx_tree_data<MEMTX_TREE_HINT> *successor_data,
 			bool *is_multikey_conflict)
 {
-	struct memtx_tree_data<true> new_data, dup_data;
+	struct memtx_tree_data<MEMTX_TREE_HINT> new_data, dup_data;
 	new_data.tuple = new_tuple;
 	new_data.hint = hint;
 	dup_data.tuple = NULL;
@@ -1606,10 +1883,10 @@ memtx_tree_index_replace_multikey_one(struct memtx_tree_index<true> *index,
 	} else if (index_check_dup(&index->base, old_tuple, new_tuple,
 				   dup_data.tuple, mode) != 0) {
 		/* Rollback replace. */
-		VERIFY(memtx_tree_index_delete_impl<true>(
+		VERIFY(memtx_tree_index_delete_impl<MEMTX_TREE_HINT>(
 				index, new_data, NULL) == 0);
 		if (dup_data.tuple != NULL)
-			VERIFY(memtx_tree_index_insert_impl<true>(
+			VERIFY(memtx_tree_index_insert_impl<MEMTX_TREE_HINT>(
 					index, dup_data, NULL, NULL) == 0);
 		return -1;
 	}
@@ -1629,12 +1906,12 @@ memtx_tree_index_replace_multikey_one(struct memtx_tree_index<true> *index,
  * delete operation is fault-tolerant.
  */
 static void
-memtx_tree_index_replace_multikey_rollback(struct memtx_tree_index<true> *index,
+memtx_tree_index_replace_multikey_rollback(struct memtx_tree_index<MEMTX_TREE_HINT> *index,
 			struct tuple *new_tuple, struct tuple *replaced_tuple,
 			int err_multikey_idx)
 {
 	struct key_def *key_def = index->base.def->key_def;
-	struct memtx_tree_data<true> data;
+	struct memtx_tree_data<MEMTX_TREE_HINT> data;
 	if (replaced_tuple != NULL) {
 		/* Restore replaced tuple index occurrences. */
 		struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
@@ -1645,7 +1922,7 @@ memtx_tree_index_replace_multikey_rollback(struct memtx_tree_index<true> *index,
 			if (tuple_key_is_excluded(replaced_tuple, key_def, i))
 				continue;
 			data.hint = i;
-			VERIFY(memtx_tree_index_insert_impl<true>(
+			VERIFY(memtx_tree_index_insert_impl<MEMTX_TREE_HINT>(
 					index, data, NULL, NULL) == 0);
 		}
 	}
@@ -1660,7 +1937,7 @@ memtx_tree_index_replace_multikey_rollback(struct memtx_tree_index<true> *index,
 		if (tuple_key_is_excluded(new_tuple, key_def, i))
 			continue;
 		data.hint = i;
-		VERIFY(memtx_tree_index_delete_value_impl<true>(
+		VERIFY(memtx_tree_index_delete_value_impl<MEMTX_TREE_HINT>(
 					index, data, NULL) == 0);
 	}
 }
@@ -1716,8 +1993,8 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 			struct tuple *new_tuple, enum dup_replace_mode mode,
 			struct tuple **result, struct tuple **successor)
 {
-	struct memtx_tree_index<true> *index =
-		(struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<MEMTX_TREE_HINT> *index =
+		(struct memtx_tree_index<MEMTX_TREE_HINT> *)base;
 
 	/* MUTLIKEY doesn't support successor for now. */
 	*successor = NULL;
@@ -1735,7 +2012,7 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 						  multikey_idx))
 				continue;
 			bool is_multikey_conflict;
-			struct memtx_tree_data<true> replaced_data;
+			struct memtx_tree_data<MEMTX_TREE_HINT> replaced_data;
 			err = memtx_tree_index_replace_multikey_one(index,
 						old_tuple, new_tuple, mode,
 						multikey_idx, &replaced_data,
@@ -1760,7 +2037,7 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 		}
 	}
 	if (old_tuple != NULL) {
-		struct memtx_tree_data<true> data;
+		struct memtx_tree_data<MEMTX_TREE_HINT> data;
 		data.tuple = old_tuple;
 		uint32_t multikey_count =
 			tuple_multikey_count(old_tuple, cmp_def);
@@ -1768,7 +2045,7 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 			if (tuple_key_is_excluded(old_tuple, key_def, i))
 				continue;
 			data.hint = i;
-			if (memtx_tree_index_delete_value_impl<true>(
+			if (memtx_tree_index_delete_value_impl<MEMTX_TREE_HINT>(
 					index, data, NULL) != 0) {
 				uint32_t multikey_count = 0;
 				if (new_tuple != 0)
@@ -1796,7 +2073,7 @@ struct func_key_undo {
 	/** A link to organize entries in list. */
 	struct rlist link;
 	/** An inserted record copy. */
-	struct memtx_tree_data<true> key;
+	struct memtx_tree_data<MEMTX_TREE_HINT> key;
 };
 
 /**
@@ -1805,18 +2082,18 @@ struct func_key_undo {
  * return a given index object in it's original state.
  */
 static void
-memtx_tree_func_index_replace_rollback(struct memtx_tree_index<true> *index,
+memtx_tree_func_index_replace_rollback(struct memtx_tree_index<MEMTX_TREE_HINT> *index,
 				       struct rlist *old_keys,
 				       struct rlist *new_keys)
 {
 	struct func_key_undo *entry;
 	rlist_foreach_entry(entry, new_keys, link) {
-		VERIFY(memtx_tree_index_delete_value_impl<true>(
+		VERIFY(memtx_tree_index_delete_value_impl<MEMTX_TREE_HINT>(
 					index, entry->key, NULL) == 0);
 		tuple_unref((struct tuple *)entry->key.hint);
 	}
 	rlist_foreach_entry(entry, old_keys, link)
-		VERIFY(memtx_tree_index_insert_impl<true>(
+		VERIFY(memtx_tree_index_insert_impl<MEMTX_TREE_HINT>(
 				index, entry->key, NULL, NULL) == 0);
 }
 
@@ -1841,8 +2118,8 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 	*successor = NULL;
 
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
-	struct memtx_tree_index<true> *index =
-		(struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<MEMTX_TREE_HINT> *index =
+		(struct memtx_tree_index<MEMTX_TREE_HINT> *)base;
 	struct index_def *index_def = index->base.def;
 	assert(index_def->key_def->for_func_index);
 	/* Make sure that key_def is not multikey - we rely on it below. */
@@ -1878,7 +2155,7 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 			undo->key.hint = (hint_t)key;
 			rlist_add(&new_keys, &undo->link);
 			bool is_multikey_conflict;
-			struct memtx_tree_data<true> old_data, successor_data;
+			struct memtx_tree_data<MEMTX_TREE_HINT> old_data, successor_data;
 			old_data.tuple = NULL;
 			successor_data.tuple = NULL;
 			err = memtx_tree_index_replace_multikey_one(index,
@@ -1930,7 +2207,7 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 		if (key_list_iterator_create(&it, old_tuple, index_def, false,
 					     tuple_format_runtime) != 0)
 			goto end;
-		struct memtx_tree_data<true> data, deleted_data;
+		struct memtx_tree_data<MEMTX_TREE_HINT> data, deleted_data;
 		data.tuple = old_tuple;
 		struct tuple *key;
 		while (key_list_iterator_next(&it, &key) == 0 && key != NULL) {
@@ -1966,14 +2243,14 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 	return rc;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static struct iterator *
 memtx_tree_index_create_iterator_with_offset(
 	struct index *base, enum iterator_type type, const char *key,
 	uint32_t part_count, const char *pos, uint32_t offset)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 
@@ -1984,41 +2261,41 @@ memtx_tree_index_create_iterator_with_offset(
 		return NULL;
 	});
 
-	struct tree_iterator<USE_HINT> *it = (struct tree_iterator<USE_HINT> *)
+	struct tree_iterator<LAYOUT> *it = (struct tree_iterator<LAYOUT> *)
 		mempool_alloc(&memtx->iterator_pool);
 	if (it == NULL) {
-		diag_set(OutOfMemory, sizeof(struct tree_iterator<USE_HINT>),
+		diag_set(OutOfMemory, sizeof(struct tree_iterator<LAYOUT>),
 			 "memtx_tree_index", "iterator");
 		return NULL;
 	}
 	iterator_create(&it->base, base);
 	it->pool = &memtx->iterator_pool;
-	it->base.next_internal = tree_iterator_start<USE_HINT>;
+	it->base.next_internal = tree_iterator_start<LAYOUT>;
 	it->base.next = memtx_iterator_next;
-	it->base.free = tree_iterator_free<USE_HINT>;
+	it->base.free = tree_iterator_free<LAYOUT>;
 	if (base->def->key_def->for_func_index) {
-		assert(USE_HINT);
+		assert(LAYOUT == MEMTX_TREE_HINT);
 		it->base.position = tree_iterator_position_func;
 	} else if (base->def->key_def->is_multikey) {
-		assert(USE_HINT);
-		it->base.position = tree_iterator_position<true, true>;
+		assert(LAYOUT == MEMTX_TREE_HINT);
+		it->base.position = tree_iterator_position<MEMTX_TREE_HINT, true>;
 	} else {
-		it->base.position = tree_iterator_position<USE_HINT, false>;
+		it->base.position = tree_iterator_position<LAYOUT, false>;
 	}
 	it->type = type;
 	it->key_data.key = key;
 	it->key_data.part_count = part_count;
-	if (USE_HINT)
+	if (LAYOUT != MEMTX_TREE_NO_HINT)
 		it->key_data.set_hint(key_hint(key, part_count, cmp_def));
 	invalidate_tree_iterator(&it->tree_iterator);
 	it->last.tuple = NULL;
-	if (USE_HINT)
+	if (LAYOUT != MEMTX_TREE_NO_HINT)
 		it->last.set_hint(HINT_NONE);
 	it->last_func_key = NULL;
 	if (pos != NULL) {
 		it->after_data.key = pos;
 		it->after_data.part_count = cmp_def->part_count;
-		if (USE_HINT)
+		if (LAYOUT != MEMTX_TREE_NO_HINT)
 			it->after_data.set_hint(HINT_NONE);
 	} else {
 		it->after_data.key = NULL;
@@ -2028,36 +2305,36 @@ memtx_tree_index_create_iterator_with_offset(
 	return (struct iterator *)it;
 }
 
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static struct iterator *
 memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 				 const char *key, uint32_t part_count,
 				 const char *pos)
 {
-	return memtx_tree_index_create_iterator_with_offset<USE_HINT>(
+	return memtx_tree_index_create_iterator_with_offset<LAYOUT>(
 		base, type, key, part_count, pos, 0);
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
 memtx_tree_index_begin_build(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	assert(memtx_tree_size(&index->tree) == 0);
 	(void)index;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	if (size_hint < index->build_array_alloc_size)
 		return 0;
-	struct memtx_tree_data<USE_HINT> *tmp =
-		(struct memtx_tree_data<USE_HINT> *)
+	struct memtx_tree_data<LAYOUT> *tmp =
+		(struct memtx_tree_data<LAYOUT> *)
 			realloc(index->build_array, size_hint * sizeof(*tmp));
 	if (tmp == NULL) {
 		diag_set(OutOfMemory, size_hint * sizeof(*tmp),
@@ -2069,15 +2346,15 @@ memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 /** Initialize the next element of the index build_array. */
 static int
-memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
+memtx_tree_index_build_array_append(struct memtx_tree_index<LAYOUT> *index,
 				    struct tuple *tuple, hint_t hint)
 {
 	if (index->build_array == NULL) {
 		index->build_array =
-			(struct memtx_tree_data<USE_HINT> *)malloc(MEMTX_EXTENT_SIZE);
+			(struct memtx_tree_data<LAYOUT> *)malloc(MEMTX_EXTENT_SIZE);
 		if (index->build_array == NULL) {
 			diag_set(OutOfMemory, MEMTX_EXTENT_SIZE,
 				 "memtx_tree_index", "build_next");
@@ -2090,8 +2367,8 @@ memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
 	if (index->build_array_size == index->build_array_alloc_size) {
 		index->build_array_alloc_size = index->build_array_alloc_size +
 				DIV_ROUND_UP(index->build_array_alloc_size, 2);
-		struct memtx_tree_data<USE_HINT> *tmp =
-			(struct memtx_tree_data<USE_HINT> *)realloc(index->build_array,
+		struct memtx_tree_data<LAYOUT> *tmp =
+			(struct memtx_tree_data<LAYOUT> *)realloc(index->build_array,
 				index->build_array_alloc_size * sizeof(*tmp));
 		if (tmp == NULL) {
 			diag_set(OutOfMemory, index->build_array_alloc_size *
@@ -2100,22 +2377,24 @@ memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
 		}
 		index->build_array = tmp;
 	}
-	struct memtx_tree_data<USE_HINT> *elem =
+	struct memtx_tree_data<LAYOUT> *elem =
 		&index->build_array[index->build_array_size++];
 	elem->tuple = tuple;
-	if (USE_HINT)
+	if (LAYOUT != MEMTX_TREE_NO_HINT)
 		elem->set_hint(hint);
+	if (LAYOUT == MEMTX_TREE_KEY_PREFIX)
+		elem->set_key_prefix(memtx_tree_cmp_def(&index->tree));
 	return 0;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 {
 	if (tuple_key_is_excluded(tuple, base->def->key_def, MULTIKEY_NONE))
 		return 0;
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	return memtx_tree_index_build_array_append(index, tuple,
 						   tuple_hint(tuple, cmp_def));
@@ -2124,7 +2403,7 @@ memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 static int
 memtx_tree_index_build_next_multikey(struct index *base, struct tuple *tuple)
 {
-	struct memtx_tree_index<true> *index = (struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<MEMTX_TREE_HINT> *index = (struct memtx_tree_index<MEMTX_TREE_HINT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	uint32_t multikey_count = tuple_multikey_count(tuple, cmp_def);
 	for (uint32_t multikey_idx = 0; multikey_idx < multikey_count;
@@ -2143,8 +2422,8 @@ static int
 memtx_tree_func_index_build_next(struct index *base, struct tuple *tuple)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
-	struct memtx_tree_index<true> *index =
-		(struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<MEMTX_TREE_HINT> *index =
+		(struct memtx_tree_index<MEMTX_TREE_HINT> *)base;
 	struct index_def *index_def = index->base.def;
 	assert(index_def->key_def->for_func_index);
 	/* Make sure that key_def is not multikey - we rely on it below. */
@@ -2185,10 +2464,10 @@ memtx_tree_func_index_build_next(struct index *base, struct tuple *tuple)
  * of equal tuples (in terms of index's cmp_def and have same
  * tuple pointer). The build_array is expected to be sorted.
  */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
 memtx_tree_index_build_array_deduplicate(
-	struct memtx_tree_index<USE_HINT> *index)
+	struct memtx_tree_index<LAYOUT> *index)
 {
 	if (index->build_array_size == 0)
 		return;
@@ -2228,17 +2507,17 @@ memtx_sort_thread_init(void *arg)
 	tuple_formats_inherit(formats);
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
 memtx_tree_index_end_build(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
 	tt_sort(index->build_array, index->build_array_size,
 		sizeof(index->build_array[0]),
-		memtx_tree_qcompare<USE_HINT>, cmp_def,
+		memtx_tree_qcompare<LAYOUT>, cmp_def,
 		memtx_sort_thread_init, tuple_formats,
 		memtx->sort_threads);
 	if (cmp_def->is_multikey || cmp_def->for_func_index) {
@@ -2249,7 +2528,7 @@ memtx_tree_index_end_build(struct index *base)
 		 * the following memtx_tree_build assumes that
 		 * all keys are unique.
 		 */
-		memtx_tree_index_build_array_deduplicate<USE_HINT>(index);
+		memtx_tree_index_build_array_deduplicate<LAYOUT>(index);
 	}
 	memtx_tree_build(&index->tree, index->build_array,
 			 index->build_array_size);
@@ -2260,18 +2539,49 @@ memtx_tree_index_end_build(struct index *base)
 	index->build_array_alloc_size = 0;
 }
 
+template <memtx_tree_layout LAYOUT>
+static void
+memtx_tree_index_relocate(struct index *base, struct tuple *old_tuple,
+			  struct tuple *new_tuple)
+{
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	if (tuple_key_is_excluded(old_tuple, base->def->key_def,
+				  MULTIKEY_NONE))
+		return;
+	/*
+	 * The tuples are equal so the found entry can be updated in
+	 * place without breaking the order of the tree.
+	 */
+	struct memtx_tree_data<LAYOUT> old_data;
+	old_data.tuple = old_tuple;
+	if (LAYOUT != MEMTX_TREE_NO_HINT)
+		old_data.set_hint(tuple_hint(old_tuple, cmp_def));
+	if (LAYOUT == MEMTX_TREE_KEY_PREFIX)
+		old_data.set_key_prefix(cmp_def);
+	bool exact = false;
+	memtx_tree_iterator_t<LAYOUT> it =
+		memtx_tree_lower_bound_elem(&index->tree, old_data, &exact);
+	assert(exact);
+	struct memtx_tree_data<LAYOUT> *elem =
+		memtx_tree_iterator_get_elem(&index->tree, &it);
+	assert(elem != NULL && elem->tuple == old_tuple);
+	elem->tuple = new_tuple;
+}
+
 /**
  * Build the index using the O(n) sort algorithm with MemTX sort data.
  */
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 memtx_tree_index_build_using_sort_data(
 	struct index *base,
 	struct memtx_sort_data_reader *reader)
 {
 	assert(!base->def->key_def->for_func_index);
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
 
 	/* Check if can use the sort data. */
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
@@ -2281,9 +2591,9 @@ memtx_tree_index_build_using_sort_data(
 	/* Load the build array. */
 	size_t build_array_size = memtx_sort_data_reader_get_size(reader);
 	size_t build_array_bsize = build_array_size *
-				   sizeof(struct memtx_tree_data<USE_HINT>);
-	struct memtx_tree_data<USE_HINT> *build_array =
-		(struct memtx_tree_data<USE_HINT> *)xmalloc(build_array_bsize);
+				   sizeof(struct memtx_tree_data<LAYOUT>);
+	struct memtx_tree_data<LAYOUT> *build_array =
+		(struct memtx_tree_data<LAYOUT> *)xmalloc(build_array_bsize);
 	auto _ = make_scoped_guard([build_array] { free(build_array); });
 	if (memtx_sort_data_reader_get(reader, build_array,
 				       build_array_bsize) != 0)
@@ -2308,13 +2618,75 @@ int
 memtx_tree_index_build_using_sort_data(struct index *base,
 				       struct memtx_sort_data_reader *reader)
 {
-	if (memtx_tree_index_uses_hint(base->def)) {
-		return memtx_tree_index_build_using_sort_data<true>(base,
-								    reader);
-	} else {
-		return memtx_tree_index_build_using_sort_data<false>(base,
-								     reader);
+	switch (memtx_tree_index_layout(base->def)) {
+	case MEMTX_TREE_NO_HINT:
+		return memtx_tree_index_build_using_sort_data
+			<MEMTX_TREE_NO_HINT>(base, reader);
+	case MEMTX_TREE_HINT:
+		return memtx_tree_index_build_using_sort_data
+			<MEMTX_TREE_HINT>(base, reader);
+	case MEMTX_TREE_KEY_PREFIX:
+		return memtx_tree_index_build_using_sort_data
+			<MEMTX_TREE_KEY_PREFIX>(base, reader);
+	}
+	unreachable();
+	return -1;
+}
+
+/**
+ * Check the unique constraint of an index built from an unchecked
+ * sequence of tuples. The tree is ordered by cmp_def, which starts with
+ * the index key parts, so tuples with equal keys are adjacent and it
+ * suffices to compare the key of each tuple with the next one. Keys
+ * containing NULL don't violate the constraint of a nullable index.
+ */
+template <memtx_tree_layout LAYOUT>
+static int
+memtx_tree_index_check_unique(struct index *base)
+{
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
+	struct key_def *key_def = base->def->key_def;
+	memtx_tree_iterator_t<LAYOUT> it = memtx_tree_first(&index->tree);
+	struct memtx_tree_data<LAYOUT> *prev = NULL;
+	struct memtx_tree_data<LAYOUT> *curr;
+	while ((curr = memtx_tree_iterator_get_elem(&index->tree,
+						    &it)) != NULL) {
+		if (prev != NULL &&
+		    memtx_tree_compare(prev, curr, key_def) == 0 &&
+		    !(key_def->is_nullable &&
+		      tuple_key_contains_null(curr->tuple, key_def,
+					      MULTIKEY_NONE))) {
+			diag_set(ClientError, ER_TUPLE_FOUND, base->def->name,
+				 base->def->space_name, tuple_str(prev->tuple),
+				 tuple_str(curr->tuple), prev->tuple,
+				 curr->tuple);
+			return -1;
+		}
+		prev = curr;
+		memtx_tree_iterator_next(&index->tree, &it);
+	}
+	return 0;
+}
+
+int
+memtx_tree_index_check_unique(struct index *base)
+{
+	if (!base->def->opts.is_unique)
+		return 0;
+	assert(!base->def->key_def->is_multikey);
+	assert(!base->def->key_def->for_func_index);
+	switch (memtx_tree_index_layout(base->def)) {
+	case MEMTX_TREE_NO_HINT:
+		return memtx_tree_index_check_unique<MEMTX_TREE_NO_HINT>(base);
+	case MEMTX_TREE_HINT:
+		return memtx_tree_index_check_unique<MEMTX_TREE_HINT>(base);
+	case MEMTX_TREE_KEY_PREFIX:
+		return memtx_tree_index_check_unique
+			<MEMTX_TREE_KEY_PREFIX>(base);
 	}
+	unreachable();
+	return -1;
 }
 
 static int
@@ -2342,52 +2714,56 @@ memtx_tree_disabled_index_replace(struct index *index, struct tuple *old_tuple,
 }
 
 /** Read view implementation. */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 struct tree_read_view {
 	/** Base class. */
 	struct index_read_view base;
 	/** Read view index. Ref counter incremented. */
-	struct memtx_tree_index<USE_HINT> *index;
+	struct memtx_tree_index<LAYOUT> *index;
 	/** BPS tree read view. */
-	memtx_tree_view_t<USE_HINT> tree_view;
+	memtx_tree_view_t<LAYOUT> tree_view;
 	/** Used for clarifying read view tuples. */
 	struct memtx_tx_snapshot_cleaner cleaner;
 	/** Used for dumping into the sort data file. */
-	memtx_tree_iterator_t<USE_HINT> dump_iterator;
+	memtx_tree_iterator_t<LAYOUT> dump_iterator;
 };
 
 /** Read view iterator implementation. */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 struct tree_read_view_iterator {
 	/** Base class. */
 	struct index_read_view_iterator_base base;
 	/** Iterator key. */
-	struct memtx_tree_key_data<USE_HINT> key_data;
+	struct memtx_tree_key_data<LAYOUT> key_data;
 	/** BPS tree iterator. */
-	memtx_tree_iterator_t<USE_HINT> tree_iterator;
+	memtx_tree_iterator_t<LAYOUT> tree_iterator;
 	/**
 	 * Data that was fetched last. Is NULL only if there was no data
 	 * fetched. Otherwise, tuple pointer is not NULL, even if iterator
 	 * is exhausted - pagination relies on it.
 	 */
-	struct memtx_tree_data<USE_HINT> *last;
+	struct memtx_tree_data<LAYOUT> *last;
 };
 
-static_assert(sizeof(struct tree_read_view_iterator<false>) <=
+static_assert(sizeof(struct tree_read_view_iterator<MEMTX_TREE_NO_HINT>) <=
 	      INDEX_READ_VIEW_ITERATOR_SIZE,
-	      "sizeof(struct tree_read_view_iterator<false>) must be less than "
+	      "sizeof(struct tree_read_view_iterator<MEMTX_TREE_NO_HINT>) must be less than "
 	      "or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
-static_assert(sizeof(struct tree_read_view_iterator<true>) <=
+static_assert(sizeof(struct tree_read_view_iterator<MEMTX_TREE_HINT>) <=
 	      INDEX_READ_VIEW_ITERATOR_SIZE,
-	      "sizeof(struct tree_read_view_iterator<true>) must be less than "
+	      "sizeof(struct tree_read_view_iterator<MEMTX_TREE_HINT>) must be less than "
 	      "or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_read_view_iterator<MEMTX_TREE_KEY_PREFIX>) <=
+	      INDEX_READ_VIEW_ITERATOR_SIZE,
+	      "sizeof(struct tree_read_view_iterator<MEMTX_TREE_KEY_PREFIX>) must be "
+	      "less than or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static void
 tree_read_view_free(struct index_read_view *base)
 {
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)base;
+	struct tree_read_view<LAYOUT> *rv =
+		(struct tree_read_view<LAYOUT> *)base;
 	memtx_tree_view_destroy(&rv->tree_view);
 	index_unref(&rv->index->base);
 	memtx_tx_snapshot_cleaner_destroy(&rv->cleaner);
@@ -2399,7 +2775,7 @@ tree_read_view_free(struct index_read_view *base)
 # include "memtx_tree_read_view.cc"
 #else /* !defined(ENABLE_READ_VIEW) */
 
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static ssize_t
 tree_read_view_count(struct index_read_view *rv, enum iterator_type type,
 		     const char *key, uint32_t part_count)
@@ -2407,7 +2783,7 @@ tree_read_view_count(struct index_read_view *rv, enum iterator_type type,
 	return generic_index_read_view_count(rv, type, key, part_count);
 }
 
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 tree_read_view_quantile(struct index_read_view *rv, double level,
 			const char *begin_key, uint32_t begin_part_count,
@@ -2420,33 +2796,48 @@ tree_read_view_quantile(struct index_read_view *rv, double level,
 		quantile_key, quantile_key_size);
 }
 
-template <bool USE_HINT>
+/** Implementation of get_raw index_read_view callback. */
+template <memtx_tree_layout LAYOUT>
 static int
-tree_read_view_get_raw(struct index_read_view *rv,
+tree_read_view_get_raw(struct index_read_view *base,
 		       const char *key, uint32_t part_count,
 		       struct read_view_tuple *result)
 {
-	(void)rv;
-	(void)key;
-	(void)part_count;
-	(void)result;
-	unreachable();
-	return 0;
+	struct tree_read_view<LAYOUT> *rv =
+		(struct tree_read_view<LAYOUT> *)base;
+	assert(base->def->opts.is_unique &&
+	       part_count == base->def->key_def->part_count);
+	assert(!base->def->key_def->is_multikey &&
+	       !base->def->key_def->for_func_index);
+	struct key_def *cmp_def = base->def->cmp_def;
+	struct memtx_tree_key_data<LAYOUT> key_data;
+	key_data.key = key;
+	key_data.part_count = part_count;
+	if (LAYOUT != MEMTX_TREE_NO_HINT)
+		key_data.set_hint(key_hint(key, part_count, cmp_def));
+	struct memtx_tree_data<LAYOUT> *res =
+		memtx_tree_view_find(&rv->tree_view, &key_data);
+	if (res == NULL) {
+		*result = read_view_tuple_none();
+		return 0;
+	}
+	return memtx_prepare_read_view_tuple(res->tuple, base, &rv->cleaner,
+					     result);
 }
 
 /** Implementation of next_raw index_read_view_iterator callback. */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 tree_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
 				 struct read_view_tuple *result)
 {
-	struct tree_read_view_iterator<USE_HINT> *it =
-		(struct tree_read_view_iterator<USE_HINT> *)iterator;
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)it->base.index;
+	struct tree_read_view_iterator<LAYOUT> *it =
+		(struct tree_read_view_iterator<LAYOUT> *)iterator;
+	struct tree_read_view<LAYOUT> *rv =
+		(struct tree_read_view<LAYOUT> *)it->base.index;
 
 	while (true) {
-		struct memtx_tree_data<USE_HINT> *res =
+		struct memtx_tree_data<LAYOUT> *res =
 			memtx_tree_view_iterator_get_elem(&rv->tree_view,
 							  &it->tree_iterator);
 
@@ -2466,9 +2857,9 @@ tree_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
 }
 
 /** Positions the iterator to the given key. */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
-tree_read_view_iterator_start(struct tree_read_view_iterator<USE_HINT> *it,
+tree_read_view_iterator_start(struct tree_read_view_iterator<LAYOUT> *it,
 			      enum iterator_type type,
 			      const char *key, uint32_t part_count,
 			      const char *pos, uint32_t offset)
@@ -2483,18 +2874,22 @@ tree_read_view_iterator_start(struct tree_read_view_iterator<USE_HINT> *it,
 	(void)part_count;
 	(void)pos;
 	(void)offset;
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)it->base.index;
-	it->base.next_raw = tree_read_view_iterator_next_raw<USE_HINT>;
+	struct tree_read_view<LAYOUT> *rv =
+		(struct tree_read_view<LAYOUT> *)it->base.index;
+	it->base.next_raw = tree_read_view_iterator_next_raw<LAYOUT>;
 	it->tree_iterator = memtx_tree_view_first(&rv->tree_view);
 	return 0;
 }
 
-template <bool USE_HINT>
+/**
+ * Make the tree view use the key definition owned by the read view,
+ * because the index key definition may be freed on alter.
+ */
+template <memtx_tree_layout LAYOUT>
 static void
-tree_read_view_reset_key_def(struct tree_read_view<USE_HINT> *rv)
+tree_read_view_reset_key_def(struct tree_read_view<LAYOUT> *rv)
 {
-	rv->tree_view.common.arg = NULL;
+	rv->tree_view.common.arg = rv->base.def->cmp_def;
 }
 
 #endif /* !defined(ENABLE_READ_VIEW) */
@@ -2502,14 +2897,14 @@ tree_read_view_reset_key_def(struct tree_read_view<USE_HINT> *rv)
 /**
  * Implementation of iterator position for general and multikey read views.
  */
-template <bool USE_HINT, bool IS_MULTIKEY>
+template <memtx_tree_layout LAYOUT, bool IS_MULTIKEY>
 static int
 tree_read_view_iterator_position(struct index_read_view_iterator *it,
 				 const char **pos, uint32_t *size)
 {
-	struct tree_read_view_iterator<USE_HINT> *tree_it =
-		(struct tree_read_view_iterator<USE_HINT> *)it;
-	return tree_iterator_position_impl<USE_HINT, IS_MULTIKEY>(
+	struct tree_read_view_iterator<LAYOUT> *tree_it =
+		(struct tree_read_view_iterator<LAYOUT> *)it;
+	return tree_iterator_position_impl<LAYOUT, IS_MULTIKEY>(
 		tree_it->last, it->base.index->def, pos, size);
 }
 
@@ -2520,23 +2915,23 @@ static int
 tree_read_view_iterator_position_func(struct index_read_view_iterator *it,
 				      const char **pos, uint32_t *size)
 {
-	struct tree_read_view_iterator<true> *tree_it =
-		(struct tree_read_view_iterator<true> *)it;
+	struct tree_read_view_iterator<MEMTX_TREE_HINT> *tree_it =
+		(struct tree_read_view_iterator<MEMTX_TREE_HINT> *)it;
 	return tree_iterator_position_func_impl(tree_it->last,
 						it->base.index->def,
 						pos, size);
 }
 
 /** Implementation of create_iterator_with_offset index_read_view callback. */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 tree_read_view_create_iterator_with_offset(
 	struct index_read_view *base, enum iterator_type type, const char *key,
 	uint32_t part_count, const char *pos, uint32_t offset,
 	struct index_read_view_iterator *iterator)
 {
-	struct tree_read_view_iterator<USE_HINT> *it =
-		(struct tree_read_view_iterator<USE_HINT> *)iterator;
+	struct tree_read_view_iterator<LAYOUT> *it =
+		(struct tree_read_view_iterator<LAYOUT> *)iterator;
 	it->base.index = base;
 	it->base.destroy = generic_index_read_view_iterator_destroy;
 	it->base.next_raw = exhausted_index_read_view_iterator_next_raw;
@@ -2545,13 +2940,13 @@ tree_read_view_create_iterator_with_offset(
 			tree_read_view_iterator_position_func;
 	else if (it->base.index->def->key_def->is_multikey)
 		it->base.position =
-			tree_read_view_iterator_position<true, true>;
+			tree_read_view_iterator_position<MEMTX_TREE_HINT, true>;
 	else
 		it->base.position =
-			tree_read_view_iterator_position<USE_HINT, false>;
+			tree_read_view_iterator_position<LAYOUT, false>;
 	it->key_data.key = NULL;
 	it->key_data.part_count = 0;
-	if (USE_HINT)
+	if (LAYOUT != MEMTX_TREE_NO_HINT)
 		it->key_data.set_hint(HINT_NONE);
 	it->last = NULL;
 	invalidate_tree_iterator(&it->tree_iterator);
@@ -2560,37 +2955,37 @@ tree_read_view_create_iterator_with_offset(
 }
 
 /** Implementation of create_iterator index_read_view callback. */
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 tree_read_view_create_iterator(struct index_read_view *base,
 			       enum iterator_type type, const char *key,
 			       uint32_t part_count, const char *pos,
 			       struct index_read_view_iterator *iterator)
 {
-	return tree_read_view_create_iterator_with_offset<USE_HINT>(
+	return tree_read_view_create_iterator_with_offset<LAYOUT>(
 		base, type, key, part_count, pos, 0, iterator);
 }
 
 /** Implementation of create_read_view index callback. */
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static struct index_read_view *
 memtx_tree_index_create_read_view(struct index *base)
 {
 	static const struct index_read_view_vtab vtab = {
-		.free = tree_read_view_free<USE_HINT>,
-		.count = tree_read_view_count<USE_HINT>,
-		.quantile = tree_read_view_quantile<USE_HINT>,
-		.get_raw = tree_read_view_get_raw<USE_HINT>,
-		.create_iterator = tree_read_view_create_iterator<USE_HINT>,
+		.free = tree_read_view_free<LAYOUT>,
+		.count = tree_read_view_count<LAYOUT>,
+		.quantile = tree_read_view_quantile<LAYOUT>,
+		.get_raw = tree_read_view_get_raw<LAYOUT>,
+		.create_iterator = tree_read_view_create_iterator<LAYOUT>,
 		.create_iterator_with_offset =
-			tree_read_view_create_iterator_with_offset<USE_HINT>,
+			tree_read_view_create_iterator_with_offset<LAYOUT>,
 		.create_arrow_stream =
 			generic_index_read_view_create_arrow_stream,
 	};
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)xmalloc(sizeof(*rv));
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)base;
+	struct tree_read_view<LAYOUT> *rv =
+		(struct tree_read_view<LAYOUT> *)xmalloc(sizeof(*rv));
 	index_read_view_create(&rv->base, &vtab, base->def);
 	struct space *space = space_by_id(base->def->space_id);
 	assert(space != NULL);
@@ -2604,7 +2999,7 @@ memtx_tree_index_create_read_view(struct index *base)
 }
 
 /** Dump the tree data into the sort data file. */
-template<bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static int
 memtx_tree_index_read_view_dump_sort_data(
 	struct index_read_view *base, int tuple_count,
@@ -2613,17 +3008,17 @@ memtx_tree_index_read_view_dump_sort_data(
 	assert(!base->def->key_def->for_func_index);
 
 	/* Collect the data to save. */
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)base;
-	struct memtx_tree_data<USE_HINT> *buffer =
-		(struct memtx_tree_data<USE_HINT> *)
+	struct tree_read_view<LAYOUT> *rv =
+		(struct tree_read_view<LAYOUT> *)base;
+	struct memtx_tree_data<LAYOUT> *buffer =
+		(struct memtx_tree_data<LAYOUT> *)
 			xmalloc(sizeof(*buffer) * tuple_count);
 	auto _ = make_scoped_guard([buffer] { free(buffer); });
 	int dumped = 0;
 	while (dumped != tuple_count &&
 	       memtx_tree_view_iterator_next(&rv->tree_view,
 					     &rv->dump_iterator)) {
-		struct memtx_tree_data<USE_HINT> *data =
+		struct memtx_tree_data<LAYOUT> *data =
 			memtx_tree_view_iterator_get_elem(
 				&rv->tree_view, &rv->dump_iterator);
 		/* Only dump visible data. */
@@ -2633,8 +3028,10 @@ memtx_tree_index_read_view_dump_sort_data(
 			continue;
 		/* Dump clarified tuples with hints (optionally). */
 		buffer[dumped].tuple = clarified;
-		if (USE_HINT)
+		if (LAYOUT != MEMTX_TREE_NO_HINT)
 			buffer[dumped].set_hint(data->hint);
+		if (LAYOUT == MEMTX_TREE_KEY_PREFIX)
+			buffer[dumped].copy_key_prefix(data);
 		dumped++;
 	}
 
@@ -2652,13 +3049,22 @@ memtx_tree_index_read_view_dump_sort_data(
 	struct index_read_view *base, int tuple_count,
 	struct memtx_sort_data_writer *sort_data, bool *have_more)
 {
-	if (memtx_tree_index_uses_hint(base->def)) {
-		return memtx_tree_index_read_view_dump_sort_data<true>(
-			base, tuple_count, sort_data, have_more);
-	} else {
-		return memtx_tree_index_read_view_dump_sort_data<false>(
-			base, tuple_count, sort_data, have_more);
+	switch (memtx_tree_index_layout(base->def)) {
+	case MEMTX_TREE_NO_HINT:
+		return memtx_tree_index_read_view_dump_sort_data
+			<MEMTX_TREE_NO_HINT>(base, tuple_count, sort_data,
+					     have_more);
+	case MEMTX_TREE_HINT:
+		return memtx_tree_index_read_view_dump_sort_data
+			<MEMTX_TREE_HINT>(base, tuple_count, sort_data,
+					  have_more);
+	case MEMTX_TREE_KEY_PREFIX:
+		return memtx_tree_index_read_view_dump_sort_data
+			<MEMTX_TREE_KEY_PREFIX>(base, tuple_count, sort_data,
+						have_more);
 	}
+	unreachable();
+	return -1;
 }
 
 /**
@@ -2668,7 +3074,7 @@ memtx_tree_index_read_view_dump_sort_data(
  * key defintion is not completely initialized at that moment).
  */
 static const struct index_vtab memtx_tree_disabled_index_vtab_base = {
-	/* .destroy = */ memtx_tree_index_destroy<true>,
+	/* .destroy = */ memtx_tree_index_destroy<MEMTX_TREE_HINT>,
 	/* .commit_create = */ generic_index_commit_create,
 	/* .abort_create = */ generic_index_abort_create,
 	/* .commit_modify = */ generic_index_commit_modify,
@@ -2686,6 +3092,7 @@ static const struct index_vtab memtx_tree_disabled_index_vtab_base = {
 	/* .count = */ generic_index_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ generic_index_get,
+	/* .prefetch = */ generic_index_prefetch,
 	/* .create_iterator = */ generic_index_create_iterator,
 	/* .create_iterator_with_offset = */
 	generic_index_create_iterator_with_offset,
@@ -2703,6 +3110,7 @@ static const struct memtx_index_vtab memtx_tree_disabled_index_vtab = {
 	/* .reserve = */ generic_memtx_index_reserve,
 	/* .build_next = */ memtx_tree_disabled_index_build_next,
 	/* .end_build = */ generic_memtx_index_end_build,
+	/* .relocate = */ NULL,
 };
 
 /** Type of index in terms of different vtabs. */
@@ -2720,14 +3128,17 @@ enum memtx_tree_vtab_type {
 };
 
 /**
- * Get index vtab by @a TYPE and @a USE_HINT, template version.
- * USE_HINT == false is only allowed for general index type.
+ * Get index vtab by @a TYPE and @a LAYOUT, template version.
+ * Layouts other than MEMTX_TREE_HINT are only allowed for general
+ * index type.
  */
-template <memtx_tree_vtab_type TYPE, bool USE_HINT = true>
+template <memtx_tree_vtab_type TYPE,
+	  memtx_tree_layout LAYOUT = MEMTX_TREE_HINT>
 static const struct index_vtab *
 get_memtx_tree_index_vtab(void)
 {
-	static_assert(USE_HINT || TYPE == MEMTX_TREE_VTAB_GENERAL,
+	static_assert(LAYOUT == MEMTX_TREE_HINT ||
+		      TYPE == MEMTX_TREE_VTAB_GENERAL,
 		      "Multikey and func indexes must use hints");
 
 	if (TYPE == MEMTX_TREE_VTAB_DISABLED)
@@ -2736,31 +3147,32 @@ get_memtx_tree_index_vtab(void)
 	const bool is_mk = TYPE == MEMTX_TREE_VTAB_MULTIKEY;
 	const bool is_func = TYPE == MEMTX_TREE_VTAB_FUNC;
 	static const struct index_vtab vtab_base = {
-		/* .destroy = */ memtx_tree_index_destroy<USE_HINT>,
+		/* .destroy = */ memtx_tree_index_destroy<LAYOUT>,
 		/* .commit_create = */ generic_index_commit_create,
 		/* .abort_create = */ generic_index_abort_create,
 		/* .commit_modify = */ generic_index_commit_modify,
 		/* .commit_drop = */ generic_index_commit_drop,
-		/* .update_def = */ memtx_tree_index_update_def<USE_HINT>,
+		/* .update_def = */ memtx_tree_index_update_def<LAYOUT>,
 		/* .depends_on_pk = */ memtx_tree_index_depends_on_pk,
 		/* .def_change_requires_rebuild = */
 			memtx_index_def_change_requires_rebuild,
-		/* .size = */ memtx_tree_index_size<USE_HINT>,
-		/* .bsize = */ memtx_tree_index_bsize<USE_HINT>,
-		/* .quantile = */ memtx_tree_index_quantile<USE_HINT>,
+		/* .size = */ memtx_tree_index_size<LAYOUT>,
+		/* .bsize = */ memtx_tree_index_bsize<LAYOUT>,
+		/* .quantile = */ memtx_tree_index_quantile<LAYOUT>,
 		/* .min = */ generic_index_min,
 		/* .max = */ generic_index_max,
-		/* .random = */ memtx_tree_index_random<USE_HINT>,
-		/* .count = */ memtx_tree_index_count<USE_HINT>,
-		/* .get_internal */ memtx_tree_index_get_internal<USE_HINT>,
+		/* .random = */ memtx_tree_index_random<LAYOUT>,
+		/* .count = */ memtx_tree_index_count<LAYOUT>,
+		/* .get_internal */ memtx_tree_index_get_internal<LAYOUT>,
 		/* .get = */ memtx_index_get,
+		/* .prefetch = */ generic_index_prefetch,
 		/* .create_iterator = */
-			memtx_tree_index_create_iterator<USE_HINT>,
+			memtx_tree_index_create_iterator<LAYOUT>,
 		/* .create_iterator_with_offset = */
-		memtx_tree_index_create_iterator_with_offset<USE_HINT>,
+		memtx_tree_index_create_iterator_with_offset<LAYOUT>,
 		/* .create_arrow_stream = */ generic_index_create_arrow_stream,
 		/* .create_read_view = */
-			memtx_tree_index_create_read_view<USE_HINT>,
+			memtx_tree_index_create_read_view<LAYOUT>,
 		/* .stat = */ generic_index_stat,
 		/* .compact = */ generic_index_compact,
 		/* .reset_stat = */ generic_index_reset_stat,
@@ -2769,24 +3181,26 @@ get_memtx_tree_index_vtab(void)
 		/* .base = */ vtab_base,
 		/* .replace = */ is_mk ? memtx_tree_index_replace_multikey :
 				 is_func ? memtx_tree_func_index_replace :
-				 memtx_tree_index_replace<USE_HINT>,
-		/* .begin_build = */ memtx_tree_index_begin_build<USE_HINT>,
-		/* .reserve = */ memtx_tree_index_reserve<USE_HINT>,
+				 memtx_tree_index_replace<LAYOUT>,
+		/* .begin_build = */ memtx_tree_index_begin_build<LAYOUT>,
+		/* .reserve = */ memtx_tree_index_reserve<LAYOUT>,
 		/* .build_next = */ is_mk ? memtx_tree_index_build_next_multikey :
 				    is_func ? memtx_tree_func_index_build_next :
-				    memtx_tree_index_build_next<USE_HINT>,
-		/* .end_build = */ memtx_tree_index_end_build<USE_HINT>,
+				    memtx_tree_index_build_next<LAYOUT>,
+		/* .end_build = */ memtx_tree_index_end_build<LAYOUT>,
+		/* .relocate = */ is_mk || is_func ? NULL :
+				  memtx_tree_index_relocate<LAYOUT>,
 	};
 	return (struct index_vtab *)&vtab;
 }
 
-template <bool USE_HINT>
+template <memtx_tree_layout LAYOUT>
 static struct index *
 memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
 			 const struct index_vtab *vtab)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)
+	struct memtx_tree_index<LAYOUT> *index =
+		(struct memtx_tree_index<LAYOUT> *)
 		xcalloc(1, sizeof(*index));
 	index_create(&index->base, (struct engine *)memtx, vtab, def);
 
@@ -2805,7 +3219,7 @@ memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
 struct index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 {
-	bool use_hint = memtx_tree_index_uses_hint(def);
+	enum memtx_tree_layout layout = memtx_tree_index_layout(def);
 	const struct index_vtab *vtab;
 	if (def->key_def->for_func_index) {
 		if (def->key_def->func_index_func != NULL) {
@@ -2815,21 +3229,31 @@ memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 			vtab = get_memtx_tree_index_vtab
 				<MEMTX_TREE_VTAB_DISABLED>();
 		}
-		assert(use_hint);
+		assert(layout == MEMTX_TREE_HINT);
 	} else if (def->key_def->is_multikey) {
 		vtab = get_memtx_tree_index_vtab<MEMTX_TREE_VTAB_MULTIKEY>();
-		assert(use_hint);
-	} else if (def->opts.hint == INDEX_HINT_ON) {
+		assert(layout == MEMTX_TREE_HINT);
+	} else if (layout == MEMTX_TREE_KEY_PREFIX) {
 		vtab = get_memtx_tree_index_vtab
-			<MEMTX_TREE_VTAB_GENERAL, true>();
-		assert(use_hint);
+			<MEMTX_TREE_VTAB_GENERAL, MEMTX_TREE_KEY_PREFIX>();
+	} else if (layout == MEMTX_TREE_HINT) {
+		vtab = get_memtx_tree_index_vtab
+			<MEMTX_TREE_VTAB_GENERAL, MEMTX_TREE_HINT>();
 	} else {
 		vtab = get_memtx_tree_index_vtab
-			<MEMTX_TREE_VTAB_GENERAL, false>();
-		assert(!use_hint);
+			<MEMTX_TREE_VTAB_GENERAL, MEMTX_TREE_NO_HINT>();
 	}
-	if (use_hint)
-		return memtx_tree_index_new_tpl<true>(memtx, def, vtab);
-	else
-		return memtx_tree_index_new_tpl<false>(memtx, def, vtab);
+	switch (layout) {
+	case MEMTX_TREE_NO_HINT:
+		return memtx_tree_index_new_tpl<MEMTX_TREE_NO_HINT>(memtx, def,
+								    vtab);
+	case MEMTX_TREE_HINT:
+		return memtx_tree_index_new_tpl<MEMTX_TREE_HINT>(memtx, def,
+								 vtab);
+	case MEMTX_TREE_KEY_PREFIX:
+		return memtx_tree_index_new_tpl<MEMTX_TREE_KEY_PREFIX>(
+			memtx, def, vtab);
+	}
+	unreachable();
+	return NULL;
 }
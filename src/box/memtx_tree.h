@@ -44,6 +44,17 @@ struct memtx_sort_data_writer;
 struct index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def);
 
+/**
+ * Check if the 'layout' option of an index definition is supported
+ * by memtx. The only supported layout is "key_prefix": a tree index
+ * storing a prefix of the first key part, which must be a string,
+ * along with each tuple pointer. Returns 0 on success, -1 on error
+ * (diag is set).
+ */
+int
+memtx_tree_index_check_layout(const struct index_def *def,
+			      const char *space_name);
+
 /**
  * Dump the index sort data via the given writer.
  */
@@ -59,6 +70,15 @@ int
 memtx_tree_index_build_using_sort_data(struct index *base,
 				       struct memtx_sort_data_reader *reader);
 
+/**
+ * Check that an index built with begin_build(), build_next() and
+ * end_build() doesn't violate its unique constraint: unlike replace(),
+ * the build doesn't check it. Returns 0 on success, -1 if a duplicate
+ * is found (diag is set).
+ */
+int
+memtx_tree_index_check_unique(struct index *base);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
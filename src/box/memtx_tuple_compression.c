@@ -0,0 +1,300 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_tuple_compression.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <zstd.h>
+
+#include "diag.h"
+#include "error.h"
+#include "fiber.h"
+#include "memtx_engine.h"
+#include "mp_compression.h"
+#include "mp_extension_types.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "trivia/util.h"
+#include "tuple.h"
+#include "tuple_format.h"
+
+#if defined(ENABLE_TUPLE_COMPRESSION)
+# error unimplemented
+#endif
+
+enum {
+	/**
+	 * Fields shorter than this are never compressed: the MP_EXT
+	 * header and the zstd frame header eat all the savings.
+	 */
+	MEMTX_TUPLE_COMPRESSION_MIN_FIELD_SIZE = 64,
+};
+
+/**
+ * Compression context. Compression is only done in the tx thread so
+ * a single context is enough. Created on demand and never freed.
+ */
+static ZSTD_CCtx *memtx_zstd_cctx;
+
+/**
+ * Decompression context. Read views may be read from application
+ * threads so the context is thread-local. Created on demand and never
+ * freed.
+ */
+static __thread ZSTD_DCtx *memtx_zstd_dctx;
+
+/**
+ * Try to compress the MsgPack field [@a field, @a field_end) with
+ * the given options and write it to @a out encoded as MP_COMPRESSION.
+ * Returns the end of the written data or @a out if compression turned
+ * out to be useless because the field didn't shrink. On error returns
+ * NULL and sets diag.
+ */
+static char *
+memtx_tuple_compress_field(const struct compression_opts *opts,
+			   const char *field, const char *field_end, char *out)
+{
+	assert(opts->type == COMPRESSION_TYPE_ZSTD);
+	size_t raw_size = field_end - field;
+	if (raw_size < MEMTX_TUPLE_COMPRESSION_MIN_FIELD_SIZE)
+		return out;
+	if (memtx_zstd_cctx == NULL) {
+		memtx_zstd_cctx = ZSTD_createCCtx();
+		if (memtx_zstd_cctx == NULL) {
+			diag_set(OutOfMemory, sizeof(memtx_zstd_cctx),
+				 "malloc", "zstd context");
+			return NULL;
+		}
+	}
+	struct region *region = &fiber()->gc;
+	size_t bound = ZSTD_compressBound(raw_size);
+	char *buf = xregion_alloc(region, bound);
+	size_t size = ZSTD_compressCCtx(memtx_zstd_cctx, buf, bound,
+					field, raw_size, opts->level);
+	if (ZSTD_isError(size)) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 ZSTD_getErrorName(size));
+		return NULL;
+	}
+	uint32_t payload_size = 1 + mp_sizeof_uint(raw_size) + size;
+	if (mp_sizeof_ext(payload_size) >= raw_size)
+		return out;
+	out = mp_encode_extl(out, MP_COMPRESSION, payload_size);
+	*out++ = (char)opts->type;
+	out = mp_encode_uint(out, raw_size);
+	memcpy(out, buf, size);
+	return out + size;
+}
+
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple)
+{
+	struct tuple_format *format = tuple_format(tuple);
+	assert(format->is_compressed);
+	assert(!tuple_is_compressed(tuple));
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	uint32_t compressible_count = MIN(field_count,
+					  tuple_format_field_count(format));
+	/*
+	 * A field is only replaced with its compressed form if the latter
+	 * is shorter so the result never exceeds the original tuple.
+	 */
+	char *buf = xregion_alloc(region, bsize);
+	char *out = buf;
+	memcpy(out, data, pos - data);
+	out += pos - data;
+	bool is_compressed = false;
+	struct tuple *result = NULL;
+	for (uint32_t i = 0; i < compressible_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		struct tuple_field *f = tuple_format_field(format, i);
+		char *field_out = out;
+		/*
+		 * Indexed fields and fields with indexed JSON paths are
+		 * compared in place so they're never compressed.
+		 */
+		if (f->compression_opts.type != COMPRESSION_TYPE_NONE &&
+		    !f->is_key_part && json_token_is_leaf(&f->token)) {
+			field_out = memtx_tuple_compress_field(
+				&f->compression_opts, field, pos, out);
+			if (field_out == NULL)
+				goto out;
+		}
+		if (field_out != out) {
+			is_compressed = true;
+			out = field_out;
+		} else {
+			memcpy(out, field, pos - field);
+			out += pos - field;
+		}
+	}
+	if (!is_compressed) {
+		result = tuple;
+		goto out;
+	}
+	memcpy(out, pos, data + bsize - pos);
+	out += data + bsize - pos;
+	/*
+	 * Indexed fields are never compressed so the field map built
+	 * for the compressed data is the same as for the original one.
+	 */
+	result = memtx_tuple_new_raw(format, buf, out,
+				     MEMTX_TUPLE_NEW_RAW_NO_VALIDATE);
+	if (result != NULL)
+		tuple_set_flag(result, TUPLE_IS_COMPRESSED);
+out:
+	region_truncate(region, region_svp);
+	return result;
+}
+
+/**
+ * Decompress the MP_COMPRESSION payload [@a payload, @a payload + @a len)
+ * to @a out. The raw size of the field must be checked by the caller.
+ * Returns 0 on success, -1 on error (diag is set).
+ */
+static int
+memtx_tuple_decompress_field(const char *payload, uint32_t len,
+			     char *out, uint64_t raw_size)
+{
+	const char *end = payload + len;
+	enum compression_type type;
+	uint64_t size;
+	if (mp_decode_compression_header(&payload, len, &type, &size) != 0) {
+		diag_set(ClientError, ER_DECOMPRESSION, "malformed payload");
+		return -1;
+	}
+	assert(size == raw_size);
+	assert(type == COMPRESSION_TYPE_ZSTD);
+	(void)type;
+	if (memtx_zstd_dctx == NULL) {
+		memtx_zstd_dctx = ZSTD_createDCtx();
+		if (memtx_zstd_dctx == NULL) {
+			diag_set(OutOfMemory, sizeof(memtx_zstd_dctx),
+				 "malloc", "zstd context");
+			return -1;
+		}
+	}
+	size = ZSTD_decompressDCtx(memtx_zstd_dctx, out, raw_size,
+				   payload, end - payload);
+	if (ZSTD_isError(size)) {
+		diag_set(ClientError, ER_DECOMPRESSION,
+			 ZSTD_getErrorName(size));
+		return -1;
+	}
+	if (size != raw_size) {
+		diag_set(ClientError, ER_DECOMPRESSION, "size mismatch");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Return the raw size of the field at @a pos if it's compressed.
+ * Otherwise return 0. Advances @a pos to the next field.
+ */
+static uint64_t
+memtx_tuple_field_raw_size(const char **pos)
+{
+	if (mp_typeof(**pos) != MP_EXT) {
+		mp_next(pos);
+		return 0;
+	}
+	int8_t ext_type;
+	uint32_t len = mp_decode_extl(pos, &ext_type);
+	const char *payload = *pos;
+	*pos += len;
+	enum compression_type type;
+	uint64_t raw_size;
+	if (ext_type != MP_COMPRESSION ||
+	    mp_decode_compression_header(&payload, len, &type,
+					 &raw_size) != 0)
+		return 0;
+	return raw_size;
+}
+
+const char *
+memtx_tuple_decompress_raw(const char *tuple, const char *tuple_end,
+			   uint32_t *p_size)
+{
+	/* Compute the size of the decompressed data first. */
+	const char *pos = tuple;
+	uint32_t field_count = mp_decode_array(&pos);
+	uint64_t size = tuple_end - tuple;
+	bool is_compressed = false;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		uint64_t raw_size = memtx_tuple_field_raw_size(&pos);
+		if (raw_size > 0) {
+			is_compressed = true;
+			size = size - (pos - field) + raw_size;
+		}
+	}
+	if (!is_compressed) {
+		*p_size = tuple_end - tuple;
+		return tuple;
+	}
+	if (size > UINT32_MAX) {
+		diag_set(ClientError, ER_DECOMPRESSION, "tuple is too large");
+		return NULL;
+	}
+	char *buf = xregion_alloc(&fiber()->gc, size);
+	char *out = buf;
+	pos = tuple;
+	mp_decode_array(&pos);
+	memcpy(out, tuple, pos - tuple);
+	out += pos - tuple;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		uint64_t raw_size = memtx_tuple_field_raw_size(&pos);
+		if (raw_size == 0) {
+			memcpy(out, field, pos - field);
+			out += pos - field;
+			continue;
+		}
+		int8_t ext_type;
+		uint32_t len = mp_decode_extl(&field, &ext_type);
+		if (memtx_tuple_decompress_field(field, len, out,
+						 raw_size) != 0)
+			return NULL;
+		out += raw_size;
+	}
+	assert(out == buf + size);
+	*p_size = size;
+	return buf;
+}
+
+struct tuple *
+memtx_tuple_decompress_slowpath(struct tuple *tuple)
+{
+	assert(tuple_is_compressed(tuple));
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	uint32_t size;
+	data = memtx_tuple_decompress_raw(data, data + bsize, &size);
+	struct tuple *result = NULL;
+	if (data != NULL) {
+		/*
+		 * The data was valid before compression and the tuple may
+		 * exceed the size limit only because it's decompressed.
+		 */
+		result = memtx_tuple_new_raw(
+			tuple_format(tuple), data, data + size,
+			MEMTX_TUPLE_NEW_RAW_NO_VALIDATE |
+			MEMTX_TUPLE_NEW_RAW_NO_TUPLE_MAX_SIZE);
+	}
+	region_truncate(region, region_svp);
+	return result;
+}
@@ -17,28 +17,45 @@
 extern "C" {
 #endif
 
-static inline struct tuple *
-memtx_tuple_compress(struct tuple *tuple)
-{
-        (void)tuple;
-        unreachable();
-        return NULL;
-}
+/**
+ * Compress the fields of a memtx tuple which have compression enabled
+ * in the tuple format. Fields that don't shrink are stored as is.
+ * Returns a new tuple with compressed fields, the given tuple if no
+ * field was compressed, or NULL on error (diag is set). The returned
+ * tuple is flagged with TUPLE_IS_COMPRESSED and must only be stored
+ * in indexes: its non-indexed fields aren't valid MsgPack values of
+ * the format types.
+ */
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple);
+
+/** Slow path of memtx_tuple_decompress(). */
+struct tuple *
+memtx_tuple_decompress_slowpath(struct tuple *tuple);
 
+/**
+ * Return a tuple with all the fields of @a tuple decompressed. If
+ * the tuple has no compressed fields, it's returned as is. Otherwise
+ * a new tuple is allocated. Returns NULL on error (diag is set).
+ */
 static inline struct tuple *
 memtx_tuple_decompress(struct tuple *tuple)
 {
-	assert(!tuple_is_compressed(tuple));
-	return tuple;
+	if (likely(!tuple_is_compressed(tuple)))
+		return tuple;
+	return memtx_tuple_decompress_slowpath(tuple);
 }
 
-static inline const char *
+/**
+ * Decompress raw MsgPack tuple data [@a tuple, @a tuple_end). If the
+ * data contains compressed fields, the decompressed data is allocated
+ * on the fiber region, otherwise @a tuple is returned. The size of
+ * the returned data is stored in @a p_size. Returns NULL on error
+ * (diag is set).
+ */
+const char *
 memtx_tuple_decompress_raw(const char *tuple, const char *tuple_end,
-			   uint32_t *p_size)
-{
-	*p_size = tuple_end - tuple;
-	return tuple;
-}
+			   uint32_t *p_size);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -360,10 +360,41 @@ port_c_dump_msgpack_impl(struct port *base, struct mpstream *stream,
 	mpstream_flush(stream);
 }
 
+/**
+ * Fast path of port_c_dump_msgpack() for a port that consists only of
+ * tuples, which is the case for box_select() results. Tuple data are
+ * copied straight to the output buffer, without going through mpstream.
+ * Space is allocated per tuple rather than for the whole result, so that
+ * a large result can be spread over several buffer chunks. Returns -1 if
+ * the port has entries of other types, in which case nothing is dumped.
+ */
+static int
+port_c_dump_tuples_msgpack(struct port_c *port, struct obuf *out)
+{
+	for (struct port_c_entry *pe = port->first; pe != NULL;
+	     pe = pe->next) {
+		if (pe->type != PORT_C_ENTRY_TUPLE)
+			return -1;
+	}
+	for (struct port_c_entry *pe = port->first; pe != NULL;
+	     pe = pe->next) {
+		/* Prefetch the next tuple while copying the current one. */
+		if (pe->next != NULL)
+			__builtin_prefetch(pe->next->tuple);
+		uint32_t size;
+		const char *mp = tuple_data_range(pe->tuple, &size);
+		char *data = (char *)xobuf_alloc(out, size);
+		memcpy(data, mp, size);
+	}
+	return 0;
+}
+
 static int
 port_c_dump_msgpack(struct port *base, struct obuf *out, struct mp_ctx *ctx)
 {
 	struct port_c *port = (struct port_c *)base;
+	if (ctx == NULL && port_c_dump_tuples_msgpack(port, out) == 0)
+		return port->size;
 	struct mpstream stream;
 	mpstream_init(&stream, out, obuf_reserve_cb, obuf_alloc_cb,
 		      mpstream_panic_cb, NULL);
@@ -181,13 +181,26 @@ dd_check_is_disabled(void)
 	       !box_is_configured() || recovery_state != FINISHED_RECOVERY;
 }
 
+/** Returns the schema version id the feature appeared in. */
+static uint32_t
+schema_feature_version_id(enum schema_feature feature)
+{
+	struct version v = schema_feature_version[feature];
+	return version_id(v.major, v.minor, v.patch);
+}
+
+bool
+schema_has_feature(enum schema_feature feature)
+{
+	return dd_version_id >= schema_feature_version_id(feature);
+}
+
 int
 schema_check_feature(enum schema_feature feature)
 {
 	if (dd_check_is_disabled())
 		return 0;
-	struct version v = schema_feature_version[feature];
-	uint32_t id = version_id(v.major, v.minor, v.patch);
+	uint32_t id = schema_feature_version_id(feature);
 	if (dd_version_id < id) {
 		diag_set(ClientError, ER_SCHEMA_NEEDS_UPGRADE,
 			 version_id_to_string(dd_version_id),
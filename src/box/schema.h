@@ -77,6 +77,7 @@ extern struct rlist on_schema_init;
 	_(SCHEMA_FEATURE_DDL_BEFORE_UPGRADE, 0, 2, 11, 1) \
 	_(SCHEMA_FEATURE_PERSISTENT_NAMES, 1, 2, 11, 5) \
 	_(SCHEMA_FEATURE_PERSISTENT_TRIGGERS, 2, 3, 1, 0) \
+	_(SCHEMA_FEATURE_MEMTX_CHECKPOINT_DELTA, 3, 3, 7, 0) \
 
 ENUM(schema_feature, SCHEMA_FEATURES);
 extern const char *schema_feature_strs[];
@@ -93,6 +94,14 @@ extern const struct version schema_feature_version[];
 int
 schema_check_feature(enum schema_feature feature);
 
+/**
+ * Returns true if the current schema version is new enough for the feature.
+ * Unlike schema_check_feature(), doesn't set diag and doesn't take into
+ * account whether data dictionary checks are disabled.
+ */
+bool
+schema_has_feature(enum schema_feature feature);
+
 /**
  * Returns true if data dictionary checks may be skipped by the current fiber.
  *
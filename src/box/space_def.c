@@ -50,6 +50,7 @@ const struct space_opts space_opts_default = {
 	/* .constraint_def = */ NULL,
 	/* .constraint_count = */ 0,
 	/* .upgrade_def = */ NULL,
+	/* .field_offset_step = */ 0,
 };
 
 /**
@@ -102,6 +103,8 @@ const struct opt_def space_opts_reg[] = {
 	OPT_DEF_CUSTOM("constraint", space_opts_parse_constraint),
 	OPT_DEF_CUSTOM("foreign_key", space_opts_parse_foreign_key),
 	OPT_DEF_CUSTOM("upgrade", space_opts_parse_upgrade),
+	OPT_DEF("field_offset_step", OPT_UINT32, struct space_opts,
+		field_offset_step),
 	OPT_DEF_LEGACY("checks"),
 	OPT_END,
 };
@@ -122,7 +125,8 @@ space_tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 				space_opts_is_data_temporary(&def->opts),
 				def->opts.is_ephemeral,
 				def->opts.constraint_def,
-				def->opts.constraint_count, def->format_data,
+				def->opts.constraint_count,
+				def->opts.field_offset_step, def->format_data,
 				def->format_data_len);
 	tuple_dictionary_unref(dict);
 	return format;
@@ -120,6 +120,13 @@ struct space_opts {
 	uint32_t constraint_count;
 	/** Space upgrade definition or NULL. */
 	struct space_upgrade_def *upgrade_def;
+	/**
+	 * If not 0, tuples of the space store offsets of every
+	 * field_offset_step-th field of the space format, which speeds up
+	 * access to non-indexed fields of wide tuples at the cost of
+	 * 4 bytes per stored offset.
+	 */
+	uint32_t field_offset_step;
 };
 
 extern const struct space_opts space_opts_default;
@@ -344,6 +344,7 @@ runtime_tuple_format_new(const char *format_data, size_t format_data_len,
 				 /*is_temporary=*/false, /*is_reusable=*/true,
 				 /*constraint_def=*/NULL,
 				 /*constraint_count=*/0,
+				 /*field_offset_step=*/0,
 				 /*format_data=*/format_data,
 				 /*format_data_len=*/format_data_len);
 	region_truncate(region, region_svp);
@@ -410,6 +410,12 @@ enum tuple_flag {
 	 * immediately while a snapshot is in progress.
 	 */
 	TUPLE_IS_TEMPORARY = 2,
+	/**
+	 * Some fields of the tuple are compressed, so the tuple must be
+	 * decompressed before it's returned to the user, see
+	 * memtx_tuple_compress().
+	 */
+	TUPLE_IS_COMPRESSED = 3,
 	tuple_flag_MAX,
 };
 
@@ -669,6 +675,17 @@ tuple_is_unreferenced(struct tuple *tuple)
 	return tuple->local_refs == 0;
 }
 
+/**
+ * Check that the tuple has exactly one reference. For a memtx tuple
+ * this means that it's only referenced by its space.
+ */
+static inline bool
+tuple_is_referenced_once(struct tuple *tuple)
+{
+	return tuple->local_refs == 1 &&
+	       !tuple_has_flag(tuple, TUPLE_HAS_UPLOADED_REFS);
+}
+
 /** Check that the tuple is in compact mode. */
 static inline bool
 tuple_is_compact(struct tuple *tuple)
@@ -802,7 +819,7 @@ tuple_format(struct tuple *tuple)
 static inline bool
 tuple_is_compressed(struct tuple *tuple)
 {
-        return tuple_format(tuple)->is_compressed;
+	return tuple_has_flag(tuple, TUPLE_IS_COMPRESSED);
 }
 
 /**
@@ -932,6 +949,54 @@ tuple_field_go_to_index(const char **field, uint64_t index);
 int
 tuple_field_go_to_key(const char **field, const char *key, int len);
 
+/**
+ * Get a top-level tuple field that doesn't have an offset slot.
+ * Decoding starts from the closest preceding field which offset is
+ * stored in the field map, see tuple_format::field_offset_step, or
+ * from the first field if there's no such field.
+ * @param format Tuple format.
+ * @param tuple MessagePack tuple's body.
+ * @param field_map Tuple field map.
+ * @param fieldno The index of the field to return.
+ *
+ * @returns field data if field exists or NULL
+ */
+static inline const char *
+tuple_field_raw_seek(struct tuple_format *format, const char *tuple,
+		     const uint32_t *field_map, uint32_t fieldno)
+{
+	const char *pos = tuple;
+	uint32_t field_count = mp_decode_array(&pos);
+	if (unlikely(fieldno >= field_count))
+		return NULL;
+	uint32_t step = format->field_offset_step;
+	uint32_t base = step > 0 ? fieldno - fieldno % step : 0;
+	if (base > 0 && base < tuple_format_field_count(format)) {
+		struct tuple_field *field = tuple_format_field(format, base);
+		uint32_t offset = 0;
+		if (field->offset_slot != TUPLE_OFFSET_SLOT_NIL &&
+		    !field->is_multikey_part) {
+			offset = field_map_get_offset(field_map,
+						      field->offset_slot,
+						      MULTIKEY_NONE);
+		}
+		/*
+		 * The offset may be unset if the field map was built
+		 * for key parts only. Decode from the first field then.
+		 */
+		if (offset != 0) {
+			pos = tuple + offset;
+			for (fieldno -= base; fieldno > 0; fieldno--)
+				mp_next(&pos);
+			return pos;
+		}
+	}
+	ERROR_INJECT(ERRINJ_TUPLE_FIELD, return NULL);
+	for ( ; fieldno > 0; fieldno--)
+		mp_next(&pos);
+	return pos;
+}
+
 /**
  * Get tuple field by field index, relative JSON path and
  * multikey_idx.
@@ -1016,14 +1081,11 @@ tuple_field_raw_by_path(struct tuple_format *format, const char *tuple,
 			return NULL;
 		tuple += offset;
 	} else {
-		uint32_t field_count;
 parse:
-		ERROR_INJECT(ERRINJ_TUPLE_FIELD, return NULL);
-		field_count = mp_decode_array(&tuple);
-		if (unlikely(fieldno >= field_count))
+		tuple = tuple_field_raw_seek(format, tuple, field_map,
+					     fieldno);
+		if (tuple == NULL)
 			return NULL;
-		for (uint32_t k = 0; k < fieldno; k++)
-			mp_next(&tuple);
 		if (path != NULL &&
 		    unlikely(tuple_go_to_path(&tuple, path, path_len,
 					      index_base, multikey_idx) != 0))
@@ -1067,12 +1129,8 @@ tuple_field_raw(struct tuple_format *format, const char *tuple,
 		tuple += offset;
 	} else {
 parse:
-		ERROR_INJECT(ERRINJ_TUPLE_FIELD, return NULL);
-		uint32_t field_count = mp_decode_array(&tuple);
-		if (unlikely(field_no >= field_count))
-			return NULL;
-		for ( ; field_no > 0; field_no--)
-			mp_next(&tuple);
+		return tuple_field_raw_seek(format, tuple, field_map,
+					    field_no);
 	}
 	return tuple;
 }
@@ -31,6 +31,7 @@
 #include "tuple_bloom.h"
 
 #include <assert.h>
+#include <errno.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -44,6 +45,7 @@
 #include "key_def.h"
 #include "tuple.h"
 #include "salad/bloom.h"
+#include "salad/binary_fuse.h"
 #include "trivia/util.h"
 #include <PMurHash.h>
 
@@ -259,16 +261,62 @@ tuple_bloom_builder_add_key(struct tuple_bloom_builder *builder,
 	return 0;
 }
 
+/**
+ * Create a binary fuse filter part storing the given hashes.
+ * Returns the false positive rate of the part.
+ */
+static double
+tuple_bloom_part_create_fuse(struct tuple_bloom_part *part,
+			     const struct tuple_hash_array *hash_arr,
+			     double fpr)
+{
+	binary_fuse_create(&part->fuse, hash_arr->count, fpr);
+	part->data = xcalloc(1, binary_fuse_data_size(&part->fuse));
+	errno = 0;
+	if (binary_fuse_build(&part->fuse, part->data, hash_arr->values,
+			      hash_arr->count) != 0) {
+		/*
+		 * The filter matches everything now: it's better to
+		 * lose the filter than to fail the dump or compaction.
+		 */
+		if (errno == ENOMEM) {
+			diag_set(OutOfMemory,
+				 hash_arr->count * sizeof(uint64_t),
+				 "malloc", "binary fuse filter");
+			diag_log();
+		}
+		free(part->data);
+		part->data = NULL;
+	}
+	return binary_fuse_fpr(&part->fuse);
+}
+
 struct tuple_bloom *
-tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
+tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr,
+		enum tuple_bloom_version version)
 {
+	assert(version == TUPLE_BLOOM_VERSION_V3 ||
+	       version == TUPLE_BLOOM_VERSION_V4);
 	uint32_t part_count = builder->part_count;
 	size_t size = sizeof(struct tuple_bloom) +
 			part_count * sizeof(struct tuple_bloom_part);
 	struct tuple_bloom *bloom = xmalloc(size);
-	bloom->version = TUPLE_BLOOM_VERSION_V3;
+	bloom->version = version;
 	bloom->part_count = 0;
 
+	if (version == TUPLE_BLOOM_VERSION_V4) {
+		/* See the comment below. */
+		double prev_fpr = 1;
+		for (uint32_t i = 0; i < part_count; i++) {
+			double part_fpr = MIN(fpr / prev_fpr, 0.5);
+			prev_fpr *= tuple_bloom_part_create_fuse(
+				&bloom->parts[i], &builder->parts[i],
+				part_fpr);
+			bloom->part_count++;
+		}
+		return bloom;
+	}
+
 	for (uint32_t i = 0; i < part_count; i++) {
 		struct tuple_hash_array *hash_arr = &builder->parts[i];
 		uint32_t count = hash_arr->count;
@@ -305,6 +353,19 @@ tuple_bloom_delete(struct tuple_bloom *bloom)
 	free(bloom);
 }
 
+/**
+ * Check if a hash is stored in a part of a V3 or V4 filter.
+ */
+static inline bool
+tuple_bloom_part_maybe_has(const struct tuple_bloom *bloom,
+			   const struct tuple_bloom_part *part, uint32_t hash)
+{
+	if (bloom->version == TUPLE_BLOOM_VERSION_V4)
+		return binary_fuse_maybe_has(&part->fuse, part->data, hash);
+	assert(bloom->version == TUPLE_BLOOM_VERSION_V3);
+	return bloom_maybe_has(&part->bloom, part->data, hash);
+}
+
 bool
 tuple_bloom_maybe_has(const struct tuple_bloom *bloom, struct tuple *tuple,
 		      struct key_def *key_def, int multikey_idx)
@@ -335,15 +396,12 @@ tuple_bloom_maybe_has(const struct tuple_bloom *bloom, struct tuple *tuple,
 		}
 		return true;
 	}
-	assert(bloom->version == TUPLE_BLOOM_VERSION_V3);
 	for (uint32_t i = 0; i < key_def->part_count; i++) {
 		total_size += tuple_hash_key_part(&h, &carry, tuple,
 						  &key_def->parts[i],
 						  multikey_idx);
 		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i].bloom,
-				     bloom->parts[i].data,
-				     hash))
+		if (!tuple_bloom_part_maybe_has(bloom, &bloom->parts[i], hash))
 			return false;
 	}
 	return true;
@@ -380,18 +438,68 @@ tuple_bloom_maybe_has_key(const struct tuple_bloom *bloom,
 		}
 		return true;
 	}
-	assert(bloom->version == TUPLE_BLOOM_VERSION_V3);
 	for (uint32_t i = 0; i < part_count; i++) {
 		total_size += tuple_hash_field(&h, &carry, &key,
 					       key_def->parts[i].coll);
 		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i].bloom,
-				     bloom->parts[i].data, hash))
+		if (!tuple_bloom_part_maybe_has(bloom, &bloom->parts[i], hash))
 			return false;
 	}
 	return true;
 }
 
+/**
+ * Returns amount of bytes required to encode a binary fuse filter
+ * part to MsgPack.
+ */
+static size_t
+tuple_bloom_sizeof_fuse_part(const struct tuple_bloom_part *part)
+{
+	size_t size = 0;
+	size += mp_sizeof_array(5);
+	size += mp_sizeof_uint(part->fuse.fingerprint_bits);
+	size += mp_sizeof_uint(part->fuse.segment_length);
+	size += mp_sizeof_uint(part->fuse.segment_count);
+	size += mp_sizeof_uint(part->fuse.seed);
+	size += mp_sizeof_bin(binary_fuse_data_size(&part->fuse));
+	return size;
+}
+
+/** Encodes a binary fuse filter part to MsgPack. */
+static char *
+tuple_bloom_encode_fuse_part(const struct tuple_bloom_part *part, char *buf)
+{
+	buf = mp_encode_array(buf, 5);
+	buf = mp_encode_uint(buf, part->fuse.fingerprint_bits);
+	buf = mp_encode_uint(buf, part->fuse.segment_length);
+	buf = mp_encode_uint(buf, part->fuse.segment_count);
+	buf = mp_encode_uint(buf, part->fuse.seed);
+	buf = mp_encode_bin(buf, part->data,
+			    binary_fuse_data_size(&part->fuse));
+	return buf;
+}
+
+/** Decodes a binary fuse filter part from MsgPack. */
+static void
+tuple_bloom_decode_fuse_part(struct tuple_bloom_part *part,
+			     const char **data)
+{
+	memset(part, 0, sizeof(*part));
+	if (mp_decode_array(data) != 5)
+		unreachable();
+	part->fuse.fingerprint_bits = mp_decode_uint(data);
+	part->fuse.segment_length = mp_decode_uint(data);
+	part->fuse.segment_count = mp_decode_uint(data);
+	part->fuse.seed = mp_decode_uint(data);
+	size_t store_size = mp_decode_binl(data);
+	assert(store_size == binary_fuse_data_size(&part->fuse));
+	if (store_size > 0) {
+		part->data = xmalloc(store_size);
+		memcpy(part->data, *data, store_size);
+	}
+	*data += store_size;
+}
+
 /** Returns amount of bytes required to encode the part to MsgPack. */
 static size_t
 tuple_bloom_sizeof_part(const struct tuple_bloom_part *part)
@@ -436,8 +544,12 @@ tuple_bloom_size(const struct tuple_bloom *bloom)
 {
 	size_t size = 0;
 	size += mp_sizeof_array(bloom->part_count);
-	for (uint32_t i = 0; i < bloom->part_count; i++)
-		size += tuple_bloom_sizeof_part(&bloom->parts[i]);
+	for (uint32_t i = 0; i < bloom->part_count; i++) {
+		if (bloom->version == TUPLE_BLOOM_VERSION_V4)
+			size += tuple_bloom_sizeof_fuse_part(&bloom->parts[i]);
+		else
+			size += tuple_bloom_sizeof_part(&bloom->parts[i]);
+	}
 	return size;
 }
 
@@ -445,8 +557,13 @@ char *
 tuple_bloom_encode(const struct tuple_bloom *bloom, char *buf)
 {
 	buf = mp_encode_array(buf, bloom->part_count);
-	for (uint32_t i = 0; i < bloom->part_count; i++)
-		buf = tuple_bloom_encode_part(&bloom->parts[i], buf);
+	for (uint32_t i = 0; i < bloom->part_count; i++) {
+		if (bloom->version == TUPLE_BLOOM_VERSION_V4)
+			buf = tuple_bloom_encode_fuse_part(&bloom->parts[i],
+							   buf);
+		else
+			buf = tuple_bloom_encode_part(&bloom->parts[i], buf);
+	}
 	return buf;
 }
 
@@ -481,6 +598,13 @@ tuple_bloom_decode(const char **data, enum tuple_bloom_version version)
 			bloom->part_count++;
 		}
 		break;
+	case TUPLE_BLOOM_VERSION_V4:
+		bloom->part_count = 0;
+		for (uint32_t i = 0; i < part_count; i++) {
+			tuple_bloom_decode_fuse_part(&bloom->parts[i], data);
+			bloom->part_count++;
+		}
+		break;
 	}
 	return bloom;
 }
@@ -35,6 +35,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "salad/bloom.h"
+#include "salad/binary_fuse.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -51,14 +52,23 @@ enum tuple_bloom_version {
 	 * MessagePack integers.
 	 */
 	TUPLE_BLOOM_VERSION_V2,
-	/** The latest bloom filter. */
+	/** The latest classic bloom filter. */
 	TUPLE_BLOOM_VERSION_V3,
+	/**
+	 * Binary fuse filter, see salad/binary_fuse.h. Uses the same
+	 * hash functions as TUPLE_BLOOM_VERSION_V3.
+	 */
+	TUPLE_BLOOM_VERSION_V4,
 };
 
 /** Holder for bloom filter definition along with its data. */
 struct tuple_bloom_part {
-	/* Definition of the bloom filter. */
-	struct bloom bloom;
+	union {
+		/* Definition of the bloom filter (V1-V3). */
+		struct bloom bloom;
+		/* Definition of the binary fuse filter (V4). */
+		struct binary_fuse fuse;
+	};
 	/* Data of the bloom filter. */
 	char *data;
 };
@@ -170,10 +180,13 @@ tuple_bloom_builder_add_key(struct tuple_bloom_builder *builder,
  * Create a new tuple bloom filter.
  * @param builder - bloom filter builder
  * @param fpr - desired false positive rate
+ * @param version - TUPLE_BLOOM_VERSION_V3 for a classic bloom filter
+ *  or TUPLE_BLOOM_VERSION_V4 for a binary fuse filter
  * @return bloom filter, never fails (never returns NULL)
  */
 struct tuple_bloom *
-tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr);
+tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr,
+		enum tuple_bloom_version version);
 
 /**
  * Delete a tuple bloom filter.
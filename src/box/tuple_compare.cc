@@ -1547,6 +1547,403 @@ func_index_compare_with_key(struct tuple *tuple, hint_t tuple_hint,
 
 /* }}} tuple_compare_with_key */
 
+/* {{{ tuple_compare_typed */
+
+/**
+ * Comparators resolved from the actual shape of a key definition.
+ *
+ * The pre-compiled comparators above are bound to fixed field numbers
+ * and cover only unsigned and string parts, so any other key falls back
+ * to the slow path, which dispatches on the part type for each field it
+ * compares. For the key definitions that have no JSON paths and no
+ * optional parts we instantiate a comparator for each combination of
+ * the types of up to TYPED_COMPARE_MAX_PARTS leading parts and pick
+ * the one matching the key definition when it's created. Field numbers,
+ * nullability and sort order are read from the key parts, so a single
+ * instance serves any key of the same shape. The remaining parts, if
+ * any, are compared by the generic code.
+ */
+enum { TYPED_COMPARE_MAX_PARTS = 3 };
+
+/**
+ * Return the field type a key part is compared as by the typed
+ * comparators or field_type_MAX if there's no typed comparator for it.
+ */
+static enum field_type
+key_part_typed_compare_type(const struct key_part *part)
+{
+	switch (part->type) {
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_UINT8:
+	case FIELD_TYPE_UINT16:
+	case FIELD_TYPE_UINT32:
+	case FIELD_TYPE_UINT64:
+		return FIELD_TYPE_UNSIGNED;
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_INT8:
+	case FIELD_TYPE_INT16:
+	case FIELD_TYPE_INT32:
+	case FIELD_TYPE_INT64:
+		return FIELD_TYPE_INTEGER;
+	case FIELD_TYPE_STRING:
+		return part->coll == NULL ? FIELD_TYPE_STRING : field_type_MAX;
+	case FIELD_TYPE_UUID:
+		return FIELD_TYPE_UUID;
+	default:
+		return field_type_MAX;
+	}
+}
+
+template <int TYPE>
+static inline int
+field_compare_typed(const char *field_a, const char *field_b);
+
+template <>
+inline int
+field_compare_typed<FIELD_TYPE_UNSIGNED>(const char *field_a,
+					 const char *field_b)
+{
+	return mp_compare_uint(field_a, field_b);
+}
+
+template <>
+inline int
+field_compare_typed<FIELD_TYPE_INTEGER>(const char *field_a,
+					const char *field_b)
+{
+	return mp_compare_integer_with_type(field_a, mp_typeof(*field_a),
+					    field_b, mp_typeof(*field_b));
+}
+
+template <>
+inline int
+field_compare_typed<FIELD_TYPE_STRING>(const char *field_a,
+				       const char *field_b)
+{
+	return mp_compare_str(field_a, field_b);
+}
+
+template <>
+inline int
+field_compare_typed<FIELD_TYPE_UUID>(const char *field_a, const char *field_b)
+{
+	return mp_compare_uuid(field_a, field_b);
+}
+
+/**
+ * Compare two fields of a key part of type TYPE. Follows the logic of
+ * key_part_compare_fields() for keys without optional parts, but the
+ * field type is known at compile time.
+ */
+template <int TYPE>
+static ALWAYS_INLINE int
+key_part_compare_fields_typed(struct key_part *part, const char *field_a,
+			      const char *field_b, bool is_nullable,
+			      bool *was_null_met)
+{
+	assert(field_a != NULL && field_b != NULL);
+	int rc;
+	bool a_is_value = !is_nullable || mp_typeof(*field_a) != MP_NIL;
+	bool b_is_value = !is_nullable || mp_typeof(*field_b) != MP_NIL;
+	if (likely(a_is_value && b_is_value)) {
+		rc = field_compare_typed<TYPE>(field_a, field_b);
+	} else {
+		if (was_null_met != NULL)
+			*was_null_met = true;
+		rc = a_is_value - b_is_value;
+	}
+	return key_part_compare_result<true>(part, rc);
+}
+
+namespace /* local symbols */ {
+
+template <int ...TYPES> struct TypedFieldCompare { };
+
+template <int TYPE, int ...MORE_TYPES>
+struct TypedFieldCompare<TYPE, MORE_TYPES...>
+{
+	static ALWAYS_INLINE int
+	compare(struct key_part *part,
+		struct tuple_format *format_a, const char *tuple_a_raw,
+		const uint32_t *field_map_a,
+		struct tuple_format *format_b, const char *tuple_b_raw,
+		const uint32_t *field_map_b,
+		bool is_nullable, bool *was_null_met)
+	{
+		const char *field_a = tuple_field_raw(format_a, tuple_a_raw,
+						      field_map_a,
+						      part->fieldno);
+		const char *field_b = tuple_field_raw(format_b, tuple_b_raw,
+						      field_map_b,
+						      part->fieldno);
+		int rc = key_part_compare_fields_typed<TYPE>(
+			part, field_a, field_b, is_nullable, was_null_met);
+		if (rc != 0)
+			return rc;
+		return TypedFieldCompare<MORE_TYPES...>::compare(
+			part + 1, format_a, tuple_a_raw, field_map_a,
+			format_b, tuple_b_raw, field_map_b,
+			is_nullable, was_null_met);
+	}
+
+	static ALWAYS_INLINE int
+	compare_with_key(struct key_part *part, struct key_part *end,
+			 struct tuple_format *format, const char *tuple_raw,
+			 const uint32_t *field_map, const char **key,
+			 bool is_nullable)
+	{
+		if (part == end)
+			return 0;
+		const char *field = tuple_field_raw(format, tuple_raw,
+						    field_map, part->fieldno);
+		int rc = key_part_compare_fields_typed<TYPE>(
+			part, field, *key, is_nullable, NULL);
+		if (rc != 0)
+			return rc;
+		mp_next(key);
+		return TypedFieldCompare<MORE_TYPES...>::compare_with_key(
+			part + 1, end, format, tuple_raw, field_map, key,
+			is_nullable);
+	}
+};
+
+template <>
+struct TypedFieldCompare<>
+{
+	static ALWAYS_INLINE int
+	compare(struct key_part *, struct tuple_format *, const char *,
+		const uint32_t *, struct tuple_format *, const char *,
+		const uint32_t *, bool, bool *)
+	{
+		return 0;
+	}
+
+	static ALWAYS_INLINE int
+	compare_with_key(struct key_part *, struct key_part *,
+			 struct tuple_format *, const char *,
+			 const uint32_t *, const char **, bool)
+	{
+		return 0;
+	}
+};
+
+} /* end of anonymous namespace */
+
+/**
+ * Compare the key parts following the typed prefix the same way
+ * tuple_compare_slowpath() does it.
+ */
+template <bool is_nullable>
+static int
+tuple_compare_typed_tail(struct key_part *part, struct key_def *key_def,
+			 struct tuple_format *format_a, const char *tuple_a_raw,
+			 const uint32_t *field_map_a,
+			 struct tuple_format *format_b, const char *tuple_b_raw,
+			 const uint32_t *field_map_b, bool was_null_met)
+{
+	int rc;
+	const char *field_a, *field_b;
+	struct key_part *end = key_def->parts + (is_nullable ?
+						 key_def->unique_part_count :
+						 key_def->part_count);
+	for (; part < end; part++) {
+		field_a = tuple_field_raw(format_a, tuple_a_raw, field_map_a,
+					  part->fieldno);
+		field_b = tuple_field_raw(format_b, tuple_b_raw, field_map_b,
+					  part->fieldno);
+		rc = key_part_compare_fields<is_nullable, false, false, true>(
+			part, field_a, field_b, &was_null_met);
+		if (rc != 0)
+			return rc;
+	}
+	if (!is_nullable || !was_null_met)
+		return 0;
+	/* Index parts are equal and contain NULLs, see the slow path. */
+	end = key_def->parts + key_def->part_count;
+	for (; part < end; part++) {
+		field_a = tuple_field_raw(format_a, tuple_a_raw, field_map_a,
+					  part->fieldno);
+		field_b = tuple_field_raw(format_b, tuple_b_raw, field_map_b,
+					  part->fieldno);
+		rc = key_part_compare_fields<false, false, false, true>(
+			part, field_a, field_b);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+template <int ...TYPES>
+static int
+tuple_compare_typed(struct tuple *tuple_a, hint_t tuple_a_hint,
+		    struct tuple *tuple_b, hint_t tuple_b_hint,
+		    struct key_def *key_def)
+{
+	assert(!key_def->has_json_paths);
+	assert(!key_def->has_optional_parts);
+	assert(!key_def->is_multikey && !key_def->for_func_index);
+	int rc = hint_cmp(tuple_a_hint, tuple_b_hint);
+	if (rc != 0)
+		return rc;
+	bool is_nullable = key_def->is_nullable;
+	bool was_null_met = false;
+	struct tuple_format *format_a = tuple_format(tuple_a);
+	struct tuple_format *format_b = tuple_format(tuple_b);
+	const char *tuple_a_raw = tuple_data(tuple_a);
+	const char *tuple_b_raw = tuple_data(tuple_b);
+	const uint32_t *field_map_a = tuple_field_map(tuple_a);
+	const uint32_t *field_map_b = tuple_field_map(tuple_b);
+	rc = TypedFieldCompare<TYPES...>::compare(
+		key_def->parts, format_a, tuple_a_raw, field_map_a,
+		format_b, tuple_b_raw, field_map_b, is_nullable, &was_null_met);
+	if (rc != 0)
+		return rc;
+	struct key_part *part = key_def->parts + sizeof...(TYPES);
+	if (is_nullable) {
+		return tuple_compare_typed_tail<true>(
+			part, key_def, format_a, tuple_a_raw, field_map_a,
+			format_b, tuple_b_raw, field_map_b, was_null_met);
+	}
+	return tuple_compare_typed_tail<false>(
+		part, key_def, format_a, tuple_a_raw, field_map_a,
+		format_b, tuple_b_raw, field_map_b, was_null_met);
+}
+
+template <int ...TYPES>
+static int
+tuple_compare_with_key_typed(struct tuple *tuple, hint_t tuple_hint,
+			     const char *key, uint32_t part_count,
+			     hint_t key_hint, struct key_def *key_def)
+{
+	assert(!key_def->has_json_paths);
+	assert(!key_def->has_optional_parts);
+	assert(!key_def->is_multikey && !key_def->for_func_index);
+	assert(key != NULL || part_count == 0);
+	assert(part_count <= key_def->part_count);
+	int rc = hint_cmp(tuple_hint, key_hint);
+	if (rc != 0)
+		return rc;
+	bool is_nullable = key_def->is_nullable;
+	struct tuple_format *format = tuple_format(tuple);
+	const char *tuple_raw = tuple_data(tuple);
+	const uint32_t *field_map = tuple_field_map(tuple);
+	struct key_part *part = key_def->parts;
+	struct key_part *end = part + part_count;
+	rc = TypedFieldCompare<TYPES...>::compare_with_key(
+		part, end, format, tuple_raw, field_map, &key, is_nullable);
+	if (rc != 0)
+		return rc;
+	part += sizeof...(TYPES);
+	for (; part < end; part++, mp_next(&key)) {
+		const char *field = tuple_field_raw(format, tuple_raw,
+						    field_map, part->fieldno);
+		if (is_nullable) {
+			rc = key_part_compare_fields<true, false, false, true>(
+				part, field, key);
+		} else {
+			rc = key_part_compare_fields<false, false, false, true>(
+				part, field, key);
+		}
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+namespace /* local symbols */ {
+
+/**
+ * Select the typed comparators for the first part_count parts of a key
+ * definition. DEPTH is the number of part types already resolved and
+ * passed in TYPES.
+ */
+template <int DEPTH, int ...TYPES>
+struct TypedCompareSelector
+{
+	static void
+	select(struct key_def *def, uint32_t part_count,
+	       tuple_compare_t *cmp, tuple_compare_with_key_t *cmp_wk)
+	{
+		if ((uint32_t)DEPTH == part_count) {
+			*cmp = tuple_compare_typed<TYPES...>;
+			*cmp_wk = tuple_compare_with_key_typed<TYPES...>;
+			return;
+		}
+		switch (key_part_typed_compare_type(&def->parts[DEPTH])) {
+		case FIELD_TYPE_UNSIGNED:
+			TypedCompareSelector<DEPTH + 1, TYPES...,
+					     FIELD_TYPE_UNSIGNED>::
+				select(def, part_count, cmp, cmp_wk);
+			break;
+		case FIELD_TYPE_INTEGER:
+			TypedCompareSelector<DEPTH + 1, TYPES...,
+					     FIELD_TYPE_INTEGER>::
+				select(def, part_count, cmp, cmp_wk);
+			break;
+		case FIELD_TYPE_STRING:
+			TypedCompareSelector<DEPTH + 1, TYPES...,
+					     FIELD_TYPE_STRING>::
+				select(def, part_count, cmp, cmp_wk);
+			break;
+		case FIELD_TYPE_UUID:
+			TypedCompareSelector<DEPTH + 1, TYPES...,
+					     FIELD_TYPE_UUID>::
+				select(def, part_count, cmp, cmp_wk);
+			break;
+		default:
+			unreachable();
+		}
+	}
+};
+
+template <int ...TYPES>
+struct TypedCompareSelector<TYPED_COMPARE_MAX_PARTS, TYPES...>
+{
+	static void
+	select(struct key_def *def, uint32_t part_count,
+	       tuple_compare_t *cmp, tuple_compare_with_key_t *cmp_wk)
+	{
+		(void)def;
+		assert(part_count == TYPED_COMPARE_MAX_PARTS);
+		(void)part_count;
+		*cmp = tuple_compare_typed<TYPES...>;
+		*cmp_wk = tuple_compare_with_key_typed<TYPES...>;
+	}
+};
+
+} /* end of anonymous namespace */
+
+/**
+ * Find the typed comparators for a key definition. Returns false if
+ * there are none, i.e. the first key part can't be compared by them.
+ */
+static bool
+key_def_find_compare_func_typed(struct key_def *def, tuple_compare_t *cmp,
+				tuple_compare_with_key_t *cmp_wk)
+{
+	if (def->for_func_index || def->is_multikey || def->has_json_paths ||
+	    def->has_optional_parts)
+		return false;
+	/*
+	 * Nullable keys compare the extended parts only if NULL is met,
+	 * so the typed prefix must not go beyond the unique parts.
+	 */
+	uint32_t limit = def->is_nullable ? def->unique_part_count :
+			 def->part_count;
+	limit = MIN(limit, (uint32_t)TYPED_COMPARE_MAX_PARTS);
+	uint32_t part_count = 0;
+	while (part_count < limit &&
+	       key_part_typed_compare_type(&def->parts[part_count]) !=
+	       field_type_MAX)
+		part_count++;
+	if (part_count == 0)
+		return false;
+	TypedCompareSelector<0>::select(def, part_count, cmp, cmp_wk);
+	return true;
+}
+
+/* }}} tuple_compare_typed */
+
 /* {{{ tuple_hint */
 
 /**
@@ -2214,7 +2611,7 @@ key_def_set_compare_func_fast(struct key_def *def)
 
 	/*
 	 * Use pre-compiled comparators if available, otherwise
-	 * fall back on generic comparators.
+	 * fall back on typed or generic comparators.
 	 */
 	for (uint32_t k = 0; k < lengthof(cmp_arr); k++) {
 		uint32_t i = 0;
@@ -2239,6 +2636,15 @@ key_def_set_compare_func_fast(struct key_def *def)
 			break;
 		}
 	}
+	tuple_compare_t typed_cmp;
+	tuple_compare_with_key_t typed_cmp_wk;
+	if ((cmp == NULL || cmp_wk == NULL) &&
+	    key_def_find_compare_func_typed(def, &typed_cmp, &typed_cmp_wk)) {
+		if (cmp == NULL)
+			cmp = typed_cmp;
+		if (cmp_wk == NULL)
+			cmp_wk = typed_cmp_wk;
+	}
 	if (cmp == NULL) {
 		cmp = is_sequential ?
 			tuple_compare_sequential<false, false, false> :
@@ -2261,6 +2667,10 @@ static void
 key_def_set_compare_func_plain(struct key_def *def)
 {
 	assert(!def->has_json_paths);
+	if (!has_optional_parts &&
+	    key_def_find_compare_func_typed(def, &def->tuple_compare,
+					    &def->tuple_compare_with_key))
+		return;
 	if (key_def_is_sequential(def)) {
 		def->tuple_compare = tuple_compare_sequential
 			<is_nullable, has_optional_parts, has_desc_parts>;
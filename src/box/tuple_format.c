@@ -89,6 +89,8 @@ tuple_format_cmp(const struct tuple_format *format1,
 		return a->exact_field_count - b->exact_field_count;
 	if (a->total_field_count != b->total_field_count)
 		return a->total_field_count - b->total_field_count;
+	if (a->field_offset_step != b->field_offset_step)
+		return (int)a->field_offset_step - (int)b->field_offset_step;
 
 	if (a->constraint_count != b->constraint_count)
 		return (int)a->constraint_count - (int)b->constraint_count;
@@ -584,6 +586,20 @@ tuple_format_create(struct tuple_format *format, struct key_def *const *keys,
 
 	assert(tuple_format_field(format, 0)->offset_slot == TUPLE_OFFSET_SLOT_NIL
 	       || json_token_is_multikey(&tuple_format_field(format, 0)->token));
+	/*
+	 * Store offsets of every field_offset_step-th field so that
+	 * non-indexed fields can be accessed without decoding all
+	 * the preceding fields, see tuple_field_raw_seek().
+	 */
+	uint32_t step = format->field_offset_step;
+	for (uint32_t fieldno = step; step > 0 &&
+	     fieldno < tuple_format_field_count(format); fieldno += step) {
+		struct tuple_field *field = tuple_format_field(format, fieldno);
+		if (field->offset_slot == TUPLE_OFFSET_SLOT_NIL) {
+			current_slot--;
+			field->offset_slot = current_slot;
+		}
+	}
 	size_t field_map_size = -current_slot * sizeof(uint32_t);
 	if (field_map_size > INT16_MAX) {
 		/** tuple->data_offset is 15 bits */
@@ -760,6 +776,7 @@ tuple_format_alloc(struct key_def * const *keys, uint16_t key_count,
 	format->refs = 0;
 	format->id = FORMAT_ID_NIL;
 	format->index_field_count = index_field_count;
+	format->field_offset_step = 0;
 	format->exact_field_count = 0;
 	format->min_field_count = 0;
 	format->epoch = 0;
@@ -847,8 +864,8 @@ tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 		 uint32_t space_field_count, uint32_t exact_field_count,
 		 struct tuple_dictionary *dict, bool is_temporary,
 		 bool is_reusable, struct tuple_constraint_def *constraint_def,
-		 uint32_t constraint_count, const char *format_data,
-		 size_t format_data_len)
+		 uint32_t constraint_count, uint32_t field_offset_step,
+		 const char *format_data, size_t format_data_len)
 {
 	assert(!tuple_formats_inherited);
 	struct tuple_format *format =
@@ -865,6 +882,7 @@ tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 	/* This flag is set in `tuple_format_create` function. */
 	format->is_compressed = false;
 	format->exact_field_count = exact_field_count;
+	format->field_offset_step = field_offset_step;
 	format->epoch = ++formats_epoch;
 	if (format_data != NULL) {
 		format->data = xmalloc(format_data_len);
@@ -263,6 +263,14 @@ struct tuple_format {
 	 * element is used by an index.
 	 */
 	uint32_t index_field_count;
+	/**
+	 * If not 0, every top-level field of the format with the number
+	 * multiple of this value is given an offset slot even if it isn't
+	 * indexed. It lets us access any formatted field of a wide tuple
+	 * by skipping less than this number of fields, see
+	 * tuple_field_raw_seek().
+	 */
+	uint32_t field_offset_step;
 	/**
 	 * The minimal field count that must be specified.
 	 * index_field_count <= min_field_count <= field_count.
@@ -421,6 +429,8 @@ tuple_format_unref(struct tuple_format *format)
  * @param is_reusable Set if format may be reused.
  * @param constraint_def - Array of constraint definitions.
  * @param constraint_count - Number of constraints above.
+ * @param field_offset_step Step of offset slots of non-indexed fields,
+ *        0 to store offsets of indexed fields only.
  * @param format_data Original format clause encoded to Msgpack (may be NULL).
  * @param format_data_len Length of MsgPack encoded format clause (may be 0).
  *
@@ -434,8 +444,8 @@ tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 		 uint32_t space_field_count, uint32_t exact_field_count,
 		 struct tuple_dictionary *dict, bool is_temporary,
 		 bool is_reusable, struct tuple_constraint_def *constraint_def,
-		 uint32_t constraint_count, const char *format_data,
-		 size_t format_data_len);
+		 uint32_t constraint_count, uint32_t field_offset_step,
+		 const char *format_data, size_t format_data_len);
 
 /**
  * Check, if tuple @a format is compatible with @a key_def.
@@ -455,8 +465,8 @@ simple_tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 			struct key_def * const *keys, uint16_t key_count)
 {
 	return tuple_format_new(vtab, engine, keys, key_count,
-				NULL, 0, 0, NULL, false, false, NULL, 0, NULL,
-				0);
+				NULL, 0, 0, NULL, false, false, NULL, 0, 0,
+				NULL, 0);
 }
 
 /**
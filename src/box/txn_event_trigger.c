@@ -408,3 +408,13 @@ txn_events_are_enabled(void)
 {
 	return txn_events_enabled;
 }
+
+bool
+txn_events_have_global_triggers(void)
+{
+	for (size_t i = 0; i < lengthof(txn_global_events); i++) {
+		if (event_has_triggers(txn_global_events[i]))
+			return true;
+	}
+	return false;
+}
@@ -103,6 +103,10 @@ txn_events_enable(bool value);
 bool
 txn_events_are_enabled(void);
 
+/** Whether any global (not bound to a space) txn event triggers are set. */
+bool
+txn_events_have_global_triggers(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
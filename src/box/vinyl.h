@@ -57,6 +57,18 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *handler);
 void
 vinyl_engine_set_cache(struct engine *engine, size_t quota);
 
+/**
+ * Update vinyl run page cache size.
+ */
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota);
+
+/**
+ * Update the max size of loaded vinyl bloom filter partitions.
+ */
+void
+vinyl_engine_set_bloom_partition_cache(struct engine *engine, size_t quota);
+
 /**
  * Update vinyl memory size.
  */
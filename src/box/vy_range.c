@@ -262,6 +262,70 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
 	range->version++;
 }
 
+struct vy_slice *
+vy_range_next_sorted_run(struct vy_range *range, struct vy_slice *slice,
+			 int *slice_count, struct vy_disk_stmt_counter *count)
+{
+	int64_t dump_lsn = slice->run->dump_lsn;
+	*slice_count = 0;
+	do {
+		vy_disk_stmt_counter_add(count, &slice->count);
+		++*slice_count;
+		slice = rlist_next_entry(slice, in_range);
+		if (rlist_entry_is_head(slice, &range->slices, in_range))
+			return NULL;
+	} while (slice->run->dump_lsn == dump_lsn);
+	return slice;
+}
+
+/**
+ * Return true if DELETE statements stored in a range are worth purging
+ * by compaction of all its runs.
+ *
+ * DELETE statements, including deferred DELETE statements generated for
+ * secondary indexes, are small so they take long to fill an LSM tree
+ * level and trigger compaction while the tuples they overwrite keep
+ * wasting disk space and slowing down reads. Typically, they come in
+ * bulk from expiration of outdated data. So we assume that each DELETE
+ * stored in a newer run purges a statement of the oldest sorted run and
+ * request compaction once they would purge 1/run_size_ratio of it, the
+ * same fraction that triggers compaction of a level above it. DELETE
+ * statements stored in the oldest sorted run aren't accounted, because
+ * compaction can't purge them unless they are visible from a read view.
+ *
+ * The number of DELETE statements in a slice is estimated from the run
+ * statement statistics in proportion to the number of the slice rows.
+ */
+static bool
+vy_range_needs_purge(struct vy_range *range, const struct index_opts *opts)
+{
+	double deletes = 0;
+	int64_t last_rows = 0;
+	struct vy_slice *slice, *next_slice;
+	slice = rlist_empty(&range->slices) ? NULL :
+		rlist_first_entry(&range->slices, struct vy_slice, in_range);
+	for (; slice != NULL; slice = next_slice) {
+		int slice_count;
+		struct vy_disk_stmt_counter count;
+		vy_disk_stmt_counter_reset(&count);
+		next_slice = vy_range_next_sorted_run(range, slice,
+						      &slice_count, &count);
+		if (next_slice == NULL) {
+			last_rows = count.rows;
+			break;
+		}
+		for (int i = 0; i < slice_count; i++) {
+			struct vy_run *run = slice->run;
+			if (run->count.rows > 0) {
+				deletes += (double)run->info.stmt_stat.deletes *
+					   slice->count.rows / run->count.rows;
+			}
+			slice = rlist_next_entry(slice, in_range);
+		}
+	}
+	return deletes > 0 && deletes * opts->run_size_ratio >= last_rows;
+}
+
 /**
  * To reduce write amplification caused by compaction, we follow
  * the LSM tree design. Runs in each range are divided into groups
@@ -283,7 +347,22 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
  *
  * Given a range, this function computes the maximal level that needs
  * to be compacted and sets @compaction_priority to the number of runs
- * in this level and all preceding levels.
+ * in this level and all preceding levels. Runs that form a sorted run,
+ * see vy_range_next_sorted_run(), are accounted as one run.
+ *
+ * The policy depends on the index compaction_strategy option:
+ *
+ * - leveled: the last level may store only one run, so space
+ *   amplification stays low, but the last run is rewritten every
+ *   time an upper level is compacted.
+ * - tiered: the last level may store up to run_count_per_level runs
+ *   just like the upper levels, so each statement is rewritten only
+ *   once per level. This reduces write amplification at the cost of
+ *   higher space and read amplification, which suits write-heavy,
+ *   rarely read spaces.
+ * - delete_aware: leveled, but the whole range is compacted early if
+ *   newer runs store many DELETE statements, see
+ *   vy_range_needs_purge().
  */
 void
 vy_range_update_compaction_priority(struct vy_range *range,
@@ -295,7 +374,25 @@ vy_range_update_compaction_priority(struct vy_range *range,
 	range->compaction_priority = 0;
 	vy_disk_stmt_counter_reset(&range->compaction_queue);
 
-	if (range->slice_count <= 1) {
+	/* Sizes of the newest and the oldest sorted runs. */
+	uint64_t first_size = 0;
+	uint64_t last_size = 0;
+	int sorted_run_count = 0;
+	struct vy_slice *slice, *next_slice;
+	slice = rlist_empty(&range->slices) ? NULL :
+		rlist_first_entry(&range->slices, struct vy_slice, in_range);
+	for (; slice != NULL; slice = next_slice) {
+		int slice_count;
+		struct vy_disk_stmt_counter count;
+		vy_disk_stmt_counter_reset(&count);
+		next_slice = vy_range_next_sorted_run(range, slice,
+						      &slice_count, &count);
+		if (sorted_run_count++ == 0)
+			first_size = count.bytes;
+		last_size = count.bytes;
+	}
+
+	if (sorted_run_count <= 1) {
 		/* Nothing to compact. */
 		range->needs_compaction = false;
 		return;
@@ -342,20 +439,24 @@ vy_range_update_compaction_priority(struct vy_range *range,
 	uint64_t target_run_size;
 
 	uint64_t size;
-	struct vy_slice *slice;
-	slice = rlist_last_entry(&range->slices, struct vy_slice, in_range);
-	size = MAX(slice->count.bytes, 1);
-	slice = rlist_first_entry(&range->slices, struct vy_slice, in_range);
+	size = MAX(last_size, 1);
 	do {
 		target_run_size = size;
 		size = ceil(target_run_size / opts->run_size_ratio);
-	} while (size > (uint64_t)MAX(slice->count.bytes, 1));
-
-	rlist_foreach_entry(slice, &range->slices, in_range) {
-		size = slice->count.bytes;
+	} while (size > MAX(first_size, 1));
+
+	for (slice = rlist_first_entry(&range->slices, struct vy_slice,
+				       in_range);
+	     slice != NULL; slice = next_slice) {
+		int slice_count;
+		struct vy_disk_stmt_counter count;
+		vy_disk_stmt_counter_reset(&count);
+		next_slice = vy_range_next_sorted_run(range, slice,
+						      &slice_count, &count);
+		size = count.bytes;
 		level_run_count++;
-		total_run_count++;
-		vy_disk_stmt_counter_add(&total_stmt_count, &slice->count);
+		total_run_count += slice_count;
+		vy_disk_stmt_counter_add(&total_stmt_count, &count);
 		while (size > target_run_size) {
 			/*
 			 * The run size exceeds the threshold
@@ -416,7 +517,8 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		}
 	}
 
-	if (level_run_count > 1) {
+	if (level_run_count > 1 &&
+	    opts->compaction_strategy != INDEX_COMPACTION_STRATEGY_TIERED) {
 		/*
 		 * Do not store more than one run at the last level
 		 * to keep space amplification low.
@@ -424,6 +526,20 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		range->compaction_priority = total_run_count;
 		range->compaction_queue = total_stmt_count;
 	}
+
+	if (opts->compaction_strategy ==
+			INDEX_COMPACTION_STRATEGY_DELETE_AWARE &&
+	    range->compaction_priority < range->slice_count &&
+	    vy_range_needs_purge(range, opts)) {
+		/*
+		 * Compact all runs so that DELETE statements are
+		 * purged along with the tuples they overwrite. This
+		 * also moves the range to the top of the compaction
+		 * heap, because it has the highest priority possible.
+		 */
+		range->compaction_priority = range->slice_count;
+		range->compaction_queue = range->count;
+	}
 }
 
 void
@@ -450,6 +566,8 @@ vy_range_update_dumps_per_compaction(struct vy_range *range)
  * - We should split around the last run middle key.
  * - We should only split if the last run size is greater than
  *   4/3 * range_size.
+ * - If the last run is a sorted run consisting of a few runs, see
+ *   vy_range_next_sorted_run(), we should split it at a run boundary.
  */
 bool
 vy_range_needs_split(struct vy_range *range, int64_t range_size,
@@ -465,10 +583,48 @@ vy_range_needs_split(struct vy_range *range, int64_t range_size,
 	assert(!rlist_empty(&range->slices));
 	slice = rlist_last_entry(&range->slices, struct vy_slice, in_range);
 
+	/* Find all runs constituting the oldest sorted run. */
+	struct vy_slice *first_slice = slice;
+	int64_t size = 0;
+	int slice_count = 0;
+	while (true) {
+		size += first_slice->count.bytes;
+		slice_count++;
+		if (first_slice == rlist_first_entry(&range->slices,
+						     struct vy_slice, in_range))
+			break;
+		struct vy_slice *prev = rlist_prev_entry(first_slice,
+							 in_range);
+		if (prev->run->dump_lsn != slice->run->dump_lsn)
+			break;
+		first_slice = prev;
+	}
+
 	/* The range is too small to be split. */
-	if (slice->count.bytes < range_size * 4 / 3)
+	if (size < range_size * 4 / 3)
 		return false;
 
+	if (slice_count > 1) {
+		/*
+		 * Split the sorted run between its runs. Runs are
+		 * sorted by key so we use the min key of the middle
+		 * run. It's greater than the range lower bound
+		 * because the preceding runs aren't empty.
+		 */
+		slice = first_slice;
+		for (int i = 0; i < slice_count / 2; i++)
+			slice = rlist_next_entry(slice, in_range);
+		struct vy_page_info *page = vy_run_page_info(
+				slice->run, slice->first_page_no);
+		if (slice->begin.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(slice->begin, page->min_key,
+						  page->min_key_hint,
+						  range->cmp_def) >= 0)
+			return false;
+		*p_split_key = page->min_key;
+		return true;
+	}
+
 	/* Find the median key in the oldest run (approximately). */
 	struct vy_page_info *mid_page;
 	mid_page = vy_run_page_info(slice->run, slice->first_page_no +
@@ -98,7 +98,10 @@ struct vy_range {
 	 *
 	 * This variable contains the number of runs the next
 	 * compaction of this range will include. If it is 0,
-	 * the range doesn't need to be compacted.
+	 * the range doesn't need to be compacted. Note, runs
+	 * written by a compaction split in parts are counted
+	 * separately here although the compaction policy treats
+	 * them as one run, see vy_range_next_sorted_run().
 	 *
 	 * The lower the level is scheduled for compaction,
 	 * the bigger it tends to be because upper levels are
@@ -237,6 +240,23 @@ vy_range_add_slice_before(struct vy_range *range, struct vy_slice *slice,
 void
 vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice);
 
+/**
+ * Compaction may split its output into a few runs covering disjoint
+ * key ranges, see vy_task_compaction_split(). Such runs share the
+ * dump LSN and are stored next to each other in a range. Together
+ * they form one sorted run, which is treated as a single run by
+ * the compaction policy.
+ *
+ * Given the first slice of a sorted run, this function returns the
+ * first slice of the next sorted run or NULL if there's no more
+ * slices in the range. The number of slices in the sorted run is
+ * returned in @a slice_count, their statement counters are added
+ * to @a count.
+ */
+struct vy_slice *
+vy_range_next_sorted_run(struct vy_range *range, struct vy_slice *slice,
+			 int *slice_count, struct vy_disk_stmt_counter *count);
+
 /**
  * Update compaction priority of a range.
  *
@@ -723,8 +723,6 @@ static void
 vy_read_iterator_add_disk(struct vy_read_iterator *itr)
 {
 	assert(itr->curr_range != NULL);
-	enum iterator_type iterator_type = (itr->iterator_type != ITER_REQ ?
-					    itr->iterator_type : ITER_LE);
 	struct vy_lsm *lsm = itr->lsm;
 	struct vy_slice *slice;
 	/*
@@ -736,7 +734,7 @@ vy_read_iterator_add_disk(struct vy_read_iterator *itr)
 		struct vy_read_src *sub_src = vy_read_iterator_add_src(itr);
 		vy_run_iterator_open(&sub_src->run_iterator,
 				     &lsm->stat.disk.iterator, slice,
-				     iterator_type, itr->key,
+				     itr->iterator_type, itr->key,
 				     itr->read_view, lsm->cmp_def,
 				     lsm->key_def, lsm->format,
 				     lsm->env->key_format,
@@ -810,7 +808,10 @@ vy_read_iterator_open_after(struct vy_read_iterator *itr, struct vy_lsm *lsm,
 		 * use ITER_LE instead, so we need to enable EQ
 		 * check in this case.
 		 *
-		 * See vy_read_iterator_add_{tx,cache,mem,run}.
+		 * See vy_read_iterator_add_{tx,cache,mem}. The run
+		 * iterator handles ITER_REQ as ITER_LE, too, but it
+		 * also uses bloom filters to skip runs that don't
+		 * store the key prefix.
 		 */
 		itr->need_check_eq = true;
 	}
@@ -188,6 +188,8 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	tt_pthread_key_create(&env->zdctx_key, vy_free_zdctx);
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
+	rlist_create(&env->page_cache.lru);
+	rlist_create(&env->bloom_cache.lru);
 	env->initial_join = false;
 }
 
@@ -199,6 +201,7 @@ vy_run_env_destroy(struct vy_run_env *env)
 {
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
+	vy_run_env_set_page_cache_quota(env, 0);
 	mempool_destroy(&env->read_task_pool);
 	tt_pthread_key_delete(env->zdctx_key);
 }
@@ -285,6 +288,13 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	return run;
 }
 
+static void
+vy_page_cache_purge_run(struct vy_page_cache *cache, struct vy_run *run);
+
+static void
+vy_bloom_cache_evict(struct vy_bloom_cache *cache,
+		     struct vy_bloom_partition *partition);
+
 static void
 vy_run_clear(struct vy_run *run)
 {
@@ -301,6 +311,16 @@ vy_run_clear(struct vy_run *run)
 		tuple_bloom_delete(run->info.bloom);
 		run->info.bloom = NULL;
 	}
+	for (uint32_t i = 0; i < run->info.bloom_partition_count; i++) {
+		struct vy_bloom_partition *partition =
+			&run->info.bloom_partitions[i];
+		if (partition->bloom != NULL)
+			vy_bloom_cache_evict(&run->env->bloom_cache, partition);
+	}
+	free(run->info.bloom_partitions);
+	run->info.bloom_partitions = NULL;
+	run->info.bloom_partition_count = 0;
+	run->info.bloom_partition_pages = 0;
 	free(run->info.min_key);
 	run->info.min_key = NULL;
 	free(run->info.max_key);
@@ -313,6 +333,8 @@ vy_run_delete(struct vy_run *run)
 	assert(run->refs == 0);
 	if (run->fd >= 0 && close(run->fd) < 0)
 		say_syserror("close failed");
+	if (run->cached_pages != NULL)
+		vy_page_cache_purge_run(&run->env->page_cache, run);
 	vy_run_clear(run);
 	TRASH(run);
 	free(run);
@@ -321,7 +343,11 @@ vy_run_delete(struct vy_run *run)
 size_t
 vy_run_bloom_size(struct vy_run *run)
 {
-	return run->info.bloom == NULL ? 0 : tuple_bloom_size(run->info.bloom);
+	size_t size = run->info.bloom_partition_count *
+		      sizeof(*run->info.bloom_partitions);
+	if (run->info.bloom != NULL)
+		size += tuple_bloom_size(run->info.bloom);
+	return size;
 }
 
 /**
@@ -626,6 +652,8 @@ iproto_to_tuple_bloom_version(uint32_t key)
 		return TUPLE_BLOOM_VERSION_V2;
 	case VY_RUN_INFO_BLOOM_FILTER:
 		return TUPLE_BLOOM_VERSION_V3;
+	case VY_RUN_INFO_BLOOM_FILTER_BINARY_FUSE:
+		return TUPLE_BLOOM_VERSION_V4;
 	default:
 		unreachable();
 	}
@@ -642,12 +670,107 @@ tuple_bloom_version_to_iproto(enum tuple_bloom_version version)
 		return VY_RUN_INFO_BLOOM_FILTER_LEGACY_V2;
 	case TUPLE_BLOOM_VERSION_V3:
 		return VY_RUN_INFO_BLOOM_FILTER;
+	case TUPLE_BLOOM_VERSION_V4:
+		return VY_RUN_INFO_BLOOM_FILTER_BINARY_FUSE;
+	default:
+		unreachable();
+	}
+	return 0;
+}
+
+/** Return the version of bloom filters of the given type. */
+static enum tuple_bloom_version
+vy_bloom_version(enum index_bloom_type type)
+{
+	switch (type) {
+	case INDEX_BLOOM_TYPE_CLASSIC:
+		return TUPLE_BLOOM_VERSION_V3;
+	case INDEX_BLOOM_TYPE_BINARY_FUSE:
+		return TUPLE_BLOOM_VERSION_V4;
 	default:
 		unreachable();
 	}
 	return 0;
 }
 
+/**
+ * Decode the index of bloom filter partitions:
+ * [pages per partition, [[offset, size, unpacked size], ...]].
+ */
+static int
+vy_bloom_partitions_decode(struct vy_run_info *run_info, const char **data,
+			   const char *filename)
+{
+	if (mp_decode_array(data) != 2) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+			 "Can't decode bloom filter partitions");
+		return -1;
+	}
+	uint32_t pages = mp_decode_uint(data);
+	uint32_t count = mp_decode_array(data);
+	struct vy_bloom_partition *partitions = NULL;
+	if (count > 0) {
+		partitions = calloc(count, sizeof(*partitions));
+		if (partitions == NULL) {
+			diag_set(OutOfMemory, count * sizeof(*partitions),
+				 "malloc", "struct vy_bloom_partition");
+			return -1;
+		}
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		struct vy_bloom_partition *partition = &partitions[i];
+		if (mp_decode_array(data) != 3) {
+			free(partitions);
+			diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+				 "Can't decode bloom filter partitions");
+			return -1;
+		}
+		partition->offset = mp_decode_uint(data);
+		partition->size = mp_decode_uint(data);
+		partition->unpacked_size = mp_decode_uint(data);
+	}
+	run_info->bloom_partition_pages = pages;
+	run_info->bloom_partition_count = count;
+	run_info->bloom_partitions = partitions;
+	return 0;
+}
+
+/** Return the size of the encoded bloom filter partition index. */
+static size_t
+vy_bloom_partitions_sizeof(const struct vy_run_info *run_info)
+{
+	size_t size = mp_sizeof_array(2) +
+		      mp_sizeof_uint(run_info->bloom_partition_pages) +
+		      mp_sizeof_array(run_info->bloom_partition_count);
+	for (uint32_t i = 0; i < run_info->bloom_partition_count; i++) {
+		const struct vy_bloom_partition *partition =
+			&run_info->bloom_partitions[i];
+		size += mp_sizeof_array(3) +
+			mp_sizeof_uint(partition->offset) +
+			mp_sizeof_uint(partition->size) +
+			mp_sizeof_uint(partition->unpacked_size);
+	}
+	return size;
+}
+
+/** Encode the bloom filter partition index. */
+static char *
+vy_bloom_partitions_encode(const struct vy_run_info *run_info, char *pos)
+{
+	pos = mp_encode_array(pos, 2);
+	pos = mp_encode_uint(pos, run_info->bloom_partition_pages);
+	pos = mp_encode_array(pos, run_info->bloom_partition_count);
+	for (uint32_t i = 0; i < run_info->bloom_partition_count; i++) {
+		const struct vy_bloom_partition *partition =
+			&run_info->bloom_partitions[i];
+		pos = mp_encode_array(pos, 3);
+		pos = mp_encode_uint(pos, partition->offset);
+		pos = mp_encode_uint(pos, partition->size);
+		pos = mp_encode_uint(pos, partition->unpacked_size);
+	}
+	return pos;
+}
+
 /**
  * Decode the run metadata from xrow.
  *
@@ -698,12 +821,18 @@ vy_run_info_decode(struct vy_run_info *run_info,
 		case VY_RUN_INFO_BLOOM_FILTER_LEGACY_V1:
 		case VY_RUN_INFO_BLOOM_FILTER_LEGACY_V2:
 		case VY_RUN_INFO_BLOOM_FILTER:
+		case VY_RUN_INFO_BLOOM_FILTER_BINARY_FUSE:
 			run_info->bloom = tuple_bloom_decode(
 				&pos, iproto_to_tuple_bloom_version(key));
 			break;
 		case VY_RUN_INFO_STMT_STAT:
 			vy_stmt_stat_decode(&run_info->stmt_stat, &pos);
 			break;
+		case VY_RUN_INFO_BLOOM_FILTER_PARTITIONS:
+			if (vy_bloom_partitions_decode(run_info, &pos,
+						       filename) != 0)
+				return -1;
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -717,6 +846,16 @@ vy_run_info_decode(struct vy_run_info *run_info,
 				    vy_run_info_key_name(key)));
 		return -1;
 	}
+	if (run_info->bloom_partition_count > 0 &&
+	    (run_info->bloom_partition_pages == 0 ||
+	     run_info->bloom_partition_count !=
+	     DIV_ROUND_UP(run_info->page_count,
+			  run_info->bloom_partition_pages))) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+			 "Can't decode run info: "
+			 "wrong number of bloom filter partitions");
+		return -1;
+	}
 	return 0;
 }
 
@@ -731,6 +870,9 @@ vy_page_new(const struct vy_page_info *page_info)
 	}
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
+	page->refs = 1;
+	page->cached_run = NULL;
+	rlist_create(&page->in_cache);
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
 	if (page->row_index == NULL) {
 		diag_set(OutOfMemory, page_info->row_count * sizeof(uint32_t),
@@ -753,6 +895,7 @@ vy_page_new(const struct vy_page_info *page_info)
 static void
 vy_page_delete(struct vy_page *page)
 {
+	assert(page->cached_run == NULL);
 	uint32_t *row_index = page->row_index;
 	char *data = page->data;
 #if !defined(NDEBUG)
@@ -765,6 +908,131 @@ vy_page_delete(struct vy_page *page)
 	free(page);
 }
 
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+static inline void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
+/** Return the amount of memory occupied by a page. */
+static inline size_t
+vy_page_mem_used(struct vy_page *page)
+{
+	return sizeof(*page) + page->unpacked_size +
+	       page->row_count * sizeof(uint32_t);
+}
+
+/** Remove a page from the page cache and drop the cache reference. */
+static void
+vy_page_cache_evict(struct vy_page_cache *cache, struct vy_page *page)
+{
+	struct vy_run *run = page->cached_run;
+	assert(run != NULL);
+	assert(run->cached_pages[page->page_no] == page);
+	run->cached_pages[page->page_no] = NULL;
+	page->cached_run = NULL;
+	rlist_del_entry(page, in_cache);
+	assert(cache->mem_used >= vy_page_mem_used(page));
+	cache->mem_used -= vy_page_mem_used(page);
+	vy_page_unref(page);
+}
+
+/** Evict pages from the page cache until it fits in the quota. */
+static void
+vy_page_cache_evict_to_quota(struct vy_page_cache *cache)
+{
+	while (cache->mem_used > cache->mem_quota) {
+		assert(!rlist_empty(&cache->lru));
+		struct vy_page *page = rlist_last_entry(&cache->lru,
+							struct vy_page,
+							in_cache);
+		vy_page_cache_evict(cache, page);
+	}
+}
+
+/**
+ * Look up a page of a run in the page cache. Returns NULL if the
+ * page isn't cached. The returned page isn't referenced.
+ */
+static struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, struct vy_run *run,
+		  uint32_t page_no)
+{
+	if (run->cached_pages == NULL)
+		return NULL;
+	assert(page_no < run->info.page_count);
+	struct vy_page *page = run->cached_pages[page_no];
+	if (page == NULL)
+		return NULL;
+	/* Move the page to the head of the LRU list. */
+	rlist_move_entry(&cache->lru, page, in_cache);
+	return page;
+}
+
+/**
+ * Try to insert a page read from a run into the page cache.
+ * The cache takes a reference to the page on success. Failures
+ * are ignored, because the cache is just an optimization.
+ */
+static void
+vy_page_cache_put(struct vy_page_cache *cache, struct vy_run *run,
+		  struct vy_page *page)
+{
+	size_t size = vy_page_mem_used(page);
+	if (size > cache->mem_quota)
+		return;
+	assert(page->cached_run == NULL);
+	assert(page->page_no < run->info.page_count);
+	if (run->cached_pages == NULL) {
+		run->cached_pages = calloc(run->info.page_count,
+					   sizeof(*run->cached_pages));
+		if (run->cached_pages == NULL)
+			return;
+	}
+	/*
+	 * The page could have been inserted by another fiber while
+	 * we were reading it.
+	 */
+	if (run->cached_pages[page->page_no] != NULL)
+		return;
+	run->cached_pages[page->page_no] = page;
+	page->cached_run = run;
+	vy_page_ref(page);
+	rlist_add_entry(&cache->lru, page, in_cache);
+	cache->mem_used += size;
+	vy_page_cache_evict_to_quota(cache);
+}
+
+/** Evict all pages of a run from the page cache. */
+static void
+vy_page_cache_purge_run(struct vy_page_cache *cache, struct vy_run *run)
+{
+	for (uint32_t i = 0; i < run->info.page_count; i++) {
+		struct vy_page *page = run->cached_pages[i];
+		if (page != NULL)
+			vy_page_cache_evict(cache, page);
+	}
+	free(run->cached_pages);
+	run->cached_pages = NULL;
+}
+
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota)
+{
+	struct vy_page_cache *cache = &env->page_cache;
+	cache->mem_quota = quota;
+	vy_page_cache_evict_to_quota(cache);
+}
+
 static int
 vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	     struct xrow_header *xrow)
@@ -893,9 +1161,9 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 		itr->curr = vy_entry_none();
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
 }
@@ -1054,9 +1322,277 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	return 0;
 }
 
+/**
+ * Decode a bloom filter partition from xrow.
+ * Returns NULL and sets diag on error.
+ */
+static struct tuple_bloom *
+vy_bloom_partition_decode(const struct xrow_header *xrow)
+{
+	if (xrow->type != VY_RUN_BLOOM) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Wrong bloom filter partition type "
+				    "(expected %d, got %u)",
+				    VY_RUN_BLOOM, (unsigned)xrow->type));
+		return NULL;
+	}
+	struct tuple_bloom *bloom = NULL;
+	const char *pos = xrow->body->iov_base;
+	uint32_t map_size = mp_decode_map(&pos);
+	for (uint32_t map_item = 0; map_item < map_size; ++map_item) {
+		uint32_t key = mp_decode_uint(&pos);
+		switch (key) {
+		case VY_RUN_BLOOM_FILTER:
+		case VY_RUN_BLOOM_FILTER_BINARY_FUSE:
+			if (bloom != NULL)
+				tuple_bloom_delete(bloom);
+			bloom = tuple_bloom_decode(&pos,
+					key == VY_RUN_BLOOM_FILTER ?
+					TUPLE_BLOOM_VERSION_V3 :
+					TUPLE_BLOOM_VERSION_V4);
+			break;
+		default:
+			mp_next(&pos); /* unknown key, ignore */
+			break;
+		}
+	}
+	if (bloom == NULL) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 "Missing bloom filter in partition");
+	}
+	return bloom;
+}
+
+/**
+ * Read a bloom filter partition from disk.
+ * Returns NULL and sets diag on error.
+ */
+static struct tuple_bloom *
+vy_bloom_partition_read(const struct vy_bloom_partition *partition,
+			struct vy_run *run, ZSTD_DStream *zdctx)
+{
+	struct tuple_bloom *bloom = NULL;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	char *data = region_alloc(region, partition->size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, partition->size, "region gc",
+			 "bloom filter partition");
+		goto out;
+	}
+	char *rows = region_alloc(region, partition->unpacked_size);
+	if (rows == NULL) {
+		diag_set(OutOfMemory, partition->unpacked_size, "region gc",
+			 "bloom filter partition");
+		goto out;
+	}
+	ssize_t readen = fio_pread(run->fd, data, partition->size,
+				   partition->offset);
+	if (readen < 0) {
+		diag_set(SystemError, "failed to read from file");
+		goto out;
+	}
+	if (readen != (ssize_t)partition->size) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 "Unexpected end of file");
+		goto out;
+	}
+	char *rows_end = rows + partition->unpacked_size;
+	if (xlog_tx_decode(data, data + readen, rows, rows_end, zdctx) != 0)
+		goto out;
+	struct xrow_header xrow;
+	const char *pos = rows;
+	if (xrow_decode(&xrow, &pos, rows_end, true) != 0)
+		goto out;
+	bloom = vy_bloom_partition_decode(&xrow);
+out:
+	region_truncate(region, region_svp);
+	if (bloom == NULL) {
+		diag_log();
+		say_error("error reading %s@%llu:%u", vy_run_filename(run),
+			  (unsigned long long)partition->offset,
+			  (unsigned)partition->size);
+	}
+	return bloom;
+}
+
+/** Task to read a bloom filter partition in a reader thread. */
+struct vy_bloom_read_task {
+	/** parent */
+	struct cbus_call_msg base;
+	/** vy_run with fd - ref. counted */
+	struct vy_run *run;
+	/** partition to read */
+	const struct vy_bloom_partition *partition;
+	/** [out] loaded bloom filter */
+	struct tuple_bloom *bloom;
+};
+
+/** Bloom filter partition read task callback. */
+static int
+vy_bloom_read_cb(struct cbus_call_msg *base)
+{
+	struct vy_bloom_read_task *task = (struct vy_bloom_read_task *)base;
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(task->run->env);
+	if (zdctx == NULL)
+		return -1;
+	task->bloom = vy_bloom_partition_read(task->partition, task->run,
+					      zdctx);
+	return task->bloom != NULL ? 0 : -1;
+}
+
+/** Unload a bloom filter partition and remove it from the cache. */
+static void
+vy_bloom_cache_evict(struct vy_bloom_cache *cache,
+		     struct vy_bloom_partition *partition)
+{
+	assert(partition->bloom != NULL);
+	size_t size = tuple_bloom_size(partition->bloom);
+	rlist_del_entry(partition, in_lru);
+	assert(cache->mem_used >= size);
+	cache->mem_used -= size;
+	tuple_bloom_delete(partition->bloom);
+	partition->bloom = NULL;
+}
+
+/**
+ * Evict bloom filter partitions until the cache fits in the quota.
+ * The most recently used partition is kept, because the caller may
+ * be using it.
+ */
+static void
+vy_bloom_cache_evict_to_quota(struct vy_bloom_cache *cache)
+{
+	while (cache->mem_used > cache->mem_quota) {
+		assert(!rlist_empty(&cache->lru));
+		struct vy_bloom_partition *partition =
+			rlist_last_entry(&cache->lru,
+					 struct vy_bloom_partition, in_lru);
+		if (partition == rlist_first_entry(&cache->lru,
+						   struct vy_bloom_partition,
+						   in_lru))
+			break;
+		vy_bloom_cache_evict(cache, partition);
+	}
+}
+
+void
+vy_run_env_set_bloom_cache_quota(struct vy_run_env *env, size_t quota)
+{
+	struct vy_bloom_cache *cache = &env->bloom_cache;
+	cache->mem_quota = quota;
+	vy_bloom_cache_evict_to_quota(cache);
+}
+
+/**
+ * Return the bloom filter of a run partition, loading it from
+ * disk if necessary. Loaded partitions are kept in the bloom
+ * filter cache. The returned filter stays valid until the next
+ * call to this function. May yield. Returns NULL on error.
+ */
+static struct tuple_bloom *
+vy_run_load_bloom_partition(struct vy_run *run, uint32_t partition_no)
+{
+	assert(partition_no < run->info.bloom_partition_count);
+	struct vy_bloom_cache *cache = &run->env->bloom_cache;
+	struct vy_bloom_partition *partition =
+		&run->info.bloom_partitions[partition_no];
+	if (partition->bloom != NULL) {
+		/* Move the partition to the head of the LRU list. */
+		rlist_move_entry(&cache->lru, partition, in_lru);
+		return partition->bloom;
+	}
+
+	struct vy_bloom_read_task task;
+	task.run = run;
+	task.partition = partition;
+	task.bloom = NULL;
+	int rc = vy_run_env_coio_call(run->env, &task.base, vy_bloom_read_cb);
+	if (rc != 0) {
+		if (task.bloom != NULL)
+			tuple_bloom_delete(task.bloom);
+		return NULL;
+	}
+	/* The partition could have been loaded by another fiber. */
+	if (partition->bloom != NULL) {
+		tuple_bloom_delete(task.bloom);
+		rlist_move_entry(&cache->lru, partition, in_lru);
+		return partition->bloom;
+	}
+	partition->bloom = task.bloom;
+	rlist_add_entry(&cache->lru, partition, in_lru);
+	cache->mem_used += tuple_bloom_size(task.bloom);
+	vy_bloom_cache_evict_to_quota(cache);
+	return task.bloom;
+}
+
+/**
+ * Check if a run may store statements matching the iterator key.
+ * For a run with partitioned bloom filters, loads the partitions
+ * covering the pages where such statements would be stored.
+ *
+ * @retval 0 success, *maybe_has is set
+ * @retval -1 read or memory error
+ */
+static NODISCARD int
+vy_run_iterator_bloom_maybe_has(struct vy_run_iterator *itr, bool *maybe_has)
+{
+	struct vy_run *run = itr->slice->run;
+	if (run->info.bloom != NULL) {
+		*maybe_has = vy_bloom_maybe_has(run->info.bloom, itr->key,
+						itr->key_def);
+		return 0;
+	}
+	assert(run->info.bloom_partition_count > 0);
+	/*
+	 * Statements matching the key are stored in pages starting
+	 * from the one found by a GE lookup in the page index and
+	 * ending with the one found by an LE lookup.
+	 */
+	bool unused;
+	uint32_t page_no = vy_page_index_find_page(run, itr->key, itr->cmp_def,
+						   ITER_GE, &unused);
+	uint32_t last_page_no = vy_page_index_find_page(run, itr->key,
+							itr->cmp_def, ITER_LE,
+							&unused);
+	if (last_page_no >= run->info.page_count) {
+		/* All pages are greater than the key. */
+		*maybe_has = false;
+		return 0;
+	}
+	assert(page_no <= last_page_no);
+	uint32_t pages = run->info.bloom_partition_pages;
+	for (uint32_t i = page_no / pages; i <= last_page_no / pages; i++) {
+		struct tuple_bloom *bloom = vy_run_load_bloom_partition(run, i);
+		if (bloom == NULL)
+			return -1;
+		if (vy_bloom_maybe_has(bloom, itr->key, itr->key_def)) {
+			*maybe_has = true;
+			return 0;
+		}
+	}
+	*maybe_has = false;
+	return 0;
+}
+
+/**
+ * Make a page the current page of a run iterator. The iterator
+ * keeps two most recently used pages. Takes the page reference.
+ */
+static void
+vy_run_iterator_set_curr_page(struct vy_run_iterator *itr,
+			      struct vy_page *page)
+{
+	if (itr->prev_page != NULL)
+		vy_page_unref(itr->prev_page);
+	itr->prev_page = itr->curr_page;
+	itr->curr_page = page;
+}
+
 /**
  * Read a page from disk given its number.
- * The function caches two most recently read pages.
+ * The function caches two most recently read pages. Pages are
+ * also looked up in and added to the run page cache.
  *
  * @retval 0 success
  * @retval -1 critical error
@@ -1090,6 +1626,20 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		return 0;
 	}
 
+	/* Check the page cache shared by all iterators. */
+	page = vy_page_cache_get(&env->page_cache, slice->run, page_no);
+	if (page != NULL) {
+		vy_page_ref(page);
+		vy_run_iterator_set_curr_page(itr, page);
+		if (key.stmt != NULL &&
+		    vy_page_find_key(page, key, itr->cmp_def,
+				     itr->is_primary, iterator_type,
+				     pos_in_page, equal_found) != 0)
+			return -1;
+		*result = page;
+		return 0;
+	}
+
 	/* Allocate buffers */
 	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
 	page = vy_page_new(page_info);
@@ -1126,11 +1676,9 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	}
 
 	/* Update cache */
-	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
-	itr->prev_page = itr->curr_page;
-	itr->curr_page = page;
 	page->page_no = page_no;
+	vy_run_iterator_set_curr_page(itr, page);
+	vy_page_cache_put(&env->page_cache, slice->run, page);
 
 	/* Update read statistics. */
 	itr->stat->read.rows += page_info->row_count;
@@ -1402,7 +1950,7 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 {
 	struct key_def *cmp_def = itr->cmp_def;
 	struct vy_slice *slice = itr->slice;
-	struct tuple_bloom *bloom = slice->run->info.bloom;
+	struct vy_run *run = slice->run;
 	struct vy_entry key = itr->key;
 	enum iterator_type iterator_type = itr->iterator_type;
 
@@ -1410,12 +1958,19 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 	assert(itr->search_started);
 
 	/* Check the bloom filter on the first iteration. */
-	bool check_bloom = (itr->iterator_type == ITER_EQ &&
-			    itr->curr.stmt == NULL && bloom != NULL);
-	if (check_bloom && !vy_bloom_maybe_has(bloom, itr->key, itr->key_def)) {
-		vy_run_iterator_stop(itr);
-		itr->stat->bloom_hit++;
-		return 0;
+	bool check_bloom = (itr->check_bloom && itr->curr.stmt == NULL &&
+			    !vy_stmt_is_empty_key(itr->key.stmt) &&
+			    (run->info.bloom != NULL ||
+			     run->info.bloom_partition_count > 0));
+	if (check_bloom) {
+		bool maybe_has;
+		if (vy_run_iterator_bloom_maybe_has(itr, &maybe_has) != 0)
+			return -1;
+		if (!maybe_has) {
+			vy_run_iterator_stop(itr);
+			itr->stat->bloom_hit++;
+			return 0;
+		}
 	}
 
 	/*
@@ -1538,6 +2093,12 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->is_primary = is_primary;
 	itr->slice = slice;
 
+	if (iterator_type == ITER_REQ) {
+		iterator_type = ITER_LE;
+		itr->check_bloom = true;
+	} else {
+		itr->check_bloom = iterator_type == ITER_EQ;
+	}
 	itr->iterator_type = iterator_type;
 	itr->key = key;
 	itr->read_view = rv;
@@ -2096,6 +2657,8 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 		bloom_key = tuple_bloom_version_to_iproto(
 			run_info->bloom->version);
 	}
+	if (run_info->bloom_partition_count > 0)
+		key_count++;
 
 	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
@@ -2109,6 +2672,9 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	if (run_info->bloom != NULL)
 		size += mp_sizeof_uint(bloom_key) +
 			tuple_bloom_size(run_info->bloom);
+	if (run_info->bloom_partition_count > 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_BLOOM_FILTER_PARTITIONS) +
+			vy_bloom_partitions_sizeof(run_info);
 	size += mp_sizeof_uint(VY_RUN_INFO_STMT_STAT) +
 		vy_stmt_stat_sizeof(&run_info->stmt_stat);
 
@@ -2137,6 +2703,10 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 		pos = mp_encode_uint(pos, bloom_key);
 		pos = tuple_bloom_encode(run_info->bloom, pos);
 	}
+	if (run_info->bloom_partition_count > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM_FILTER_PARTITIONS);
+		pos = vy_bloom_partitions_encode(run_info, pos);
+	}
 	pos = mp_encode_uint(pos, VY_RUN_INFO_STMT_STAT);
 	pos = vy_stmt_stat_encode(&run_info->stmt_stat, pos);
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
@@ -2215,7 +2785,9 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression)
+		     uint64_t page_size, double bloom_fpr,
+		     uint32_t bloom_partition_pages,
+		     enum index_bloom_type bloom_type, bool no_compression)
 {
 	memset(writer, 0, sizeof(*writer));
 	writer->run = run;
@@ -2226,6 +2798,8 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	writer->key_def = key_def;
 	writer->page_size = page_size;
 	writer->bloom_fpr = bloom_fpr;
+	writer->bloom_partition_pages = bloom_partition_pages;
+	writer->bloom_type = bloom_type;
 	writer->no_compression = no_compression;
 	if (bloom_fpr < 1) {
 		writer->bloom = tuple_bloom_builder_new(key_def->part_count);
@@ -2237,6 +2811,8 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		    4096 * sizeof(uint32_t));
 	run->info.min_lsn = INT64_MAX;
 	run->info.max_lsn = -1;
+	if (writer->bloom != NULL)
+		run->info.bloom_partition_pages = bloom_partition_pages;
 	assert(run->page_info == NULL);
 	return 0;
 }
@@ -2341,6 +2917,106 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 	return 0;
 }
 
+/**
+ * Encode a bloom filter partition as xrow.
+ * Allocates using region_alloc.
+ *
+ * @param bloom bloom filter to encode
+ * @param[out] xrow xrow to fill
+ *
+ * @retval  0 success
+ * @retval -1 error, check diag
+ */
+static int
+vy_bloom_partition_encode(const struct tuple_bloom *bloom,
+			  struct xrow_header *xrow)
+{
+	assert(bloom->version == TUPLE_BLOOM_VERSION_V3 ||
+	       bloom->version == TUPLE_BLOOM_VERSION_V4);
+	uint32_t key = bloom->version == TUPLE_BLOOM_VERSION_V3 ?
+		       VY_RUN_BLOOM_FILTER : VY_RUN_BLOOM_FILTER_BINARY_FUSE;
+	size_t size = mp_sizeof_map(1) + mp_sizeof_uint(key) +
+		      tuple_bloom_size(bloom);
+	char *pos = region_alloc(&fiber()->gc, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "region", "bloom filter partition");
+		return -1;
+	}
+	memset(xrow, 0, sizeof(*xrow));
+	xrow->type = VY_RUN_BLOOM;
+	xrow->body->iov_base = pos;
+	pos = mp_encode_map(pos, 1);
+	pos = mp_encode_uint(pos, key);
+	pos = tuple_bloom_encode(bloom, pos);
+	xrow->body->iov_len = pos - (char *)xrow->body->iov_base;
+	assert(xrow->body->iov_len == size);
+	xrow->bodycnt = 1;
+	return 0;
+}
+
+/**
+ * Write the bloom filter partition covering the pages written
+ * since the previous partition and start a new one.
+ * @param writer Run writer.
+ * @retval -1 Memory or IO error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_write_bloom_partition(struct vy_run_writer *writer)
+{
+	struct vy_run *run = writer->run;
+	assert(writer->bloom != NULL);
+	assert(writer->bloom_partition_pages > 0);
+	if (run->info.bloom_partition_count >=
+	    writer->bloom_partition_capacity) {
+		uint32_t cap = writer->bloom_partition_capacity > 0 ?
+			       writer->bloom_partition_capacity * 2 : 16;
+		struct vy_bloom_partition *partitions =
+			realloc(run->info.bloom_partitions,
+				cap * sizeof(*partitions));
+		if (partitions == NULL) {
+			diag_set(OutOfMemory, cap * sizeof(*partitions),
+				 "realloc", "struct vy_bloom_partition");
+			return -1;
+		}
+		run->info.bloom_partitions = partitions;
+		writer->bloom_partition_capacity = cap;
+	}
+	struct tuple_bloom *bloom = tuple_bloom_new(
+		writer->bloom, writer->bloom_fpr,
+		vy_bloom_version(writer->bloom_type));
+	struct xrow_header xrow;
+	int rc = vy_bloom_partition_encode(bloom, &xrow);
+	tuple_bloom_delete(bloom);
+	if (rc != 0)
+		return -1;
+
+	struct vy_bloom_partition *partition =
+		&run->info.bloom_partitions[run->info.bloom_partition_count];
+	memset(partition, 0, sizeof(*partition));
+	partition->offset = writer->data_xlog.offset;
+	xlog_tx_begin(&writer->data_xlog);
+	ssize_t written = xlog_write_row(&writer->data_xlog, &xrow);
+	if (written < 0) {
+		xlog_tx_rollback(&writer->data_xlog);
+		return -1;
+	}
+	partition->unpacked_size = written;
+	written = xlog_tx_commit(&writer->data_xlog);
+	if (written == 0)
+		written = xlog_flush(&writer->data_xlog);
+	if (written < 0)
+		return -1;
+	partition->size = written;
+	run->info.bloom_partition_count++;
+
+	tuple_bloom_builder_delete(writer->bloom);
+	writer->bloom = tuple_bloom_builder_new(writer->key_def->part_count);
+	if (writer->bloom == NULL)
+		return -1;
+	return 0;
+}
+
 /**
  * Finish a current page.
  * @param writer Run writer.
@@ -2376,6 +3052,10 @@ vy_run_writer_end_page(struct vy_run_writer *writer)
 	page->size = written;
 	vy_run_acct_page(run, page);
 	ibuf_reset(&writer->row_index_buf);
+	if (run->info.bloom_partition_pages > 0 &&
+	    run->info.page_count % run->info.bloom_partition_pages == 0 &&
+	    vy_run_writer_write_bloom_partition(writer) != 0)
+		return -1;
 	return 0;
 }
 
@@ -2447,6 +3127,11 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 	assert(run->info.max_key == NULL);
 	run->info.max_key = mp_dup(key);
 
+	if (run->info.bloom_partition_pages > 0 &&
+	    run->info.page_count % run->info.bloom_partition_pages != 0 &&
+	    vy_run_writer_write_bloom_partition(writer) != 0)
+		goto out;
+
 	ERROR_INJECT(ERRINJ_VY_RUN_FILE_RENAME, {
 		diag_set(ClientError, ER_INJECTION, "vinyl run file rename");
 		goto out;
@@ -2459,9 +3144,10 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 		goto out;
 	}
 
-	if (writer->bloom != NULL)
-		run->info.bloom = tuple_bloom_new(writer->bloom,
-						  writer->bloom_fpr);
+	if (writer->bloom != NULL && run->info.bloom_partition_pages == 0)
+		run->info.bloom = tuple_bloom_new(
+			writer->bloom, writer->bloom_fpr,
+			vy_bloom_version(writer->bloom_type));
 	if (vy_run_write_index(run, writer->dirpath,
 			       writer->space_id, writer->iid) != 0)
 		goto out;
@@ -2532,8 +3218,19 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		uint64_t page_row_index_offset = 0;
 		uint64_t row_offset = xlog_cursor_tx_pos(&cursor);
 
+		bool is_bloom_partition = false;
 		struct xrow_header xrow;
 		while ((rc = xlog_cursor_next_row(&cursor, &xrow)) == 0) {
+			if (xrow.type == VY_RUN_BLOOM) {
+				/*
+				 * Bloom filter partitions are written in
+				 * separate transactions, which aren't pages.
+				 * The rebuilt index uses a run-wide bloom
+				 * filter instead.
+				 */
+				is_bloom_partition = true;
+				continue;
+			}
 			if (xrow.type == VY_RUN_ROW_INDEX) {
 				page_row_index_offset = row_offset;
 				row_offset = xlog_cursor_tx_pos(&cursor);
@@ -2571,6 +3268,10 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 				min_lsn = xrow.lsn;
 			row_offset = xlog_cursor_tx_pos(&cursor);
 		}
+		if (is_bloom_partition) {
+			assert(page_row_count == 0);
+			continue;
+		}
 		struct vy_page_info *info;
 		info = run->page_info + run->info.page_count;
 		vy_page_info_create(info, page_offset, page_min_key, cmp_def);
@@ -2599,8 +3300,9 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 	xlog_cursor_close(&cursor, true);
 
 	if (bloom_builder != NULL) {
-		run->info.bloom = tuple_bloom_new(bloom_builder,
-						  opts->bloom_fpr);
+		run->info.bloom = tuple_bloom_new(
+			bloom_builder, opts->bloom_fpr,
+			vy_bloom_version(opts->bloom_type));
 		tuple_bloom_builder_delete(bloom_builder);
 		bloom_builder = NULL;
 	}
@@ -52,6 +52,32 @@ extern "C" {
 struct vy_history;
 struct vy_run_reader;
 
+/**
+ * Cache of decompressed run pages shared by all run iterators.
+ * Accessed only from the tx thread.
+ */
+struct vy_page_cache {
+	/** List of cached pages, most recently used first. */
+	struct rlist lru;
+	/** Memory used by cached pages, in bytes. */
+	size_t mem_used;
+	/** Max memory that may be used by cached pages, in bytes. */
+	size_t mem_quota;
+};
+
+/**
+ * Cache of bloom filter partitions loaded on demand by run iterators.
+ * Accessed only from the tx thread.
+ */
+struct vy_bloom_cache {
+	/** List of loaded partitions, most recently used first. */
+	struct rlist lru;
+	/** Memory used by loaded partitions, in bytes. */
+	size_t mem_used;
+	/** Max memory that may be used by loaded partitions, in bytes. */
+	size_t mem_quota;
+};
+
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
 	/** Write rate limit, in bytes per second. */
@@ -69,6 +95,10 @@ struct vy_run_env {
 	 * processing the next read request.
 	 */
 	int next_reader;
+	/** Cache of pages read by run iterators. */
+	struct vy_page_cache page_cache;
+	/** Cache of loaded bloom filter partitions. */
+	struct vy_bloom_cache bloom_cache;
 	/**
 	 * We need this flag during compaction in order to determine we can
 	 * unconditionally remove unused runs' files in-place.
@@ -76,6 +106,30 @@ struct vy_run_env {
 	bool initial_join;
 };
 
+/**
+ * Bloom filter for keys stored in a range of run pages.
+ *
+ * If a run is written with partitioned bloom filters, a separate
+ * filter is built for each bloom_partition_pages consecutive pages
+ * and stored in the run file after the last of them. Only the
+ * partition index is kept in the index file so partitions are
+ * loaded on demand, when a lookup hits the pages they cover, and
+ * evicted in the LRU order when the bloom filter cache exceeds its
+ * quota, see vy_bloom_cache.
+ */
+struct vy_bloom_partition {
+	/** Offset of the partition in the run file. */
+	uint64_t offset;
+	/** Size of the partition in the run file. */
+	uint32_t size;
+	/** Size of the partition in memory, i.e. unpacked. */
+	uint32_t unpacked_size;
+	/** Bloom filter if the partition is loaded, NULL otherwise. */
+	struct tuple_bloom *bloom;
+	/** Link in vy_bloom_cache::lru. Valid only if loaded. */
+	struct rlist in_lru;
+};
+
 /**
  * Run metadata. Is a written to a file as a single chunk.
  */
@@ -92,6 +146,15 @@ struct vy_run_info {
 	uint32_t page_count;
 	/** Bloom filter of all tuples in run */
 	struct tuple_bloom *bloom;
+	/**
+	 * Number of pages covered by one bloom filter partition or
+	 * 0 if the run doesn't have partitioned bloom filters.
+	 */
+	uint32_t bloom_partition_pages;
+	/** Number of bloom filter partitions. */
+	uint32_t bloom_partition_count;
+	/** Array of bloom filter partitions. */
+	struct vy_bloom_partition *bloom_partitions;
 	/** Statement statistics. */
 	struct vy_stmt_stat stmt_stat;
 };
@@ -173,6 +236,12 @@ struct vy_run {
 	struct rlist in_unused;
 	/** Link in vy_lsm::runs list. */
 	struct rlist in_lsm;
+	/**
+	 * Pages of this run stored in the page cache, indexed by
+	 * page number. Allocated on the first insertion into the
+	 * cache.
+	 */
+	struct vy_page **cached_pages;
 };
 
 /**
@@ -270,6 +339,12 @@ struct vy_run_iterator {
 	enum iterator_type iterator_type;
 	/** Key to search. */
 	struct vy_entry key;
+	/**
+	 * Set if all statements returned by the iterator must match
+	 * the key (EQ or REQ), which allows to skip the run if the
+	 * bloom filter says there's no such key.
+	 */
+	bool check_bloom;
 	/* LSN visibility, iterator shows values with lsn <= vlsn */
 	const struct vy_read_view **read_view;
 
@@ -305,6 +380,16 @@ struct vy_page {
 	uint32_t *row_index;
 	/** Pointer to the page data. */
 	char *data;
+	/**
+	 * Reference counter. A page is referenced by each run
+	 * iterator using it and by the page cache. The page is
+	 * freed once the counter hits 0.
+	 */
+	int refs;
+	/** Run the page is cached for or NULL if it isn't cached. */
+	struct vy_run *cached_run;
+	/** Link in vy_page_cache::lru. */
+	struct rlist in_cache;
 };
 
 /**
@@ -339,7 +424,25 @@ void
 vy_run_env_enable_coio(struct vy_run_env *env);
 
 /**
- * Return the size of a run bloom filter.
+ * Set the max size of the page cache, in bytes. Pages are
+ * evicted from the cache if it exceeds the new limit. Zero
+ * disables the cache.
+ */
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota);
+
+/**
+ * Set the max size of loaded bloom filter partitions, in bytes.
+ * Partitions are evicted if they exceed the new limit. The most
+ * recently used partition is never evicted.
+ */
+void
+vy_run_env_set_bloom_cache_quota(struct vy_run_env *env, size_t quota);
+
+/**
+ * Return the size of a run bloom filter. Bloom filter partitions
+ * are loaded on demand so only the partition index is accounted
+ * for a run with partitioned bloom filters.
  */
 size_t
 vy_run_bloom_size(struct vy_run *run);
@@ -551,6 +654,9 @@ vy_slice_cut(struct vy_slice *slice, int64_t id, struct vy_entry begin,
 /**
  * Open an iterator over on-disk run.
  *
+ * ITER_REQ is handled as ITER_LE, but the caller must filter out
+ * statements that don't match the key.
+ *
  * Note, it is the caller's responsibility to make sure the slice
  * is not compacted while the iterator is reading it.
  */
@@ -662,7 +768,16 @@ struct vy_run_writer {
 	struct xlog data_xlog;
 	/** Bloom filter false positive rate. */
 	double bloom_fpr;
-	/** Bloom filter. */
+	/**
+	 * Number of pages covered by one bloom filter partition,
+	 * 0 if a single bloom filter is built for the whole run.
+	 */
+	uint32_t bloom_partition_pages;
+	/** Capacity of the bloom filter partition array. */
+	uint32_t bloom_partition_capacity;
+	/** Type of bloom filters to build. */
+	enum index_bloom_type bloom_type;
+	/** Bloom filter, or current bloom filter partition. */
 	struct tuple_bloom_builder *bloom;
 	/** Buffer of a current page row offsets. */
 	struct ibuf row_index_buf;
@@ -678,7 +793,9 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression);
+		     uint64_t page_size, double bloom_fpr,
+		     uint32_t bloom_partition_pages,
+		     enum index_bloom_type bloom_type, bool no_compression);
 
 /**
  * Write a specified statement into a run.
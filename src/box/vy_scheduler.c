@@ -105,6 +105,13 @@ struct vy_worker {
 /** Max number of statements in a batch of deferred DELETEs. */
 enum { VY_DEFERRED_DELETE_BATCH_MAX = 100 };
 
+/**
+ * Min number of pages of the oldest compacted run per part of
+ * a split compaction task. Splitting a small compaction isn't
+ * worth the extra run files.
+ */
+enum { VY_COMPACTION_PART_MIN_PAGES = 16 };
+
 /** Deferred DELETE statement. */
 struct vy_deferred_delete_stmt {
 	/** Overwritten tuple. */
@@ -212,6 +219,31 @@ struct vy_task {
 	 * linked by vy_slice::in_compaction.
 	 */
 	struct rlist compacted_slices;
+	/**
+	 * If compaction is split into parts, this array stores
+	 * slices of the compacted runs cut by the key range
+	 * compacted by this task, otherwise it's NULL. The slices
+	 * aren't logged and are deleted before task completion.
+	 */
+	struct vy_slice **part_slices;
+	/** Number of entries in the part_slices array. */
+	int part_slice_count;
+	/**
+	 * Tasks compacting the other parts of the range if
+	 * compaction is split, see vy_task_compaction_split().
+	 * This task compacts the first part.
+	 */
+	struct vy_task **parts;
+	/** Number of entries in the parts array. */
+	int part_count;
+	/** Task this task is a part of or NULL. */
+	struct vy_task *parent;
+	/**
+	 * Number of parts of this task, including the task itself,
+	 * that are still being executed by worker threads. The task
+	 * is completed once all of them are done.
+	 */
+	int parts_in_progress;
 	/** Set if there is no older level than the one we're writing to. */
 	bool is_last_level;
 	/** Array of read view LSNs sorted in the ascending order. */
@@ -224,6 +256,8 @@ struct vy_task {
 	 * from another thread.
 	 */
 	double bloom_fpr;
+	uint32_t bloom_partition_pages;
+	enum index_bloom_type bloom_type;
 	int64_t page_size;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
@@ -276,6 +310,7 @@ vy_task_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	diag_create(&task->diag);
 	rlist_create(&task->dumped_mems);
 	rlist_create(&task->compacted_slices);
+	task->parts_in_progress = 1;
 	task->deferred_delete_handler.iface = &vy_task_deferred_delete_iface;
 	return task;
 }
@@ -295,12 +330,41 @@ vy_task_set_read_views(struct vy_task *task, struct rlist *read_views)
 	}
 }
 
+/**
+ * Delete slices cut for a part of a split compaction task,
+ * see vy_task::part_slices.
+ */
+static void
+vy_task_delete_part_slices(struct vy_task *task)
+{
+	for (int i = 0; i < task->part_slice_count; i++)
+		vy_slice_delete(task->part_slices[i]);
+	free(task->part_slices);
+	task->part_slices = NULL;
+	task->part_slice_count = 0;
+}
+
+/**
+ * Return the task executing part @a i of a split compaction task.
+ * Part 0 is executed by the task itself.
+ */
+static inline struct vy_task *
+vy_task_part(struct vy_task *task, int i)
+{
+	assert(i >= 0 && i <= task->part_count);
+	return i == 0 ? task : task->parts[i - 1];
+}
+
 /** Free a task allocated with vy_task_new(). */
 static void
 vy_task_delete(struct vy_task *task)
 {
 	assert(task->deferred_delete_batch == NULL);
 	assert(task->deferred_delete_in_progress == 0);
+	for (int i = 0; i < task->part_count; i++)
+		vy_task_delete(task->parts[i]);
+	free(task->parts);
+	vy_task_delete_part_slices(task);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
 	space_def_delete(task->space_def);
@@ -1148,7 +1212,8 @@ vy_task_write_run(struct vy_task *task, struct vy_stmt_stream *wi,
 				 lsm->space_id, lsm->index_id,
 				 task->cmp_def, task->key_def,
 				 task->page_size, task->bloom_fpr,
-				 no_compression) != 0)
+				 task->bloom_partition_pages,
+				 task->bloom_type, no_compression) != 0)
 		goto fail;
 
 	if (wi->iface->start(wi) != 0)
@@ -1492,6 +1557,8 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 
 	task->new_run = new_run;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
+	task->bloom_partition_pages = lsm->opts.bloom_partition_pages;
+	task->bloom_type = lsm->opts.bloom_type;
 	task->page_size = lsm->opts.page_size;
 	vy_task_set_read_views(task, scheduler->read_views);
 
@@ -1545,11 +1612,21 @@ vy_task_compaction_execute(struct vy_task *task)
 			is_primary ? &task->deferred_delete_handler : NULL);
 	if (wi == NULL)
 		goto out_delete_key_format;
-	struct vy_slice *slice;
-	rlist_foreach_entry(slice, &task->compacted_slices, in_compaction) {
-		if (vy_write_iterator_new_slice(wi, slice, format,
-						key_format) != 0)
-			goto out_close_wi;
+	if (task->part_slices != NULL) {
+		for (int i = 0; i < task->part_slice_count; i++) {
+			if (vy_write_iterator_new_slice(wi,
+						task->part_slices[i],
+						format, key_format) != 0)
+				goto out_close_wi;
+		}
+	} else {
+		struct vy_slice *slice;
+		rlist_foreach_entry(slice, &task->compacted_slices,
+				    in_compaction) {
+			if (vy_write_iterator_new_slice(wi, slice, format,
+							key_format) != 0)
+				goto out_close_wi;
+		}
 	}
 	rc = vy_task_write_run(task, wi, false);
 out_close_wi:
@@ -1568,12 +1645,17 @@ vy_task_compaction_complete(struct vy_task *task)
 	struct vy_scheduler *scheduler = task->scheduler;
 	struct vy_lsm *lsm = task->lsm;
 	struct vy_range *range = task->range;
-	struct vy_run *new_run = task->new_run;
+	int part_count = task->part_count + 1;
 	double compaction_time = ev_monotonic_now(loop()) - task->start_time;
-	struct vy_disk_stmt_counter compaction_output = new_run->count;
+	struct vy_disk_stmt_counter compaction_output;
 	struct vy_disk_stmt_counter compaction_input;
-	struct vy_slice *slice, *next_slice, *new_slice = NULL;
+	struct vy_slice *slice, *next_slice, *first_slice;
+	struct vy_slice **new_slices = NULL;
 	struct vy_run *run;
+	int i;
+
+	for (i = 0; i < part_count; i++)
+		vy_task_delete_part_slices(vy_task_part(task, i));
 
 	/*
 	 * The LSM tree could have been dropped while we were writing the new
@@ -1582,23 +1664,30 @@ vy_task_compaction_complete(struct vy_task *task)
 	 * commit the new slice. Discard the run and exit.
 	 */
 	if (lsm->is_dropped) {
-		vy_run_discard(new_run);
+		for (i = 0; i < part_count; i++)
+			vy_run_discard(vy_task_part(task, i)->new_run);
 		goto out;
 	}
 
 	/*
-	 * Allocate a slice of the new run.
+	 * Allocate a slice of each new run, one per compaction part.
 	 *
-	 * If the run is empty, we don't need to allocate a new slice
+	 * If a run is empty, we don't need to allocate a new slice
 	 * and insert it into the range, but we still need to delete
 	 * compacted runs.
 	 */
-	if (!vy_run_is_empty(new_run)) {
-		new_slice = vy_slice_new(vy_log_next_id(), new_run,
-					 vy_entry_none(), vy_entry_none(),
-					 lsm->cmp_def);
-		if (new_slice == NULL)
-			return -1;
+	new_slices = xcalloc(part_count, sizeof(*new_slices));
+	vy_disk_stmt_counter_reset(&compaction_output);
+	for (i = 0; i < part_count; i++) {
+		run = vy_task_part(task, i)->new_run;
+		vy_disk_stmt_counter_add(&compaction_output, &run->count);
+		if (vy_run_is_empty(run))
+			continue;
+		new_slices[i] = vy_slice_new(vy_log_next_id(), run,
+					     vy_entry_none(), vy_entry_none(),
+					     lsm->cmp_def);
+		if (new_slices[i] == NULL)
+			goto fail;
 	}
 
 	/*
@@ -1623,18 +1712,19 @@ vy_task_compaction_complete(struct vy_task *task)
 		vy_log_delete_slice(slice->id);
 	rlist_foreach_entry(run, &unused_runs, in_unused)
 		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
-	if (new_slice != NULL) {
-		vy_log_create_run(lsm->id, new_run->id, new_run->dump_lsn,
-				  new_run->dump_count);
-		vy_log_insert_slice(range->id, new_run->id, new_slice->id,
+	for (i = 0; i < part_count; i++) {
+		struct vy_slice *new_slice = new_slices[i];
+		if (new_slice == NULL)
+			continue;
+		run = new_slice->run;
+		vy_log_create_run(lsm->id, run->id, run->dump_lsn,
+				  run->dump_count);
+		vy_log_insert_slice(range->id, run->id, new_slice->id,
 				    tuple_data_or_null(new_slice->begin.stmt),
 				    tuple_data_or_null(new_slice->end.stmt));
 	}
-	if (vy_log_tx_commit() < 0) {
-		if (new_slice != NULL)
-			vy_slice_delete(new_slice);
-		return -1;
-	}
+	if (vy_log_tx_commit() < 0)
+		goto fail;
 
 	/*
 	 * Remove compacted run files that were created after
@@ -1654,30 +1744,36 @@ vy_task_compaction_complete(struct vy_task *task)
 	}
 
 	/*
-	 * Account the new run if it is not empty,
-	 * otherwise discard it.
+	 * Account the new runs if they are not empty,
+	 * otherwise discard them.
 	 */
-	if (new_slice != NULL) {
-		vy_lsm_add_run(lsm, new_run);
-		/* Drop the reference held by the task. */
-		vy_run_unref(new_run);
-	} else
-		vy_run_discard(new_run);
+	for (i = 0; i < part_count; i++) {
+		run = vy_task_part(task, i)->new_run;
+		if (new_slices[i] != NULL) {
+			vy_lsm_add_run(lsm, run);
+			/* Drop the reference held by the task. */
+			vy_run_unref(run);
+		} else
+			vy_run_discard(run);
+	}
 
 	/*
-	 * Replace compacted slices with the resulting slice and
+	 * Replace compacted slices with the resulting slices and
 	 * account compaction in LSM tree statistics.
 	 *
 	 * Note, since a slice might have been added to the range
 	 * by a concurrent dump while compaction was in progress,
-	 * we must insert the new slice at the same position where
-	 * the compacted slices were.
+	 * we must insert the new slices at the same position where
+	 * the compacted slices were. Slices of a split compaction
+	 * are inserted in the key order.
 	 */
 	vy_lsm_unacct_range(lsm, range);
-	if (new_slice != NULL) {
-		struct vy_slice *first_slice = rlist_first_entry(
-			&task->compacted_slices, typeof(*slice), in_compaction);
-		vy_range_add_slice_before(range, new_slice, first_slice);
+	first_slice = rlist_first_entry(&task->compacted_slices,
+					typeof(*slice), in_compaction);
+	for (i = 0; i < part_count; i++) {
+		if (new_slices[i] != NULL)
+			vy_range_add_slice_before(range, new_slices[i],
+						  first_slice);
 	}
 	vy_disk_stmt_counter_reset(&compaction_input);
 	rlist_foreach_entry(slice, &task->compacted_slices, in_compaction) {
@@ -1704,6 +1800,7 @@ vy_task_compaction_complete(struct vy_task *task)
 		vy_slice_wait_pinned(slice);
 		vy_slice_delete(slice);
 	}
+	free(new_slices);
 out:
 	assert(heap_node_is_stray(&range->heap_node));
 	vy_range_heap_insert(&lsm->range_heap, range);
@@ -1712,6 +1809,13 @@ vy_task_compaction_complete(struct vy_task *task)
 	say_verbose("%s: completed compacting range %s",
 		    vy_lsm_name(lsm), vy_range_str(range));
 	return 0;
+fail:
+	for (i = 0; i < part_count; i++) {
+		if (new_slices[i] != NULL)
+			vy_slice_delete(new_slices[i]);
+	}
+	free(new_slices);
+	return -1;
 }
 
 static void
@@ -1726,13 +1830,220 @@ vy_task_compaction_abort(struct vy_task *task)
 	say_error("%s: failed to compact range %s",
 		  vy_lsm_name(lsm), vy_range_str(range));
 
-	vy_run_discard(task->new_run);
+	for (int i = 0; i <= task->part_count; i++) {
+		struct vy_task *part = vy_task_part(task, i);
+		vy_task_delete_part_slices(part);
+		vy_run_discard(part->new_run);
+	}
 
 	assert(heap_node_is_stray(&range->heap_node));
 	vy_range_heap_insert(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 }
 
+/**
+ * Choose keys splitting a compaction task into at most @a part_count
+ * parts. The keys are taken from the page index of the oldest compacted
+ * run, which is usually the biggest one, so that each part contains
+ * roughly the same number of its pages. If the oldest run is a sorted
+ * run, see vy_range_next_sorted_run(), pages of all its runs are used.
+ *
+ * On success returns the number of parts and stores their boundaries
+ * in @a keys, which the caller must unref. On failure returns -1.
+ */
+static int
+vy_task_compaction_split_keys(struct vy_task *task, int part_count,
+			      struct vy_entry *keys)
+{
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+	struct vy_slice *first = rlist_first_entry(&task->compacted_slices,
+						   struct vy_slice,
+						   in_compaction);
+	struct vy_slice *last = rlist_last_entry(&task->compacted_slices,
+						 struct vy_slice,
+						 in_compaction);
+	struct vy_slice *slice = last;
+	int64_t page_count = slice->count.pages;
+	while (slice != first) {
+		struct vy_slice *prev = rlist_prev_entry(slice, in_compaction);
+		if (prev->run->dump_lsn != last->run->dump_lsn)
+			break;
+		slice = prev;
+		page_count += slice->count.pages;
+	}
+	first = slice;
+	part_count = MIN(part_count,
+			 page_count / VY_COMPACTION_PART_MIN_PAGES);
+
+	/* The lower bound of the current part. */
+	struct vy_entry begin = range->begin;
+	int count = 1;
+	for (int i = 1; i < part_count; i++) {
+		int64_t page_no = i * page_count / part_count;
+		slice = first;
+		while (page_no >= slice->count.pages) {
+			page_no -= slice->count.pages;
+			slice = rlist_next_entry(slice, in_compaction);
+		}
+		struct vy_page_info *page = vy_run_page_info(slice->run,
+				slice->first_page_no + page_no);
+		struct vy_entry key = vy_entry_key_from_msgpack(
+				lsm->env->key_format, lsm->cmp_def,
+				page->min_key);
+		if (key.stmt == NULL) {
+			for (int j = 1; j < count; j++)
+				tuple_unref(keys[j].stmt);
+			return -1;
+		}
+		/* Skip keys that would result in an empty part. */
+		if ((begin.stmt != NULL &&
+		     vy_entry_compare(key, begin, lsm->cmp_def) <= 0) ||
+		    (range->end.stmt != NULL &&
+		     vy_entry_compare(key, range->end, lsm->cmp_def) >= 0)) {
+			tuple_unref(key.stmt);
+			continue;
+		}
+		keys[count++] = key;
+		begin = key;
+	}
+	keys[0] = vy_entry_none();
+	keys[count] = vy_entry_none();
+	return count;
+}
+
+/** Undo vy_task_compaction_split(). */
+static void
+vy_task_compaction_unsplit(struct vy_task *task)
+{
+	for (int i = 0; i < task->part_count; i++) {
+		struct vy_task *part = task->parts[i];
+		if (part->new_run != NULL)
+			vy_run_unref(part->new_run);
+		vy_worker_pool_put(part->worker);
+		vy_task_delete(part);
+	}
+	free(task->parts);
+	task->parts = NULL;
+	task->part_count = 0;
+	vy_task_delete_part_slices(task);
+}
+
+/**
+ * Split a compaction task into parts compacting disjoint key ranges
+ * of the range on different worker threads. The number of parts is
+ * limited by the compaction_threads index option and the number of
+ * idle compaction workers.
+ *
+ * Each part writes its own run. The runs are committed atomically
+ * by vy_task_compaction_complete() and form a sorted run in the range,
+ * see vy_range_next_sorted_run(). The write amplification is the same
+ * as without splitting.
+ */
+static int
+vy_task_compaction_split(struct vy_scheduler *scheduler, struct vy_task *task)
+{
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+	int part_count = MIN(lsm->opts.compaction_threads,
+			     scheduler->compaction_pool.size);
+	if (part_count <= 1)
+		return 0;
+
+	struct vy_entry *keys = xcalloc(part_count + 1, sizeof(*keys));
+	part_count = vy_task_compaction_split_keys(task, part_count, keys);
+	if (part_count < 0) {
+		free(keys);
+		return -1;
+	}
+	int rc = -1;
+	if (part_count > 1)
+		task->parts = xcalloc(part_count - 1, sizeof(*task->parts));
+	for (int i = 1; i < part_count; i++) {
+		struct vy_worker *worker = vy_worker_pool_get(
+				&scheduler->compaction_pool);
+		if (worker == NULL) {
+			/* Merge the parts left without a worker. */
+			for (int j = i; j < part_count; j++)
+				tuple_unref(keys[j].stmt);
+			keys[i] = vy_entry_none();
+			part_count = i;
+			break;
+		}
+		struct vy_task *part = vy_task_new(scheduler, worker, lsm,
+						   task->ops);
+		if (part == NULL) {
+			vy_worker_pool_put(worker);
+			goto out;
+		}
+		task->parts[task->part_count++] = part;
+		part->parent = task;
+		part->is_last_level = task->is_last_level;
+		part->bloom_fpr = task->bloom_fpr;
+		part->bloom_partition_pages = task->bloom_partition_pages;
+		part->bloom_type = task->bloom_type;
+		part->page_size = task->page_size;
+		if (task->vlsn_count > 0) {
+			part->vlsn_count = task->vlsn_count;
+			part->vlsns = xcalloc(task->vlsn_count,
+					      sizeof(*part->vlsns));
+			memcpy(part->vlsns, task->vlsns,
+			       task->vlsn_count * sizeof(*part->vlsns));
+		}
+		part->new_run = vy_run_new(scheduler->run_env,
+					   vy_log_next_id());
+		if (part->new_run == NULL)
+			goto out;
+		part->new_run->dump_lsn = task->new_run->dump_lsn;
+		part->new_run->dump_count = task->new_run->dump_count;
+	}
+	if (part_count <= 1) {
+		rc = 0;
+		goto out;
+	}
+	/*
+	 * Cut the compacted slices by the part boundaries. The cut
+	 * slices are never logged so we don't assign ids to them.
+	 */
+	for (int i = 0; i < part_count; i++) {
+		struct vy_task *part = vy_task_part(task, i);
+		part->part_slices = xcalloc(range->compaction_priority,
+					    sizeof(*part->part_slices));
+		struct vy_slice *slice, *part_slice;
+		rlist_foreach_entry(slice, &task->compacted_slices,
+				    in_compaction) {
+			if (vy_slice_cut(slice, 0, keys[i], keys[i + 1],
+					 lsm->cmp_def, &part_slice) != 0)
+				goto out;
+			if (part_slice != NULL)
+				part->part_slices[part->part_slice_count++] =
+								part_slice;
+		}
+	}
+	/*
+	 * Write the new runs to the metadata log so that we could
+	 * still find and delete them in case of a write error,
+	 * see vy_run_prepare().
+	 */
+	vy_log_tx_begin();
+	for (int i = 0; i < task->part_count; i++)
+		vy_log_prepare_run(lsm->id, task->parts[i]->new_run->id);
+	if (vy_log_tx_commit() < 0)
+		goto out;
+
+	task->parts_in_progress = part_count;
+	say_verbose("%s: split compaction of range %s into %d parts",
+		    vy_lsm_name(lsm), vy_range_str(range), part_count);
+	rc = 0;
+out:
+	if (rc != 0 || task->part_count == 0)
+		vy_task_compaction_unsplit(task);
+	for (int i = 1; i < part_count; i++)
+		tuple_unref(keys[i].stmt);
+	free(keys);
+	return rc;
+}
+
 static int
 vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		       struct vy_lsm *lsm, struct vy_task **p_task)
@@ -1762,13 +2073,20 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	if (new_run == NULL)
 		goto err_run;
 
-	struct vy_slice *slice;
+	struct vy_slice *slice, *prev_slice = NULL;
 	int32_t dump_count = 0;
 	int n = range->compaction_priority;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
 		new_run->dump_lsn = MAX(new_run->dump_lsn,
 					slice->run->dump_lsn);
-		dump_count += slice->run->dump_count;
+		/*
+		 * Runs forming a sorted run share dump_count, see
+		 * vy_range_next_sorted_run().
+		 */
+		if (prev_slice == NULL ||
+		    prev_slice->run->dump_lsn != slice->run->dump_lsn)
+			dump_count += slice->run->dump_count;
+		prev_slice = slice;
 		rlist_add_tail_entry(&task->compacted_slices, slice,
 				     in_compaction);
 		if (--n == 0)
@@ -1790,14 +2108,19 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	else
 		new_run->dump_count = dump_count;
 
-	range->needs_compaction = false;
-
 	task->range = range;
 	task->new_run = new_run;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
+	task->bloom_partition_pages = lsm->opts.bloom_partition_pages;
+	task->bloom_type = lsm->opts.bloom_type;
 	task->page_size = lsm->opts.page_size;
 	vy_task_set_read_views(task, scheduler->read_views);
 
+	if (vy_task_compaction_split(scheduler, task) != 0)
+		goto err_split;
+
+	range->needs_compaction = false;
+
 	/*
 	 * Remove the range we are going to compact from the heap
 	 * so that it doesn't get selected again.
@@ -1810,6 +2133,8 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		    range->compaction_priority, range->slice_count);
 	*p_task = task;
 	return 0;
+err_split:
+	vy_run_discard(new_run);
 err_run:
 	vy_task_delete(task);
 err:
@@ -1877,12 +2202,18 @@ vy_task_execute_f(struct cmsg *cmsg)
  * Callback invoked by the tx thread upon receiving an executed
  * task from a worker thread. It adds the task to the processed
  * task queue and wakes up the scheduler so that it can complete
- * it.
+ * it. A task split into parts is queued once all its parts have
+ * been executed.
  */
 static void
 vy_task_complete_f(struct cmsg *cmsg)
 {
 	struct vy_task *task = container_of(cmsg, struct vy_task, cmsg);
+	if (task->parent != NULL)
+		task = task->parent;
+	assert(task->parts_in_progress > 0);
+	if (--task->parts_in_progress > 0)
+		return;
 	stailq_add_tail_entry(&task->scheduler->processed_tasks,
 			      task, in_processed);
 	fiber_cond_signal(&task->scheduler->scheduler_cond);
@@ -2068,6 +2399,14 @@ vy_task_complete(struct vy_task *task)
 	assert(scheduler->stat.tasks_inprogress > 0);
 	scheduler->stat.tasks_inprogress--;
 
+	/* Fail the task if any of its parts failed. */
+	for (int i = 0; i < task->part_count && !task->is_failed; i++) {
+		struct vy_task *part = task->parts[i];
+		if (part->is_failed) {
+			task->is_failed = true;
+			diag_move(&part->diag, &task->diag);
+		}
+	}
 	struct diag *diag = &task->diag;
 	if (task->is_failed) {
 		assert(!diag_is_empty(diag));
@@ -2115,6 +2454,8 @@ vy_scheduler_complete_tasks(struct vy_scheduler *scheduler, int *tasks_done,
 			else
 				(*tasks_failed)++;
 			vy_worker_pool_put(task->worker);
+			for (int i = 0; i < task->part_count; i++)
+				vy_worker_pool_put(task->parts[i]->worker);
 			vy_task_delete(task);
 		}
 	}
@@ -2157,9 +2498,12 @@ vy_scheduler_f(va_list va)
 			continue;
 		}
 
-		/* Queue the task for execution. */
-		cmsg_init(&task->cmsg, vy_task_execute_route);
-		cpipe_push(&task->worker->worker_pipe, &task->cmsg);
+		/* Queue the task and its parts for execution. */
+		for (int i = 0; i <= task->part_count; i++) {
+			struct vy_task *part = vy_task_part(task, i);
+			cmsg_init(&part->cmsg, vy_task_execute_route);
+			cpipe_push(&part->worker->worker_pipe, &part->cmsg);
+		}
 
 		fiber_reschedule();
 		continue;
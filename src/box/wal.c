@@ -31,16 +31,21 @@
 #include "wal.h"
 
 #include "fiber.h"
+#include "fiber_cond.h"
 #include "fio.h"
 #include "errinj.h"
 #include "error.h"
 #include "exception.h"
+#include "clock.h"
+#include "latency.h"
+#include "info/info.h"
 
 #include "xlog.h"
 #include "xrow.h"
 #include "vy_log.h"
 #include "cbus.h"
 #include "coio_task.h"
+#include "coio_file.h"
 #include "replication.h"
 #include "iproto_constants.h"
 #include "watcher.h"
@@ -56,6 +61,11 @@ enum {
 	 * latency. 1 MB seems to be a well balanced choice.
 	 */
 	WAL_FALLOCATE_LEN = 1024 * 1024,
+	/**
+	 * Time to wait before retrying to create a spare WAL file
+	 * after a failure, in seconds.
+	 */
+	WAL_SPARE_RETRY_TIMEOUT = 1,
 };
 
 const char *wal_mode_STRS[WAL_MODE_MAX] = {
@@ -199,6 +209,58 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/**
+	 * A setting from instance configuration - the max time a write
+	 * may wait for other writes to share fdatasync() with them.
+	 * Zero disables group commit.
+	 */
+	double group_commit_max_delay;
+	/**
+	 * Another one - the amount of written data that makes a group
+	 * synced without waiting for the delay to expire.
+	 */
+	int64_t group_commit_max_size;
+	/**
+	 * Batches that have been written to the current WAL file but
+	 * haven't been synced yet. Used only in the fsync mode: the
+	 * batches are sent back to tx after fdatasync() is called.
+	 */
+	struct stailq sync_queue;
+	/** Number of journal entries written by sync_queue batches. */
+	int64_t sync_queue_len;
+	/** Number of bytes written by sync_queue batches. */
+	int64_t sync_queue_size;
+	/** Syncs sync_queue when the group commit delay expires. */
+	struct ev_timer sync_timer;
+	/** Moving average of fdatasync() duration, in seconds. */
+	double sync_time_avg;
+	/** Histogram of fdatasync() duration. */
+	struct latency sync_latency;
+	/** Total number of fdatasync() calls. */
+	int64_t sync_count;
+	/** Total number of journal entries synced. */
+	int64_t sync_entry_count;
+	/** Total number of bytes synced. */
+	int64_t sync_byte_count;
+	/**
+	 * A setting from instance configuration - the number of
+	 * preallocated empty files kept in the WAL directory so that
+	 * WAL rotation doesn't need to create and extend a new file.
+	 */
+	int spare_count_max;
+	/**
+	 * Spare files are named after sequence numbers. Ready spare
+	 * files have numbers [spare_first, spare_first + spare_count).
+	 */
+	int64_t spare_first;
+	/** Number of ready spare files. */
+	int spare_count;
+	/** Fiber that creates and removes spare files. */
+	struct fiber *spare_fiber;
+	/** Wakes up spare_fiber. */
+	struct fiber_cond spare_cond;
+	/** Set on shutdown to stop spare_fiber. */
+	bool spare_is_stopped;
 };
 
 struct wal_msg {
@@ -245,8 +307,12 @@ wal_write_to_disk(struct cmsg *msg);
 static void
 tx_complete_batch(struct cmsg *msg);
 
+/*
+ * The first hop has no pipe, because in the fsync mode a batch may be
+ * sent back to tx only after it's synced, see wal_msg_complete().
+ */
 static struct cmsg_hop wal_request_route[] = {
-	{wal_write_to_disk, &wal_writer_singleton.tx_prio_pipe},
+	{wal_write_to_disk, NULL},
 	{tx_complete_batch, NULL},
 };
 
@@ -437,6 +503,15 @@ tx_notify_checkpoint(struct cmsg *msg)
 	free(msg);
 }
 
+static void
+wal_sync_timer_cb(struct ev_loop *loop, struct ev_timer *timer, int events);
+
+static void
+wal_sync_queue_flush(struct wal_writer *writer);
+
+static double
+wal_group_commit_delay(struct wal_writer *writer);
+
 static int
 wal_sync_none(struct journal *journal, struct vclock *out)
 {
@@ -486,12 +561,34 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	 */
 	xdir_set_retention_period(&writer->wal_dir, wal_retention_period);
 	xlog_clear(&writer->current_wal);
-	if (wal_mode == WAL_FSYNC)
-		writer->wal_dir.open_wflags |= O_SYNC;
 
 	stailq_create(&writer->rollback);
 	writer->is_in_rollback = false;
 
+	/*
+	 * In the fsync mode, WAL files aren't opened with O_SYNC.
+	 * Instead, fdatasync() is called explicitly after writing
+	 * a group of batches, see wal_sync_queue_flush().
+	 */
+	writer->group_commit_max_delay = 0;
+	writer->group_commit_max_size = INT64_MAX;
+	stailq_create(&writer->sync_queue);
+	writer->sync_queue_len = 0;
+	writer->sync_queue_size = 0;
+	ev_timer_init(&writer->sync_timer, wal_sync_timer_cb, 0, 0);
+	writer->sync_time_avg = 0;
+	if (latency_create(&writer->sync_latency) != 0)
+		panic("failed to allocate WAL sync latency histogram");
+	writer->sync_count = 0;
+	writer->sync_entry_count = 0;
+	writer->sync_byte_count = 0;
+
+	writer->spare_count_max = 0;
+	writer->spare_first = 0;
+	writer->spare_count = 0;
+	writer->spare_fiber = NULL;
+	writer->spare_is_stopped = false;
+
 	writer->checkpoint_wal_size = 0;
 	writer->checkpoint_threshold = INT64_MAX;
 	writer->checkpoint_triggered = false;
@@ -513,6 +610,7 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 static void
 wal_writer_destroy(struct wal_writer *writer)
 {
+	latency_destroy(&writer->sync_latency);
 	xdir_destroy(&writer->wal_dir);
 }
 
@@ -693,6 +791,7 @@ wal_sync_f(struct cbus_call_msg *data)
 		diag_set(ClientError, ER_CASCADE_ROLLBACK);
 		return -1;
 	}
+	wal_sync_queue_flush(writer);
 	vclock_copy(&msg->vclock, &writer->vclock);
 	return 0;
 }
@@ -768,6 +867,7 @@ wal_begin_checkpoint_f(struct cbus_call_msg *data)
 		diag_set(ClientError, ER_CASCADE_ROLLBACK);
 		return -1;
 	}
+	wal_sync_queue_flush(writer);
 	/*
 	 * Avoid closing the current WAL if it has no rows (empty).
 	 */
@@ -951,6 +1051,181 @@ wal_get_retention_vclock(struct vclock *vclock)
 	vclock_copy(vclock, &msg.vclock);
 }
 
+/** Group commit configuration message. */
+struct wal_set_group_commit_msg {
+	/* The state of a synchronous cross-thread call. */
+	struct cbus_call_msg base;
+	/* New group_commit_max_delay value. */
+	double max_delay;
+	/* New group_commit_max_size value. */
+	int64_t max_size;
+};
+
+static int
+wal_set_group_commit_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_set_group_commit_msg *msg;
+	msg = (struct wal_set_group_commit_msg *)data;
+	writer->group_commit_max_delay = msg->max_delay;
+	writer->group_commit_max_size = msg->max_size;
+	/* Don't keep the current group waiting for the old delay. */
+	wal_sync_queue_flush(writer);
+	return 0;
+}
+
+/** Send the group commit settings stored in tx to the WAL thread. */
+static void
+wal_set_group_commit(double max_delay, int64_t max_size)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	struct wal_set_group_commit_msg msg;
+	msg.max_delay = max_delay;
+	msg.max_size = max_size;
+	cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+		  &msg.base, wal_set_group_commit_f);
+}
+
+/** Group commit settings as seen by tx. */
+static double wal_group_commit_max_delay;
+static int64_t wal_group_commit_max_size = INT64_MAX;
+
+void
+wal_set_group_commit_max_delay(double delay)
+{
+	wal_group_commit_max_delay = delay;
+	wal_set_group_commit(wal_group_commit_max_delay,
+			     wal_group_commit_max_size);
+}
+
+void
+wal_set_group_commit_max_size(int64_t size)
+{
+	wal_group_commit_max_size = size;
+	wal_set_group_commit(wal_group_commit_max_delay,
+			     wal_group_commit_max_size);
+}
+
+/** Spare files configuration message. */
+struct wal_set_spare_files_msg {
+	/* The state of a synchronous cross-thread call. */
+	struct cbus_call_msg base;
+	/* New spare_count_max value. */
+	int count;
+};
+
+static int
+wal_set_spare_files_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_set_spare_files_msg *msg;
+	msg = (struct wal_set_spare_files_msg *)data;
+	writer->spare_count_max = msg->count;
+	fiber_cond_signal(&writer->spare_cond);
+	return 0;
+}
+
+void
+wal_set_spare_files(int count)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	struct wal_set_spare_files_msg msg;
+	msg.count = count;
+	cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+		  &msg.base, wal_set_spare_files_f);
+}
+
+/** WAL sync statistics retrieval message. */
+struct wal_stat_msg {
+	/* The state of a synchronous cross-thread call. */
+	struct cbus_call_msg base;
+	int64_t sync_count;
+	int64_t sync_entry_count;
+	int64_t sync_byte_count;
+	double sync_time_avg;
+	double sync_time_p50;
+	double sync_time_p90;
+	double sync_time_p99;
+	double group_commit_delay;
+};
+
+static int
+wal_stat_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_stat_msg *msg = (struct wal_stat_msg *)data;
+	msg->sync_count = writer->sync_count;
+	msg->sync_entry_count = writer->sync_entry_count;
+	msg->sync_byte_count = writer->sync_byte_count;
+	msg->sync_time_avg = writer->sync_time_avg;
+	msg->sync_time_p50 = latency_get(&writer->sync_latency, 50);
+	msg->sync_time_p90 = latency_get(&writer->sync_latency, 90);
+	msg->sync_time_p99 = latency_get(&writer->sync_latency, 99);
+	msg->group_commit_delay = wal_group_commit_delay(writer);
+	return 0;
+}
+
+void
+wal_stat(struct info_handler *h)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_stat_msg msg;
+	memset(&msg, 0, sizeof(msg));
+	if (writer->wal_mode != WAL_NONE) {
+		cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+			  &msg.base, wal_stat_f);
+	}
+	info_begin(h);
+	info_append_int(h, "syncs", msg.sync_count);
+	info_append_int(h, "entries", msg.sync_entry_count);
+	info_append_int(h, "bytes", msg.sync_byte_count);
+	info_table_begin(h, "batch");
+	info_append_double(h, "entries", msg.sync_count == 0 ? 0 :
+			   (double)msg.sync_entry_count / msg.sync_count);
+	info_append_double(h, "bytes", msg.sync_count == 0 ? 0 :
+			   (double)msg.sync_byte_count / msg.sync_count);
+	info_table_end(h); /* batch */
+	info_table_begin(h, "sync_time");
+	info_append_double(h, "avg", msg.sync_time_avg);
+	info_append_double(h, "p50", msg.sync_time_p50);
+	info_append_double(h, "p90", msg.sync_time_p90);
+	info_append_double(h, "p99", msg.sync_time_p99);
+	info_table_end(h); /* sync_time */
+	info_append_double(h, "group_commit_delay", msg.group_commit_delay);
+	info_end(h);
+}
+
+static int
+wal_reset_stat_f(struct cbus_call_msg *data)
+{
+	(void)data;
+	struct wal_writer *writer = &wal_writer_singleton;
+	writer->sync_count = 0;
+	writer->sync_entry_count = 0;
+	writer->sync_byte_count = 0;
+	latency_reset(&writer->sync_latency);
+	/*
+	 * Keep the moving average of fdatasync() time, because it's
+	 * used for computing the group commit delay.
+	 */
+	return 0;
+}
+
+void
+wal_reset_stat(void)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	struct cbus_call_msg msg;
+	cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe, &msg,
+		  wal_reset_stat_f);
+}
+
 struct wal_gc_msg
 {
 	struct cbus_call_msg base;
@@ -1000,6 +1275,94 @@ wal_collect_garbage(const struct vclock *vclock)
 static void
 wal_notify_watchers(struct wal_writer *writer, unsigned events);
 
+/**
+ * Format the name of the spare WAL file with the given sequence
+ * number. The name has the '.inprogress' suffix so spare files
+ * left after shutdown are removed on startup, see wal_enable().
+ */
+static void
+wal_spare_path(struct wal_writer *writer, int64_t seq, char *buf)
+{
+	snprintf(buf, PATH_MAX, "%s/spare.%lld%s.inprogress",
+		 writer->wal_dir.dirname, (long long)seq,
+		 writer->wal_dir.filename_ext);
+}
+
+static int
+wal_create_spare_f(va_list ap)
+{
+	const char *path = va_arg(ap, const char *);
+	size_t len = va_arg(ap, size_t);
+	return xlog_create_spare(path, len);
+}
+
+/**
+ * Maintain writer->spare_count_max spare WAL files. The files are
+ * created in a coio thread so as not to stall writes.
+ */
+static int
+wal_spare_f(va_list ap)
+{
+	(void)ap;
+	struct wal_writer *writer = &wal_writer_singleton;
+	char path[PATH_MAX];
+	while (!writer->spare_is_stopped) {
+		if (writer->spare_count < writer->spare_count_max) {
+			/*
+			 * Spare files may be taken while we're creating
+			 * a new one, but they're taken from the head
+			 * while we append to the tail.
+			 */
+			wal_spare_path(writer, writer->spare_first +
+				       writer->spare_count, path);
+			if (coio_call(wal_create_spare_f, path,
+				      (size_t)writer->wal_max_size) != 0) {
+				diag_log();
+				fiber_cond_wait_timeout(
+					&writer->spare_cond,
+					WAL_SPARE_RETRY_TIMEOUT);
+				continue;
+			}
+			writer->spare_count++;
+		} else if (writer->spare_count > writer->spare_count_max) {
+			writer->spare_count--;
+			wal_spare_path(writer, writer->spare_first +
+				       writer->spare_count, path);
+			if (coio_unlink(path) != 0)
+				say_syserror("failed to remove %s", path);
+		} else {
+			fiber_cond_wait(&writer->spare_cond);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Create a new WAL file. Take over a spare file if there's one,
+ * so that we don't need to create the file and allocate disk
+ * space for it.
+ */
+static int
+wal_create_xlog(struct wal_writer *writer)
+{
+	if (writer->spare_count > 0) {
+		char path[PATH_MAX];
+		wal_spare_path(writer, writer->spare_first, path);
+		writer->spare_first++;
+		writer->spare_count--;
+		fiber_cond_signal(&writer->spare_cond);
+		if (xdir_create_materialized_xlog_from_spare(
+				&writer->wal_dir, &writer->current_wal,
+				&writer->vclock, path) == 0)
+			return 0;
+		/* Fall back on creating a new file. */
+		diag_log();
+	}
+	return xdir_create_materialized_xlog(&writer->wal_dir,
+					     &writer->current_wal,
+					     &writer->vclock);
+}
+
 /**
  * If there is no current WAL, try to open it, and close the
  * previous WAL. We close the previous WAL only after opening
@@ -1023,6 +1386,8 @@ wal_opt_rotate(struct wal_writer *writer)
 	 */
 	if (xlog_is_open(&writer->current_wal) &&
 	    writer->current_wal.offset >= writer->wal_max_size) {
+		/* Sync the pending group before closing the file. */
+		wal_sync_queue_flush(writer);
 		xdir_set_retention_vclock(
 			&writer->wal_dir, &writer->current_wal.meta.vclock);
 		wal_xlog_close(&writer->current_wal);
@@ -1031,9 +1396,7 @@ wal_opt_rotate(struct wal_writer *writer)
 	if (xlog_is_open(&writer->current_wal))
 		return 0;
 
-	if (xdir_create_materialized_xlog(&writer->wal_dir,
-					  &writer->current_wal,
-					  &writer->vclock) != 0)
+	if (wal_create_xlog(writer) != 0)
 		return -1;
 	/*
 	 * Keep track of the new WAL vclock. Required for garbage
@@ -1045,12 +1408,37 @@ wal_opt_rotate(struct wal_writer *writer)
 	return 0;
 }
 
+/**
+ * Remove the oldest spare WAL file to free disk space for writes.
+ * spare_fiber isn't woken up so that it doesn't compete with writes
+ * for the freed space right away. Returns false if there are no
+ * spare files.
+ */
+static bool
+wal_remove_spare(struct wal_writer *writer)
+{
+	if (writer->spare_count == 0)
+		return false;
+	/*
+	 * Take the file from the head, like wal_create_xlog() does,
+	 * because spare_fiber may be appending a file to the tail.
+	 */
+	char path[PATH_MAX];
+	wal_spare_path(writer, writer->spare_first, path);
+	writer->spare_first++;
+	writer->spare_count--;
+	if (unlink(path) != 0)
+		say_syserror("failed to remove %s", path);
+	return true;
+}
+
 /**
  * Make sure there's enough disk space to append @len bytes
  * of data to the current WAL.
  *
- * If fallocate() fails with ENOSPC, delete old WAL files
- * that are not needed for recovery and retry.
+ * If fallocate() fails with ENOSPC, delete spare WAL files,
+ * then old WAL files that are not needed for recovery, and
+ * retry.
  */
 static int
 wal_fallocate(struct wal_writer *writer, size_t len)
@@ -1094,6 +1482,10 @@ wal_fallocate(struct wal_writer *writer, size_t len)
 	}
 	if (errno != ENOSPC)
 		goto error;
+	if (wal_remove_spare(writer)) {
+		say_warn("ran out of disk space, deleted a spare WAL file");
+		goto retry;
+	}
 	if (!xdir_has_garbage(&writer->wal_dir, gc_lsn))
 		goto error;
 
@@ -1209,6 +1601,107 @@ wal_assign_lsn(struct vclock *vclock_diff, struct vclock *base,
 	(*end)->is_commit = true;
 }
 
+/** Send a processed batch back to tx. */
+static void
+wal_msg_complete(struct wal_writer *writer, struct wal_msg *batch)
+{
+	batch->base.hop++;
+	cpipe_push(&writer->tx_prio_pipe, &batch->base);
+}
+
+/**
+ * Returns the time a group of writes may wait for fdatasync().
+ *
+ * There's no point in waiting longer than fdatasync() takes: a write
+ * that arrives later would be better off in the next group. So the
+ * delay adapts to the observed disk latency and is limited by the
+ * configured value from above.
+ */
+static double
+wal_group_commit_delay(struct wal_writer *writer)
+{
+	return MIN(writer->group_commit_max_delay, writer->sync_time_avg);
+}
+
+/**
+ * Sync the current WAL file and send all batches written to it since
+ * the last sync back to tx.
+ */
+static void
+wal_sync_queue_flush(struct wal_writer *writer)
+{
+	ev_timer_stop(loop(), &writer->sync_timer);
+	if (stailq_empty(&writer->sync_queue))
+		return;
+	if (writer->sync_queue_size > 0) {
+		assert(xlog_is_open(&writer->current_wal));
+		double start = clock_monotonic();
+		/*
+		 * The batches have already been applied to the WAL
+		 * vclock and may have been sent to replicas. If we fail
+		 * to sync them, the state of the file is unknown and
+		 * retrying fdatasync() may report success for lost data.
+		 */
+		if (fdatasync(writer->current_wal.fd) != 0) {
+			panic_syserror("failed to sync WAL file '%s'",
+				       writer->current_wal.filename);
+		}
+		double time = clock_monotonic() - start;
+		/* Exponential moving average with 1/8 weight. */
+		if (writer->sync_time_avg == 0)
+			writer->sync_time_avg = time;
+		else
+			writer->sync_time_avg += (time -
+						  writer->sync_time_avg) / 8;
+		latency_collect(&writer->sync_latency, time);
+		writer->sync_count++;
+		writer->sync_entry_count += writer->sync_queue_len;
+		writer->sync_byte_count += writer->sync_queue_size;
+	}
+	wal_notify_watchers(writer, WAL_EVENT_WRITE);
+	struct wal_msg *batch, *tmp;
+	stailq_foreach_entry_safe(batch, tmp, &writer->sync_queue, base.fifo)
+		wal_msg_complete(writer, batch);
+	stailq_create(&writer->sync_queue);
+	writer->sync_queue_len = 0;
+	writer->sync_queue_size = 0;
+}
+
+static void
+wal_sync_timer_cb(struct ev_loop *loop, struct ev_timer *timer, int events)
+{
+	(void)loop;
+	(void)timer;
+	(void)events;
+	wal_sync_queue_flush(&wal_writer_singleton);
+}
+
+/**
+ * Add a written batch to the group of batches waiting for fdatasync().
+ * The group is synced right away if it's large enough, if group commit
+ * is disabled, or if the batch failed, because a rollback must not be
+ * delayed. Otherwise, the group is synced when the delay expires.
+ */
+static void
+wal_sync_queue_add(struct wal_writer *writer, struct wal_msg *batch,
+		   int64_t len, int64_t size)
+{
+	bool was_empty = stailq_empty(&writer->sync_queue);
+	stailq_add_tail_entry(&writer->sync_queue, batch, base.fifo);
+	writer->sync_queue_len += len;
+	writer->sync_queue_size += size;
+	double delay = wal_group_commit_delay(writer);
+	if (delay == 0 || !stailq_empty(&batch->rollback) ||
+	    writer->sync_queue_size >= writer->group_commit_max_size) {
+		wal_sync_queue_flush(writer);
+		return;
+	}
+	if (was_empty) {
+		ev_timer_set(&writer->sync_timer, delay, 0);
+		ev_timer_start(loop(), &writer->sync_timer);
+	}
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg)
 {
@@ -1218,6 +1711,9 @@ wal_write_to_disk(struct cmsg *msg)
 	struct stailq_entry *last_committed = NULL;
 	struct journal_entry *entry;
 	struct error *error;
+	/* Number of entries and bytes written by this batch. */
+	int64_t written_len = 0;
+	int64_t written_size = 0;
 	if (stailq_empty(&wal_msg->commit))
 		panic("Attempted to write an empty batch to WAL");
 
@@ -1291,7 +1787,9 @@ wal_write_to_disk(struct cmsg *msg)
 			err_code = JOURNAL_ENTRY_ERR_IO;
 			goto done;
 		}
+		written_len++;
 		if (rc > 0) {
+			written_size += rc;
 			writer->checkpoint_wal_size += rc;
 			last_committed = &entry->fifo;
 			vclock_merge(&writer->vclock, &vclock_diff);
@@ -1303,6 +1801,7 @@ wal_write_to_disk(struct cmsg *msg)
 		err_code = JOURNAL_ENTRY_ERR_IO;
 		goto done;
 	}
+	written_size += rc;
 	writer->checkpoint_wal_size += rc;
 	last_committed = stailq_last(&wal_msg->commit);
 	vclock_merge(&writer->vclock, &vclock_diff);
@@ -1363,7 +1862,12 @@ wal_write_to_disk(struct cmsg *msg)
 	} else {
 		assert(err_code == JOURNAL_ENTRY_ERR_UNKNOWN);
 	}
-	wal_notify_watchers(writer, WAL_EVENT_WRITE);
+	if (writer->wal_mode == WAL_FSYNC) {
+		wal_sync_queue_add(writer, wal_msg, written_len, written_size);
+	} else {
+		wal_notify_watchers(writer, WAL_EVENT_WRITE);
+		wal_msg_complete(writer, wal_msg);
+	}
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
 }
 
@@ -1386,8 +1890,27 @@ wal_writer_f(va_list ap)
 	 */
 	cpipe_create(&writer->tx_prio_pipe, "tx_prio");
 
+	fiber_cond_create(&writer->spare_cond);
+	if (writer->wal_mode != WAL_NONE) {
+		writer->spare_fiber = fiber_new_system("wal_spare",
+						       wal_spare_f);
+		if (writer->spare_fiber == NULL)
+			panic("failed to allocate WAL spare file fiber");
+		fiber_set_joinable(writer->spare_fiber, true);
+		fiber_start(writer->spare_fiber);
+	}
+
 	cbus_loop(&endpoint);
 
+	if (writer->spare_fiber != NULL) {
+		writer->spare_is_stopped = true;
+		fiber_cond_signal(&writer->spare_cond);
+		fiber_join(writer->spare_fiber);
+	}
+
+	/* Don't leave written batches unsynced. */
+	wal_sync_queue_flush(writer);
+
 	/*
 	 * Create a new empty WAL on shutdown so that we don't
 	 * have to rescan the last WAL to find the instance vclock.
@@ -1413,6 +1936,7 @@ wal_writer_f(va_list ap)
 
 	cpipe_destroy(&writer->tx_prio_pipe);
 	cbus_endpoint_destroy(&endpoint, cbus_process);
+	fiber_cond_destroy(&writer->spare_cond);
 	return 0;
 }
 
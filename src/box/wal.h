@@ -38,6 +38,7 @@
 #include "vclock/vclock.h"
 
 struct fiber;
+struct info_handler;
 struct wal_writer;
 struct tt_uuid;
 
@@ -223,6 +224,37 @@ wal_set_queue_max_size(int64_t size);
 void
 wal_set_retention_period(double period);
 
+/**
+ * Set the max time a write may wait in the fsync mode so that it's
+ * synced to disk together with following writes. The actual delay
+ * never exceeds the average fdatasync() time. Zero disables group
+ * commit.
+ */
+void
+wal_set_group_commit_max_delay(double delay);
+
+/**
+ * Set the size of written data that makes a group of writes synced
+ * without waiting for the group commit delay to expire.
+ */
+void
+wal_set_group_commit_max_size(int64_t size);
+
+/**
+ * Set the number of preallocated spare files kept in the WAL
+ * directory to speed up WAL rotation.
+ */
+void
+wal_set_spare_files(int count);
+
+/** Append WAL sync statistics (box.stat.wal()) to an info handler. */
+void
+wal_stat(struct info_handler *h);
+
+/** Reset WAL sync statistics. */
+void
+wal_reset_stat(void);
+
 /**
  * Return vclock (unless @vclock is NULL) of the oldest file,
  * which is protected from garbage collection.
@@ -31,6 +31,7 @@
 #include "xlog.h"
 #include <dirent.h>
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <ctype.h>
 
 #include "fiber.h"
@@ -118,6 +119,7 @@ enum {
 #define VERSION_KEY "Version"
 #define PREV_VCLOCK_KEY "PrevVClock"
 
+static const char v14[] = "0.14";
 static const char v13[] = "0.13";
 static const char v12[] = "0.12";
 
@@ -137,6 +139,7 @@ xlog_meta_create(struct xlog_meta *meta, const char *filetype,
 		vclock_copy(&meta->prev_vclock, prev_vclock);
 	else
 		vclock_clear(&meta->prev_vclock);
+	meta->is_delta = false;
 }
 
 /**
@@ -160,7 +163,7 @@ xlog_meta_format(const struct xlog_meta *meta, char *buf, int size)
 		"%s\n"
 		VERSION_KEY ": %s\n"
 		INSTANCE_UUID_KEY ": %s\n",
-		meta->filetype, v13, PACKAGE_VERSION,
+		meta->filetype, meta->is_delta ? v14 : v13, PACKAGE_VERSION,
 		tt_uuid_str(&meta->instance_uuid));
 	if (vclock_is_set(&meta->vclock)) {
 		SNPRINT(total, snprintf, buf, size, VCLOCK_KEY ": %s\n",
@@ -239,7 +242,7 @@ xlog_meta_parse(struct xlog_meta *meta, const char **data,
 	assert(pos <= end);
 
 	/*
-	 * Parse version string, i.e. "0.12" or "0.13"
+	 * Parse version string, i.e. "0.12", "0.13" or "0.14"
 	 */
 	char version[10];
 	eol = (const char *)memchr(pos, '\n', end - pos);
@@ -252,7 +255,8 @@ xlog_meta_parse(struct xlog_meta *meta, const char **data,
 	pos = eol + 1;
 	assert(pos <= end);
 	if (strncmp(version, v12, sizeof(v12)) != 0 &&
-	    strncmp(version, v13, sizeof(v13)) != 0) {
+	    strncmp(version, v13, sizeof(v13)) != 0 &&
+	    strncmp(version, v14, sizeof(v14)) != 0) {
 		diag_set(XlogError,
 			  "unsupported file format version %s",
 			  version);
@@ -261,6 +265,7 @@ xlog_meta_parse(struct xlog_meta *meta, const char **data,
 
 	vclock_clear(&meta->vclock);
 	vclock_clear(&meta->prev_vclock);
+	meta->is_delta = strncmp(version, v14, sizeof(v14)) == 0;
 
 	/*
 	 * Parse "key: value" pairs
@@ -321,6 +326,10 @@ xlog_meta_parse(struct xlog_meta *meta, const char **data,
 				 (int)(key_end - key), key);
 		}
 	}
+	if (meta->is_delta && !vclock_is_set(&meta->prev_vclock)) {
+		diag_set(XlogError, "no previous vclock in a delta file");
+		return -1;
+	}
 	*data = end + 1; /* skip the last trailing \n of \n\n sequence */
 	return 0;
 }
@@ -827,12 +836,19 @@ xlog_free(struct xlog *xlog)
 	xlog->zctx = NULL;
 }
 
-int
-xlog_create(struct xlog *xlog, const char *name, int flags,
-	    const struct xlog_meta *meta, const struct xlog_opts *opts)
+/**
+ * Implementation of xlog_create() and xdir_create_xlog_impl().
+ * If @a spare is NULL, a new file is created, otherwise the given
+ * spare file is taken over.
+ */
+static int
+xlog_create_impl(struct xlog *xlog, const char *name, int flags,
+		 const struct xlog_meta *meta, const struct xlog_opts *opts,
+		 const char *spare)
 {
 	char meta_buf[XLOG_META_LEN_MAX];
 	int meta_len;
+	size_t spare_len = 0;
 
 	/*
 	 * Check whether a file with this name already exists.
@@ -858,7 +874,44 @@ xlog_create(struct xlog *xlog, const char *name, int flags,
 		goto err;
 	}
 
-	flags |= O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC;
+	flags |= O_RDWR | O_CLOEXEC;
+	if (spare != NULL) {
+		/*
+		 * The spare file is empty, so it can be treated
+		 * the same way as a newly created one. Unlike rename(),
+		 * link() fails if the target file exists, just like
+		 * open() with O_EXCL below.
+		 */
+		if (link(spare, xlog->filename) != 0) {
+			diag_set(SystemError, "failed to link '%s' file",
+				 spare);
+			goto err_open;
+		}
+		if (unlink(spare) != 0) {
+			diag_set(SystemError, "failed to unlink '%s' file",
+				 spare);
+			xlog_remove_file(xlog->filename, 0);
+			goto err_open;
+		}
+		xlog->fd = open(xlog->filename, flags);
+		if (xlog->fd < 0) {
+			diag_set(SystemError, "failed to open file '%s'",
+				 xlog->filename);
+			xlog_remove_file(xlog->filename, 0);
+			goto err_open;
+		}
+		/*
+		 * Find out how much disk space is preallocated for
+		 * the file rather than trust the size it was created
+		 * with: the file size is zero, so blocks beyond it
+		 * can only have been allocated by xlog_create_spare().
+		 */
+		struct stat st;
+		if (fstat(xlog->fd, &st) == 0)
+			spare_len = (size_t)st.st_blocks * 512;
+		goto write_meta;
+	}
+	flags |= O_CREAT | O_EXCL;
 
 	/*
 	 * Open the <lsn>.<suffix>.inprogress file.
@@ -876,7 +929,7 @@ xlog_create(struct xlog *xlog, const char *name, int flags,
 			 xlog->filename);
 		goto err_open;
 	}
-
+write_meta:
 	/* Format metadata */
 	meta_len = xlog_meta_format(&xlog->meta, meta_buf, sizeof(meta_buf));
 	if (meta_len < 0)
@@ -892,6 +945,9 @@ xlog_create(struct xlog *xlog, const char *name, int flags,
 	}
 
 	xlog->offset = meta_len; /* first log starts after meta */
+	/* Disk space preallocated for the spare file is ours now. */
+	if (spare_len > (size_t)meta_len)
+		xlog->allocated = spare_len - meta_len;
 	return 0;
 err_write:
 	close(xlog->fd);
@@ -903,6 +959,52 @@ xlog_create(struct xlog *xlog, const char *name, int flags,
 	return -1;
 }
 
+int
+xlog_create(struct xlog *xlog, const char *name, int flags,
+	    const struct xlog_meta *meta, const struct xlog_opts *opts)
+{
+	return xlog_create_impl(xlog, name, flags, meta, opts, NULL);
+}
+
+int
+xlog_create_spare(const char *name, size_t len)
+{
+	int fd = open(name, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to create file '%s'", name);
+		return -1;
+	}
+#ifdef HAVE_FALLOCATE
+	/*
+	 * Keep the file size zero so that the file can be used as
+	 * a new xlog, see the comment in xlog_fallocate().
+	 */
+	if (fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, len) != 0) {
+		if (errno != ENOSYS && errno != EOPNOTSUPP) {
+			diag_set(SystemError, "%s: can't allocate disk space",
+				 name);
+			goto err;
+		}
+	}
+#else
+	(void)len;
+#endif /* HAVE_FALLOCATE */
+	/*
+	 * Flush the allocation metadata now so that it doesn't add
+	 * up to the first sync of the file once it's taken over.
+	 */
+	if (fsync(fd) != 0) {
+		diag_set(SystemError, "failed to sync file '%s'", name);
+		goto err;
+	}
+	close(fd);
+	return 0;
+err:
+	close(fd);
+	unlink(name);
+	return -1;
+}
+
 int
 xlog_open(struct xlog *xlog, const char *name, const struct xlog_opts *opts)
 {
@@ -990,12 +1092,15 @@ xdir_touch_xlog(struct xdir *dir, const struct vclock *vclock)
 }
 
 /**
+ * Implementation of xdir_create_xlog() and
+ * xdir_create_materialized_xlog_from_spare().
+ *
  * In case of error, writes a message to the error log
  * and sets errno.
  */
-int
-xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
-		 const struct vclock *vclock)
+static int
+xdir_create_xlog_impl(struct xdir *dir, struct xlog *xlog,
+		      const struct vclock *vclock, const char *spare)
 {
 	int64_t signature = vclock_sum(vclock);
 	assert(signature >= 0);
@@ -1008,9 +1113,21 @@ xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 	struct xlog_meta meta;
 	xlog_meta_create(&meta, dir->filetype, dir->instance_uuid,
 			 vclock, prev_vclock);
+	if (dir->is_delta) {
+		assert(prev_vclock != NULL);
+		meta.is_delta = true;
+	}
 
 	const char *filename = xdir_format_filename(dir, signature);
-	return xlog_create(xlog, filename, dir->open_wflags, &meta, &dir->opts);
+	return xlog_create_impl(xlog, filename, dir->open_wflags, &meta,
+				&dir->opts, spare);
+}
+
+int
+xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
+		 const struct vclock *vclock)
+{
+	return xdir_create_xlog_impl(dir, xlog, vclock, NULL);
 }
 
 int
@@ -1026,6 +1143,20 @@ xdir_create_materialized_xlog(struct xdir *dir, struct xlog *xlog,
 	return 0;
 }
 
+int
+xdir_create_materialized_xlog_from_spare(struct xdir *dir, struct xlog *xlog,
+					 const struct vclock *vclock,
+					 const char *spare)
+{
+	if (xdir_create_xlog_impl(dir, xlog, vclock, spare) != 0)
+		return -1;
+	if (xlog_materialize(xlog) != 0) {
+		xlog_discard(xlog);
+		return -1;
+	}
+	return 0;
+}
+
 ssize_t
 xlog_fallocate(struct xlog *log, size_t len)
 {
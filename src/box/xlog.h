@@ -119,6 +119,12 @@ struct xdir {
 	 * check for gaps on recovery.
 	 */
 	bool store_prev_vclock;
+	/**
+	 * Files created in the directory contain only changes
+	 * made since the previous file, see xlog_meta::is_delta.
+	 * Requires store_prev_vclock.
+	 */
+	bool is_delta;
 	/**
 	 * Additional flags to apply at open(2) to write.
 	 */
@@ -360,6 +366,14 @@ struct xlog_meta {
 	 * directory for missing WALs.
 	 */
 	struct vclock prev_vclock;
+	/**
+	 * Set if the file contains only changes made since the
+	 * file referred to by prev_vclock, like an incremental
+	 * snapshot, and so is useless without it. Such files are
+	 * written in format version 0.14 so that older versions,
+	 * which would load them as complete, refuse to open them.
+	 */
+	bool is_delta;
 };
 
 /**
@@ -483,6 +497,16 @@ int
 xdir_create_materialized_xlog(struct xdir *dir, struct xlog *xlog,
 			      const struct vclock *vclock);
 
+/**
+ * Same as xdir_create_materialized_xlog(), but instead of creating
+ * a new file, takes over the spare file @a spare created with
+ * xlog_create_spare(). Fails if the target file exists.
+ */
+int
+xdir_create_materialized_xlog_from_spare(struct xdir *dir, struct xlog *xlog,
+					 const struct vclock *vclock,
+					 const char *spare);
+
 /**
  * Create new xlog writer based on fd.
  * @param fd            file descriptor
@@ -529,6 +553,18 @@ xlog_is_open(struct xlog *l)
 	return l->fd != -1;
 }
 
+/**
+ * Create an empty file @a name and preallocate @a len bytes of disk
+ * space for it, so that it can be used as a new xlog file later, see
+ * xdir_create_materialized_xlog_from_spare(). Blocking.
+ *
+ * No disk space is preallocated if the underlying OS does not
+ * support fallocate. On error, removes the file, returns -1 and
+ * sets diag.
+ */
+int
+xlog_create_spare(const char *name, size_t len);
+
 /**
  * Allocate @size bytes of disk space at the end of the given
  * xlog file.
@@ -2024,14 +2024,23 @@ void *cord_thread_func(void *p)
 	return res;
 }
 
-int
-cord_start(struct cord *cord, const char *name, void *(*f)(void *), void *arg)
+/** Flags used to create a cord event loop by default. */
+static const unsigned int cord_ev_flags_default =
+	EVFLAG_AUTO | EVFLAG_ALLOCFD;
+
+/**
+ * Starts a cord with the given thread function and creates its event loop
+ * with the given libev flags.
+ */
+static int
+cord_start_ev(struct cord *cord, const char *name, unsigned int ev_flags,
+	      void *(*f)(void *), void *arg)
 {
 	int res = -1;
 	struct cord_thread_arg ct_arg = { cord, name, f, arg, false,
 		PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
 	tt_pthread_mutex_lock(&ct_arg.start_mutex);
-	cord->loop = ev_loop_new(EVFLAG_AUTO | EVFLAG_ALLOCFD);
+	cord->loop = ev_loop_new(ev_flags);
 	if (cord->loop == NULL) {
 		diag_set(OutOfMemory, 0, "ev_loop_new", "ev_loop");
 		goto end;
@@ -2058,6 +2067,12 @@ cord_start(struct cord *cord, const char *name, void *(*f)(void *), void *arg)
 	return res;
 }
 
+int
+cord_start(struct cord *cord, const char *name, void *(*f)(void *), void *arg)
+{
+	return cord_start_ev(cord, name, cord_ev_flags_default, f, arg);
+}
+
 int
 cord_join(struct cord *cord)
 {
@@ -2227,7 +2242,8 @@ cord_costart_thread_func(void *arg)
 }
 
 int
-cord_costart(struct cord *cord, const char *name, fiber_func f, void *arg)
+cord_costart_ev(struct cord *cord, const char *name, unsigned int ev_flags,
+		fiber_func f, void *arg)
 {
 	/** Must be allocated to avoid races. */
 	struct costart_ctx *ctx = (struct costart_ctx *) malloc(sizeof(*ctx));
@@ -2238,13 +2254,20 @@ cord_costart(struct cord *cord, const char *name, fiber_func f, void *arg)
 	}
 	ctx->run = f;
 	ctx->arg = arg;
-	if (cord_start(cord, name, cord_costart_thread_func, ctx) == -1) {
+	if (cord_start_ev(cord, name, ev_flags,
+			  cord_costart_thread_func, ctx) == -1) {
 		free(ctx);
 		return -1;
 	}
 	return 0;
 }
 
+int
+cord_costart(struct cord *cord, const char *name, fiber_func f, void *arg)
+{
+	return cord_costart_ev(cord, name, cord_ev_flags_default, f, arg);
+}
+
 void
 cord_set_name(const char *name)
 {
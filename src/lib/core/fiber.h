@@ -924,6 +924,14 @@ cord_start(struct cord *cord, const char *name,
 int
 cord_costart(struct cord *cord, const char *name, fiber_func f, void *arg);
 
+/**
+ * Like cord_costart(), but creates the cord event loop with the given
+ * libev flags (EVFLAG_* and EVBACKEND_*) instead of the default ones.
+ */
+int
+cord_costart_ev(struct cord *cord, const char *name, unsigned int ev_flags,
+		fiber_func f, void *arg);
+
 /**
  * Yield until \a cord has terminated. If fiber is cancelled
  * then cancel is progarated to the cord main fiber if cord is started
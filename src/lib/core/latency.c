@@ -64,8 +64,6 @@ latency_create(struct latency *latency)
 	latency->histogram = histogram_new(buckets, lengthof(buckets));
 	if (latency->histogram == NULL)
 		return -1;
-
-	histogram_collect(latency->histogram, 0);
 	return 0;
 }
 
@@ -79,7 +77,6 @@ void
 latency_reset(struct latency *latency)
 {
 	histogram_reset(latency->histogram);
-	histogram_collect(latency->histogram, 0);
 }
 
 void
@@ -92,6 +89,14 @@ latency_collect(struct latency *latency, double value)
 double
 latency_get(struct latency *latency, int pct)
 {
+	if (latency->histogram->total == 0)
+		return 0;
 	int64_t value_usec = histogram_percentile(latency->histogram, pct);
 	return (double)value_usec / USEC_PER_SEC;
 }
+
+void
+latency_merge(struct latency *dst, const struct latency *src)
+{
+	histogram_merge(dst->histogram, src->histogram);
+}
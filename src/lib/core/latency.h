@@ -31,6 +31,10 @@
  * SUCH DAMAGE.
  */
 
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
 struct histogram;
 
 /**
@@ -72,9 +76,21 @@ latency_collect(struct latency *latency, double value);
 
 /**
  * Get accumulated latency value, in seconds.
- * Returns @pct-th percentile of all observations.
+ * Returns @pct-th percentile of all observations
+ * or 0 if there are no observations.
  */
 double
 latency_get(struct latency *latency, int pct);
 
+/**
+ * Add all observations accumulated by latency counter @src
+ * to latency counter @dst.
+ */
+void
+latency_merge(struct latency *dst, const struct latency *src);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
 #endif /* TARANTOOL_LATENCY_H_INCLUDED */
@@ -14,31 +14,76 @@
 #include <stdint.h>
 #include <stdio.h>
 #include "tt_compression.h"
+#include "msgpuck.h"
 #include <trivia/util.h>
 
 #if defined(__cplusplus)
 extern "C" {
 #endif
 
+/*
+ * A compressed field is stored as the MP_COMPRESSION extension with
+ * the following payload:
+ *
+ *   +-----------+--------------------+-----------------+
+ *   | type: u8  | raw size: MP_UINT  | compressed data |
+ *   +-----------+--------------------+-----------------+
+ *
+ * where type is enum compression_type and raw size is the size of
+ * the original MsgPack field.
+ */
+
+/**
+ * Decode the header of the MP_COMPRESSION extension payload @a data
+ * of length @a len. On success returns 0, sets @a type and
+ * @a raw_size, and advances @a data to the compressed data.
+ * Returns -1 if the payload is malformed.
+ */
+static inline int
+mp_decode_compression_header(const char **data, uint32_t len,
+			     enum compression_type *type, uint64_t *raw_size)
+{
+	const char *end = *data + len;
+	const char *p = *data;
+	if (len < 2 || (uint8_t)*p == COMPRESSION_TYPE_NONE ||
+	    (uint8_t)*p >= compression_type_MAX)
+		return -1;
+	*type = (enum compression_type)(uint8_t)*p++;
+	if (mp_typeof(*p) != MP_UINT || mp_check_uint(p, end) > 0)
+		return -1;
+	*raw_size = mp_decode_uint(&p);
+	*data = p;
+	return 0;
+}
+
 static inline int
 mp_snprint_compression(char *buf, int size, const char **data, uint32_t len)
 {
-        (void)buf;
-        (void)size;
-        (void)data;
-        (void)len;
-        unreachable();
-        return -1;
+	const char *payload = *data;
+	*data += len;
+	enum compression_type type;
+	uint64_t raw_size;
+	if (mp_decode_compression_header(&payload, len, &type,
+					 &raw_size) != 0)
+		return -1;
+	return snprintf(buf, size, "compressed(%s, %llu)",
+			compression_type_strs[type],
+			(unsigned long long)raw_size);
 }
 
 static inline int
 mp_fprint_compression(FILE *file, const char **data, uint32_t len)
 {
-        (void)file;
-        (void)data;
-        (void)len;
-        unreachable();
-        return -1;
+	const char *payload = *data;
+	*data += len;
+	enum compression_type type;
+	uint64_t raw_size;
+	if (mp_decode_compression_header(&payload, len, &type,
+					 &raw_size) != 0)
+		return -1;
+	return fprintf(file, "compressed(%s, %llu)",
+		       compression_type_strs[type],
+		       (unsigned long long)raw_size);
 }
 
 #if defined(__cplusplus)
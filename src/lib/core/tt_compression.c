@@ -13,58 +13,100 @@
 #endif
 
 const char *compression_type_strs[] = {
-        "none",
+	"none",
+	"zstd",
 };
 
+enum {
+	/** Minimal zstd compression level accepted in options. */
+	COMPRESSION_ZSTD_LEVEL_MIN = 1,
+	/** Maximal zstd compression level, see ZSTD_maxCLevel(). */
+	COMPRESSION_ZSTD_LEVEL_MAX = 22,
+};
+
+/**
+ * Decode a compression type name from msgpack @a *data to @a type.
+ * Return 0 on success, -1 on failure (diag is set).
+ */
+static int
+compression_type_decode(const char **data, enum compression_type *type)
+{
+	if (mp_typeof(**data) != MP_STR) {
+		diag_set(IllegalParams, "non-string compression type");
+		return -1;
+	}
+	uint32_t str_len;
+	const char *str = mp_decode_str(data, &str_len);
+	for (int i = 0; i < compression_type_MAX; i++) {
+		if (str_len == strlen(compression_type_strs[i]) &&
+		    strncmp(str, compression_type_strs[i], str_len) == 0) {
+			*type = (enum compression_type)i;
+			return 0;
+		}
+	}
+	diag_set(IllegalParams, "unknown compression type");
+	return -1;
+}
+
 int
 compression_opts_decode(const char **data, struct compression_opts *opts,
 			struct region *region)
 {
 	assert(opts->type == COMPRESSION_TYPE_NONE);
-
-	/* Only used in EE option parser. */
 	(void)region;
-	(void)opts;
 
 	/* Parse the string version of the "compression" field. */
 	if (mp_typeof(**data) == MP_STR)
-		goto check_compression_type;
+		return compression_type_decode(data, &opts->type);
 
-	/* Parse the map version: {type = "none"}. */
+	/* Parse the map version: {type = "zstd", level = 5}. */
 	if (mp_typeof(**data) != MP_MAP) {
 		diag_set(IllegalParams,
 			 "compression is expected to be a MAP or STR");
 		return -1;
 	}
+	bool has_level = false;
 	uint32_t map_size = mp_decode_map(data);
-	if (map_size == 0)
-		return 0;
-	if (map_size != 1) {
-		diag_set(IllegalParams, "CE supports no compression options");
-		return -1;
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(**data) != MP_STR) {
+			diag_set(IllegalParams,
+				 "compression option name must be a string");
+			return -1;
+		}
+		uint32_t str_len;
+		const char *str = mp_decode_str(data, &str_len);
+		if (str_len == strlen("type") &&
+		    strncmp(str, "type", str_len) == 0) {
+			if (compression_type_decode(data, &opts->type) != 0)
+				return -1;
+		} else if (str_len == strlen("level") &&
+			   strncmp(str, "level", str_len) == 0) {
+			int64_t level;
+			if (mp_read_int64(data, &level) != 0) {
+				diag_set(IllegalParams,
+					 "compression level must be an integer");
+				return -1;
+			}
+			if (level < COMPRESSION_ZSTD_LEVEL_MIN ||
+			    level > COMPRESSION_ZSTD_LEVEL_MAX) {
+				diag_set(IllegalParams,
+					 "compression level must be from %d "
+					 "to %d", COMPRESSION_ZSTD_LEVEL_MIN,
+					 COMPRESSION_ZSTD_LEVEL_MAX);
+				return -1;
+			}
+			opts->level = level;
+			has_level = true;
+		} else {
+			diag_set(IllegalParams,
+				 "unknown compression option '%.*s'",
+				 (int)str_len, str);
+			return -1;
+		}
 	}
-	if (mp_typeof(**data) != MP_STR) {
-		diag_set(IllegalParams,
-			 "compression option name must be a string");
-		return -1;
-	}
-	uint32_t str_len;
-	const char *str = mp_decode_str(data, &str_len);
-	if (str_len != strlen("type") || strncmp(str, "type", str_len) != 0) {
+	if (has_level && opts->type != COMPRESSION_TYPE_ZSTD) {
 		diag_set(IllegalParams,
-			 "CE only supports 'type' compression table key");
-		return -1;
-	}
-	if (mp_typeof(**data) != MP_STR) {
-		diag_set(IllegalParams, "non-string compression type");
-		return -1;
-	}
-
-check_compression_type:
-	str = mp_decode_str(data, &str_len);
-	if (str_len != strlen("none") ||
-	    strncmp(str, "none", str_len) != 0) {
-		diag_set(IllegalParams, "unknown compression type");
+			 "compression level is only supported by zstd");
 		return -1;
 	}
 	return 0;
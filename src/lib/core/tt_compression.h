@@ -14,16 +14,22 @@
 #else /* !defined(ENABLE_TUPLE_COMPRESSION) */
 
 enum compression_type {
-        COMPRESSION_TYPE_NONE = 0,
-        compression_type_MAX
+	COMPRESSION_TYPE_NONE = 0,
+	COMPRESSION_TYPE_ZSTD,
+	compression_type_MAX
 };
 
 /**
- * Dummy compression options.
+ * Field compression options.
  */
 struct compression_opts {
-	/* Expected to be COMPRESSION_TYPE_NONE. */
+	/** Compression algorithm. */
 	enum compression_type type;
+	/**
+	 * Compression level, 0 means the default level of the
+	 * algorithm. Ignored if the algorithm has no levels.
+	 */
+	int level;
 };
 
 /**
@@ -32,6 +38,7 @@ struct compression_opts {
  */
 static const struct compression_opts compression_opts_default = {
 	.type = COMPRESSION_TYPE_NONE,
+	.level = 0,
 };
 
 #endif /* !defined(ENABLE_TUPLE_COMPRESSION) */
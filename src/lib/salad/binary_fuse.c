@@ -0,0 +1,244 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "binary_fuse.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trivia/util.h"
+
+enum {
+	/** Max number of seeds to try before giving up. */
+	BINARY_FUSE_MAX_ITERATIONS = 100,
+	/** Max number of slots in a segment. */
+	BINARY_FUSE_MAX_SEGMENT_LENGTH = 1 << 18,
+};
+
+void
+binary_fuse_create(struct binary_fuse *filter, uint32_t number_of_values,
+		   double false_positive_rate)
+{
+	assert(false_positive_rate > 0 && false_positive_rate < 1);
+	double bits = ceil(-log2(false_positive_rate));
+	filter->fingerprint_bits = MAX(1, MIN(bits, 32));
+	filter->seed = 0;
+	/*
+	 * Segment length and size factor were chosen empirically by
+	 * the authors of the paper, see binary_fuse.h. They are very
+	 * sensitive: for example, using round() instead of floor()
+	 * here can substantially affect the construction time.
+	 */
+	uint32_t n = number_of_values;
+	uint32_t segment_length = n == 0 ? 4 :
+		1U << (int)floor(log((double)n) / log(3.33) + 2.25);
+	segment_length = MIN(segment_length,
+			     (uint32_t)BINARY_FUSE_MAX_SEGMENT_LENGTH);
+	double size_factor = n <= 1 ? 0 :
+		fmax(1.125, 0.875 + 0.25 * log(1000000.0) / log((double)n));
+	uint32_t capacity = n <= 1 ? 0 : (uint32_t)round(n * size_factor);
+	uint32_t segment_count = DIV_ROUND_UP(capacity, segment_length);
+	filter->segment_length = segment_length;
+	filter->segment_count = segment_count <= 2 ? 1 : segment_count - 2;
+}
+
+/** Number of fingerprint slots in a filter. */
+static uint32_t
+binary_fuse_slot_count(const struct binary_fuse *filter)
+{
+	return (filter->segment_count + 2) * filter->segment_length;
+}
+
+size_t
+binary_fuse_data_size(const struct binary_fuse *filter)
+{
+	if (filter->fingerprint_bits == 0)
+		return 0;
+	uint64_t bits = (uint64_t)binary_fuse_slot_count(filter) *
+			filter->fingerprint_bits;
+	/* Padding for reading the last slot with a 64-bit load. */
+	return DIV_ROUND_UP(bits, 8) + sizeof(uint64_t) - 1;
+}
+
+double
+binary_fuse_fpr(const struct binary_fuse *filter)
+{
+	return exp2(-(double)filter->fingerprint_bits);
+}
+
+/** Write a fingerprint slot, see binary_fuse_get(). */
+static void
+binary_fuse_set(const struct binary_fuse *filter, void *filter_data,
+		uint32_t slot, uint32_t fingerprint)
+{
+	uint64_t bit = (uint64_t)slot * filter->fingerprint_bits;
+	char *p = (char *)filter_data + bit / 8;
+	uint64_t mask = (1ULL << filter->fingerprint_bits) - 1;
+	uint64_t word;
+	memcpy(&word, p, sizeof(word));
+	word &= ~(mask << (bit % 8));
+	word |= ((uint64_t)fingerprint & mask) << (bit % 8);
+	memcpy(p, &word, sizeof(word));
+}
+
+/** SplitMix64 pseudo-random number generator. */
+static uint64_t
+binary_fuse_rng(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+static int
+binary_fuse_cmp_value(const void *a, const void *b)
+{
+	uint32_t va = *(const uint32_t *)a;
+	uint32_t vb = *(const uint32_t *)b;
+	return va < vb ? -1 : va > vb;
+}
+
+/**
+ * Try to build a filter with the current seed: find an order in which
+ * slots can be assigned so that each value has a slot not used by
+ * values that follow it ("peeling"). On success, the hashes are
+ * stored in @a stack in that order and the index of the free slot of
+ * each of them is stored in @a stack_slot.
+ */
+static bool
+binary_fuse_peel(const struct binary_fuse *filter, const uint32_t *values,
+		 uint32_t count, uint64_t *stack, uint8_t *stack_slot,
+		 uint8_t *slot_count, uint64_t *slot_hash, uint32_t *queue)
+{
+	uint32_t slot_total = binary_fuse_slot_count(filter);
+	memset(slot_count, 0, slot_total * sizeof(*slot_count));
+	memset(slot_hash, 0, slot_total * sizeof(*slot_hash));
+	/*
+	 * For each slot, count the values mapped to it and compute
+	 * the xor of their hashes, so that the hash of the only value
+	 * mapped to a slot is known. The two low bits of a counter
+	 * store the xor of the indexes of the slot among the three
+	 * slots of each value, the rest is the number of values.
+	 */
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t hash = binary_fuse_hash(filter, values[i]);
+		uint32_t slots[3];
+		binary_fuse_slots(filter, hash, slots);
+		for (uint8_t j = 0; j < 3; j++) {
+			uint8_t c = slot_count[slots[j]];
+			/* Too many values mapped to the slot. */
+			if (c >> 2 == UINT8_MAX >> 2)
+				return false;
+			slot_count[slots[j]] = (c + 4) ^ j;
+			slot_hash[slots[j]] ^= hash;
+		}
+	}
+	uint32_t queue_size = 0;
+	for (uint32_t i = 0; i < slot_total; i++) {
+		if (slot_count[i] >> 2 == 1)
+			queue[queue_size++] = i;
+	}
+	uint32_t stack_size = 0;
+	while (queue_size > 0) {
+		uint32_t slot = queue[--queue_size];
+		if (slot_count[slot] >> 2 != 1)
+			continue;
+		uint64_t hash = slot_hash[slot];
+		uint8_t found = slot_count[slot] & 3;
+		stack[stack_size] = hash;
+		stack_slot[stack_size] = found;
+		stack_size++;
+		uint32_t slots[3];
+		binary_fuse_slots(filter, hash, slots);
+		for (uint8_t j = 0; j < 3; j++) {
+			if (j == found)
+				continue;
+			uint32_t other = slots[j];
+			slot_count[other] = (slot_count[other] - 4) ^ j;
+			slot_hash[other] ^= hash;
+			if (slot_count[other] >> 2 == 1)
+				queue[queue_size++] = other;
+		}
+	}
+	return stack_size == count;
+}
+
+int
+binary_fuse_build(struct binary_fuse *filter, void *filter_data,
+		  const uint32_t *values, uint32_t count)
+{
+	assert(filter->fingerprint_bits > 0);
+	uint32_t slot_total = binary_fuse_slot_count(filter);
+	uint32_t *keys = malloc((count + 1) * sizeof(*keys));
+	uint64_t *stack = malloc((count + 1) * sizeof(*stack));
+	uint8_t *stack_slot = malloc(count + 1);
+	uint8_t *slot_count = malloc(slot_total * sizeof(*slot_count));
+	uint64_t *slot_hash = malloc(slot_total * sizeof(*slot_hash));
+	/* A slot is queued at most once per value mapped to it. */
+	uint32_t *queue = malloc((3 * (uint64_t)count + slot_total) *
+				 sizeof(*queue));
+	int rc = -1;
+	if (keys == NULL || stack == NULL || stack_slot == NULL ||
+	    slot_count == NULL || slot_hash == NULL || queue == NULL) {
+		errno = ENOMEM;
+		goto out;
+	}
+	/* Duplicates would never be peeled, remove them. */
+	memcpy(keys, values, count * sizeof(*keys));
+	qsort(keys, count, sizeof(*keys), binary_fuse_cmp_value);
+	uint32_t unique = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (unique == 0 || keys[unique - 1] != keys[i])
+			keys[unique++] = keys[i];
+	}
+	count = unique;
+
+	uint64_t rng = 0x726b2b9d438b9d4dULL;
+	for (int i = 0; i < BINARY_FUSE_MAX_ITERATIONS; i++) {
+		filter->seed = binary_fuse_rng(&rng);
+		if (binary_fuse_peel(filter, keys, count, stack, stack_slot,
+				     slot_count, slot_hash, queue)) {
+			rc = 0;
+			break;
+		}
+	}
+	if (rc == 0) {
+		/*
+		 * Assign fingerprints in the reverse peeling order: the
+		 * free slot of each value isn't used by values assigned
+		 * before it.
+		 */
+		for (uint32_t i = count; i-- > 0; ) {
+			uint64_t hash = stack[i];
+			uint32_t slots[3];
+			binary_fuse_slots(filter, hash, slots);
+			uint32_t f = binary_fuse_fingerprint(filter, hash);
+			for (uint8_t j = 0; j < 3; j++) {
+				if (j != stack_slot[i])
+					f ^= binary_fuse_get(filter,
+							     filter_data,
+							     slots[j]);
+			}
+			binary_fuse_set(filter, filter_data,
+					slots[stack_slot[i]], f);
+		}
+	}
+out:
+	if (rc != 0) {
+		filter->fingerprint_bits = 0;
+		filter->seed = 0;
+	}
+	free(queue);
+	free(slot_hash);
+	free(slot_count);
+	free(stack_slot);
+	free(stack);
+	free(keys);
+	return rc;
+}
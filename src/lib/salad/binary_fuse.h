@@ -0,0 +1,203 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+/*
+ * Binary fuse filter: a static approximate set membership filter,
+ * see
+ *  Graf, T. M.; Lemire, D. (2022)
+ *  "Binary Fuse Filters: Fast and Smaller Than Xor Filters"
+ *  https://arxiv.org/abs/2201.01174
+ *
+ * A value is mapped to three fingerprint slots located in three
+ * consecutive segments of the slot array. The filter is built so
+ * that the xor of the three slots is equal to the fingerprint of
+ * every value of the set. A fingerprint of k bits gives the false
+ * positive rate of 2^-k at about 1.125 * k bits per value for
+ * large sets, while a bloom filter needs about 1.44 * k bits per
+ * value for the same rate. Unlike a bloom filter, a binary fuse
+ * filter can't be updated once built.
+ *
+ * Fingerprints are bit-packed so that any false positive rate can
+ * be used without wasting memory on byte alignment.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Binary fuse filter definition, data is stored separately: all the
+ * methods accept a pointer to the data buffer along with the filter
+ * definition. Size of the data buffer can be calculated with
+ * binary_fuse_data_size() function. The data buffer must be filled
+ * with zero bytes before the filter is built.
+ */
+struct binary_fuse {
+	/** Seed of the hash function, chosen on construction. */
+	uint64_t seed;
+	/** Number of slots in a segment, a power of two. */
+	uint32_t segment_length;
+	/**
+	 * Number of segments the first slot of a value may be
+	 * located in. The slot array has two more segments.
+	 */
+	uint32_t segment_count;
+	/**
+	 * Number of bits in a fingerprint. Zero means that the filter
+	 * couldn't be built and matches all values.
+	 */
+	uint8_t fingerprint_bits;
+};
+
+/* {{{ API declaration */
+
+/**
+ * Initialize a binary fuse filter definition.
+ *
+ * @param filter - structure to initialize
+ * @param number_of_values - number of values to be stored
+ * @param false_positive_rate - desired false positive rate
+ */
+void
+binary_fuse_create(struct binary_fuse *filter, uint32_t number_of_values,
+		   double false_positive_rate);
+
+/**
+ * Calculate size of a buffer that is needed for storing the filter
+ * @param filter - the filter to store
+ * @return - Exact size
+ */
+size_t
+binary_fuse_data_size(const struct binary_fuse *filter);
+
+/**
+ * Return the expected false positive rate of a binary fuse filter.
+ * @param filter - the filter
+ * @return - expected false positive rate
+ */
+double
+binary_fuse_fpr(const struct binary_fuse *filter);
+
+/**
+ * Build a binary fuse filter storing the given set of values.
+ * Duplicate values are allowed. The number of values (not counting
+ * duplicates) must not exceed the number the filter definition was
+ * created for.
+ *
+ * If the filter can't be built, because memory allocation failed
+ * or, which is practically impossible, no suitable seed was found,
+ * it is turned into a filter matching all values. In the former
+ * case errno is set to ENOMEM.
+ *
+ * @param filter - the filter definition
+ * @param filter_data - zero-filled filter data
+ * @param values - array of values to store
+ * @param count - number of values in the array
+ * @retval 0 - success
+ * @retval -1 - the filter couldn't be built
+ */
+int
+binary_fuse_build(struct binary_fuse *filter, void *filter_data,
+		  const uint32_t *values, uint32_t count);
+
+/**
+ * Query for presence of a value in the data set
+ * @param filter - the filter definition
+ * @param filter_data - the filter data
+ * @param value - the value, usually a hash
+ * @return true - the value could be in data set; false - the value is
+ *  definitively not in data set
+ */
+static bool
+binary_fuse_maybe_has(const struct binary_fuse *filter,
+		      const void *filter_data, uint32_t value);
+
+/* }}} API declaration */
+
+/* {{{ API definition */
+
+/** Mix a value with the filter seed into a 64-bit hash. */
+static inline uint64_t
+binary_fuse_hash(const struct binary_fuse *filter, uint32_t value)
+{
+	/* MurmurHash3 64-bit finalizer. */
+	uint64_t h = value + filter->seed;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+/** Return the fingerprint of a hash. */
+static inline uint32_t
+binary_fuse_fingerprint(const struct binary_fuse *filter, uint64_t hash)
+{
+	uint64_t mask = (1ULL << filter->fingerprint_bits) - 1;
+	return (hash ^ (hash >> 32)) & mask;
+}
+
+/** Calculate the three slots of a hash. */
+static inline void
+binary_fuse_slots(const struct binary_fuse *filter, uint64_t hash,
+		  uint32_t slots[3])
+{
+	uint64_t range = (uint64_t)filter->segment_count *
+			 filter->segment_length;
+	uint32_t mask = filter->segment_length - 1;
+	/* Map the hash to [0, range) without division. */
+	uint32_t h0 = (uint32_t)(((__uint128_t)hash * range) >> 64);
+	slots[0] = h0;
+	slots[1] = (h0 + filter->segment_length) ^
+		   ((uint32_t)(hash >> 18) & mask);
+	slots[2] = (h0 + 2 * filter->segment_length) ^
+		   ((uint32_t)hash & mask);
+}
+
+/**
+ * Read a fingerprint slot. Fingerprints are packed in little-endian
+ * order and the data buffer is padded so that a slot can always be
+ * read with a single 64-bit load.
+ */
+static inline uint32_t
+binary_fuse_get(const struct binary_fuse *filter, const void *filter_data,
+		uint32_t slot)
+{
+	uint64_t bit = (uint64_t)slot * filter->fingerprint_bits;
+	uint64_t word;
+	memcpy(&word, (const char *)filter_data + bit / 8, sizeof(word));
+	uint64_t mask = (1ULL << filter->fingerprint_bits) - 1;
+	return (word >> (bit % 8)) & mask;
+}
+
+static inline bool
+binary_fuse_maybe_has(const struct binary_fuse *filter,
+		      const void *filter_data, uint32_t value)
+{
+	if (filter->fingerprint_bits == 0)
+		return true;
+	uint64_t hash = binary_fuse_hash(filter, value);
+	uint32_t slots[3];
+	binary_fuse_slots(filter, hash, slots);
+	uint32_t f = binary_fuse_fingerprint(filter, hash);
+	f ^= binary_fuse_get(filter, filter_data, slots[0]);
+	f ^= binary_fuse_get(filter, filter_data, slots[1]);
+	f ^= binary_fuse_get(filter, filter_data, slots[2]);
+	return f == 0;
+}
+
+/* }}} API definition */
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
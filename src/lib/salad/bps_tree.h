@@ -293,6 +293,33 @@
  * #define BPS_BLOCK_LINEAR_SEARCH
  */
 
+/**
+ * Optional narrowing of the binary search range in a block. If the element
+ * type allows to cheaply exclude elements that are certainly less or
+ * greater than the key (for example, by comparing some precalculated
+ * values with a vectorized scan), one can define
+ * #define BPS_TREE_NARROW_KEY(arr, size, key, arg, begin, end)
+ * #define BPS_TREE_NARROW_ELEM(arr, size, elem, arg, begin, end)
+ * The macros are called before the binary search with pointers to the
+ * `begin` and `end` pointers to the array elements and must shrink the
+ * [begin, end) range so that all the elements before it are less than the
+ * key and all the elements after it are greater than the key. Not used
+ * with BPS_BLOCK_LINEAR_SEARCH.
+ */
+
+/**
+ * Optional prefetching of the data referenced by the elements. Iterators
+ * prefetch the next leaf block when they enter a leaf. If the elements
+ * refer to some external data (for example, pointers to records), one can
+ * also define
+ * #define BPS_TREE_PREFETCH_ELEM(elem) prefetch((elem).ptr, 0)
+ * which is called by iterators on the element that is going to be visited
+ * BPS_TREE_PREFETCH_DISTANCE steps later.
+ */
+#ifndef BPS_TREE_PREFETCH_DISTANCE
+#define BPS_TREE_PREFETCH_DISTANCE 4
+#endif
+
 /**
  * A switch to make the tree store the cardinality of each of its
  * child blocks in an array. A block cardinality is the amount of
@@ -482,6 +509,9 @@ typedef int64_t bps_tree_block_card_t;
 #define bps_tree_find_after_ins_point_key _bps_tree(find_after_ins_point_key)
 #define bps_tree_find_after_ins_point_elem _bps_tree(find_after_ins_point_elem)
 #define bps_tree_get_leaf_safe _bps_tree(get_leaf_safe)
+#define bps_tree_prefetch_block _bps_tree(prefetch_block)
+#define bps_tree_prefetch_forward _bps_tree(prefetch_forward)
+#define bps_tree_prefetch_backward _bps_tree(prefetch_backward)
 #define bps_tree_garbage_push _bps_tree(garbage_push)
 #define bps_tree_garbage_pop _bps_tree(garbage_pop)
 #define bps_tree_create_leaf _bps_tree(create_leaf)
@@ -2012,6 +2042,9 @@ bps_tree_find_ins_point_key(const struct bps_tree_common *tree,
 	}
 	return (bps_tree_pos_t)(begin - arr);
 #else
+#ifdef BPS_TREE_NARROW_KEY
+	BPS_TREE_NARROW_KEY(arr, size, key, tree->arg, &begin, &end);
+#endif
 	while (begin != end) {
 		bps_tree_elem_t *mid = begin + (end - begin) / 2;
 		int res = BPS_TREE_COMPARE_KEY(*mid, key, tree->arg);
@@ -2057,6 +2090,9 @@ bps_tree_find_ins_point_elem(const struct bps_tree_common *tree,
 	}
 	return (bps_tree_pos_t)(begin - arr);
 #else
+#ifdef BPS_TREE_NARROW_ELEM
+	BPS_TREE_NARROW_ELEM(arr, size, elem, tree->arg, &begin, &end);
+#endif
 	while (begin != end) {
 		bps_tree_elem_t *mid = begin + (end - begin) / 2;
 		int res = BPS_TREE_COMPARE(*mid, elem, tree->arg);
@@ -2144,6 +2180,9 @@ bps_tree_find_after_ins_point_key(const struct bps_tree_common *tree,
 	}
 	return (bps_tree_pos_t)(begin - arr);
 #else
+#ifdef BPS_TREE_NARROW_KEY
+	BPS_TREE_NARROW_KEY(arr, size, key, tree->arg, &begin, &end);
+#endif
 	while (begin != end) {
 		bps_tree_elem_t *mid = begin + (end - begin) / 2;
 		int res = BPS_TREE_COMPARE_KEY(*mid, key, tree->arg);
@@ -2189,6 +2228,9 @@ bps_tree_find_after_ins_point_elem(const struct bps_tree_common *tree,
 	}
 	return (bps_tree_pos_t)(begin - arr);
 #else
+#ifdef BPS_TREE_NARROW_ELEM
+	BPS_TREE_NARROW_ELEM(arr, size, elem, tree->arg, &begin, &end);
+#endif
 	while (begin != end) {
 		bps_tree_elem_t *mid = begin + (end - begin) / 2;
 		int res = BPS_TREE_COMPARE(*mid, elem, tree->arg);
@@ -2278,6 +2320,75 @@ bps_tree_get_leaf_safe(const struct bps_tree_common *tree,
 	return (struct bps_leaf *)block;
 }
 
+/**
+ * @brief Start fetching the block with the given ID into the CPU cache.
+ */
+static inline void
+bps_tree_prefetch_block(const struct bps_tree_common *tree,
+			bps_tree_block_id_t id)
+{
+	if (id == (bps_tree_block_id_t)(-1))
+		return;
+	const char *block = (const char *)bps_tree_restore_block(tree, id);
+	for (size_t offset = 0; offset < BPS_TREE_BLOCK_SIZE;
+	     offset += CACHELINE_SIZE)
+		prefetch(block + offset, 0);
+}
+
+/**
+ * @brief Prefetch the data a forward scan positioned at @a pos of
+ *  @a leaf is going to need soon: the next leaf when the scan enters
+ *  the leaf and the element BPS_TREE_PREFETCH_DISTANCE steps ahead.
+ */
+static inline void
+bps_tree_prefetch_forward(const struct bps_tree_common *tree,
+			  const struct bps_leaf *leaf, bps_tree_pos_t pos)
+{
+	if (pos == 0)
+		bps_tree_prefetch_block(tree, leaf->next_id);
+#ifdef BPS_TREE_PREFETCH_ELEM
+	bps_tree_pos_t ahead = pos + BPS_TREE_PREFETCH_DISTANCE;
+	if (ahead < leaf->header.size) {
+		BPS_TREE_PREFETCH_ELEM(leaf->elems[ahead]);
+	} else if (leaf->next_id != (bps_tree_block_id_t)(-1)) {
+		/* The next leaf was prefetched when the scan entered this one. */
+		const struct bps_leaf *next = (const struct bps_leaf *)
+			bps_tree_restore_block(tree, leaf->next_id);
+		ahead -= leaf->header.size;
+		if (ahead < next->header.size)
+			BPS_TREE_PREFETCH_ELEM(next->elems[ahead]);
+	}
+#else
+	(void)tree;
+#endif
+}
+
+/**
+ * @brief Same as bps_tree_prefetch_forward(), but for a backward scan.
+ */
+static inline void
+bps_tree_prefetch_backward(const struct bps_tree_common *tree,
+			   const struct bps_leaf *leaf, bps_tree_pos_t pos)
+{
+	if (pos == leaf->header.size - 1)
+		bps_tree_prefetch_block(tree, leaf->prev_id);
+#ifdef BPS_TREE_PREFETCH_ELEM
+	bps_tree_pos_t ahead = pos - BPS_TREE_PREFETCH_DISTANCE;
+	if (ahead >= 0) {
+		BPS_TREE_PREFETCH_ELEM(leaf->elems[ahead]);
+	} else if (leaf->prev_id != (bps_tree_block_id_t)(-1)) {
+		/* The prev leaf was prefetched when the scan entered this one. */
+		const struct bps_leaf *prev = (const struct bps_leaf *)
+			bps_tree_restore_block(tree, leaf->prev_id);
+		ahead += prev->header.size;
+		if (ahead >= 0)
+			BPS_TREE_PREFETCH_ELEM(prev->elems[ahead]);
+	}
+#else
+	(void)tree;
+#endif
+}
+
 /**
  * @brief Compare two iterators and return true if trey point to
  * the same element.
@@ -2929,8 +3040,12 @@ bps_tree_iterator_next_impl(const struct bps_tree_common *tree,
 	if (itr->pos >= leaf->header.size) {
 		itr->block_id = leaf->next_id;
 		itr->pos = 0;
-		return itr->block_id != (bps_tree_block_id_t)(-1);
+		if (itr->block_id == (bps_tree_block_id_t)(-1))
+			return false;
+		leaf = (struct bps_leaf *)
+			bps_tree_restore_block(tree, itr->block_id);
 	}
+	bps_tree_prefetch_forward(tree, leaf, itr->pos);
 	return true;
 }
 
@@ -2972,9 +3087,14 @@ bps_tree_iterator_prev_impl(const struct bps_tree_common *tree,
 	if (itr->pos == 0) {
 		itr->block_id = leaf->prev_id;
 		itr->pos = (bps_tree_pos_t)(-1);
-		return itr->block_id != (bps_tree_block_id_t)(-1);
+		if (itr->block_id == (bps_tree_block_id_t)(-1))
+			return false;
+		leaf = (struct bps_leaf *)
+			bps_tree_restore_block(tree, itr->block_id);
+		bps_tree_prefetch_backward(tree, leaf, leaf->header.size - 1);
 	} else {
 		itr->pos--;
+		bps_tree_prefetch_backward(tree, leaf, itr->pos);
 	}
 	return true;
 }
@@ -7724,6 +7844,9 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_find_after_ins_point_key
 #undef bps_tree_find_after_ins_point_elem
 #undef bps_tree_get_leaf_safe
+#undef bps_tree_prefetch_block
+#undef bps_tree_prefetch_forward
+#undef bps_tree_prefetch_backward
 #undef bps_tree_garbage_push
 #undef bps_tree_garbage_pop
 #undef bps_tree_create_leaf
@@ -0,0 +1,192 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "hint_search.h"
+
+#include "trivia/util.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Generic implementation: a binary search over hints would need to
+ * compare hints in a loop with unpredictable branches, which isn't any
+ * faster than the full search with hinted comparators, so leave the
+ * range as is.
+ */
+static void
+hint_search_range_generic(const uint64_t *hints, size_t count, size_t stride,
+			  uint64_t hint, size_t *begin, size_t *end)
+{
+	(void)hints;
+	(void)stride;
+	(void)hint;
+	*begin = 0;
+	*end = count;
+}
+
+/**
+ * Scalar scan of the array tail starting from the given position.
+ * Since known hints are sorted in the array, the scan stops on the
+ * first element with a greater hint.
+ */
+static inline void
+hint_search_range_tail(const uint64_t *hints, size_t pos, size_t count,
+		       size_t stride, uint64_t hint, size_t *begin,
+		       size_t *end)
+{
+	for (; pos < count; pos++) {
+		uint64_t h = hints[pos * stride];
+		if (h == HINT_SEARCH_NONE)
+			continue;
+		if (h < hint) {
+			*begin = pos + 1;
+		} else if (h > hint) {
+			*end = pos;
+			return;
+		}
+	}
+}
+
+#if defined(__x86_64__)
+
+/**
+ * SSE4.2 implementation. Hints are assumed to be interleaved with
+ * 8-byte values (stride is 2) so that two array elements fill two
+ * 16-byte registers.
+ */
+__attribute__((target("sse4.2")))
+static void
+hint_search_range_sse42(const uint64_t *hints, size_t count, size_t stride,
+			uint64_t hint, size_t *begin, size_t *end)
+{
+	if (stride != 2) {
+		hint_search_range_generic(hints, count, stride, hint,
+					  begin, end);
+		return;
+	}
+	*begin = 0;
+	*end = count;
+	/* There's no unsigned comparison, so flip the sign bits. */
+	const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+	const __m128i none = _mm_set1_epi64x(HINT_SEARCH_NONE);
+	const __m128i key = _mm_xor_si128(_mm_set1_epi64x(hint), sign);
+	size_t pos = 0;
+	for (; pos + 2 <= count; pos += 2) {
+		__m128i a = _mm_loadu_si128(
+			(const __m128i *)(hints + pos * stride - 1));
+		__m128i b = _mm_loadu_si128(
+			(const __m128i *)(hints + (pos + 1) * stride - 1));
+		__m128i h = _mm_unpackhi_epi64(a, b);
+		__m128i hs = _mm_xor_si128(h, sign);
+		int lt = _mm_movemask_pd(_mm_castsi128_pd(
+			_mm_cmpgt_epi64(key, hs)));
+		int gt = _mm_movemask_pd(_mm_castsi128_pd(_mm_andnot_si128(
+			_mm_cmpeq_epi64(h, none), _mm_cmpgt_epi64(hs, key))));
+		if (lt != 0)
+			*begin = pos + 32 - __builtin_clz(lt);
+		if (gt != 0) {
+			*end = pos + __builtin_ctz(gt);
+			return;
+		}
+	}
+	hint_search_range_tail(hints, pos, count, stride, hint, begin, end);
+}
+
+/**
+ * AVX2 implementation. Hints are assumed to be interleaved with 8-byte
+ * values (stride is 2) so that four array elements fill two 32-byte
+ * registers.
+ */
+__attribute__((target("avx2")))
+static void
+hint_search_range_avx2(const uint64_t *hints, size_t count, size_t stride,
+		       uint64_t hint, size_t *begin, size_t *end)
+{
+	if (stride != 2) {
+		hint_search_range_generic(hints, count, stride, hint,
+					  begin, end);
+		return;
+	}
+	*begin = 0;
+	*end = count;
+	/* There's no unsigned comparison, so flip the sign bits. */
+	const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+	const __m256i none = _mm256_set1_epi64x(HINT_SEARCH_NONE);
+	const __m256i key = _mm256_xor_si256(_mm256_set1_epi64x(hint), sign);
+	size_t pos = 0;
+	for (; pos + 4 <= count; pos += 4) {
+		__m256i a = _mm256_loadu_si256(
+			(const __m256i *)(hints + pos * stride - 1));
+		__m256i b = _mm256_loadu_si256(
+			(const __m256i *)(hints + (pos + 2) * stride - 1));
+		/* h0 h2 h1 h3 -> h0 h1 h2 h3 */
+		__m256i h = _mm256_permute4x64_epi64(
+			_mm256_unpackhi_epi64(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+		__m256i hs = _mm256_xor_si256(h, sign);
+		int lt = _mm256_movemask_pd(_mm256_castsi256_pd(
+			_mm256_cmpgt_epi64(key, hs)));
+		int gt = _mm256_movemask_pd(_mm256_castsi256_pd(
+			_mm256_andnot_si256(_mm256_cmpeq_epi64(h, none),
+					    _mm256_cmpgt_epi64(hs, key))));
+		if (lt != 0)
+			*begin = pos + 32 - __builtin_clz(lt);
+		if (gt != 0) {
+			*end = pos + __builtin_ctz(gt);
+			return;
+		}
+	}
+	hint_search_range_tail(hints, pos, count, stride, hint, begin, end);
+}
+
+#endif /* defined(__x86_64__) */
+
+hint_search_range_f hint_search_range = hint_search_range_generic;
+
+const char *hint_search_impl_strs[] = {
+	/* [HINT_SEARCH_GENERIC] = */ "generic",
+	/* [HINT_SEARCH_SSE42] = */ "sse4.2",
+	/* [HINT_SEARCH_AVX2] = */ "avx2",
+};
+
+static_assert(lengthof(hint_search_impl_strs) == hint_search_impl_MAX,
+	      "each hint_search_impl must have a name");
+
+hint_search_range_f
+hint_search_range_impl(enum hint_search_impl impl)
+{
+	switch (impl) {
+	case HINT_SEARCH_GENERIC:
+		return hint_search_range_generic;
+#if defined(__x86_64__)
+	case HINT_SEARCH_SSE42:
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("sse4.2"))
+			return hint_search_range_sse42;
+		return NULL;
+	case HINT_SEARCH_AVX2:
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return hint_search_range_avx2;
+		return NULL;
+#endif /* defined(__x86_64__) */
+	default:
+		return NULL;
+	}
+}
+
+void
+hint_search_init(void)
+{
+	for (int i = hint_search_impl_MAX - 1; i >= 0; i--) {
+		hint_search_range_f f =
+			hint_search_range_impl((enum hint_search_impl)i);
+		if (f != NULL) {
+			hint_search_range = f;
+			return;
+		}
+	}
+}
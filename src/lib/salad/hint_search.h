@@ -0,0 +1,74 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/** Hint value meaning that the hint is unknown. */
+#define HINT_SEARCH_NONE UINT64_MAX
+
+/**
+ * Narrow the range of a sorted array to be searched for a key using
+ * comparison hints.
+ *
+ * The array elements are given by their hints, the i-th element hint is
+ * `hints[i * stride]`. A hint is an unsigned number such that if the hint
+ * of an element is less (greater) than the hint of the key then the element
+ * is less (greater) than the key. Hints equal to HINT_SEARCH_NONE are
+ * unknown and may appear anywhere in the array.
+ *
+ * On return, all the elements before `begin` are known to be less than
+ * the key and all the elements starting from `end` are known to be greater
+ * than the key, so only the [begin, end) range needs to be searched with
+ * the full comparison.
+ *
+ * The key hint must not be HINT_SEARCH_NONE. If stride is 2, the word
+ * preceding the first hint must be readable: vectorized implementations
+ * load pairs of words, expecting hints to be interleaved with pointers.
+ */
+typedef void
+(*hint_search_range_f)(const uint64_t *hints, size_t count, size_t stride,
+		       uint64_t hint, size_t *begin, size_t *end);
+
+/**
+ * The best hint search implementation supported by the CPU, selected by
+ * hint_search_init(). Until then, it doesn't narrow the range at all.
+ */
+extern hint_search_range_f hint_search_range;
+
+/** Hint search implementations. */
+enum hint_search_impl {
+	/** Doesn't narrow the range at all. */
+	HINT_SEARCH_GENERIC,
+	/** Narrows the range if stride is 2, requires SSE4.2. */
+	HINT_SEARCH_SSE42,
+	/** Narrows the range if stride is 2, requires AVX2. */
+	HINT_SEARCH_AVX2,
+	hint_search_impl_MAX,
+};
+
+/** String names of enum hint_search_impl members. */
+extern const char *hint_search_impl_strs[];
+
+/**
+ * Returns the given hint search implementation or NULL if it isn't
+ * supported by the CPU. Useful for testing.
+ */
+hint_search_range_f
+hint_search_range_impl(enum hint_search_impl impl);
+
+/** Select the hint search implementation. */
+void
+hint_search_init(void);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
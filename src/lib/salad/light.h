@@ -296,6 +296,26 @@ static inline uint32_t
 LIGHT(view_find_key)(const struct LIGHT(view) *v, uint32_t hash,
 		     LIGHT_KEY_TYPE data);
 
+/**
+ * @brief Start loading the record a search for the given hash begins
+ *  with into the CPU cache. Issuing it for the next few hashes of
+ *  a batch before looking up the current one hides the cache miss
+ *  of a random bucket access.
+ * @param ht - pointer to a hash table struct
+ * @param hash - hash that is going to be looked up or inserted
+ */
+static inline void
+LIGHT(prefetch)(const struct LIGHT(core) *ht, uint32_t hash);
+
+/**
+ * @brief Start loading the record a search for the given hash begins
+ *  with into the CPU cache.
+ * @param v - pointer to a hash table view struct
+ * @param hash - hash that is going to be looked up
+ */
+static inline void
+LIGHT(view_prefetch)(const struct LIGHT(view) *v, uint32_t hash);
+
 /**
  * @brief Insert a record with given hash and value
  * @param ht - pointer to a hash table struct
@@ -639,6 +659,26 @@ LIGHT(view_find_key)(const struct LIGHT(view) *v, uint32_t hash,
 	return LIGHT(find_key_impl)(&v->common, hash, key);
 }
 
+static inline void
+LIGHT(prefetch_impl)(const struct LIGHT(common) *ht, uint32_t hash)
+{
+	if (ht->count == 0)
+		return;
+	__builtin_prefetch(LIGHT(get_record)(ht, LIGHT(slot)(ht, hash)));
+}
+
+static inline void
+LIGHT(prefetch)(const struct LIGHT(core) *ht, uint32_t hash)
+{
+	LIGHT(prefetch_impl)(&ht->common, hash);
+}
+
+static inline void
+LIGHT(view_prefetch)(const struct LIGHT(view) *v, uint32_t hash)
+{
+	LIGHT(prefetch_impl)(&v->common, hash);
+}
+
 /**
  * @brief Replace a record with given hash and value
  * @param htab - pointer to a hash table struct
@@ -54,6 +54,7 @@
 #include "coio_task.h"
 #include "cord_buf.h"
 #include <crc32.h>
+#include "salad/hint_search.h"
 #include "memory.h"
 #include <say.h>
 #include <rmean.h>
@@ -1034,6 +1035,7 @@ main(int argc, char **argv)
 	random_init();
 
 	crc32_init();
+	hint_search_init();
 	memory_init();
 
 	main_argc = argc;
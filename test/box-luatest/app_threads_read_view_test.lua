@@ -0,0 +1,226 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            app_threads = 2,
+            app_threads_read_view_staleness = 0.1,
+        },
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {type = 'hash', parts = {2, 'string'}})
+        for i = 1, 10 do
+            s:insert({i, 'v' .. i})
+        end
+        box.schema.user.passwd('admin', 'secret')
+        for _, user in ipairs({'alice', 'bob'}) do
+            box.schema.user.create(user, {password = 'secret'})
+            box.schema.user.grant(user, 'read', 'space', 'test')
+            box.schema.user.grant(user, 'execute', 'lua_call',
+                                  'box.iproto.internal.enable_thread_requests')
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+local function connect(cg, user)
+    local conn = net.connect(cg.server.net_box_uri, {
+        user = user, password = 'secret',
+    })
+    conn:call('box.iproto.internal.enable_thread_requests')
+    return conn
+end
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({app_threads_read_view_staleness = 0.1})
+    end)
+end)
+
+g.test_select = function(cg)
+    local conn = connect(cg, 'alice')
+    local space = conn.space.test
+    local opts = {_thread_id = 1}
+    local exp = {}
+    for i = 1, 10 do
+        table.insert(exp, {i, 'v' .. i})
+    end
+    t.helpers.retrying({}, function()
+        t.assert_equals(space:select({}, opts), exp)
+    end)
+    opts._thread_id = 2
+    t.assert_equals(space:select({}, opts), exp)
+    t.assert_equals(space:select({}, {_thread_id = 2, offset = 3, limit = 2}),
+                    {{4, 'v4'}, {5, 'v5'}})
+    t.assert_equals(space:select({}, {_thread_id = 1, iterator = 'ge',
+                                      limit = 1}), {{1, 'v1'}})
+    t.assert_items_equals(space.index.sk:select({}, {_thread_id = 1}), exp)
+    conn:close()
+end
+
+g.test_staleness = function(cg)
+    local conn = connect(cg, 'alice')
+    local space = conn.space.test
+    cg.server:exec(function()
+        box.space.test:insert({11, 'v11'})
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_equals(space:select({}, {_thread_id = 1, offset = 10}),
+                        {{11, 'v11'}})
+    end)
+    cg.server:exec(function()
+        box.space.test:delete({11})
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_equals(space:select({}, {_thread_id = 1, offset = 10}), {})
+    end)
+    conn:close()
+end
+
+g.test_disabled = function(cg)
+    local conn = connect(cg, 'alice')
+    local space = conn.space.test
+    cg.server:exec(function()
+        box.cfg({app_threads_read_view_staleness = 0})
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_error_covers({
+            type = 'ClientError',
+            name = 'UNABLE_TO_PROCESS_IN_THREAD',
+            thread_id = 1,
+        }, space.select, space, {}, {_thread_id = 1})
+    end)
+    conn:close()
+end
+
+g.test_unsupported = function(cg)
+    local conn = connect(cg, 'alice')
+    local space = conn.space.test
+    local function check(msg, key, opts)
+        opts._thread_id = 1
+        t.assert_error_msg_equals(
+            'Application thread read view does not support ' .. msg,
+            space.select, space, key, opts)
+    end
+    t.helpers.retrying({}, function()
+        t.assert_equals(space:select({}, {_thread_id = 1, limit = 1}),
+                        {{1, 'v1'}})
+    end)
+    check('non-empty search key', {1}, {})
+    check('iterator type LT', {}, {iterator = 'lt'})
+    check('pagination', {}, {fetch_pos = true})
+    conn:close()
+end
+
+g.test_no_such_space = function(cg)
+    local conn = connect(cg, 'admin')
+    t.helpers.retrying({}, function()
+        t.assert_equals(conn.space.test:select({}, {_thread_id = 1,
+                                                    limit = 1}),
+                        {{1, 'v1'}})
+    end)
+    -- System spaces aren't included into the read view.
+    t.assert_error_covers({
+        type = 'ClientError',
+        name = 'NO_SUCH_SPACE',
+    }, conn.space._space.select, conn.space._space, {}, {_thread_id = 1})
+    conn:close()
+end
+
+g.test_access_denied = function(cg)
+    local conn = connect(cg, 'bob')
+    local space = conn.space.test
+    t.helpers.retrying({}, function()
+        t.assert_equals(space:select({}, {_thread_id = 1, limit = 1}),
+                        {{1, 'v1'}})
+    end)
+    cg.server:exec(function()
+        box.schema.user.revoke('bob', 'read', 'space', 'test')
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_error_covers({
+            type = 'AccessDeniedError',
+            object_type = 'space',
+            object_name = 'test',
+            access_type = 'Read',
+        }, space.select, space, {}, {_thread_id = 1})
+    end)
+    conn:close()
+end
+
+-- The read view is closed when it isn't used so that it doesn't keep memtx
+-- from freeing old tuples and defragmenting memory. The next request reopens
+-- it.
+g.test_idle = function(cg)
+    local function read_view_count()
+        return cg.server:exec(function()
+            local count = 0
+            for _, rv in ipairs(box.internal.read_view_list()) do
+                if rv.name == 'app_threads' then
+                    count = count + 1
+                end
+            end
+            return count
+        end)
+    end
+    cg.server:exec(function()
+        box.cfg({app_threads_read_view_staleness = 0.5})
+    end)
+    local conn = connect(cg, 'alice')
+    local space = conn.space.test
+    local opts = {_thread_id = 1, limit = 1}
+    t.assert_equals(space:select({}, opts), {{1, 'v1'}})
+    t.assert_ge(read_view_count(), 1)
+    t.helpers.retrying({}, function()
+        t.assert_equals(read_view_count(), 0)
+    end)
+    t.assert_equals(space:select({}, opts), {{1, 'v1'}})
+    t.assert_ge(read_view_count(), 1)
+    conn:close()
+end
+
+-- Checks concurrent requests of the same connection waiting for the idle
+-- read view to be reopened.
+g.test_idle_concurrent = function(cg)
+    local conn = connect(cg, 'alice')
+    local space = conn.space.test
+    t.assert_equals(space:select({}, {_thread_id = 1, limit = 1}),
+                    {{1, 'v1'}})
+    t.helpers.retrying({}, function()
+        cg.server:exec(function()
+            for _, rv in ipairs(box.internal.read_view_list()) do
+                t.assert_not_equals(rv.name, 'app_threads')
+            end
+        end)
+    end)
+    local futures = {}
+    for i = 1, 10 do
+        futures[i] = space:select({}, {_thread_id = 1, offset = i - 1,
+                                       limit = 1, is_async = true})
+    end
+    for i = 1, 10 do
+        t.assert_equals(futures[i]:wait_result(), {{i, 'v' .. i}})
+    end
+    conn:close()
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'app_threads_read_view_staleness': " ..
+            "the value must be greater than or equal to 0",
+            box.cfg, {app_threads_read_view_staleness = -1})
+        box.cfg({app_threads_read_view_staleness = 1})
+        t.assert_equals(box.cfg.app_threads_read_view_staleness, 1)
+    end)
+end
@@ -43,23 +43,32 @@ g.test_compression_values = function(cg)
         check_fail(1, msg_map_or_str)
         check_fail(false, msg_map_or_str)
 
-        -- More than two compression table keys.
-        local msg_no_options = 'CE supports no compression options'
-        check_fail({type = 'none', acceleration = 1}, msg_no_options)
-        check_fail({type = 'none', option = true}, msg_no_options)
-        check_fail({'none', [true] = false}, msg_no_options)
-        check_fail({'none', 'two'}, msg_no_options)
-
         -- A non-string compression table key.
         local msg_string_option = 'compression option name must be a string'
         check_fail({true}, msg_string_option)
         check_fail({'none'}, msg_string_option)
         check_fail({[true] = 'none'}, msg_string_option)
+        check_fail({'none', [true] = false}, msg_string_option)
+        check_fail({'none', 'two'}, msg_string_option)
+
+        -- A string key other than 'type' and 'level'.
+        check_fail({none = true}, "unknown compression option 'none'")
+        check_fail({acceleration = 1000},
+                   "unknown compression option 'acceleration'")
+        check_fail({type = 'zstd', acceleration = 1},
+                   "unknown compression option 'acceleration'")
 
-        -- A string key other than 'type'.
-        local msg_type_only = "CE only supports 'type' compression table key"
-        check_fail({none = true}, msg_type_only)
-        check_fail({acceleration = 1000}, msg_type_only)
+        -- Invalid compression level.
+        check_fail({type = 'zstd', level = 'high'},
+                   'compression level must be an integer')
+        check_fail({type = 'zstd', level = 0},
+                   'compression level must be from 1 to 22')
+        check_fail({type = 'zstd', level = 23},
+                   'compression level must be from 1 to 22')
+        check_fail({type = 'none', level = 1},
+                   'compression level is only supported by zstd')
+        check_fail({level = 1},
+                   'compression level is only supported by zstd')
 
         -- Non-string provided by the 'type' key.
         local non_string_type = 'non-string compression type'
@@ -67,15 +76,113 @@ g.test_compression_values = function(cg)
         check_fail({type = true}, non_string_type)
         check_fail({type = {table = true}}, non_string_type)
 
-        -- A compression type other than 'none'.
+        -- A compression type other than 'none' and 'zstd'.
         local msg_unknown_type = "unknown compression type"
         check_fail('lz4', msg_unknown_type)
         check_fail('zlib', msg_unknown_type)
-        check_fail('zstd', msg_unknown_type)
         check_fail('invalid', msg_unknown_type)
         check_fail({type = 'lz4'}, msg_unknown_type)
         check_fail({type = 'zlib'}, msg_unknown_type)
-        check_fail({type = 'zstd'}, msg_unknown_type)
         check_fail({type = 'invalid'}, msg_unknown_type)
+
+        -- Zstd compression is only supported by memtx.
+        local zstd_values = {
+            'zstd', {type = 'zstd'}, {type = 'zstd', level = 1},
+            {type = 'zstd', level = 22},
+        }
+        for _, compression in ipairs(zstd_values) do
+            if engine == 'memtx' then
+                check_ok(compression)
+            else
+                t.assert_error_msg_content_equals(
+                    "Vinyl does not support compression",
+                    box.space.test.format, box.space.test,
+                    {{name = 'id', type = 'unsigned',
+                      compression = compression}})
+            end
+        end
     end, {cg.params.engine})
 end
+
+g = t.group("zstd compression")
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:stop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_compressed_tuples = function(cg)
+    t.tarantool.skip_if_enterprise()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {name = 'id', type = 'unsigned', compression = 'zstd'},
+            {name = 'doc', type = 'string',
+             compression = {type = 'zstd', level = 3}},
+            {name = 'tag', type = 'string', compression = 'zstd'},
+        }})
+        s:create_index('pk')
+        s:create_index('tag', {parts = {'tag'}, unique = false})
+
+        local doc = string.rep('{"key": "value"}', 1000)
+        local short = 'short'
+        local bsize = s:bsize()
+        for i = 1, 100 do
+            s:insert({i, i % 2 == 0 and doc or short, 'tag' .. i % 3})
+        end
+        -- Documents are stored compressed.
+        t.assert_lt(s:bsize() - bsize, 50 * #doc)
+
+        -- Tuples are decompressed on access.
+        t.assert_equals(s:get(2), {2, doc, 'tag2'})
+        t.assert_equals(s:get(3), {3, short, 'tag0'})
+        t.assert_equals(s.index.tag:count('tag1'), 34)
+        for _, tuple in s.index.tag:pairs('tag2') do
+            t.assert_equals(tuple[2], tuple[1] % 2 == 0 and doc or short)
+        end
+        t.assert_equals(s:update(4, {{'=', 3, 'new'}}), {4, doc, 'new'})
+        t.assert_equals(s:delete(4), {4, doc, 'new'})
+
+        -- Changing the format validates the decompressed data.
+        t.assert_error_msg_contains(
+            "Tuple field 2 (doc) type does not match one required",
+            s.format, s, {{name = 'id', type = 'unsigned'},
+                          {name = 'doc', type = 'unsigned'}})
+        s:format({{name = 'id', type = 'unsigned'},
+                  {name = 'doc', type = 'string'}})
+        t.assert_equals(s:get(2), {2, doc, 'tag2'})
+    end)
+end
+
+g.test_compressed_tuples_recovery = function(cg)
+    t.tarantool.skip_if_enterprise()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {name = 'id', type = 'unsigned'},
+            {name = 'doc', type = 'string', compression = 'zstd'},
+        }})
+        s:create_index('pk')
+        local doc = string.rep('abc', 1000)
+        s:insert({1, doc})
+        box.snapshot()
+        s:insert({2, doc})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local doc = string.rep('abc', 1000)
+        t.assert_equals(box.space.test:select(),
+                        {{1, doc}, {2, doc}})
+        t.assert_lt(box.space.test:bsize(), #doc)
+    end)
+end
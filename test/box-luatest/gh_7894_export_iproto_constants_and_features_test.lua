@@ -139,6 +139,7 @@ local reference_table = {
         COMMIT = 15,
         ROLLBACK = 16,
         INSERT_ARROW = 17,
+        GET_MANY = 18,
         RAFT = 30,
         RAFT_PROMOTE = 31,
         RAFT_DEMOTE = 32,
@@ -174,7 +175,7 @@ local reference_table = {
     },
 
     -- `IPROTO_CURRENT_VERSION` constant
-    protocol_version = 10,
+    protocol_version = 11,
 
     -- `feature_id` enumeration
     protocol_features = {
@@ -191,6 +192,7 @@ local reference_table = {
         fetch_snapshot_cursor = is_enterprise and true or nil,
         is_sync = true,
         insert_arrow = true,
+        get_many = true,
     },
     feature = {
         streams = 0,
@@ -206,6 +208,7 @@ local reference_table = {
         fetch_snapshot_cursor = 10,
         is_sync = 11,
         insert_arrow = 12,
+        get_many = 13,
     },
 }
 
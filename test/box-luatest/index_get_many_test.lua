@@ -0,0 +1,126 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('index_get_many', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'string'}, {3, 'unsigned'}}})
+        s:create_index('nu', {parts = {3, 'unsigned'}, unique = false})
+        for i = 1, 10 do
+            s:insert({i * 10, 'key' .. i, i % 3})
+        end
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_local = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:get_many({}), {})
+        local res = s:get_many({30, {10}, 15, 100, 10})
+        t.assert_equals(res[1], {30, 'key3', 0})
+        t.assert_equals(res[2], {10, 'key1', 1})
+        t.assert_equals(res[3], nil)
+        t.assert_equals(res[4], {100, 'key10', 1})
+        t.assert_equals(res[5], {10, 'key1', 1})
+        res = s.index.sk:get_many({{'key2', 2}, {'key2', 1}, {'key5', 2}})
+        t.assert_equals(res[1], {20, 'key2', 2})
+        t.assert_equals(res[2], nil)
+        t.assert_equals(res[3], {50, 'key5', 2})
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_equals('Usage: index:get_many(keys)',
+                                  s.index.pk.get_many, s.index.pk, 10)
+        t.assert_error_covers({code = box.error.EXACT_MATCH},
+                              s.index.sk.get_many, s.index.sk,
+                              {{'key1', 1}, {'key2'}})
+        t.assert_error_covers({code = box.error.KEY_PART_TYPE},
+                              s.get_many, s, {1, 'x'})
+        t.assert_error_covers({code = box.error.MORE_THAN_ONE_TUPLE},
+                              s.index.nu.get_many, s.index.nu, {{1}})
+    end)
+end
+
+g.test_transaction = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        box.begin()
+        s:replace({10, 'new', 0})
+        s:delete(20)
+        local res = s:get_many({10, 20, 30})
+        box.rollback()
+        t.assert_equals(res[1], {10, 'new', 0})
+        t.assert_equals(res[2], nil)
+        t.assert_equals(res[3], {30, 'key3', 0})
+    end)
+end
+
+g.test_net_box = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    local s = conn.space.test
+    t.assert_equals(s:get_many({}), {})
+    local res = s:get_many({30, {10}, 15, 100})
+    t.assert_equals(res[1], {30, 'key3', 0})
+    t.assert_equals(res[2], {10, 'key1', 1})
+    t.assert_equals(res[3], nil)
+    t.assert_equals(res[4], {100, 'key10', 1})
+    res = s.index.sk:get_many({{'key2', 2}, {'key2', 1}})
+    t.assert_equals(res[1], {20, 'key2', 2})
+    t.assert_equals(res[2], nil)
+    t.assert_error_covers({code = box.error.MORE_THAN_ONE_TUPLE},
+                          s.index.nu.get_many, s.index.nu, {{1}})
+
+    local stream = conn:new_stream()
+    stream:begin()
+    stream.space.test:replace({10, 'new', 0})
+    res = stream.space.test:get_many({10, 20})
+    t.assert_equals(res[1], {10, 'new', 0})
+    t.assert_equals(res[2], {20, 'key2', 2})
+    stream:rollback()
+    t.assert_equals(s:get_many({10})[1], {10, 'key1', 1})
+    conn:close()
+end
+
+g.test_net_box_unsupported = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_IPROTO_DISABLE_ID', true)
+    end)
+    local conn = net.connect(cg.server.net_box_uri)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_IPROTO_DISABLE_ID', false)
+    end)
+    t.assert_equals(conn.peer_protocol_features.get_many, false)
+    local s = conn.space.test
+    t.assert_error_msg_equals('Remote server does not support get_many',
+                              s.get_many, s, {10})
+    conn:close()
+end
@@ -0,0 +1,60 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group(nil, t.helpers.matrix({backend = {'auto', 'io_uring'}}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            iproto_threads = 2,
+            iproto_ev_backend = cg.params.backend,
+        },
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.test_requests = function(cg)
+    local conns = {}
+    for i = 1, 4 do
+        conns[i] = net.connect(cg.server.net_box_uri)
+        t.assert_equals(conns[i].state, 'active')
+    end
+    -- Pipeline a bunch of requests over several connections so that
+    -- both network threads have plenty of sockets to poll.
+    local futures = {}
+    for i = 1, 1000 do
+        local conn = conns[i % #conns + 1]
+        table.insert(futures, conn.space.test:replace({i}, {is_async = true}))
+    end
+    for i, f in ipairs(futures) do
+        t.assert_equals(f:wait_result():totable(), {i})
+    end
+    for i = 1, 1000 do
+        local conn = conns[i % #conns + 1]
+        t.assert_equals(conn.space.test:get(i):totable(), {i})
+    end
+    for _, conn in ipairs(conns) do
+        conn:close()
+    end
+end
+
+g.test_static = function(cg)
+    cg.server:exec(function(backend)
+        t.assert_equals(box.cfg.iproto_ev_backend, backend)
+        t.assert_error_msg_equals(
+            "Can't set option 'iproto_ev_backend' dynamically",
+            box.cfg, {iproto_ev_backend = backend == 'auto' and
+                      'io_uring' or 'auto'})
+    end, {cg.params.backend})
+end
@@ -0,0 +1,114 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {iproto_threads = 2}})
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'sleep', function(timeout)
+            require('fiber').sleep(timeout)
+        end)
+        rawset(_G, 'check_latency_format', function(latency)
+            local t = require('luatest')
+            local function keys(tbl)
+                local res = {}
+                for k in pairs(tbl) do
+                    table.insert(res, k)
+                end
+                return res
+            end
+            t.assert_items_equals(keys(latency),
+                                  {'INPUT', 'CBUS', 'EXEC', 'OUTPUT'})
+            for _, stage in pairs(latency) do
+                t.assert_items_equals(keys(stage),
+                                      {'p50', 'p75', 'p90', 'p95', 'p99'})
+            end
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({iproto_connection_latency = false})
+        box.stat.reset()
+    end)
+end)
+
+g.test_thread = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    for _ = 1, 10 do
+        conn:call('sleep', {0.01})
+    end
+    cg.server:exec(function()
+        local latency = box.stat.net().LATENCY
+        _G.check_latency_format(latency)
+        t.assert_ge(latency.EXEC.p99, 0.01)
+        _G.check_latency_format(box.stat.net.LATENCY)
+
+        local max_p99 = 0
+        local threads = box.stat.net.thread()
+        t.assert_equals(#threads, 2)
+        for i, stat in ipairs(threads) do
+            _G.check_latency_format(stat.LATENCY)
+            _G.check_latency_format(box.stat.net.thread[i].LATENCY)
+            max_p99 = math.max(max_p99, stat.LATENCY.EXEC.p99)
+        end
+        t.assert_ge(max_p99, 0.01)
+
+        box.stat.reset()
+        t.assert_lt(box.stat.net().LATENCY.EXEC.p99, 0.01)
+    end)
+    conn:close()
+end
+
+g.test_connection = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    local sid = conn:eval('return box.session.id()')
+    cg.server:exec(function(sid)
+        t.assert_equals(box.cfg.iproto_connection_latency, false)
+        t.assert_equals(box.stat.net.connection(sid), nil)
+        box.cfg({iproto_connection_latency = true})
+    end, {sid})
+    conn:call('sleep', {0.01})
+    t.assert_ge(conn:eval([[
+        return box.stat.net.connection().LATENCY.EXEC.p99
+    ]]), 0.01)
+    cg.server:exec(function(sid)
+        local latency = box.stat.net.connection(sid).LATENCY
+        _G.check_latency_format(latency)
+        t.assert_ge(latency.EXEC.p99, 0.01)
+        -- No such session.
+        t.assert_equals(box.stat.net.connection(sid + 1000), nil)
+
+        box.stat.reset()
+        latency = box.stat.net.connection(sid).LATENCY
+        t.assert_lt(latency.EXEC.p99, 0.01)
+
+        box.cfg({iproto_connection_latency = false})
+        t.assert_equals(box.stat.net.connection(sid), nil)
+    end, {sid})
+    conn:close()
+end
+
+-- Checks that a counter without observations reports zero latency.
+g.test_no_requests = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    local sid = conn:eval('return box.session.id()')
+    cg.server:exec(function(sid)
+        box.cfg({iproto_connection_latency = true})
+        local latency = box.stat.net.connection(sid).LATENCY
+        _G.check_latency_format(latency)
+        for _, stage in pairs(latency) do
+            t.assert_equals(stage, {p50 = 0, p75 = 0, p90 = 0,
+                                    p95 = 0, p99 = 0})
+        end
+    end, {sid})
+    conn:close()
+end
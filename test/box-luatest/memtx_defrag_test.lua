@@ -0,0 +1,129 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{memtx_defrag_rate = 0, memtx_defrag_threshold = 0.3}
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.memtx_defrag_rate, 0)
+        t.assert_equals(box.cfg.memtx_defrag_threshold, 0.3)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'memtx_defrag_rate': " ..
+            "the value must be greater than or equal to 0",
+            box.cfg, {memtx_defrag_rate = -1})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'memtx_defrag_threshold': " ..
+            "the value must be between 0 and 1",
+            box.cfg, {memtx_defrag_threshold = 2})
+        t.assert_equals(box.cfg.memtx_defrag_rate, 0)
+        t.assert_equals(box.cfg.memtx_defrag_threshold, 0.3)
+    end)
+end
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        local stat = box.stat.memtx().defrag
+        t.assert_type(stat.fragmentation, 'number')
+        t.assert_type(stat.scanned, 'number')
+        t.assert_type(stat.relocated, 'number')
+        t.assert_type(stat.relocated_bytes, 'number')
+    end)
+end
+
+g.test_defrag = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('hash', {type = 'hash', parts = {2, 'string'}})
+        s:create_index('tree', {parts = {{3, 'unsigned'}, {2, 'string'}},
+                                unique = false})
+        local pad = string.rep('x', 200)
+        local count = 20000
+        box.begin()
+        for i = 1, count do
+            s:insert({i, tostring(i), i % 10, pad})
+        end
+        box.commit()
+        -- Free most of the tuples allocated first so that the remaining
+        -- ones can move to the lower addresses.
+        box.begin()
+        for i = 1, count * 0.9 do
+            s:delete(i)
+        end
+        box.commit()
+        collectgarbage()
+        -- A tuple referenced from Lua must stay in place.
+        local pinned = s:get(count)
+
+        local stat = box.stat.memtx().defrag
+        t.assert_gt(stat.fragmentation, 0)
+        box.cfg{memtx_defrag_rate = 1000000, memtx_defrag_threshold = 0}
+        t.helpers.retrying({}, function()
+            t.assert_ge(box.stat.memtx().defrag.scanned, count * 0.1)
+        end)
+        stat = box.stat.memtx().defrag
+        t.assert_gt(stat.relocated, 0)
+        t.assert_gt(stat.relocated_bytes, 0)
+        box.cfg{memtx_defrag_rate = 0}
+
+        t.assert_equals(pinned, {count, tostring(count), count % 10, pad})
+        t.assert_equals(s:count(), count * 0.1)
+        for i = count * 0.9 + 1, count do
+            local tuple = {i, tostring(i), i % 10, pad}
+            t.assert_equals(s:get(i), tuple)
+            t.assert_equals(s.index.hash:get(tostring(i)), tuple)
+            t.assert_equals(s.index.tree:get({i % 10, tostring(i)}), tuple)
+        end
+        local n = 0
+        for _, tuple in s.index.tree:pairs() do
+            t.assert_equals(tuple[4], pad)
+            n = n + 1
+        end
+        t.assert_equals(n, count * 0.1)
+        s:replace({count, 'new', 0, pad})
+        t.assert_equals(s.index.hash:get('new')[1], count)
+        t.assert_equals(s.index.hash:get(tostring(count)), nil)
+        s:truncate()
+        t.assert_equals(s:count(), 0)
+    end)
+end
+
+g.test_unsupported_index = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('bitset', {type = 'bitset', parts = {2, 'unsigned'},
+                                  unique = false})
+        box.begin()
+        for i = 1, 1000 do
+            s:insert({i, i % 8})
+        end
+        box.commit()
+        local scanned = box.stat.memtx().defrag.scanned
+        box.cfg{memtx_defrag_rate = 1000000, memtx_defrag_threshold = 0}
+        require('fiber').sleep(0.1)
+        -- Spaces with indexes that can't update tuple pointers in place
+        -- are skipped.
+        t.assert_equals(box.stat.memtx().defrag.scanned, scanned)
+        box.cfg{memtx_defrag_rate = 0}
+        t.assert_equals(s.index.bitset:count(3), 125)
+    end)
+end
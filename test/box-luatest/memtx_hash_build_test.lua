@@ -0,0 +1,48 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {memtx_sort_threads = 3}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Hash indexes are built in bulk on recovery from a snapshot with
+-- hashes calculated in memtx_sort_threads threads.
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local N = 10001
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash'})
+        s:create_index('sk', {type = 'hash', parts = {2, 'string'}})
+        s:create_index('tk', {parts = {3, 'unsigned', 2, 'string'}})
+        box.begin()
+        for i = 1, N do
+            s:insert({i, 'v' .. i, i % 10})
+        end
+        box.commit()
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local N = 10001
+        local s = box.space.test
+        t.assert_equals(s:len(), N)
+        t.assert_equals(s.index.sk:len(), N)
+        for i = 1, N do
+            t.assert_equals(s:get(i), {i, 'v' .. i, i % 10})
+            t.assert_equals(s.index.sk:get('v' .. i), {i, 'v' .. i, i % 10})
+        end
+        t.assert_equals(s:get(N + 1), nil)
+        t.assert_equals(s.index.sk:get('v0'), nil)
+        t.assert_error_covers({name = 'TUPLE_FOUND'},
+                              s.insert, s, {N + 1, 'v1', 0})
+        s:insert({N + 1, 'v' .. N + 1, 0})
+        t.assert_equals(s.index.sk:get('v' .. N + 1), {N + 1, 'v' .. N + 1, 0})
+    end)
+end
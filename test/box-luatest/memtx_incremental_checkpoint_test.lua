@@ -0,0 +1,242 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('memtx_incremental_checkpoint', t.helpers.matrix({
+    mvcc = {false, true},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            memtx_checkpoint_delta_count = 2,
+            memtx_use_mvcc_engine = cg.params.mvcc,
+            checkpoint_count = 100,
+        },
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local fio = require('fio')
+        -- Returns the list of snapshots, each of them marked as
+        -- incremental or not.
+        rawset(_G, 'list_snapshots', function()
+            local files = fio.glob(fio.pathjoin(box.cfg.memtx_dir, '*.snap'))
+            table.sort(files)
+            local res = {}
+            for _, path in ipairs(files) do
+                local f = fio.open(path, {'O_RDONLY'})
+                local data = f:read(1024)
+                f:close()
+                local header = data:sub(1, data:find('\n\n'))
+                -- Incremental snapshots have a format version that older
+                -- versions refuse to load.
+                local version = header:match('^[^\n]*\n([^\n]*)\n')
+                local is_delta = version == '0.14'
+                t.assert_equals(header:find('PrevVClock') ~= nil, is_delta)
+                table.insert(res, {
+                    name = fio.basename(path),
+                    is_delta = is_delta,
+                })
+            end
+            return res
+        end)
+        rawset(_G, 'last_is_delta', function()
+            local snaps = _G.list_snapshots()
+            return snaps[#snaps].is_delta
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        box.cfg{memtx_checkpoint_delta_count = 2}
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.memtx_checkpoint_delta_count, 2)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'memtx_checkpoint_delta_count': " ..
+            "the value must be greater than or equal to 0",
+            box.cfg, {memtx_checkpoint_delta_count = -1})
+        t.assert_equals(box.cfg.memtx_checkpoint_delta_count, 2)
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}})
+        s:create_index('hash', {type = 'hash', parts = {3, 'unsigned'}})
+        box.begin()
+        for i = 1, 100 do
+            s:insert({i, 'str' .. i, i})
+        end
+        box.commit()
+        -- DDL makes the next snapshot full.
+        box.snapshot()
+        t.assert_not(_G.last_is_delta())
+
+        -- Swap unique keys of two tuples.
+        s:replace({1, 'tmp', 1})
+        s:replace({2, 'str1', 2})
+        s:replace({1, 'str2', 1})
+        s:delete(3)
+        s:delete(1000)
+        s:insert({101, 'str101', 101})
+        box.begin()
+        s:replace({4, 'rolled back', 4})
+        s:insert({102, 'rolled back', 102})
+        box.rollback()
+        box.snapshot()
+        t.assert(_G.last_is_delta())
+
+        -- The deleted tuple is inserted back.
+        s:insert({3, 'new3', 3})
+        s:delete(101)
+        box.snapshot()
+        t.assert(_G.last_is_delta())
+        s:replace({5, 'str5', 1005})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:count(), 100)
+        t.assert_equals(s:get(1), {1, 'str2', 1})
+        t.assert_equals(s:get(2), {2, 'str1', 2})
+        t.assert_equals(s:get(3), {3, 'new3', 3})
+        t.assert_equals(s:get(4), {4, 'str4', 4})
+        t.assert_equals(s:get(5), {5, 'str5', 1005})
+        t.assert_equals(s:get(101), nil)
+        t.assert_equals(s:get(102), nil)
+        t.assert_equals(s.index.sk:get('str1'), {2, 'str1', 2})
+        t.assert_equals(s.index.sk:get('str2'), {1, 'str2', 1})
+        t.assert_equals(s.index.sk:get('tmp'), nil)
+        t.assert_equals(s.index.hash:get(1005), {5, 'str5', 1005})
+        t.assert_equals(s.index.sk:count(), 100)
+        t.assert_equals(s.index.hash:count(), 100)
+    end)
+end
+
+g.test_full_snapshot = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1})
+        box.snapshot()
+        t.assert_not(_G.last_is_delta())
+        -- The number of incremental snapshots is limited.
+        for i = 2, 3 do
+            s:insert({i})
+            box.snapshot()
+            t.assert(_G.last_is_delta())
+        end
+        s:insert({4})
+        box.snapshot()
+        t.assert_not(_G.last_is_delta())
+        -- Truncation isn't logged tuple by tuple.
+        s:insert({5})
+        box.snapshot()
+        t.assert(_G.last_is_delta())
+        s:truncate()
+        box.snapshot()
+        t.assert_not(_G.last_is_delta())
+        -- Incremental snapshots can be disabled.
+        s:insert({6})
+        box.cfg{memtx_checkpoint_delta_count = 0}
+        box.snapshot()
+        t.assert_not(_G.last_is_delta())
+        -- Nothing is logged when they are enabled back.
+        box.cfg{memtx_checkpoint_delta_count = 2}
+        s:insert({7})
+        box.snapshot()
+        t.assert_not(_G.last_is_delta())
+        s:insert({8})
+        box.snapshot()
+        t.assert(_G.last_is_delta())
+    end)
+end
+
+g.test_schema_upgrade = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1})
+        box.snapshot()
+        t.assert_not(_G.last_is_delta())
+        -- Incremental snapshots aren't written until the schema is
+        -- upgraded so that it's possible to roll back to an older version.
+        box.space._schema:replace({'version', 3, 3, 0})
+        s:insert({2})
+        box.snapshot()
+        t.assert_not(_G.last_is_delta())
+        t.assert_error_covers({
+            type = 'ClientError',
+            name = 'SCHEMA_NEEDS_UPGRADE',
+        }, box.cfg, {memtx_checkpoint_delta_count = 3})
+        t.assert_equals(box.cfg.memtx_checkpoint_delta_count, 2)
+        box.schema.upgrade()
+        box.cfg{memtx_checkpoint_delta_count = 3}
+        s:insert({3})
+        box.snapshot()
+        t.assert(_G.last_is_delta())
+    end)
+end
+
+g.test_gc_and_backup = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1})
+        box.snapshot()
+        local base = _G.list_snapshots()
+        base = base[#base].name
+        for i = 2, 3 do
+            s:insert({i})
+            box.snapshot()
+        end
+        local snaps = _G.list_snapshots()
+        t.assert_equals(snaps[#snaps - 2].name, base)
+
+        -- The backup contains the whole chain.
+        local files = box.backup.start()
+        local backup = {}
+        for _, path in ipairs(files) do
+            if path:endswith('.snap') then
+                table.insert(backup, fio.basename(path))
+            end
+        end
+        table.sort(backup)
+        box.backup.stop()
+        t.assert_equals(backup, {
+            snaps[#snaps - 2].name,
+            snaps[#snaps - 1].name,
+            snaps[#snaps].name,
+        })
+
+        -- The full snapshot is kept while the incremental ones need it.
+        box.cfg{checkpoint_count = 1}
+        box.snapshot()
+        t.helpers.retrying({}, function()
+            t.assert_equals(_G.list_snapshots(), {snaps[#snaps - 2],
+                                                  snaps[#snaps - 1],
+                                                  snaps[#snaps]})
+        end)
+        s:insert({4})
+        box.snapshot()
+        t.assert_not(_G.last_is_delta())
+        t.helpers.retrying({}, function()
+            t.assert_equals(#_G.list_snapshots(), 1)
+        end)
+        box.cfg{checkpoint_count = 100}
+    end)
+end
@@ -0,0 +1,56 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group(nil, t.helpers.matrix({
+    huge_pages = {'none', 'transparent', '2M'},
+    numa = {'default', 'interleave'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            memtx_memory = 256 * 1024 * 1024,
+            memtx_memory_huge_pages = cg.params.huge_pages,
+            memtx_memory_numa = cg.params.numa,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.test_tuples = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'string'}}})
+        local pad = string.rep('x', 1000)
+        box.begin()
+        for i = 1, 10000 do
+            s:insert({i, tostring(i), pad})
+        end
+        box.commit()
+        t.assert_equals(s:count(), 10000)
+        t.assert_equals(s.index.sk:get('5000'), {5000, '5000', pad})
+        s:drop()
+    end)
+end
+
+g.test_static = function(cg)
+    cg.server:exec(function(huge_pages, numa)
+        t.assert_equals(box.cfg.memtx_memory_huge_pages, huge_pages)
+        t.assert_equals(box.cfg.memtx_memory_numa, numa)
+        t.assert_error_msg_equals(
+            "Can't set option 'memtx_memory_huge_pages' dynamically",
+            box.cfg, {memtx_memory_huge_pages = huge_pages == 'none' and
+                      'transparent' or 'none'})
+        t.assert_error_msg_equals(
+            "Can't set option 'memtx_memory_numa' dynamically",
+            box.cfg, {memtx_memory_numa = numa == 'default' and
+                      'bind' or 'default'})
+    end, {cg.params.huge_pages, cg.params.numa})
+end
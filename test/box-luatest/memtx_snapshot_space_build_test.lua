@@ -0,0 +1,111 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group(nil, t.helpers.matrix({mvcc = {false, true}}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {memtx_use_mvcc_engine = cg.params.mvcc},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local N = 10000
+        for i = 1, 5 do
+            local s = box.schema.space.create('test' .. i)
+            s:create_index('pk', {
+                type = i == 3 and 'hash' or 'tree',
+                parts = {1, i % 2 == 0 and 'string' or 'unsigned'},
+            })
+            s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+            box.begin()
+            for k = N, 1, -1 do
+                local key = (k * 7919) % N
+                s:insert({i % 2 == 0 and tostring(key) or key, k % 100})
+            end
+            box.commit()
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+local function check_spaces(server)
+    server:exec(function()
+        local N = 10000
+        for i = 1, 5 do
+            local s = box.space['test' .. i]
+            t.assert_equals(s:count(), N)
+            t.assert_equals(s.index.sk:count(), N)
+            t.assert_equals(s.index.sk:count({0}), N / 100)
+            if i ~= 3 then
+                local prev
+                for _, tuple in s:pairs() do
+                    if prev ~= nil then
+                        t.assert_lt(prev[1], tuple[1])
+                    end
+                    prev = tuple
+                end
+            end
+            local key = i % 2 == 0 and '42' or 42
+            t.assert_equals(s:get(key)[1], key)
+        end
+    end)
+end
+
+local function built_in_background(server, name)
+    return server:grep_log("Building primary key of space '" .. name ..
+                           "' in background") ~= nil
+end
+
+-- Primary keys of spaces recovered from the snapshot are built in
+-- background while the next space is being loaded. Check that all
+-- the spaces are recovered correctly.
+g.test_recovery = function(cg)
+    cg.server:restart({
+        box_cfg = {
+            memtx_use_mvcc_engine = cg.params.mvcc,
+            log_level = 'verbose',
+        },
+    })
+    check_spaces(cg.server)
+    for i = 1, 4 do
+        t.assert(built_in_background(cg.server, 'test' .. i))
+    end
+end
+
+-- Recovery triggers may access any space, so a space primary key
+-- build must complete before they run. Spaces having triggers and
+-- spaces loaded right before them are built synchronously.
+g.test_recovery_triggers = function(cg)
+    local run_before_cfg = [[
+        local trigger = require('trigger')
+        rawset(_G, 'trigger_found', {})
+        trigger.set('box.space.test3.before_recovery_replace', 'test',
+                    function()
+                        table.insert(_G.trigger_found,
+                                     box.space.test1:get(42) ~= nil and
+                                     box.space.test2:get('42') ~= nil)
+                    end)
+    ]]
+    cg.server:restart({
+        env = {TARANTOOL_RUN_BEFORE_BOX_CFG = run_before_cfg},
+        box_cfg = {
+            memtx_use_mvcc_engine = cg.params.mvcc,
+            log_level = 'verbose',
+        },
+    })
+    check_spaces(cg.server)
+    t.assert(built_in_background(cg.server, 'test1'))
+    t.assert_not(built_in_background(cg.server, 'test2'))
+    t.assert_not(built_in_background(cg.server, 'test3'))
+    t.assert(built_in_background(cg.server, 'test4'))
+    cg.server:exec(function()
+        t.assert_equals(#_G.trigger_found, 10000)
+        for _, found in ipairs(_G.trigger_found) do
+            t.assert(found)
+        end
+    end)
+end
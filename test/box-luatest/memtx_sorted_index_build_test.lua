@@ -0,0 +1,150 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+-- Must be greater than MEMTX_DDL_SORT_MIN_TUPLES.
+local TUPLE_COUNT = 20000
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        -- Checks that the index contains the same tuples as the primary
+        -- key.
+        rawset(_G, 'check_index', function(index)
+            local s = box.space[index.space_id]
+            local expected = s:select({}, {fullscan = true})
+            table.sort(expected, function(a, b)
+                for _, part in ipairs(index.parts) do
+                    local fieldno = part.fieldno
+                    if a[fieldno] ~= b[fieldno] then
+                        return a[fieldno] < b[fieldno]
+                    end
+                end
+                return a[1] < b[1]
+            end)
+            t.assert_equals(index:select({}, {fullscan = true}), expected)
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(count)
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.begin()
+        for i = 1, count do
+            s:insert({i, (i * 7919) % count, 'str' .. i})
+        end
+        box.commit()
+    end, {TUPLE_COUNT})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_build = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        _G.check_index(s:create_index('sk1', {parts = {2, 'unsigned'}}))
+        _G.check_index(s:create_index('sk2', {parts = {3, 'string'},
+                                              unique = false}))
+        _G.check_index(s:create_index('sk3', {parts = {{3, 'string'},
+                                                       {2, 'unsigned'}},
+                                              hint = false}))
+        t.assert_equals(s.index.sk1:get(7919 % 20000), {1, 7919 % 20000,
+                                                       'str1'})
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function(count)
+        local s = box.space.test
+        s:replace({count, 7919, 'dup'})
+        t.assert_error_covers({
+            type = 'ClientError',
+            name = 'TUPLE_FOUND',
+        }, s.create_index, s, 'sk', {parts = {2, 'unsigned'}})
+        t.assert_equals(s.index.sk, nil)
+        t.assert_error_covers({
+            type = 'ClientError',
+            name = 'FIELD_TYPE',
+        }, s.create_index, s, 'sk', {parts = {3, 'unsigned'}})
+        t.assert_equals(s.index.sk, nil)
+    end, {TUPLE_COUNT})
+end
+
+g.test_nullable = function(cg)
+    cg.server:exec(function(count)
+        local s = box.space.test
+        local parts = {{2, 'unsigned', is_nullable = true}}
+        -- NULLs don't violate the unique constraint.
+        for i = 1, 3 do
+            s:replace({i, box.NULL, 'null' .. i})
+        end
+        local sk = s:create_index('sk', {parts = parts})
+        t.assert_equals(sk:count(), count)
+        t.assert_equals(#sk:select({box.NULL}), 3)
+        sk:drop()
+        -- The key parts are checked for duplicates, not the full tuple.
+        s:replace({count, 7919, 'dup'})
+        t.assert_error_covers({
+            type = 'ClientError',
+            name = 'TUPLE_FOUND',
+        }, s.create_index, s, 'sk', {parts = parts})
+        t.assert_equals(s.index.sk, nil)
+    end, {TUPLE_COUNT})
+end
+
+g.test_concurrent_changes = function(cg)
+    cg.server:exec(function(count)
+        local fiber = require('fiber')
+        local s = box.space.test
+        local f = fiber.new(s.create_index, s, 'sk',
+                            {parts = {{3, 'string'}}})
+        f:set_joinable(true)
+        local i = 0
+        while f:status() ~= 'dead' do
+            i = i + 1
+            local id = math.random(count * 2)
+            if i % 3 == 0 then
+                s:delete(id)
+            else
+                s:replace({id, i, 'new' .. id})
+            end
+            if i % 10 == 0 then
+                fiber.yield()
+            end
+        end
+        t.assert((f:join()))
+        t.assert_gt(i, 0)
+        _G.check_index(s.index.sk)
+    end, {TUPLE_COUNT})
+end
+
+g.test_concurrent_duplicate = function(cg)
+    cg.server:exec(function(count)
+        local fiber = require('fiber')
+        local s = box.space.test
+        local f = fiber.new(s.create_index, s, 'sk',
+                            {parts = {{3, 'string'}}})
+        f:set_joinable(true)
+        fiber.yield()
+        s:replace({count + 1, 0, 'str1'})
+        local ok, err = f:join()
+        t.assert_not(ok)
+        t.assert_covers(err:unpack(), {
+            type = 'ClientError',
+            name = 'TUPLE_FOUND',
+        })
+        t.assert_equals(s.index.sk, nil)
+    end, {TUPLE_COUNT})
+end
@@ -0,0 +1,158 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local function check(opts, reason)
+            t.assert_error_covers({
+                type = 'ClientError',
+                name = 'MODIFY_INDEX',
+                message = "Can't create or modify index 'sk' in space " ..
+                          "'test': " .. reason,
+            }, s.create_index, s, 'sk', opts)
+        end
+        local parts_reason = 'key_prefix layout requires the first key ' ..
+                             'part to be an ascending string without ' ..
+                             'collation'
+        check({layout = 'key_prefix', parts = {1, 'unsigned'}}, parts_reason)
+        check({layout = 'key_prefix',
+               parts = {{2, 'string', collation = 'unicode'}}}, parts_reason)
+        check({layout = 'key_prefix',
+               parts = {{2, 'string', sort_order = 'desc'}}}, parts_reason)
+        check({layout = 'key_prefix', hint = false, parts = {2, 'string'}},
+              'key_prefix layout requires hints')
+        check({layout = 'key_prefix', parts = {{'[2][*]', 'string'}}},
+              'key_prefix layout can\'t be used by multikey or ' ..
+              'functional index')
+        t.assert_error_covers({
+            type = 'ClientError',
+            name = 'UNSUPPORTED',
+            message = "memtx does not support 'layout' option",
+        }, s.create_index, s, 'sk', {type = 'hash', layout = 'key_prefix',
+                                     parts = {2, 'string'}})
+    end)
+end
+
+g.test_key_prefix = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {layout = 'key_prefix',
+                              parts = {{1, 'string'}, {2, 'unsigned'}}})
+        local sk = s:create_index('sk', {layout = 'key_prefix',
+                                         parts = {{3, 'string'}},
+                                         unique = false})
+        -- Strings sharing a prefix longer than a hint and a key prefix.
+        local base = string.rep('x', 20)
+        local keys = {}
+        for i = 1, 100 do
+            local key = base .. string.format('%03d', i)
+            table.insert(keys, key)
+            s:insert({key, i % 3, string.rep('y', i % 30)})
+        end
+        s:insert({'', 0, ''})
+        s:insert({base, 0, 'yy\0'})
+        s:insert({base .. '\0', 0, 'y'})
+        table.insert(keys, 1, base .. '\0')
+        table.insert(keys, 1, base)
+        table.insert(keys, 1, '')
+
+        local res = {}
+        for _, tuple in s:pairs() do
+            table.insert(res, tuple[1])
+        end
+        t.assert_equals(res, keys)
+        res = {}
+        for _, tuple in s:pairs({}, {iterator = 'REQ'}) do
+            table.insert(res, 1, tuple[1])
+        end
+        t.assert_equals(res, keys)
+
+        t.assert_equals(s:get({base .. '042', 0}), {base .. '042', 0,
+                                                    string.rep('y', 12)})
+        t.assert_equals(s:get({base .. '042', 1}), nil)
+        t.assert_equals(s:select({base .. '05'}, {iterator = 'GE',
+                                                  limit = 2}),
+                        {{base .. '050', 2, string.rep('y', 20)},
+                         {base .. '051', 0, string.rep('y', 21)}})
+        t.assert_equals(s:select({base}, {iterator = 'GT', limit = 1}),
+                        {{base .. '\0', 0, 'y'}})
+        t.assert_equals(s:select({base .. '100'}, {iterator = 'LT',
+                                                   limit = 1}),
+                        {{base .. '099', 0, string.rep('y', 9)}})
+        t.assert_equals(s:count({base .. '0'}, {iterator = 'GE'}), 100)
+
+        t.assert_equals(sk:count('y'), 5)
+        t.assert_equals(sk:select('yy\0'), {{base, 0, 'yy\0'}})
+        t.assert_equals(sk:count(string.rep('y', 20), {iterator = 'GT'}),
+                        27)
+
+        s:replace({base .. '042', 0, 'z'})
+        s:delete({base .. '043', 1})
+        t.assert_equals(s:get({base .. '043', 1}), nil)
+        t.assert_equals(sk:select('z'), {{base .. '042', 0, 'z'}})
+        t.assert_equals(s:count(), 102)
+    end)
+end
+
+g.test_nullable = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local sk = s:create_index('sk', {
+            layout = 'key_prefix', unique = false,
+            parts = {{2, 'string', is_nullable = true}},
+        })
+        s:insert({1, 'abc'})
+        s:insert({2})
+        s:insert({3, box.NULL})
+        s:insert({4, ''})
+        t.assert_equals(sk:select(), {{2}, {3, box.NULL}, {4, ''},
+                                      {1, 'abc'}})
+        t.assert_equals(sk:select(box.NULL), {{2}, {3, box.NULL}})
+        t.assert_equals(sk:select('', {iterator = 'GE'}), {{4, ''},
+                                                            {1, 'abc'}})
+    end)
+end
+
+g.test_alter = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local sk = s:create_index('sk', {parts = {2, 'string'}})
+        for i = 1, 50 do
+            s:insert({i, string.rep('a', 30) .. (100 - i)})
+        end
+        local expected = sk:select()
+        sk:alter({layout = 'key_prefix'})
+        t.assert_equals(box.space._index:get({s.id, sk.id}).opts.layout,
+                        'key_prefix')
+        t.assert_equals(sk:select(), expected)
+        local prefix = string.rep('a', 30)
+        t.assert_equals(sk:get(prefix .. 60), {40, prefix .. 60})
+        s:replace({40, prefix .. 10})
+        t.assert_equals(sk:get(prefix .. 60), nil)
+        t.assert_equals(sk:select(prefix .. 50, {iterator = 'LE'}),
+                        {{50, prefix .. 50}, {40, prefix .. 10}})
+    end)
+end
@@ -0,0 +1,159 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('space_field_offset_step', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_field_access = function(cg)
+    cg.server:exec(function(engine)
+        local format = {{'id', 'unsigned'}}
+        for i = 2, 150 do
+            table.insert(format, {'f' .. i, 'any', is_nullable = true})
+        end
+        local s = box.schema.space.create('test', {
+            engine = engine, format = format, field_offset_step = 8,
+        })
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{'f20', 'unsigned'}}})
+
+        -- Checks every field of a tuple both by number and by name.
+        local function check(tuple, data)
+            for i = 1, 200 do
+                t.assert_equals(tuple[i], data[i], 'field ' .. i)
+                if i <= #format then
+                    t.assert_equals(tuple[format[i][1]], data[i],
+                                    'field ' .. format[i][1])
+                end
+            end
+        end
+
+        local data = {}
+        for id = 1, 4 do
+            -- Tuples longer and shorter than the format, with fields
+            -- of different size.
+            local row = {id}
+            for i = 2, 90 * id / 2 + 10 do
+                row[i] = i % 3 == 0 and string.rep('x', i) or i * id
+            end
+            row[20] = id
+            data[id] = row
+            s:insert(row)
+        end
+        for id, row in ipairs(data) do
+            check(s:get(id), row)
+            check(s.index.sk:get(id), row)
+        end
+
+        -- Tuples inserted before the option is changed are still readable.
+        s:alter({field_offset_step = 3})
+        local extra = {5}
+        for i = 2, 150 do
+            extra[i] = box.NULL
+        end
+        extra[20] = 5
+        extra[151] = 'tail'
+        s:insert(extra)
+        for id, row in ipairs(data) do
+            check(s:get(id), row)
+        end
+        t.assert_equals(s:get(5)[151], 'tail')
+        t.assert_equals(s:get(5).f20, 5)
+        t.assert(s:get(5)[149] == nil)
+        s:alter({field_offset_step = 0})
+        t.assert_equals(box.space._space:get(s.id).flags, {})
+        check(s:get(4), data[4])
+    end, {cg.params.engine})
+end
+
+-- Checks that fields are decoded from the closest stored offset rather
+-- than from the tuple start: the error injection fails the latter.
+g.test_stored_offsets = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function(engine)
+        local format = {{'id', 'unsigned'}}
+        for i = 2, 150 do
+            table.insert(format, {'f' .. i, 'any', is_nullable = true})
+        end
+        local s = box.schema.space.create('test', {
+            engine = engine, format = format, field_offset_step = 8,
+        })
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{'f20', 'unsigned'}}})
+        local row = {}
+        for i = 1, 170 do
+            row[i] = i
+        end
+        s:insert(row)
+        local tuple = s:get(1)
+
+        box.error.injection.set('ERRINJ_TUPLE_FIELD', true)
+        local ok, err = pcall(function()
+            -- Indexed fields and fields following a stored offset.
+            t.assert_equals(tuple[1], 1)
+            t.assert_equals(tuple[20], 20)
+            for i = 9, 160 do
+                t.assert_equals(tuple[i], i, 'field ' .. i)
+            end
+            t.assert_equals(tuple.f9, 9)
+            t.assert_equals(tuple.f150, 150)
+            t.assert_equals(tuple['[100]'], 100)
+            -- Fields without a stored offset before them are decoded
+            -- from the tuple start.
+            for i = 2, 8 do
+                t.assert_equals(tuple[i], nil, 'field ' .. i)
+            end
+            t.assert_equals(tuple.f2, nil)
+            t.assert_equals(tuple[161], nil)
+        end)
+        box.error.injection.set('ERRINJ_TUPLE_FIELD', false)
+        if not ok then
+            error(err)
+        end
+
+        -- Without the option only indexed fields have offsets.
+        s:alter({field_offset_step = 0})
+        s:replace(row)
+        tuple = s:get(1)
+        box.error.injection.set('ERRINJ_TUPLE_FIELD', true)
+        ok, err = pcall(function()
+            t.assert_equals(tuple[20], 20)
+            t.assert_equals(tuple[9], nil)
+            t.assert_equals(tuple[100], nil)
+        end)
+        box.error.injection.set('ERRINJ_TUPLE_FIELD', false)
+        if not ok then
+            error(err)
+        end
+    end, {cg.params.engine})
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function(engine)
+        t.assert_error_msg_contains(
+            "options parameter 'field_offset_step' should be of type number",
+            box.schema.space.create, 'test',
+            {engine = engine, field_offset_step = 'x'})
+        t.assert_error_msg_contains(
+            "'field_offset_step' must be unsigned",
+            box.space._space.insert, box.space._space,
+            {600, 1, 'test', engine, 0, {field_offset_step = -1}, {}})
+    end, {cg.params.engine})
+end
@@ -0,0 +1,108 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('tuple_compare_typed', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks that an index returns tuples in the same order as a Lua sort
+-- using the reference comparison function.
+g.test_order = function(cg)
+    cg.server:exec(function(engine)
+        local uuid = require('uuid')
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        local parts = {
+            {
+                {2, 'string'}, {3, 'unsigned'},
+                {4, 'uuid', is_nullable = true},
+            },
+            {
+                {5, 'integer', sort_order = 'desc'}, {2, 'string'},
+            },
+            {
+                {4, 'uuid', is_nullable = true, sort_order = 'desc'},
+                {5, 'integer'}, {2, 'string'}, {1, 'unsigned'},
+            },
+        }
+        for i, p in ipairs(parts) do
+            s:create_index('sk' .. i, {parts = p, unique = false})
+        end
+        local uuids = {uuid.new(), uuid.new(), uuid.new()}
+        for i = 1, 200 do
+            local u = uuids[i % 4]
+            s:insert({i, 'k' .. i % 5, i % 7, u == nil and box.NULL or u,
+                      i % 9 - 4})
+        end
+        -- UUIDs are compared by their rank to avoid comparing cdata.
+        local sorted = table.copy(uuids)
+        table.sort(sorted)
+        local rank = {}
+        for i, u in ipairs(sorted) do
+            rank[u:str()] = i
+        end
+        local function field(tuple, fieldno)
+            local v = tuple[fieldno]
+            if fieldno == 4 and v ~= nil then
+                return rank[v:str()]
+            end
+            return v
+        end
+        local function cmp_field(a, b, desc)
+            local r
+            if a == b then
+                r = 0
+            elseif a == nil or b == nil then
+                r = a == nil and -1 or 1
+            else
+                r = a < b and -1 or 1
+            end
+            return desc and -r or r
+        end
+        for i, p in ipairs(parts) do
+            local expected = s:select()
+            table.sort(expected, function(a, b)
+                for _, part in ipairs(p) do
+                    local r = cmp_field(field(a, part[1]), field(b, part[1]),
+                                        part.sort_order == 'desc')
+                    if r ~= 0 then
+                        return r < 0
+                    end
+                end
+                return a[1] < b[1]
+            end)
+            local actual = s.index['sk' .. i]:select()
+            t.assert_equals(#actual, #expected)
+            for j = 1, #actual do
+                t.assert_equals(actual[j][1], expected[j][1],
+                                ('sk%d, position %d'):format(i, j))
+            end
+        end
+        -- Partial and full key lookups.
+        t.assert_equals(s.index.sk1:count({'k1', 6}), 6)
+        t.assert_equals(s.index.sk1:count({'k1', 6, uuids[1]}), 2)
+        t.assert_equals(s.index.sk1:count({'k1', 6, box.NULL}), 1)
+        t.assert_equals(s.index.sk2:count({0, 'k1'}), 4)
+        t.assert_equals(s.index.sk3:count({box.NULL}), 50)
+        local res = s.index.sk3:select({uuids[2], -2, 'k2', 2})
+        t.assert_equals(#res, 1)
+        t.assert_equals(res[1][1], 2)
+    end, {cg.params.engine})
+end
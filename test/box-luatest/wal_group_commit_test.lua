@@ -0,0 +1,113 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {wal_mode = 'fsync'}})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({
+            wal_group_commit_max_delay = 0,
+            wal_group_commit_max_size = 1024 * 1024,
+        })
+        box.space.test:truncate()
+        box.stat.reset()
+    end)
+end)
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        box.stat.reset()
+        local stat = box.stat.wal()
+        t.assert_equals(stat.syncs, 0)
+        t.assert_equals(stat.entries, 0)
+        t.assert_equals(stat.bytes, 0)
+        t.assert_equals(stat.batch, {entries = 0, bytes = 0})
+        t.assert_equals(stat.group_commit_delay, 0)
+
+        for i = 1, 10 do
+            box.space.test:insert({i})
+        end
+        stat = box.stat.wal()
+        t.assert_equals(stat.syncs, 10)
+        t.assert_equals(stat.entries, 10)
+        t.assert_gt(stat.bytes, 0)
+        t.assert_equals(stat.batch.entries, 1)
+        t.assert_equals(stat.batch.bytes, stat.bytes / 10)
+        t.assert_gt(stat.sync_time.avg, 0)
+        t.assert_ge(stat.sync_time.p99, stat.sync_time.p50)
+
+        box.stat.reset()
+        stat = box.stat.wal()
+        t.assert_equals(stat.syncs, 0)
+        t.assert_equals(stat.entries, 0)
+        t.assert_equals(stat.bytes, 0)
+        -- The average sync time is used for computing the delay
+        -- so it isn't reset.
+        t.assert_gt(stat.sync_time.avg, 0)
+    end)
+end
+
+g.test_group_commit = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        box.cfg({wal_group_commit_max_delay = 10})
+        local stat = box.stat.wal()
+        -- The delay never exceeds the average sync time.
+        t.assert_gt(stat.group_commit_delay, 0)
+        t.assert_equals(stat.group_commit_delay, stat.sync_time.avg)
+
+        box.stat.reset()
+        local fibers = {}
+        for i = 1, 100 do
+            local f = fiber.new(box.space.test.insert, box.space.test, {i})
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            t.assert(f:join())
+        end
+        t.assert_equals(box.space.test:count(), 100)
+        stat = box.stat.wal()
+        t.assert_equals(stat.entries, 100)
+        t.assert_lt(stat.syncs, 100)
+        t.assert_gt(stat.batch.entries, 1)
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'wal_group_commit_max_delay': " ..
+            "the value must be >= 0",
+            box.cfg, {wal_group_commit_max_delay = -1})
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'wal_group_commit_max_size': " ..
+            "the value must be > 0",
+            box.cfg, {wal_group_commit_max_size = 0})
+        box.cfg({
+            wal_group_commit_max_delay = 0.01,
+            wal_group_commit_max_size = 1,
+        })
+        t.assert_equals(box.cfg.wal_group_commit_max_delay, 0.01)
+        t.assert_equals(box.cfg.wal_group_commit_max_size, 1)
+        -- Every write exceeds the size threshold.
+        box.stat.reset()
+        for i = 1, 10 do
+            box.space.test:insert({i})
+        end
+        t.assert_equals(box.stat.wal().syncs, 10)
+    end)
+end
@@ -0,0 +1,110 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            wal_max_size = 1024,
+            wal_spare_files = 2,
+        },
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        rawset(_G, 'spare_files', function()
+            local fio = require('fio')
+            local files = fio.glob(fio.pathjoin(box.cfg.wal_dir,
+                                                'spare.*.xlog.inprogress'))
+            table.sort(files)
+            for i, path in ipairs(files) do
+                files[i] = fio.basename(path)
+            end
+            return files
+        end)
+        rawset(_G, 'xlog_count', function()
+            local fio = require('fio')
+            return #fio.glob(fio.pathjoin(box.cfg.wal_dir, '*.xlog'))
+        end)
+    end)
+end)
+
+g.test_rotate = function(cg)
+    cg.server:exec(function()
+        t.helpers.retrying({}, function()
+            t.assert_equals(#_G.spare_files(), 2)
+        end)
+        -- Every write exceeds wal_max_size so the next one rotates WAL.
+        box.space.test:insert({1, string.rep('x', 1024)})
+        t.helpers.retrying({}, function()
+            t.assert_equals(#_G.spare_files(), 2)
+        end)
+        local spare_files = _G.spare_files()
+        local xlog_count = _G.xlog_count()
+        box.space.test:insert({2, string.rep('x', 1024)})
+        t.assert_equals(_G.xlog_count(), xlog_count + 1)
+        -- The first spare file has been taken over and a new one
+        -- has been created instead.
+        t.helpers.retrying({}, function()
+            local files = _G.spare_files()
+            t.assert_equals(#files, 2)
+            t.assert_equals(files[1], spare_files[2])
+        end)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:count(), 2)
+        t.assert_equals(box.space.test:get(2)[2], string.rep('x', 1024))
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'wal_spare_files': " ..
+            "the value must be >= 0",
+            box.cfg, {wal_spare_files = -1})
+        box.cfg({wal_spare_files = 1})
+        t.assert_equals(box.cfg.wal_spare_files, 1)
+        t.helpers.retrying({}, function()
+            t.assert_equals(#_G.spare_files(), 1)
+        end)
+        box.cfg({wal_spare_files = 0})
+        t.helpers.retrying({}, function()
+            t.assert_equals(_G.spare_files(), {})
+        end)
+    end)
+end
+
+-- Spare files are deleted first if WAL runs out of disk space.
+g.test_no_space = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        box.cfg({wal_spare_files = 2})
+        local s = box.schema.space.create('no_space')
+        s:create_index('pk')
+        t.helpers.retrying({}, function()
+            t.assert_equals(#_G.spare_files(), 2)
+        end)
+        box.error.injection.set('ERRINJ_WAL_FALLOCATE', 1)
+        s:insert({1})
+        t.assert_equals(box.error.injection.get('ERRINJ_WAL_FALLOCATE'), 0)
+        t.assert_equals(s:get(1), {1})
+        s:drop()
+    end)
+    t.assert(cg.server:grep_log(
+        'ran out of disk space, deleted a spare WAL file'))
+    t.assert_not(cg.server:grep_log(
+        'ran out of disk space, try to delete old WAL files'))
+end
@@ -6,7 +6,7 @@ local socket = require('socket')
 local fio = require('fio')
 local uuid = require('uuid')
 local msgpack = require('msgpack')
-test:plan(116)
+test:plan(131)
 
 --------------------------------------------------------------------------------
 -- Invalid values
@@ -49,12 +49,27 @@ invalid('vinyl_run_size_ratio', 1)
 invalid('vinyl_bloom_fpr', 0)
 invalid('vinyl_bloom_fpr', 1.1)
 invalid('wal_queue_max_size', -1)
+invalid('wal_group_commit_max_delay', -1)
+invalid('wal_group_commit_max_size', 0)
+invalid('wal_group_commit_max_size', -1)
+invalid('wal_spare_files', -1)
 invalid('memtx_sort_threads', 'all')
 invalid('memtx_sort_threads', -1)
 invalid('memtx_sort_threads', 0)
 invalid('memtx_sort_threads', 257)
+invalid('memtx_memory_huge_pages', '4K')
+invalid('memtx_memory_numa', 'local')
+invalid('memtx_memory_numa_nodes', -1)
+invalid('memtx_memory_numa_nodes', 64)
+invalid('memtx_memory_numa_nodes', {0, 1.5})
+invalid('memtx_defrag_rate', -1)
+invalid('memtx_defrag_threshold', -0.1)
+invalid('memtx_defrag_threshold', 1.5)
+invalid('memtx_checkpoint_delta_count', -1)
 invalid('app_threads', -1)
 invalid('app_threads', 1001)
+invalid('app_threads_read_view_staleness', -1)
+invalid('iproto_ev_backend', 'kqueue')
 invalid('replication_synchro_queue_max_size', -1)
 invalid('replication_reconnect_timeout', -1)
 invalid('replication_synchro_quorum', 'N - Q + 1')
@@ -258,6 +258,8 @@ local function check_stats(stat)
         sub:is(stat.box[op].total, val.total,
                string.format('%s total is reported', op))
     end
+    -- Latency percentiles aren't reported.
+    net_stat.LATENCY = nil
     for op, val in pairs(net_stat) do
         sub:is(stat.net[op].total, val.total,
                string.format('%s total is reported', op))
@@ -268,7 +268,9 @@ g.test_defaults = function()
                 client = box.NULL,
             },
             threads = 1,
+            ev_backend = 'auto',
             net_msg_max = 768,
+            connection_latency = false,
             readahead = 16320,
         },
         process = {
@@ -291,6 +293,8 @@ g.test_defaults = function()
             read_threads = 1,
             write_threads = 4,
             cache = 134217728,
+            page_cache = 0,
+            bloom_partition_cache = 134217728,
             defer_deletes = false,
             memory = 134217728,
             timeout = 60,
@@ -339,6 +343,9 @@ g.test_defaults = function()
             max_size = 268435456,
             dir_rescan_delay = 2,
             queue_max_size = 16777216,
+            group_commit_max_delay = 0,
+            group_commit_max_size = 1048576,
+            spare_files = 0,
             retention_period = is_enterprise and 0 or nil,
         },
         console = {
@@ -348,6 +355,9 @@ g.test_defaults = function()
         lua = {memory = 2147483648},
         memtx = {
             memory = 268435456,
+            memory_huge_pages = 'none',
+            memory_numa = 'default',
+            memory_numa_nodes = box.NULL,
             allocator = 'small',
             slab_alloc_granularity = 8,
             slab_alloc_factor = 1.05,
@@ -355,6 +365,9 @@ g.test_defaults = function()
             max_tuple_size = 1048576,
             sort_threads = box.NULL,
             use_sort_data = false,
+            defrag_rate = 0,
+            defrag_threshold = 0.3,
+            checkpoint_delta_count = 0,
         },
         config = {
             reload = 'auto',
@@ -477,6 +477,8 @@ g.test_remaining_vinyl_options = function()
           read_threads: 11
           write_threads: 22
           cache: 111111111
+          page_cache: 33333333
+          bloom_partition_cache: 44444444
           defer_deletes: true
           memory: 222222222
           timeout: 7.5
@@ -505,6 +507,8 @@ g.test_remaining_vinyl_options = function()
         t.assert_equals(box.cfg.vinyl_read_threads, 11)
         t.assert_equals(box.cfg.vinyl_write_threads, 22)
         t.assert_equals(box.cfg.vinyl_cache, 111111111)
+        t.assert_equals(box.cfg.vinyl_page_cache, 33333333)
+        t.assert_equals(box.cfg.vinyl_bloom_partition_cache, 44444444)
         t.assert_equals(box.cfg.vinyl_defer_deletes, true)
         t.assert_equals(box.cfg.vinyl_memory, 222222222)
         t.assert_equals(box.cfg.vinyl_timeout, 7.5)
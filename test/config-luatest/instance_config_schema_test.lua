@@ -447,7 +447,9 @@ g.test_iproto = function()
                 },
             },
             threads = 1,
+            ev_backend = 'io_uring',
             net_msg_max = 1,
+            connection_latency = true,
             readahead = 1,
         },
     }
@@ -459,7 +461,9 @@ g.test_iproto = function()
             client = box.NULL,
         },
         threads = 1,
+        ev_backend = 'auto',
         net_msg_max = 768,
+        connection_latency = false,
         readahead = 16320,
     }
     local res = instance_config:apply_default({}).iproto
@@ -514,7 +518,9 @@ g.test_iproto_enterprise = function()
                 },
             },
             threads = 1,
+            ev_backend = 'io_uring',
             net_msg_max = 1,
+            connection_latency = true,
             readahead = 1,
             ssl = {
                 ssl_key = 'one',
@@ -534,7 +540,9 @@ g.test_iproto_enterprise = function()
             client = box.NULL,
         },
         threads = 1,
+        ev_backend = 'auto',
         net_msg_max = 768,
+        connection_latency = false,
         readahead = 16320,
     }
     local res = instance_config:apply_default({}).iproto
@@ -990,6 +998,9 @@ g.test_memtx = function()
     local iconfig = {
         memtx = {
             memory = 1,
+            memory_huge_pages = '2M',
+            memory_numa = 'interleave',
+            memory_numa_nodes = {0, 1},
             allocator = 'small',
             slab_alloc_granularity = 1,
             slab_alloc_factor = 1,
@@ -997,6 +1008,9 @@ g.test_memtx = function()
             max_tuple_size = 1,
             sort_threads = 1,
             use_sort_data = true,
+            defrag_rate = 1000,
+            defrag_threshold = 0.5,
+            checkpoint_delta_count = 2,
         },
     }
     instance_config:validate(iconfig)
@@ -1004,6 +1018,9 @@ g.test_memtx = function()
 
     local exp = {
         memory = 268435456,
+        memory_huge_pages = 'none',
+        memory_numa = 'default',
+        memory_numa_nodes = box.NULL,
         allocator = 'small',
         slab_alloc_granularity = 8,
         slab_alloc_factor = 1.05,
@@ -1011,6 +1028,9 @@ g.test_memtx = function()
         max_tuple_size = 1048576,
         sort_threads = box.NULL,
         use_sort_data = false,
+        defrag_rate = 0,
+        defrag_threshold = 0.3,
+        checkpoint_delta_count = 0,
     }
     local res = instance_config:apply_default({}).memtx
     t.assert_equals(res, exp)
@@ -1029,6 +1049,8 @@ g.test_vinyl = function()
             read_threads = 7,
             write_threads = 9,
             cache = 10,
+            page_cache = 12,
+            bloom_partition_cache = 13,
             defer_deletes = true,
             memory = 11,
             timeout = 5.5,
@@ -1048,6 +1070,8 @@ g.test_vinyl = function()
         read_threads = 1,
         write_threads = 4,
         cache = 134217728,
+        page_cache = 0,
+        bloom_partition_cache = 134217728,
         defer_deletes = false,
         memory = 134217728,
         timeout = 60,
@@ -1065,6 +1089,9 @@ g.test_wal = function()
             max_size = 1,
             dir_rescan_delay = 1,
             queue_max_size = 1,
+            group_commit_max_delay = 1,
+            group_commit_max_size = 1,
+            spare_files = 1,
             cleanup_delay = 1,
         },
     }
@@ -1077,6 +1104,9 @@ g.test_wal = function()
         max_size = 268435456,
         dir_rescan_delay = 2,
         queue_max_size = 16777216,
+        group_commit_max_delay = 0,
+        group_commit_max_size = 1048576,
+        spare_files = 0,
     }
     local res = instance_config:apply_default({}).wal
     t.assert_equals(res, exp)
@@ -1091,6 +1121,9 @@ g.test_wal_enterprise = function()
             max_size = 1,
             dir_rescan_delay = 1,
             queue_max_size = 1,
+            group_commit_max_delay = 1,
+            group_commit_max_size = 1,
+            spare_files = 1,
             cleanup_delay = 1,
             retention_period = 1,
             ext = {
@@ -1114,6 +1147,9 @@ g.test_wal_enterprise = function()
         max_size = 268435456,
         dir_rescan_delay = 2,
         queue_max_size = 16777216,
+        group_commit_max_delay = 0,
+        group_commit_max_size = 1048576,
+        spare_files = 0,
         retention_period = 0,
     }
     local res = instance_config:apply_default({}).wal
@@ -1460,6 +1496,10 @@ g.test_box_cfg_coverage = function()
         listen = true,
         app_threads = true,
 
+        -- Application threads are configured in the threads
+        -- section, which can't be reloaded yet.
+        app_threads_read_view_staleness = true,
+
         -- Controlled by the leader and database.mode options,
         -- handled by the box_cfg applier.
         read_only = true,
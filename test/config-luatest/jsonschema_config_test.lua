@@ -93,6 +93,8 @@ g.test_json_schema_section_from_config = function()
                 },
                 type = 'object',
             },
+            group_commit_max_delay = {default = 0, type = 'number'},
+            group_commit_max_size = {default = 1048576, type = 'integer'},
             max_size = {default = 268435456, type = 'integer'},
             mode = {
                 default = 'write',
@@ -101,6 +103,7 @@ g.test_json_schema_section_from_config = function()
             },
             queue_max_size = {default = 16777216, type = 'integer'},
             retention_period = {default = 0, type = 'number'},
+            spare_files = {default = 0, type = 'integer'},
         },
         type = 'object',
     }
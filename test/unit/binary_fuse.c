@@ -0,0 +1,104 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "salad/binary_fuse.h"
+#include "trivia/util.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+static uint32_t
+h(uint32_t i)
+{
+	return i * 2654435761U;
+}
+
+/**
+ * Check that a filter has no false negatives and its false positive
+ * rate is close to the expected one for sets of different sizes.
+ */
+static void
+test_fpr(void)
+{
+	plan(3);
+	header();
+
+	int error_count = 0;
+	int fp_rate_too_big = 0;
+	int build_failures = 0;
+	for (double p = 0.001; p < 0.5; p *= 1.7) {
+		for (uint32_t count = 0; count <= 30000;
+		     count = count == 0 ? 1 : count * 3) {
+			uint32_t *values = xmalloc((count + 1) *
+						   sizeof(*values));
+			for (uint32_t i = 0; i < count; i++)
+				values[i] = h(rand() % (count * 10) * 2);
+			struct binary_fuse filter;
+			binary_fuse_create(&filter, count, p);
+			void *data = xcalloc(1, binary_fuse_data_size(&filter));
+			if (binary_fuse_build(&filter, data, values,
+					      count) != 0)
+				build_failures++;
+			for (uint32_t i = 0; i < count; i++) {
+				if (!binary_fuse_maybe_has(&filter, data,
+							   values[i]))
+					error_count++;
+			}
+			uint32_t tests = 100000;
+			uint32_t false_positive = 0;
+			for (uint32_t i = 0; i < tests; i++) {
+				if (binary_fuse_maybe_has(&filter, data,
+							  h(i * 2 + 1)))
+					false_positive++;
+			}
+			double fp_rate = (double)false_positive / tests;
+			if (fp_rate > binary_fuse_fpr(&filter) * 1.2 + 0.001 ||
+			    fp_rate > p + 0.001)
+				fp_rate_too_big++;
+			free(data);
+			free(values);
+		}
+	}
+	is(build_failures, 0, "filters are built");
+	is(error_count, 0, "no false negatives");
+	is(fp_rate_too_big, 0, "false positive rate isn't higher than "
+	   "expected");
+
+	footer();
+	check_plan();
+}
+
+/** Check that a binary fuse filter is smaller than a bloom filter. */
+static void
+test_size(void)
+{
+	plan(1);
+	header();
+
+	uint32_t count = 100000;
+	struct binary_fuse filter;
+	binary_fuse_create(&filter, count, 0.01);
+	/* A bloom filter needs 1.44 * log2(1 / fpr) bits per value. */
+	size_t bloom_size = count * 1.44 * 7 / 8;
+	ok(binary_fuse_data_size(&filter) < bloom_size * 0.85,
+	   "size %zu, bloom size %zu", binary_fuse_data_size(&filter),
+	   bloom_size);
+
+	footer();
+	check_plan();
+}
+
+int
+main(void)
+{
+	plan(2);
+	header();
+
+	srand(time(NULL));
+	test_fpr();
+	test_size();
+
+	footer();
+	return check_plan();
+}
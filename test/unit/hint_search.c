@@ -0,0 +1,148 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "salad/hint_search.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+/** Tree element layout: a pointer interleaved with a hint. */
+struct elem {
+	void *ptr;
+	uint64_t hint;
+};
+
+enum { MAX_COUNT = 70 };
+
+/**
+ * Fill the array with sorted hints starting from `base`, replacing
+ * some of them with unknown hints.
+ */
+static void
+fill(struct elem *arr, size_t count, uint64_t base)
+{
+	uint64_t hint = base;
+	for (size_t i = 0; i < count; i++) {
+		hint += rand() % 3;
+		arr[i].ptr = NULL;
+		arr[i].hint = rand() % 7 == 0 ? HINT_SEARCH_NONE : hint;
+	}
+}
+
+/** Reference implementation of hint_search_range(). */
+static void
+range_ref(const struct elem *arr, size_t count, uint64_t hint,
+	  size_t *begin, size_t *end)
+{
+	*begin = 0;
+	*end = count;
+	for (size_t i = 0; i < count; i++) {
+		if (arr[i].hint == HINT_SEARCH_NONE)
+			continue;
+		if (arr[i].hint < hint)
+			*begin = i + 1;
+		else if (arr[i].hint > hint && *end == count)
+			*end = i;
+	}
+}
+
+/**
+ * Check that the range returned by the given implementation is the whole
+ * array for the generic implementation and the exact range for the others.
+ */
+static void
+test_range(enum hint_search_impl impl, hint_search_range_f f, uint64_t base)
+{
+	int errors = 0;
+	struct elem arr[MAX_COUNT];
+	for (int i = 0; i < 100000; i++) {
+		size_t count = rand() % MAX_COUNT;
+		fill(arr, count, base);
+		uint64_t hint = base + rand() % (count + 3);
+		size_t begin, end, ref_begin, ref_end;
+		f(&arr[0].hint, count, 2, hint, &begin, &end);
+		if (impl == HINT_SEARCH_GENERIC) {
+			ref_begin = 0;
+			ref_end = count;
+		} else {
+			range_ref(arr, count, hint, &ref_begin, &ref_end);
+		}
+		if (begin != ref_begin || end != ref_end)
+			errors++;
+	}
+	is(errors, 0, "%s: no errors, base %llu", hint_search_impl_strs[impl],
+	   (unsigned long long)base);
+}
+
+/**
+ * Check that a stride other than 2 is supported: the range may be left
+ * as is, but mustn't exclude matching elements.
+ */
+static void
+test_stride(enum hint_search_impl impl, hint_search_range_f f)
+{
+	uint64_t hints[] = {1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4};
+	size_t begin, end;
+	f(hints, 4, 3, 3, &begin, &end);
+	ok(begin <= 2 && end >= 3 && end <= 4, "%s: range [%zu, %zu)",
+	   hint_search_impl_strs[impl], begin, end);
+}
+
+/** Run the tests for each implementation supported by the CPU. */
+static void
+test_impl(enum hint_search_impl impl)
+{
+	plan(3);
+	header();
+
+	hint_search_range_f f = hint_search_range_impl(impl);
+	if (f == NULL) {
+		for (int i = 0; i < 3; i++) {
+			ok(true, "# skip; %s isn't supported by the CPU",
+			   hint_search_impl_strs[impl]);
+		}
+	} else {
+		test_range(impl, f, 0);
+		/* Check that hints are compared as unsigned. */
+		test_range(impl, f, INT64_MAX - MAX_COUNT);
+		test_stride(impl, f);
+	}
+
+	footer();
+	check_plan();
+}
+
+/** Check that hint_search_init() selects a supported implementation. */
+static void
+test_init(void)
+{
+	plan(1);
+	header();
+
+	hint_search_init();
+	hint_search_range_f best = NULL;
+	for (int i = 0; i < hint_search_impl_MAX && best == NULL; i++) {
+		best = hint_search_range_impl(
+			(enum hint_search_impl)(hint_search_impl_MAX - 1 - i));
+	}
+	ok(hint_search_range == best, "the best implementation is selected");
+
+	footer();
+	check_plan();
+}
+
+int
+main(void)
+{
+	plan(hint_search_impl_MAX + 1);
+	header();
+
+	srand(time(NULL));
+	for (int i = 0; i < hint_search_impl_MAX; i++)
+		test_impl((enum hint_search_impl)i);
+	test_init();
+
+	footer();
+	return check_plan();
+}
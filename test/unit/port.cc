@@ -736,10 +736,52 @@ test_port_c_get_c_entries(void)
 	check_plan();
 }
 
+/**
+ * Checks that a port consisting only of tuples, like the one filled by
+ * box_select(), is dumped correctly, including tuples that don't fit in
+ * the initial output buffer chunk.
+ */
+static void
+test_port_c_dump_tuples(void)
+{
+	plan(2);
+	header();
+
+	static char str[1500];
+	memset(str, 'c', sizeof(str));
+	static char tuple_buf[2048];
+	static char buf[4096];
+	char *mp = buf;
+	mp = mp_encode_array(mp, 3);
+
+	struct port port;
+	port_c_create(&port);
+	uint32_t str_lens[] = {0, 10, sizeof(str)};
+	for (size_t i = 0; i < lengthof(str_lens); i++) {
+		char *tuple_end = tuple_buf;
+		tuple_end = mp_encode_array(tuple_end, 2);
+		tuple_end = mp_encode_uint(tuple_end, i);
+		tuple_end = mp_encode_str(tuple_end, str, str_lens[i]);
+		fail_if(tuple_end > tuple_buf + lengthof(tuple_buf));
+		struct tuple *tuple = tuple_new(tuple_format_runtime,
+						tuple_buf, tuple_end);
+		port_c_add_tuple(&port, tuple);
+		memcpy(mp, tuple_buf, tuple_end - tuple_buf);
+		mp += tuple_end - tuple_buf;
+	}
+	fail_if(mp > buf + lengthof(buf));
+
+	test_check_port_dump_msgpack(&port, buf, mp - buf, /*no_header=*/true);
+	port_destroy(&port);
+
+	footer();
+	check_plan();
+}
+
 static void
 test_port_c(void)
 {
-	plan(3);
+	plan(4);
 	header();
 
 	/* Initialize long and medium strings used in the tests. */
@@ -763,6 +805,7 @@ test_port_c(void)
 	test_port_c_dump_lua();
 	test_port_c_all_msgpack_methods();
 	test_port_c_get_c_entries();
+	test_port_c_dump_tuples();
 
 	/* Deinitialize mp_ctx used in port_c tests. */
 	mp_ctx_destroy(&test_port_c_mp_ctx);
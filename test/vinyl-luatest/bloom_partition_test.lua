@@ -0,0 +1,188 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            -- Disable the tuple cache to force reads from disk.
+            vinyl_cache = 0,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for _, value in ipairs({-1, 2^32}) do
+            t.assert_error_covers({
+                type = 'ClientError',
+                name = 'WRONG_INDEX_OPTIONS',
+                message = "Wrong index options: bloom_partition_pages " ..
+                          "must be greater than or equal to 0 and less " ..
+                          "than 2^32",
+            }, s.create_index, s, 'sk', {bloom_partition_pages = value})
+        end
+        t.assert_error_msg_equals(
+            "options parameter 'bloom_partition_pages' should be of " ..
+            "type number",
+            s.create_index, s, 'sk', {bloom_partition_pages = 'x'})
+    end)
+end
+
+g.test_lookup = function(cg)
+    cg.server:exec(function()
+        local digest = require('digest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {
+            parts = {{1, 'unsigned'}, {2, 'unsigned'}},
+            page_size = 1024,
+            bloom_partition_pages = 2,
+        })
+        t.assert_equals(pk.options.bloom_partition_pages, 2)
+        t.assert_equals(box.space._index:get({s.id, 0}).opts
+                        .bloom_partition_pages, 2)
+        for i = 1, 200 do
+            -- Use random padding to make compression ineffective.
+            s:insert({i * 2, i % 3, digest.urandom(100)})
+        end
+        box.snapshot()
+        t.assert_gt(pk:stat().disk.pages, 4)
+
+        local function bloom_hits()
+            return pk:stat().disk.iterator.bloom.hit
+        end
+        local function bloom_size()
+            return box.stat.vinyl().memory.bloom_filter
+        end
+        -- Partitions are loaded on demand. A key less than the run
+        -- min key doesn't need any.
+        local size = bloom_size()
+        t.assert_equals(s:get({0, 0}), nil)
+        t.assert_equals(bloom_size(), size)
+        t.assert_not_equals(s:get({200, 1}), nil)
+        t.assert_gt(bloom_size(), size)
+
+        -- Missing keys are filtered out.
+        for i = 1, 200 do
+            t.assert_equals(s:get({i * 2 + 1, i % 3}), nil)
+            t.assert_not_equals(s:get({i * 2, i % 3}), nil)
+        end
+        t.assert_ge(bloom_hits(), 150)
+        size = bloom_size()
+        t.assert_ge(box.info.memory().index, size)
+
+        -- Key prefixes are checked by EQ and REQ iterators.
+        local hits = bloom_hits()
+        for i = 1, 100 do
+            t.assert_equals(s:select({i * 2 + 1}), {})
+            t.assert_equals(s:select({i * 2 + 1}, {iterator = 'req'}), {})
+        end
+        t.assert_ge(bloom_hits() - hits, 150)
+        t.assert_equals(#s:select({20}, {iterator = 'req'}), 1)
+        t.assert_equals(s:select({20}, {iterator = 'req'})[1][1], 20)
+        t.assert_equals(bloom_size(), size)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        local size = box.stat.vinyl().memory.bloom_filter
+        for i = 1, 200 do
+            t.assert_equals(s:get({i * 2 + 1, i % 3}), nil)
+            t.assert_equals(s:get({i * 2, i % 3})[1], i * 2)
+        end
+        t.assert_gt(box.stat.vinyl().memory.bloom_filter, size)
+        t.assert_ge(s.index.pk:stat().disk.iterator.bloom.hit, 150)
+    end)
+end
+
+g.test_alter = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {page_size = 1024,
+                                         run_count_per_level = 10})
+        for i = 1, 100 do
+            s:insert({i * 2})
+        end
+        box.snapshot()
+        local size = pk:stat().bloom_size
+        t.assert_gt(size, 0)
+
+        -- The new option is applied to new runs.
+        pk:alter({bloom_partition_pages = 1})
+        t.assert_equals(pk.options.bloom_partition_pages, 1)
+        for i = 101, 200 do
+            s:insert({i * 2})
+        end
+        box.snapshot()
+        t.assert_equals(pk:stat().run_count, 2)
+        for i = 1, 200 do
+            t.assert_equals(s:get(i * 2), {i * 2})
+            t.assert_equals(s:get(i * 2 + 1), nil)
+        end
+
+        -- Compaction builds a run-wide filter again.
+        pk:alter({bloom_partition_pages = 0})
+        t.assert_equals(pk.options.bloom_partition_pages, nil)
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().run_count, 1)
+        end)
+        t.assert_equals(s:get(100), {100})
+        t.assert_equals(s:get(101), nil)
+        t.assert_equals(s:count(), 200)
+    end)
+end
+
+g.test_cache_quota = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {page_size = 1024,
+                                         bloom_partition_pages = 1})
+        for i = 1, 200 do
+            s:insert({i * 2, string.rep('x', 50)})
+        end
+        box.snapshot()
+        t.assert_gt(pk:stat().disk.pages, 4)
+
+        local function bloom_size()
+            return box.stat.vinyl().memory.bloom_filter
+        end
+        local function check_lookups()
+            for i = 1, 200 do
+                t.assert_equals(s:get(i * 2)[1], i * 2)
+                t.assert_equals(s:get(i * 2 + 1), nil)
+            end
+        end
+        local base_size = bloom_size()
+        check_lookups()
+        local full_size = bloom_size()
+        t.assert_gt(full_size, base_size)
+
+        -- Only the most recently used partition is kept.
+        box.cfg{vinyl_bloom_partition_cache = 1}
+        local size = bloom_size()
+        t.assert_lt(size, full_size)
+        check_lookups()
+        t.assert_lt(bloom_size(), full_size)
+
+        box.cfg{vinyl_bloom_partition_cache = 128 * 1024 * 1024}
+        check_lookups()
+        t.assert_gt(bloom_size(), size)
+    end)
+end
@@ -0,0 +1,147 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            -- Disable the tuple cache to force reads from disk.
+            vinyl_cache = 0,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        for _, name in ipairs({'test', 'test2'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        t.assert_error_covers({
+            type = 'ClientError',
+            name = 'WRONG_INDEX_OPTIONS',
+            message = "Wrong index options: bloom_type must be either " ..
+                      "'classic' or 'binary_fuse'",
+        }, s.create_index, s, 'sk', {bloom_type = 'ribbon'})
+        t.assert_error_msg_equals(
+            "options parameter 'bloom_type' should be of type string",
+            s.create_index, s, 'sk', {bloom_type = 1})
+    end)
+end
+
+g.test_lookup = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {
+            parts = {{1, 'unsigned'}, {2, 'unsigned'}},
+            bloom_type = 'binary_fuse',
+        })
+        t.assert_equals(pk.options.bloom_type, 'binary_fuse')
+        t.assert_equals(box.space._index:get({s.id, 0}).opts.bloom_type,
+                        'binary_fuse')
+        local s2 = box.schema.space.create('test2', {engine = 'vinyl'})
+        local pk2 = s2:create_index('pk', {
+            parts = {{1, 'unsigned'}, {2, 'unsigned'}},
+        })
+        t.assert_equals(pk2.options.bloom_type, nil)
+        for i = 1, 1000 do
+            s:insert({i * 2, i % 3})
+            s2:insert({i * 2, i % 3})
+        end
+        box.snapshot()
+
+        -- A binary fuse filter is smaller than a bloom filter.
+        t.assert_gt(pk:stat().bloom_size, 0)
+        t.assert_lt(pk:stat().bloom_size, pk2:stat().bloom_size)
+
+        -- Missing keys are filtered out, both full and partial.
+        for i = 1, 1000 do
+            t.assert_equals(s:get({i * 2 + 1, i % 3}), nil)
+            t.assert_equals(s:get({i * 2, i % 3}), {i * 2, i % 3})
+        end
+        t.assert_ge(pk:stat().disk.iterator.bloom.hit, 900)
+        local hits = pk:stat().disk.iterator.bloom.hit
+        for i = 1, 100 do
+            t.assert_equals(s:select({i * 2 + 1}), {})
+        end
+        t.assert_ge(pk:stat().disk.iterator.bloom.hit - hits, 90)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        for i = 1, 1000 do
+            t.assert_equals(s:get({i * 2 + 1, i % 3}), nil)
+            t.assert_equals(s:get({i * 2, i % 3}), {i * 2, i % 3})
+        end
+        t.assert_ge(s.index.pk:stat().disk.iterator.bloom.hit, 900)
+    end)
+end
+
+g.test_partitions = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {
+            page_size = 1024,
+            bloom_partition_pages = 2,
+            bloom_type = 'binary_fuse',
+        })
+        for i = 1, 1000 do
+            s:insert({i * 2, string.rep('x', 20)})
+        end
+        box.snapshot()
+        t.assert_gt(pk:stat().disk.pages, 4)
+        for i = 1, 1000 do
+            t.assert_equals(s:get(i * 2 + 1), nil)
+            t.assert_equals(s:get(i * 2)[1], i * 2)
+        end
+        t.assert_ge(pk:stat().disk.iterator.bloom.hit, 900)
+    end)
+end
+
+g.test_alter = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {run_count_per_level = 10})
+        for i = 1, 100 do
+            s:insert({i * 2})
+        end
+        box.snapshot()
+
+        -- The new option is applied to new runs.
+        pk:alter({bloom_type = 'binary_fuse'})
+        t.assert_equals(pk.options.bloom_type, 'binary_fuse')
+        for i = 101, 200 do
+            s:insert({i * 2})
+        end
+        box.snapshot()
+        t.assert_equals(pk:stat().run_count, 2)
+        for i = 1, 200 do
+            t.assert_equals(s:get(i * 2), {i * 2})
+            t.assert_equals(s:get(i * 2 + 1), nil)
+        end
+
+        pk:alter({bloom_type = 'classic'})
+        t.assert_equals(pk.options.bloom_type, nil)
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().run_count, 1)
+        end)
+        t.assert_equals(s:get(100), {100})
+        t.assert_equals(s:get(101), nil)
+        t.assert_equals(s:count(), 200)
+    end)
+end
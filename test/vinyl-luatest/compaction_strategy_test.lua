@@ -0,0 +1,127 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        t.assert_error_covers({
+            type = 'ClientError',
+            name = 'WRONG_INDEX_OPTIONS',
+            message = "Wrong index options: compaction_strategy must be " ..
+                      "one of 'leveled', 'tiered' or 'delete_aware'",
+        }, s.create_index, s, 'sk', {compaction_strategy = 'foo'})
+        t.assert_error_msg_equals(
+            "options parameter 'compaction_strategy' should be of " ..
+            "type string",
+            s.create_index, s, 'sk', {compaction_strategy = 1})
+    end)
+end
+
+g.test_tiered = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {compaction_strategy = 'tiered'})
+        local sk = s:create_index('sk', {parts = {{2, 'unsigned'}}})
+        t.assert_equals(pk.options.compaction_strategy, 'tiered')
+        t.assert_equals(sk.options.compaction_strategy, nil)
+        t.assert_equals(box.space._index:get({s.id, 0}).opts
+                        .compaction_strategy, 'tiered')
+        local pad = string.rep('x', 100)
+        local function dump(n)
+            for i = n * 100 + 1, n * 100 + 100 do
+                s:insert({i, i, pad})
+            end
+            box.snapshot()
+        end
+
+        -- Leveled compaction merges two runs of the same size, while
+        -- tiered compaction keeps both of them at the last level.
+        dump(0)
+        dump(1)
+        t.helpers.retrying({}, function()
+            t.assert_equals(sk:stat().disk.compaction.count, 1)
+        end)
+        t.assert_equals(sk:stat().run_count, 1)
+        t.assert_equals(pk:stat().disk.compaction.count, 0)
+        t.assert_equals(pk:stat().run_count, 2)
+
+        -- The last level is compacted once it has too many runs.
+        dump(2)
+        dump(3)
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().disk.compaction.count, 1)
+        end)
+        t.assert_le(pk:stat().run_count, 2)
+        t.assert_equals(pk:count(), 400)
+
+        -- The strategy can be changed on the fly.
+        pk:alter({compaction_strategy = 'leveled'})
+        t.assert_equals(pk.options.compaction_strategy, nil)
+        dump(4)
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().run_count, 1)
+        end)
+        t.assert_equals(pk:count(), 500)
+    end)
+end
+
+g.test_delete_aware = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {compaction_strategy = 'delete_aware'})
+        local sk = s:create_index('sk', {parts = {{2, 'unsigned'}}})
+        t.assert_equals(pk.options.compaction_strategy, 'delete_aware')
+        local pad = string.rep('x', 100)
+        for i = 1, 1000 do
+            s:insert({i, i, pad})
+        end
+        box.snapshot()
+
+        -- A few DELETE statements don't trigger compaction.
+        for i = 1, 100 do
+            s:delete(i)
+        end
+        box.snapshot()
+        t.assert_equals(pk:stat().run_count, 2)
+        t.assert_equals(pk:stat().disk.statement.deletes, 100)
+
+        -- Once DELETE statements may purge a considerable part of
+        -- the oldest run, the whole range is compacted. The leveled
+        -- secondary index isn't compacted, because DELETE statements
+        -- are small.
+        for i = 101, 400 do
+            s:delete(i)
+        end
+        box.snapshot()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().disk.compaction.count, 1)
+        end)
+        t.assert_equals(pk:stat().run_count, 1)
+        t.assert_equals(pk:stat().disk.statement.deletes, 0)
+        t.assert_equals(pk:stat().disk.rows, 600)
+        t.assert_equals(sk:stat().disk.compaction.count, 0)
+        t.assert_equals(sk:stat().run_count, 3)
+        t.assert_equals(s:count(), 600)
+    end)
+end
@@ -0,0 +1,152 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            -- One dump thread and four compaction threads.
+            vinyl_write_threads = 5,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for _, value in ipairs({0, -1}) do
+            t.assert_error_covers({
+                type = 'ClientError',
+                name = 'WRONG_INDEX_OPTIONS',
+                message = "Wrong index options: compaction_threads " ..
+                          "must be greater than 0",
+            }, s.create_index, s, 'sk', {compaction_threads = value})
+        end
+        t.assert_error_msg_equals(
+            "options parameter 'compaction_threads' should be of " ..
+            "type number",
+            s.create_index, s, 'sk', {compaction_threads = 'x'})
+    end)
+end
+
+g.test_split = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {
+            page_size = 1024,
+            compaction_threads = 3,
+        })
+        local sk = s:create_index('sk', {
+            unique = false,
+            parts = {{2, 'unsigned'}},
+            page_size = 1024,
+        })
+        t.assert_equals(pk.options.compaction_threads, 3)
+        t.assert_equals(sk.options.compaction_threads, nil)
+        t.assert_equals(box.space._index:get({s.id, 0}).opts
+                        .compaction_threads, 3)
+        local pad = string.rep('x', 100)
+        for i = 1, 2000 do
+            s:insert({i, i % 10, pad})
+        end
+        box.snapshot()
+        for i = 1, 2000, 2 do
+            s:replace({i, i % 10 + 1, pad})
+        end
+        box.snapshot()
+        t.assert_equals(pk:stat().run_count, 2)
+
+        -- The primary index compaction is split into parts, one run
+        -- per part. The secondary index is compacted as usual.
+        pk:compact()
+        sk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().disk.compaction.count, 1)
+            t.assert_equals(sk:stat().disk.compaction.count, 1)
+        end)
+        t.assert_equals(pk:stat().range_count, 1)
+        t.assert_equals(pk:stat().run_count, 3)
+        t.assert_equals(sk:stat().run_count, 1)
+
+        local function check()
+            t.assert_equals(s:count(), 2000)
+            local result = s:select({}, {fullscan = true})
+            t.assert_equals(#result, 2000)
+            for i = 1, 2000 do
+                t.assert_equals(result[i][1], i)
+                t.assert_equals(result[i][2], i % 10 + i % 2)
+            end
+            t.assert_equals(s:get(1)[2], 2)
+            t.assert_equals(s:get(2000)[2], 0)
+            t.assert_equals(s:get(2001), nil)
+            t.assert_equals(#s:select({1000}, {iterator = 'ge'}), 1001)
+            t.assert_equals(#s:select({1000}, {iterator = 'lt'}), 999)
+            t.assert_equals(sk:count(4), 400)
+        end
+        check()
+
+        -- The runs are accounted as one run by the compaction
+        -- policy so a dump doesn't trigger compaction.
+        s:replace({1, 1, pad})
+        box.snapshot()
+        t.assert_equals(pk:stat().run_count, 4)
+        t.assert_equals(pk:stat().disk.compaction.queue.rows, 0)
+        s:replace({1, 2, pad})
+        box.snapshot()
+        t.assert_equals(pk:stat().run_count, 5)
+        check()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        local pk = s.index.pk
+        t.assert_equals(pk:stat().run_count, 5)
+        t.assert_equals(pk:stat().disk.compaction.queue.rows, 0)
+        t.assert_equals(s:count(), 2000)
+        t.assert_equals(s:get(1)[2], 2)
+        t.assert_equals(s:get(3)[2], 4)
+        t.assert_equals(s:get(4)[2], 4)
+
+        -- Major compaction of a range with a split run.
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().disk.compaction.count, 1)
+        end)
+        t.assert_equals(pk:stat().run_count, 3)
+        t.assert_equals(s:count(), 2000)
+        t.assert_equals(s:get(1)[2], 2)
+        t.assert_equals(s:get(2000)[2], 0)
+
+        -- A single split run isn't compacted.
+        pk:compact()
+        t.assert_equals(pk:stat().disk.compaction.queue.rows, 0)
+
+        -- Compaction isn't split if compaction_threads is 1.
+        pk:alter({compaction_threads = 1})
+        t.assert_equals(pk.options.compaction_threads, nil)
+        s:replace({2, 2, string.rep('x', 100)})
+        box.snapshot()
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().disk.compaction.count, 2)
+        end)
+        t.assert_equals(pk:stat().run_count, 1)
+        t.assert_equals(s:count(), 2000)
+        t.assert_equals(s:get(2)[2], 2)
+    end)
+end
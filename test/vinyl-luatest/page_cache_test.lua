@@ -0,0 +1,109 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            -- Disable the tuple cache to force reads from disk.
+            vinyl_cache = 0,
+            vinyl_page_cache = 1024 * 1024,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local digest = require('digest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024, run_count_per_level = 10})
+        for i = 1, 100 do
+            -- Use random padding to make compression ineffective.
+            s:insert({i, digest.urandom(100)})
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        box.cfg{vinyl_page_cache = 1024 * 1024}
+    end)
+end)
+
+g.test_cache = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local function pages_read()
+            return s.index.pk:stat().disk.iterator.read.pages
+        end
+        t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+        local expected = s:select()
+        local pages = pages_read()
+        t.assert_gt(pages, 1)
+        local size = box.stat.vinyl().memory.page_cache
+        t.assert_gt(size, 0)
+        t.assert_ge(box.info.memory().cache, size)
+
+        -- Cached pages aren't read from disk.
+        t.assert_equals(s:select(), expected)
+        for i = 1, 100 do
+            t.assert_equals(s:get(i), expected[i])
+        end
+        t.assert_equals(s:select({50}, {iterator = 'le'}),
+                        s:select({50}, {iterator = 'req'}))
+        t.assert_equals(pages_read(), pages)
+        t.assert_equals(box.stat.vinyl().memory.page_cache, size)
+
+        -- Shrinking the cache evicts pages.
+        box.cfg{vinyl_page_cache = size / 2}
+        t.assert_le(box.stat.vinyl().memory.page_cache, size / 2)
+        t.assert_equals(s:select(), expected)
+        t.assert_gt(pages_read(), pages)
+        t.assert_le(box.stat.vinyl().memory.page_cache, size / 2)
+
+        -- Zero disables the cache.
+        box.cfg{vinyl_page_cache = 0}
+        t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+        pages = pages_read()
+        t.assert_equals(s:select(), expected)
+        t.assert_equals(s:select(), expected)
+        t.assert_gt(pages_read(), pages + 1)
+        t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+    end)
+end
+
+g.test_run_delete = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:select()
+        t.assert_gt(box.stat.vinyl().memory.page_cache, 0)
+        -- Pages of compacted runs are evicted.
+        for i = 1, 100, 2 do
+            s:replace({i, 'new'})
+        end
+        box.snapshot()
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count, 1)
+            t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+        end)
+        t.assert_equals(s:get(1), {1, 'new'})
+        t.assert_equals(#s:select(), 100)
+        -- Dropping the space evicts its pages.
+        t.assert_gt(box.stat.vinyl().memory.page_cache, 0)
+        s:drop()
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+        end)
+    end)
+end